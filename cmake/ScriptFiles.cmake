@@ -41,6 +41,8 @@ set(SOURCE_FILES
     version.sql
     size_utils.sql
     histogram.sql
+    time_weight.sql
+    quantile_sketch.sql
     bgw_scheduler.sql
     metadata.sql
     views.sql
@@ -79,3 +79,16 @@ RETURNS BOOL AS '@MODULE_PATHNAME@', 'ts_chunk_attach_osm_table_chunk' LANGUAGE
 -- internal API used by OSM extension to drop an OSM chunk table from the hypertable
 CREATE OR REPLACE FUNCTION _timescaledb_functions.drop_osm_chunk(hypertable REGCLASS)
 RETURNS BOOL AS '@MODULE_PATHNAME@', 'ts_chunk_drop_osm_chunk' LANGUAGE C VOLATILE;
+
+-- Invalidate the caches of the chunks when the chunk catalog tables are
+-- modified with SQL instead of the catalog API
+CREATE OR REPLACE FUNCTION _timescaledb_functions.catalog_invalidate_cache_trigger() RETURNS TRIGGER
+AS '@MODULE_PATHNAME@', 'ts_catalog_invalidate_cache_trigger' LANGUAGE C;
+
+-- CREATE OR REPLACE TRIGGER is PG14+ only
+DROP TRIGGER IF EXISTS catalog_invalidate_cache_trigger ON _timescaledb_catalog.chunk;
+CREATE TRIGGER catalog_invalidate_cache_trigger AFTER INSERT OR UPDATE OR DELETE OR TRUNCATE ON _timescaledb_catalog.chunk FOR EACH STATEMENT EXECUTE FUNCTION _timescaledb_functions.catalog_invalidate_cache_trigger();
+DROP TRIGGER IF EXISTS catalog_invalidate_cache_trigger ON _timescaledb_catalog.chunk_constraint;
+CREATE TRIGGER catalog_invalidate_cache_trigger AFTER INSERT OR UPDATE OR DELETE OR TRUNCATE ON _timescaledb_catalog.chunk_constraint FOR EACH STATEMENT EXECUTE FUNCTION _timescaledb_functions.catalog_invalidate_cache_trigger();
+DROP TRIGGER IF EXISTS catalog_invalidate_cache_trigger ON _timescaledb_catalog.dimension_slice;
+CREATE TRIGGER catalog_invalidate_cache_trigger AFTER INSERT OR UPDATE OR DELETE OR TRUNCATE ON _timescaledb_catalog.dimension_slice FOR EACH STATEMENT EXECUTE FUNCTION _timescaledb_functions.catalog_invalidate_cache_trigger();
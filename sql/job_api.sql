@@ -37,6 +37,13 @@ next_start TIMESTAMPTZ, check_config TEXT, fixed_schedule BOOL, initial_start TI
 AS '@MODULE_PATHNAME@', 'ts_job_alter'
 LANGUAGE C VOLATILE;
 
+-- Report the amount of work the running job left for later runs. Jobs with
+-- "adaptive_schedule" set in their config start again early when they
+-- report a backlog.
+CREATE OR REPLACE FUNCTION _timescaledb_functions.job_report_backlog(backlog BIGINT)
+RETURNS VOID AS '@MODULE_PATHNAME@', 'ts_bgw_job_report_backlog'
+LANGUAGE C VOLATILE STRICT;
+
 CREATE OR REPLACE FUNCTION _timescaledb_functions.alter_job_set_hypertable_id(
     job_id INTEGER,
     hypertable REGCLASS )
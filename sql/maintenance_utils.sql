@@ -11,6 +11,12 @@ CREATE OR REPLACE FUNCTION @extschema@.reorder_chunk(
     verbose BOOLEAN=FALSE
 ) RETURNS VOID AS '@MODULE_PATHNAME@', 'ts_reorder_chunk' LANGUAGE C VOLATILE;
 
+-- Move a chunk and its indexes to other tablespaces. With a reorder index,
+-- or a clustered index on the chunk or hypertable, the chunk is rewritten in
+-- index order and the AccessExclusiveLock is only held for the final swap.
+-- Otherwise, and for compressed chunks, the files are copied block by block
+-- with ALTER TABLE SET TABLESPACE, which holds an AccessExclusiveLock on the
+-- chunk for the whole copy and blocks reads of the chunk until it is done.
 CREATE OR REPLACE FUNCTION @extschema@.move_chunk(
     chunk REGCLASS,
     destination_tablespace Name,
@@ -19,6 +25,18 @@ CREATE OR REPLACE FUNCTION @extschema@.move_chunk(
     verbose BOOLEAN=FALSE
 ) RETURNS VOID AS '@MODULE_PATHNAME@', 'ts_move_chunk' LANGUAGE C VOLATILE;
 
+-- Merge adjacent chunks into the first of them and return it
+CREATE OR REPLACE FUNCTION @extschema@.merge_chunks(
+    chunks REGCLASS[]
+) RETURNS REGCLASS AS '@MODULE_PATHNAME@', 'ts_chunk_merge_chunks' LANGUAGE C VOLATILE;
+
+-- Split a chunk at a point in its primary dimension, or in the middle if
+-- split_at is NULL, and return the new chunk holding the upper part
+CREATE OR REPLACE FUNCTION @extschema@.split_chunk(
+    chunk REGCLASS,
+    split_at "any" = NULL
+) RETURNS REGCLASS AS '@MODULE_PATHNAME@', 'ts_chunk_split_chunk' LANGUAGE C VOLATILE;
+
 CREATE OR REPLACE FUNCTION _timescaledb_functions.create_compressed_chunk(
     chunk REGCLASS,
     chunk_table REGCLASS,
@@ -43,7 +43,8 @@ _timescaledb_functions.policy_compression_execute(
   verbose_log         BOOLEAN,
   recompress_enabled  BOOLEAN,
   use_creation_time   BOOLEAN,
-  useam               BOOLEAN = NULL)
+  useam               BOOLEAN = NULL,
+  adaptive            BOOLEAN = false)
 AS $$
 DECLARE
   htoid       REGCLASS;
@@ -59,6 +60,10 @@ DECLARE
   bit_compressed_partial int := 8;
   creation_lag INTERVAL := NULL;
   chunks_failure INTEGER := 0;
+  -- adaptive scheduling: chunks left for later runs and time budget of this run
+  backlog     INTEGER := 0;
+  deadline    TIMESTAMPTZ := NULL;
+  limit_reached BOOLEAN := false;
 BEGIN
 
   -- procedures with SET clause cannot execute transaction
@@ -87,6 +92,15 @@ BEGIN
     lag := NULL;
   END IF;
 
+  -- with adaptive scheduling a run stops compressing after half of the
+  -- schedule interval and reports the remaining chunks as backlog, so the
+  -- job is started again early instead of over-running
+  IF adaptive IS TRUE THEN
+    SELECT clock_timestamp() + schedule_interval / 2 INTO deadline
+    FROM _timescaledb_config.bgw_job
+    WHERE id = job_id;
+  END IF;
+
   FOR chunk_rec IN
     SELECT
       show.oid, ch.schema_name, ch.table_name, ch.status
@@ -107,6 +121,10 @@ BEGIN
         )
       )
   LOOP
+    IF limit_reached OR clock_timestamp() >= deadline THEN
+      backlog := backlog + 1;
+      CONTINUE;
+    END IF;
     IF chunk_rec.status = 0 THEN
       BEGIN
         PERFORM @extschema@.compress_chunk(chunk_rec.oid, hypercore_use_access_method => useam);
@@ -158,10 +176,20 @@ BEGIN
     END IF;
     numchunks := numchunks + 1;
     IF maxchunks > 0 AND numchunks >= maxchunks THEN
+      IF adaptive IS NOT TRUE THEN
          EXIT;
+      END IF;
+      limit_reached := true;
     END IF;
   END LOOP;
 
+  IF backlog > 0 THEN
+    PERFORM _timescaledb_functions.job_report_backlog(backlog);
+    IF verbose_log THEN
+      RAISE LOG 'job % left % chunks to compress in later runs', job_id, backlog;
+    END IF;
+  END IF;
+
   IF chunks_failure > 0 THEN
     RAISE EXCEPTION 'compression policy failure'
       USING DETAIL = format('Failed to compress %L chunks. Successfully compressed %L chunks.', chunks_failure, numchunks - chunks_failure);
@@ -188,6 +216,7 @@ DECLARE
   recompress_enabled  BOOL;
   use_creation_time   BOOL := FALSE;
   hypercore_use_access_method   BOOL;
+  adaptive            BOOL;
 BEGIN
 
   -- procedures with SET clause cannot execute transaction
@@ -206,6 +235,7 @@ BEGIN
   verbose_log         := COALESCE(jsonb_object_field_text(config, 'verbose_log')::BOOLEAN, FALSE);
   maxchunks           := COALESCE(jsonb_object_field_text(config, 'maxchunks_to_compress')::INTEGER, 0);
   recompress_enabled  := COALESCE(jsonb_object_field_text(config, 'recompress')::BOOLEAN, TRUE);
+  adaptive            := COALESCE(jsonb_object_field_text(config, 'adaptive_schedule')::BOOLEAN, FALSE);
 
   -- find primary dimension type --
   SELECT dim.column_type INTO dimtype
@@ -235,22 +265,26 @@ BEGIN
     WHEN 'TIMESTAMP'::regtype, 'TIMESTAMPTZ'::regtype, 'DATE'::regtype, 'INTERVAL' ::regtype  THEN
       CALL _timescaledb_functions.policy_compression_execute(
         job_id, htid, lag_value::INTERVAL,
-        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method
+        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method,
+        adaptive
       );
     WHEN 'BIGINT'::regtype THEN
       CALL _timescaledb_functions.policy_compression_execute(
         job_id, htid, lag_value::BIGINT,
-        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method
+        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method,
+        adaptive
       );
     WHEN 'INTEGER'::regtype THEN
       CALL _timescaledb_functions.policy_compression_execute(
         job_id, htid, lag_value::INTEGER,
-        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method
+        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method,
+        adaptive
       );
     WHEN 'SMALLINT'::regtype THEN
       CALL _timescaledb_functions.policy_compression_execute(
         job_id, htid, lag_value::SMALLINT,
-        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method
+        maxchunks, verbose_log, recompress_enabled, use_creation_time, hypercore_use_access_method,
+        adaptive
       );
   END CASE;
 END;
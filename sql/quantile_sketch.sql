@@ -0,0 +1,40 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.quantile_sketch_sfunc(state INTERNAL, fraction DOUBLE PRECISION, value DOUBLE PRECISION)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_quantile_sketch_sfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.quantile_sketch_combinefunc(state1 INTERNAL, state2 INTERNAL)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_quantile_sketch_combinefunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.quantile_sketch_serializefunc(INTERNAL)
+RETURNS bytea
+AS '@MODULE_PATHNAME@', 'ts_quantile_sketch_serializefunc'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.quantile_sketch_deserializefunc(bytea, INTERNAL)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_quantile_sketch_deserializefunc'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.approx_percentile_finalfunc(state INTERNAL)
+RETURNS DOUBLE PRECISION
+AS '@MODULE_PATHNAME@', 'ts_approx_percentile_finalfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+-- Value at the given fraction of the ordered input values, within a relative
+-- error of 1%. Unlike percentile_disc(), it can be partially aggregated.
+CREATE OR REPLACE AGGREGATE @extschema@.approx_percentile(DOUBLE PRECISION, DOUBLE PRECISION) (
+    SFUNC = _timescaledb_functions.quantile_sketch_sfunc,
+    STYPE = INTERNAL,
+    COMBINEFUNC = _timescaledb_functions.quantile_sketch_combinefunc,
+    SERIALFUNC = _timescaledb_functions.quantile_sketch_serializefunc,
+    DESERIALFUNC = _timescaledb_functions.quantile_sketch_deserializefunc,
+    PARALLEL = SAFE,
+    FINALFUNC = _timescaledb_functions.approx_percentile_finalfunc
+);
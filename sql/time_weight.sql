@@ -0,0 +1,77 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.time_weight_sfunc(state INTERNAL, ts TIMESTAMPTZ, value DOUBLE PRECISION)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_time_weight_sfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.time_weight_combinefunc(state1 INTERNAL, state2 INTERNAL)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_time_weight_combinefunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.time_weight_serializefunc(INTERNAL)
+RETURNS bytea
+AS '@MODULE_PATHNAME@', 'ts_time_weight_serializefunc'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.time_weight_deserializefunc(bytea, INTERNAL)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_time_weight_deserializefunc'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.time_weighted_avg_finalfunc(state INTERNAL)
+RETURNS DOUBLE PRECISION
+AS '@MODULE_PATHNAME@', 'ts_time_weighted_avg_finalfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.time_weight_integral_finalfunc(state INTERNAL)
+RETURNS DOUBLE PRECISION
+AS '@MODULE_PATHNAME@', 'ts_time_weight_integral_finalfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.counter_rate_finalfunc(state INTERNAL)
+RETURNS DOUBLE PRECISION
+AS '@MODULE_PATHNAME@', 'ts_counter_rate_finalfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+-- The values are linearly interpolated between consecutive points in time,
+-- so the rows have to arrive in time order within each partial aggregate. This
+-- holds for the per-chunk partial aggregates, but not for the arbitrary split
+-- of a parallel scan, so the aggregates are parallel restricted.
+
+-- Average of the values weighted by the time between them.
+CREATE OR REPLACE AGGREGATE @extschema@.time_weighted_avg(TIMESTAMPTZ, DOUBLE PRECISION) (
+    SFUNC = _timescaledb_functions.time_weight_sfunc,
+    STYPE = INTERNAL,
+    COMBINEFUNC = _timescaledb_functions.time_weight_combinefunc,
+    SERIALFUNC = _timescaledb_functions.time_weight_serializefunc,
+    DESERIALFUNC = _timescaledb_functions.time_weight_deserializefunc,
+    PARALLEL = RESTRICTED,
+    FINALFUNC = _timescaledb_functions.time_weighted_avg_finalfunc
+);
+
+-- Area under the values over time, in value-seconds.
+CREATE OR REPLACE AGGREGATE @extschema@.integral(TIMESTAMPTZ, DOUBLE PRECISION) (
+    SFUNC = _timescaledb_functions.time_weight_sfunc,
+    STYPE = INTERNAL,
+    COMBINEFUNC = _timescaledb_functions.time_weight_combinefunc,
+    SERIALFUNC = _timescaledb_functions.time_weight_serializefunc,
+    DESERIALFUNC = _timescaledb_functions.time_weight_deserializefunc,
+    PARALLEL = RESTRICTED,
+    FINALFUNC = _timescaledb_functions.time_weight_integral_finalfunc
+);
+
+-- Per-second increase of a counter that is reset to zero whenever the value
+-- decreases.
+CREATE OR REPLACE AGGREGATE @extschema@.counter_rate(TIMESTAMPTZ, DOUBLE PRECISION) (
+    SFUNC = _timescaledb_functions.time_weight_sfunc,
+    STYPE = INTERNAL,
+    COMBINEFUNC = _timescaledb_functions.time_weight_combinefunc,
+    SERIALFUNC = _timescaledb_functions.time_weight_serializefunc,
+    DESERIALFUNC = _timescaledb_functions.time_weight_deserializefunc,
+    PARALLEL = RESTRICTED,
+    FINALFUNC = _timescaledb_functions.counter_rate_finalfunc
+);
@@ -41,7 +41,7 @@ RETURNS BOOL
 AS '@MODULE_PATHNAME@', 'ts_policies_add'
 LANGUAGE C VOLATILE;
 
-DROP PROCEDURE IF EXISTS _timescaledb_functions.policy_compression_execute(job_id INTEGER, htid INTEGER, lag ANYELEMENT, maxchunks INTEGER, verbose_log BOOLEAN, recompress_enabled  BOOLEAN, use_creation_time BOOLEAN, useam BOOLEAN);
+DROP PROCEDURE IF EXISTS _timescaledb_functions.policy_compression_execute(job_id INTEGER, htid INTEGER, lag ANYELEMENT, maxchunks INTEGER, verbose_log BOOLEAN, recompress_enabled  BOOLEAN, use_creation_time BOOLEAN, useam BOOLEAN, adaptive BOOLEAN);
 
 DROP PROCEDURE IF EXISTS _timescaledb_functions.policy_compression(job_id INTEGER, config JSONB);
 DROP PROCEDURE IF EXISTS @extschema@.convert_to_columnstore(REGCLASS, BOOLEAN, BOOLEAN, BOOLEAN);
@@ -57,3 +57,33 @@ ALTER EXTENSION timescaledb DROP VIEW timescaledb_information.chunk_columnstore_
 DROP VIEW timescaledb_information.hypertable_columnstore_settings;
 DROP VIEW timescaledb_information.chunk_columnstore_settings;
 
+ALTER EXTENSION timescaledb DROP VIEW timescaledb_information.job_profiles;
+DROP VIEW timescaledb_information.job_profiles;
+
+DROP FUNCTION IF EXISTS _timescaledb_functions.job_report_backlog(BIGINT);
+
+DROP AGGREGATE IF EXISTS @extschema@.time_weighted_avg(TIMESTAMPTZ, DOUBLE PRECISION);
+DROP AGGREGATE IF EXISTS @extschema@.integral(TIMESTAMPTZ, DOUBLE PRECISION);
+DROP AGGREGATE IF EXISTS @extschema@.counter_rate(TIMESTAMPTZ, DOUBLE PRECISION);
+DROP FUNCTION IF EXISTS _timescaledb_functions.time_weight_sfunc(INTERNAL, TIMESTAMPTZ, DOUBLE PRECISION);
+DROP FUNCTION IF EXISTS _timescaledb_functions.time_weight_combinefunc(INTERNAL, INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.time_weight_serializefunc(INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.time_weight_deserializefunc(bytea, INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.time_weighted_avg_finalfunc(INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.time_weight_integral_finalfunc(INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.counter_rate_finalfunc(INTERNAL);
+
+DROP AGGREGATE IF EXISTS @extschema@.approx_percentile(DOUBLE PRECISION, DOUBLE PRECISION);
+DROP FUNCTION IF EXISTS _timescaledb_functions.quantile_sketch_sfunc(INTERNAL, DOUBLE PRECISION, DOUBLE PRECISION);
+DROP FUNCTION IF EXISTS _timescaledb_functions.quantile_sketch_combinefunc(INTERNAL, INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.quantile_sketch_serializefunc(INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.quantile_sketch_deserializefunc(bytea, INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.approx_percentile_finalfunc(INTERNAL);
+
+DROP TRIGGER IF EXISTS catalog_invalidate_cache_trigger ON _timescaledb_catalog.chunk;
+DROP TRIGGER IF EXISTS catalog_invalidate_cache_trigger ON _timescaledb_catalog.chunk_constraint;
+DROP TRIGGER IF EXISTS catalog_invalidate_cache_trigger ON _timescaledb_catalog.dimension_slice;
+DROP FUNCTION IF EXISTS _timescaledb_functions.catalog_invalidate_cache_trigger();
+
+DROP FUNCTION IF EXISTS @extschema@.merge_chunks(REGCLASS[]);
+DROP FUNCTION IF EXISTS @extschema@.split_chunk(REGCLASS, "any");
@@ -354,6 +354,36 @@ WHERE (pg_catalog.pg_has_role(current_user,
 			   'MEMBER') IS TRUE
     OR pg_catalog.pg_has_role(current_user, owner, 'MEMBER') IS TRUE);
 
+-- Execution profiles recorded in the job history. Policies record the time
+-- spent in each phase of their execution (in milliseconds) and counters for
+-- the work they did. Profiles are only collected when a job is run by a
+-- background worker, so running a job with CALL run_job() does not add a
+-- profile here.
+CREATE OR REPLACE VIEW timescaledb_information.job_profiles
+WITH (security_barrier = true) AS
+SELECT
+    h.id,
+    h.job_id,
+    h.succeeded,
+    coalesce(h.data->'job'->>'proc_schema', j.proc_schema) as proc_schema,
+    coalesce(h.data->'job'->>'proc_name', j.proc_name) as proc_name,
+    h.execution_start AS start_time,
+    h.execution_finish AS finish_time,
+    h.execution_finish - h.execution_start AS total_duration,
+    h.data->'profile'->'phases' AS phases,
+    h.data->'profile'->'counters' AS counters
+FROM
+    _timescaledb_internal.bgw_job_stat_history h
+LEFT JOIN
+    _timescaledb_config.bgw_job j ON (j.id = h.job_id)
+WHERE h.data ? 'profile'
+    AND (pg_catalog.pg_has_role(current_user,
+			   (SELECT pg_catalog.pg_get_userbyid(datdba)
+			      FROM pg_catalog.pg_database
+			     WHERE datname = current_database()),
+			   'MEMBER') IS TRUE
+    OR pg_catalog.pg_has_role(current_user, owner, 'MEMBER') IS TRUE);
+
 CREATE OR REPLACE VIEW timescaledb_information.hypertable_compression_settings AS
 	SELECT
 		format('%I.%I',ht.schema_name,ht.table_name)::regclass AS hypertable,
@@ -12,6 +12,8 @@
 #include <libpq/pqformat.h>
 #include <nodes/value.h>
 #include <utils/datum.h>
+#include <utils/float.h>
+#include <utils/fmgroids.h>
 #include <utils/lsyscache.h>
 #include <utils/syscache.h>
 
@@ -38,6 +40,8 @@ typedef struct PolyDatum
 {
 	bool is_null;
 	Datum datum;
+	/* size of the by-reference copy of the datum we own, 0 if unknown */
+	Size alloc_size;
 } PolyDatum;
 
 typedef struct TypeInfoCache
@@ -66,6 +70,7 @@ polydatum_from_arg(int argno, FunctionCallInfo fcinfo)
 		value.datum = PG_GETARG_DATUM(argno);
 	else
 		value.datum = PointerGetDatum(NULL);
+	value.alloc_size = 0;
 	return value;
 }
 
@@ -200,6 +205,7 @@ polydatum_deserialize(MemoryContext mem_ctx, PolyDatum *result, StringInfo buf,
 	}
 
 	result->datum = ReceiveFunctionCall(&state->proc, bufptr, state->typeioparam, -1);
+	result->alloc_size = 0;
 
 	if (bufptr)
 	{
@@ -217,11 +223,27 @@ polydatum_deserialize(MemoryContext mem_ctx, PolyDatum *result, StringInfo buf,
 	return result;
 }
 
+/*
+ * Comparisons of common fixed-width types are done inline instead of calling
+ * the operator procedure through fmgr.
+ */
+typedef enum BookendCmpKind
+{
+	BOOKEND_CMP_FMGR = 0,
+	BOOKEND_CMP_INT2,
+	BOOKEND_CMP_INT4,
+	BOOKEND_CMP_INT8,
+	BOOKEND_CMP_FLOAT4,
+	BOOKEND_CMP_FLOAT8,
+} BookendCmpKind;
+
 typedef struct TransCache
 {
 	TypeInfoCache value_type_cache;
 	TypeInfoCache cmp_type_cache;
 	FmgrInfo cmp_proc;
+	BookendCmpKind cmp_kind;
+	bool cmp_less; /* the comparison is < rather than > */
 } TransCache;
 
 /* Internal state for bookend aggregates */
@@ -250,32 +272,88 @@ typedef struct InternalCmpAggStoreIOState
 	PolyDatumIOState cmp; /* the comparison element. e.g. time */
 } InternalCmpAggStoreIOState;
 
+/*
+ * Copy the input datum to the output. A by-reference copy already owned by
+ * the output is overwritten when it is big enough, so a new extreme does not
+ * need an allocation. That happens for every row when the input is sorted by
+ * the comparison element.
+ */
 inline static void
 typeinfocache_polydatumcopy(TypeInfoCache *tic, PolyDatum input, PolyDatum *output)
 {
 	Assert(OidIsValid(tic->typoid));
 
-	if (!tic->typbyval && !output->is_null)
+	if (tic->typbyval)
 	{
-		pfree(DatumGetPointer(output->datum));
+		output->datum = input.is_null ? PointerGetDatum(NULL) : input.datum;
+		output->is_null = input.is_null;
+		output->alloc_size = 0;
+		return;
 	}
 
-	*output = input;
-
 	if (!input.is_null)
 	{
-		output->datum = datumCopy(input.datum, tic->typbyval, tic->typlen);
+		bool expanded =
+			tic->typlen == -1 && VARATT_IS_EXTERNAL_EXPANDED(DatumGetPointer(input.datum));
+		Size size = expanded ? 0 : datumGetSize(input.datum, false, tic->typlen);
+
+		if (!expanded && !output->is_null && output->alloc_size >= size)
+		{
+			memcpy(DatumGetPointer(output->datum), DatumGetPointer(input.datum), size);
+			return;
+		}
+
+		if (!output->is_null)
+			pfree(DatumGetPointer(output->datum));
+
+		output->datum = datumCopy(input.datum, false, tic->typlen);
 		output->is_null = false;
+		output->alloc_size = size;
 	}
 	else
 	{
+		if (!output->is_null)
+			pfree(DatumGetPointer(output->datum));
+
 		output->datum = PointerGetDatum(NULL);
 		output->is_null = true;
+		output->alloc_size = 0;
+	}
+}
+
+static BookendCmpKind
+cmpproc_kind(Oid cmp_regproc)
+{
+	switch (cmp_regproc)
+	{
+		case F_INT2LT:
+		case F_INT2GT:
+			return BOOKEND_CMP_INT2;
+		case F_INT4LT:
+		case F_INT4GT:
+		case F_DATE_LT:
+		case F_DATE_GT:
+			return BOOKEND_CMP_INT4;
+		case F_INT8LT:
+		case F_INT8GT:
+		case F_TIMESTAMP_LT:
+		case F_TIMESTAMP_GT:
+		case F_TIMESTAMPTZ_LT:
+		case F_TIMESTAMPTZ_GT:
+			return BOOKEND_CMP_INT8;
+		case F_FLOAT4LT:
+		case F_FLOAT4GT:
+			return BOOKEND_CMP_FLOAT4;
+		case F_FLOAT8LT:
+		case F_FLOAT8GT:
+			return BOOKEND_CMP_FLOAT8;
+		default:
+			return BOOKEND_CMP_FMGR;
 	}
 }
 
 inline static void
-cmpproc_init(FunctionCallInfo fcinfo, FmgrInfo *cmp_proc, Oid type_oid, char *opname)
+cmpproc_init(FunctionCallInfo fcinfo, TransCache *cache, Oid type_oid, char *opname)
 {
 	Oid cmp_op, cmp_regproc;
 
@@ -291,13 +369,40 @@ cmpproc_init(FunctionCallInfo fcinfo, FmgrInfo *cmp_proc, Oid type_oid, char *op
 			 "could not find the procedure for the %s operator for type %d",
 			 opname,
 			 type_oid);
-	fmgr_info_cxt(cmp_regproc, cmp_proc, fcinfo->flinfo->fn_mcxt);
+	fmgr_info_cxt(cmp_regproc, &cache->cmp_proc, fcinfo->flinfo->fn_mcxt);
+	cache->cmp_kind = cmpproc_kind(cmp_regproc);
+	cache->cmp_less = opname[0] == '<';
 }
 
+#define BOOKEND_CMP(cache, left, right)                                                            \
+	((cache)->cmp_less ? (left) < (right) : (left) > (right))
+
 inline static bool
-cmpproc_cmp(FmgrInfo *cmp_proc, FunctionCallInfo fcinfo, PolyDatum left, PolyDatum right)
+cmpproc_cmp(TransCache *cache, FunctionCallInfo fcinfo, PolyDatum left, PolyDatum right)
 {
-	return DatumGetBool(FunctionCall2Coll(cmp_proc, fcinfo->fncollation, left.datum, right.datum));
+	switch (cache->cmp_kind)
+	{
+		case BOOKEND_CMP_INT2:
+			return BOOKEND_CMP(cache, DatumGetInt16(left.datum), DatumGetInt16(right.datum));
+		case BOOKEND_CMP_INT4:
+			return BOOKEND_CMP(cache, DatumGetInt32(left.datum), DatumGetInt32(right.datum));
+		case BOOKEND_CMP_INT8:
+			return BOOKEND_CMP(cache, DatumGetInt64(left.datum), DatumGetInt64(right.datum));
+		case BOOKEND_CMP_FLOAT4:
+			/* float4_lt() and float4_gt() sort NaN above all other values */
+			return cache->cmp_less ?
+					   float4_lt(DatumGetFloat4(left.datum), DatumGetFloat4(right.datum)) :
+					   float4_gt(DatumGetFloat4(left.datum), DatumGetFloat4(right.datum));
+		case BOOKEND_CMP_FLOAT8:
+			return cache->cmp_less ?
+					   float8_lt(DatumGetFloat8(left.datum), DatumGetFloat8(right.datum)) :
+					   float8_gt(DatumGetFloat8(left.datum), DatumGetFloat8(right.datum));
+		case BOOKEND_CMP_FMGR:
+			break;
+	}
+
+	return DatumGetBool(
+		FunctionCall2Coll(&cache->cmp_proc, fcinfo->fncollation, left.datum, right.datum));
 }
 
 /*
@@ -336,11 +441,11 @@ bookend_sfunc(MemoryContext aggcontext, InternalCmpAggStore *state, char *opname
 
 		if (cache->cmp_proc.fn_addr == NULL)
 		{
-			cmpproc_init(fcinfo, &cache->cmp_proc, cache->cmp_type_cache.typoid, opname);
+			cmpproc_init(fcinfo, cache, cache->cmp_type_cache.typoid, opname);
 		}
 
 		/* only do comparison if cmp is not NULL */
-		if (state->cmp.is_null || cmpproc_cmp(&cache->cmp_proc, fcinfo, cmp, state->cmp))
+		if (state->cmp.is_null || cmpproc_cmp(cache, fcinfo, cmp, state->cmp))
 		{
 			typeinfocache_polydatumcopy(&cache->value_type_cache, value, &state->value);
 			typeinfocache_polydatumcopy(&cache->cmp_type_cache, cmp, &state->cmp);
@@ -407,9 +512,9 @@ bookend_combinefunc(MemoryContext aggcontext, InternalCmpAggStore *state1,
 	TransCache *cache1 = &state1->aggstate_type_cache;
 	if (cache1->cmp_proc.fn_addr == NULL)
 	{
-		cmpproc_init(fcinfo, &cache1->cmp_proc, cache1->cmp_type_cache.typoid, opname);
+		cmpproc_init(fcinfo, cache1, cache1->cmp_type_cache.typoid, opname);
 	}
-	if (cmpproc_cmp(&cache1->cmp_proc, fcinfo, state2->cmp, state1->cmp))
+	if (cmpproc_cmp(cache1, fcinfo, state2->cmp, state1->cmp))
 	{
 		old_context = MemoryContextSwitchTo(aggcontext);
 		typeinfocache_polydatumcopy(&cache1->value_type_cache, state2->value, &state1->value);
@@ -0,0 +1,747 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#include <postgres.h>
+#include <math.h>
+#include <access/htup_details.h>
+#include <access/table.h>
+#include <catalog/indexing.h>
+#include <catalog/pg_class.h>
+#include <catalog/pg_statistic.h>
+#include <catalog/pg_type.h>
+#include <utils/array.h>
+#include <utils/datum.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/rel.h>
+#include <utils/sortsupport.h>
+#include <utils/syscache.h>
+#include <utils/typcache.h>
+
+#include "attstats.h"
+#include "chunk.h"
+#include "ts_catalog/compression_chunk_size.h"
+#include "utils.h"
+
+/*
+ * Column statistics of chunks and hypertables.
+ *
+ * The data of a compressed chunk is stored in its compressed chunk, so
+ * ANALYZE only finds an empty relation when it samples the rows of the chunk
+ * or of the hypertable. Instead, the column statistics of a chunk are computed
+ * from a sample of its rows when the chunk is compressed, and ANALYZE on the
+ * hypertable merges the statistics of the compressed chunks into the
+ * statistics of the hypertable, without reading the compressed data.
+ */
+
+/*
+ * Store the column statistics computed by the typanalyze function of the
+ * column in pg_statistic, like update_attstats() does for ANALYZE.
+ */
+void
+ts_attstats_store(Oid relid, AttrNumber attnum, bool inherited, const VacAttrStats *stats)
+{
+	Relation sd;
+	HeapTuple tuple;
+	Datum values[Natts_pg_statistic];
+	bool nulls[Natts_pg_statistic] = { false };
+	bool replaces[Natts_pg_statistic];
+	int i;
+
+	memset(replaces, true, sizeof(replaces));
+
+	values[AttrNumberGetAttrOffset(Anum_pg_statistic_starelid)] = ObjectIdGetDatum(relid);
+	values[AttrNumberGetAttrOffset(Anum_pg_statistic_staattnum)] = Int16GetDatum(attnum);
+	values[AttrNumberGetAttrOffset(Anum_pg_statistic_stainherit)] = BoolGetDatum(inherited);
+	values[AttrNumberGetAttrOffset(Anum_pg_statistic_stanullfrac)] =
+		Float4GetDatum(stats->stanullfrac);
+	values[AttrNumberGetAttrOffset(Anum_pg_statistic_stawidth)] = Int32GetDatum(stats->stawidth);
+	values[AttrNumberGetAttrOffset(Anum_pg_statistic_stadistinct)] =
+		Float4GetDatum(stats->stadistinct);
+
+	for (int k = 0; k < STATISTIC_NUM_SLOTS; k++)
+	{
+		values[AttrNumberGetAttrOffset(Anum_pg_statistic_stakind1) + k] =
+			Int16GetDatum(stats->stakind[k]);
+		values[AttrNumberGetAttrOffset(Anum_pg_statistic_staop1) + k] =
+			ObjectIdGetDatum(stats->staop[k]);
+		values[AttrNumberGetAttrOffset(Anum_pg_statistic_stacoll1) + k] =
+			ObjectIdGetDatum(stats->stacoll[k]);
+	}
+
+	for (int k = 0; k < STATISTIC_NUM_SLOTS; k++)
+	{
+		i = AttrNumberGetAttrOffset(Anum_pg_statistic_stanumbers1) + k;
+
+		if (stats->numnumbers[k] > 0)
+		{
+			Datum *numdatums = palloc(stats->numnumbers[k] * sizeof(Datum));
+
+			for (int n = 0; n < stats->numnumbers[k]; n++)
+				numdatums[n] = Float4GetDatum(stats->stanumbers[k][n]);
+
+			values[i] = PointerGetDatum(construct_array(numdatums,
+														stats->numnumbers[k],
+														FLOAT4OID,
+														sizeof(float4),
+														true,
+														TYPALIGN_INT));
+		}
+		else
+		{
+			nulls[i] = true;
+			values[i] = (Datum) 0;
+		}
+	}
+
+	for (int k = 0; k < STATISTIC_NUM_SLOTS; k++)
+	{
+		i = AttrNumberGetAttrOffset(Anum_pg_statistic_stavalues1) + k;
+
+		if (stats->numvalues[k] > 0)
+		{
+			values[i] = PointerGetDatum(construct_array(stats->stavalues[k],
+														stats->numvalues[k],
+														stats->statypid[k],
+														stats->statyplen[k],
+														stats->statypbyval[k],
+														stats->statypalign[k]));
+		}
+		else
+		{
+			nulls[i] = true;
+			values[i] = (Datum) 0;
+		}
+	}
+
+	sd = table_open(StatisticRelationId, RowExclusiveLock);
+
+	tuple = SearchSysCache3(STATRELATTINH,
+							ObjectIdGetDatum(relid),
+							Int16GetDatum(attnum),
+							BoolGetDatum(inherited));
+
+	if (HeapTupleIsValid(tuple))
+	{
+		HeapTuple newtuple =
+			heap_modify_tuple(tuple, RelationGetDescr(sd), values, nulls, replaces);
+
+		ReleaseSysCache(tuple);
+		CatalogTupleUpdate(sd, &newtuple->t_self, newtuple);
+		heap_freetuple(newtuple);
+	}
+	else
+	{
+		HeapTuple newtuple = heap_form_tuple(RelationGetDescr(sd), values, nulls);
+
+		CatalogTupleInsert(sd, newtuple);
+		heap_freetuple(newtuple);
+	}
+
+	table_close(sd, RowExclusiveLock);
+}
+
+/* The statistics of a column of one of the inputs of a merge */
+typedef struct AttStatsInput
+{
+	HeapTuple tuple;
+	/* The number of rows described by the statistics, including NULLs */
+	double rows;
+	/* The fraction of the rows in the MCV list of the input */
+	double mcv_frac;
+} AttStatsInput;
+
+/* A value of the merged statistics, and the number of rows it stands for */
+typedef struct AttStatsValue
+{
+	Datum value;
+	double rows;
+} AttStatsValue;
+
+static int
+attstats_value_cmp(const void *a, const void *b, void *arg)
+{
+	const AttStatsValue *va = (const AttStatsValue *) a;
+	const AttStatsValue *vb = (const AttStatsValue *) b;
+
+	return ApplySortComparator(va->value, false, vb->value, false, (SortSupport) arg);
+}
+
+static int
+attstats_value_rows_cmp(const void *a, const void *b)
+{
+	const AttStatsValue *va = (const AttStatsValue *) a;
+	const AttStatsValue *vb = (const AttStatsValue *) b;
+
+	if (va->rows != vb->rows)
+		return va->rows > vb->rows ? -1 : 1;
+
+	return 0;
+}
+
+static void
+attstats_prepare_sort(SortSupport ssup, Oid ltopr, Oid collation)
+{
+	memset(ssup, 0, sizeof(SortSupportData));
+	ssup->ssup_cxt = CurrentMemoryContext;
+	ssup->ssup_collation = collation;
+	ssup->ssup_nulls_first = false;
+	PrepareSortSupportFromOrderingOp(ltopr, ssup);
+}
+
+/*
+ * Add up the rows of equal values. The values are sorted if the type has an
+ * ordering operator, otherwise they are compared one by one with the
+ * equality operator of the MCV lists. Returns the number of distinct values.
+ */
+static int
+attstats_combine_values(AttStatsValue *values, int nvalues, Oid valuetype, Oid eqopr,
+						Oid collation)
+{
+	TypeCacheEntry *typentry = lookup_type_cache(valuetype, TYPECACHE_LT_OPR);
+	int ncombined = 0;
+
+	if (OidIsValid(typentry->lt_opr))
+	{
+		SortSupportData ssup;
+
+		attstats_prepare_sort(&ssup, typentry->lt_opr, collation);
+		qsort_arg(values, nvalues, sizeof(AttStatsValue), attstats_value_cmp, &ssup);
+
+		for (int i = 0; i < nvalues; i++)
+		{
+			if (ncombined > 0 &&
+				attstats_value_cmp(&values[ncombined - 1], &values[i], &ssup) == 0)
+				values[ncombined - 1].rows += values[i].rows;
+			else
+				values[ncombined++] = values[i];
+		}
+	}
+	else
+	{
+		FmgrInfo eqproc;
+
+		fmgr_info(get_opcode(eqopr), &eqproc);
+
+		for (int i = 0; i < nvalues; i++)
+		{
+			int j;
+
+			for (j = 0; j < ncombined; j++)
+			{
+				if (DatumGetBool(
+						FunctionCall2Coll(&eqproc, collation, values[j].value, values[i].value)))
+				{
+					values[j].rows += values[i].rows;
+					break;
+				}
+			}
+
+			if (j == ncombined)
+				values[ncombined++] = values[i];
+		}
+	}
+
+	return ncombined;
+}
+
+static void
+attstats_set_slot_type(VacAttrStats *stats, int slot, Oid valuetype)
+{
+	stats->statypid[slot] = valuetype;
+	get_typlenbyvalalign(valuetype,
+						 &stats->statyplen[slot],
+						 &stats->statypbyval[slot],
+						 &stats->statypalign[slot]);
+}
+
+/*
+ * Merge the MCV lists of the inputs. The merged list is as long as the
+ * longest input list, and the values that don't make it into the merged list
+ * are returned, so that they can be added to the histogram.
+ */
+static int
+attstats_merge_mcv(VacAttrStats *stats, int slot, AttStatsInput *inputs, int ninputs,
+				   double total_rows, AttStatsValue **leftover, int *nleftover, Oid *valuetype)
+{
+	AttStatsValue *values = NULL;
+	int nvalues = 0;
+	int max_mcvs = 0;
+	Oid eqopr = InvalidOid;
+	Oid collation = InvalidOid;
+	int16 typlen = 0;
+	bool typbyval = false;
+	int nkeep;
+
+	for (int i = 0; i < ninputs; i++)
+	{
+		AttStatsSlot sslot;
+
+		if (!get_attstatsslot(&sslot,
+							  inputs[i].tuple,
+							  STATISTIC_KIND_MCV,
+							  InvalidOid,
+							  ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS))
+			continue;
+
+		if (!OidIsValid(eqopr))
+		{
+			eqopr = sslot.staop;
+			collation = sslot.stacoll;
+			*valuetype = sslot.valuetype;
+			get_typlenbyval(*valuetype, &typlen, &typbyval);
+		}
+
+		if (sslot.valuetype == *valuetype && sslot.nvalues == sslot.nnumbers)
+		{
+			if (values == NULL)
+				values = palloc(sizeof(AttStatsValue) * sslot.nvalues);
+			else
+				values = repalloc(values, sizeof(AttStatsValue) * (nvalues + sslot.nvalues));
+
+			for (int j = 0; j < sslot.nvalues; j++)
+			{
+				values[nvalues].value = datumCopy(sslot.values[j], typbyval, typlen);
+				values[nvalues].rows = sslot.numbers[j] * inputs[i].rows;
+				inputs[i].mcv_frac += sslot.numbers[j];
+				nvalues++;
+			}
+
+			max_mcvs = Max(max_mcvs, sslot.nvalues);
+		}
+
+		free_attstatsslot(&sslot);
+	}
+
+	if (nvalues == 0)
+		return 0;
+
+	nvalues = attstats_combine_values(values, nvalues, *valuetype, eqopr, collation);
+	qsort(values, nvalues, sizeof(AttStatsValue), attstats_value_rows_cmp);
+	nkeep = Min(nvalues, max_mcvs);
+
+	stats->stakind[slot] = STATISTIC_KIND_MCV;
+	stats->staop[slot] = eqopr;
+	stats->stacoll[slot] = collation;
+	stats->numvalues[slot] = nkeep;
+	stats->stavalues[slot] = palloc(sizeof(Datum) * nkeep);
+	stats->numnumbers[slot] = nkeep;
+	stats->stanumbers[slot] = palloc(sizeof(float4) * nkeep);
+	attstats_set_slot_type(stats, slot, *valuetype);
+
+	for (int i = 0; i < nkeep; i++)
+	{
+		stats->stavalues[slot][i] = values[i].value;
+		stats->stanumbers[slot][i] = values[i].rows / total_rows;
+	}
+
+	*leftover = &values[nkeep];
+	*nleftover = nvalues - nkeep;
+
+	return 1;
+}
+
+/*
+ * Merge the histograms of the inputs. Every bucket of an input histogram
+ * stands for the same number of rows, which are split between the two bounds
+ * of the bucket. The merged histogram picks its bounds at equal distances in
+ * the number of rows along all the bounds.
+ */
+static int
+attstats_merge_histogram(VacAttrStats *stats, int slot, AttStatsInput *inputs, int ninputs,
+						 AttStatsValue *leftover, int nleftover, Oid *valuetype)
+{
+	AttStatsValue *points = NULL;
+	int npoints = 0;
+	int max_bounds = 0;
+	Oid ltopr = InvalidOid;
+	Oid collation = InvalidOid;
+	int16 typlen = 0;
+	bool typbyval = false;
+	SortSupportData ssup;
+	double total = 0;
+	double cumulative = 0;
+	int nbounds = 0;
+	int p = 0;
+
+	for (int i = 0; i < ninputs; i++)
+	{
+		Form_pg_statistic form = (Form_pg_statistic) GETSTRUCT(inputs[i].tuple);
+		AttStatsSlot sslot;
+		double rows;
+
+		if (!get_attstatsslot(&sslot,
+							  inputs[i].tuple,
+							  STATISTIC_KIND_HISTOGRAM,
+							  InvalidOid,
+							  ATTSTATSSLOT_VALUES))
+			continue;
+
+		if (!OidIsValid(ltopr))
+		{
+			ltopr = sslot.staop;
+			collation = sslot.stacoll;
+
+			if (!OidIsValid(*valuetype))
+				*valuetype = sslot.valuetype;
+
+			get_typlenbyval(*valuetype, &typlen, &typbyval);
+		}
+
+		rows = inputs[i].rows * (1.0 - form->stanullfrac - inputs[i].mcv_frac);
+
+		if (sslot.valuetype == *valuetype && sslot.nvalues >= 2 && rows > 0)
+		{
+			double bucket_rows = rows / (sslot.nvalues - 1);
+
+			if (points == NULL)
+				points = palloc(sizeof(AttStatsValue) * (sslot.nvalues + nleftover));
+			else
+				points = repalloc(points,
+								  sizeof(AttStatsValue) * (npoints + sslot.nvalues + nleftover));
+
+			for (int j = 0; j < sslot.nvalues; j++)
+			{
+				bool is_end = (j == 0 || j == sslot.nvalues - 1);
+
+				points[npoints].value = datumCopy(sslot.values[j], typbyval, typlen);
+				points[npoints].rows = is_end ? bucket_rows / 2 : bucket_rows;
+				npoints++;
+			}
+
+			max_bounds = Max(max_bounds, sslot.nvalues);
+		}
+
+		free_attstatsslot(&sslot);
+	}
+
+	if (npoints == 0)
+		return 0;
+
+	/* The values that didn't make it into the merged MCV list */
+	for (int i = 0; i < nleftover; i++)
+		points[npoints++] = leftover[i];
+
+	attstats_prepare_sort(&ssup, ltopr, collation);
+	qsort_arg(points, npoints, sizeof(AttStatsValue), attstats_value_cmp, &ssup);
+
+	for (int i = 0; i < npoints; i++)
+		total += points[i].rows;
+
+	stats->stavalues[slot] = palloc(sizeof(Datum) * max_bounds);
+
+	for (int b = 0; b < max_bounds; b++)
+	{
+		double target = total * b / (max_bounds - 1);
+		Datum bound;
+
+		while (p < npoints - 1 && cumulative + points[p].rows < target)
+			cumulative += points[p++].rows;
+
+		bound = (b == max_bounds - 1) ? points[npoints - 1].value : points[p].value;
+
+		/* Bounds must be distinct */
+		if (nbounds > 0 && ApplySortComparator(stats->stavalues[slot][nbounds - 1],
+											   false,
+											   bound,
+											   false,
+											   &ssup) == 0)
+			continue;
+
+		stats->stavalues[slot][nbounds++] = bound;
+	}
+
+	if (nbounds < 2)
+		return 0;
+
+	stats->stakind[slot] = STATISTIC_KIND_HISTOGRAM;
+	stats->staop[slot] = ltopr;
+	stats->stacoll[slot] = collation;
+	stats->numvalues[slot] = nbounds;
+	attstats_set_slot_type(stats, slot, *valuetype);
+
+	return 1;
+}
+
+/* The correlation of the merged statistics is the average of the inputs */
+static int
+attstats_merge_correlation(VacAttrStats *stats, int slot, AttStatsInput *inputs, int ninputs)
+{
+	double correlation = 0;
+	double rows = 0;
+
+	for (int i = 0; i < ninputs; i++)
+	{
+		Form_pg_statistic form = (Form_pg_statistic) GETSTRUCT(inputs[i].tuple);
+		AttStatsSlot sslot;
+
+		if (!get_attstatsslot(&sslot,
+							  inputs[i].tuple,
+							  STATISTIC_KIND_CORRELATION,
+							  InvalidOid,
+							  ATTSTATSSLOT_NUMBERS))
+			continue;
+
+		if (sslot.nnumbers == 1)
+		{
+			double nonnull_rows = inputs[i].rows * (1.0 - form->stanullfrac);
+
+			stats->staop[slot] = sslot.staop;
+			stats->stacoll[slot] = sslot.stacoll;
+			correlation += sslot.numbers[0] * nonnull_rows;
+			rows += nonnull_rows;
+		}
+
+		free_attstatsslot(&sslot);
+	}
+
+	if (rows <= 0)
+		return 0;
+
+	stats->stakind[slot] = STATISTIC_KIND_CORRELATION;
+	stats->numnumbers[slot] = 1;
+	stats->stanumbers[slot] = palloc(sizeof(float4));
+	stats->stanumbers[slot][0] = correlation / rows;
+
+	return 1;
+}
+
+/*
+ * Merge the statistics of a column of several relations into the statistics
+ * of the column of the hypertable.
+ *
+ * The NULL fraction, width and correlation are averaged over the rows, and
+ * the MCV lists and histograms are merged. Other kinds of statistics are not
+ * merged. The number of distinct values can only be estimated: a number of
+ * distinct values that ANALYZE expects to grow with the number of rows, like
+ * with time values, is added up, otherwise the largest number is used, like
+ * with the values of a small set of devices that appear in every chunk.
+ */
+static void
+attstats_merge_column(Oid relid, AttrNumber attnum, AttStatsInput *inputs, int ninputs)
+{
+	VacAttrStats stats = { 0 };
+	double total_rows = 0;
+	double nonnull_rows = 0;
+	double width = 0;
+	double distinct_fixed = 0;
+	double distinct_scaled = 0;
+	AttStatsValue *leftover = NULL;
+	int nleftover = 0;
+	Oid valuetype = InvalidOid;
+	int slot = 0;
+
+	for (int i = 0; i < ninputs; i++)
+	{
+		Form_pg_statistic form = (Form_pg_statistic) GETSTRUCT(inputs[i].tuple);
+		double rows = inputs[i].rows;
+
+		total_rows += rows;
+		nonnull_rows += rows * (1.0 - form->stanullfrac);
+		width += rows * (1.0 - form->stanullfrac) * form->stawidth;
+
+		if (form->stadistinct > 0)
+			distinct_fixed = Max(distinct_fixed, form->stadistinct);
+		else
+			distinct_scaled += -form->stadistinct * rows;
+	}
+
+	if (total_rows <= 0)
+		return;
+
+	stats.stanullfrac = (total_rows - nonnull_rows) / total_rows;
+	stats.stawidth = nonnull_rows > 0 ? (int32) rint(width / nonnull_rows) : 0;
+
+	if (distinct_scaled > distinct_fixed)
+		stats.stadistinct = -Min(distinct_scaled, nonnull_rows) / total_rows;
+	else
+		stats.stadistinct = Min(distinct_fixed, nonnull_rows);
+
+	slot += attstats_merge_mcv(&stats,
+							   slot,
+							   inputs,
+							   ninputs,
+							   total_rows,
+							   &leftover,
+							   &nleftover,
+							   &valuetype);
+	slot += attstats_merge_histogram(&stats,
+									 slot,
+									 inputs,
+									 ninputs,
+									 leftover,
+									 nleftover,
+									 &valuetype);
+	slot += attstats_merge_correlation(&stats, slot, inputs, ninputs);
+
+	ts_attstats_store(relid, attnum, true, &stats);
+}
+
+typedef struct CompressedChunkRows
+{
+	Oid relid;
+	double rows;
+} CompressedChunkRows;
+
+/*
+ * Merge the column statistics of the compressed chunks of a hypertable into
+ * the statistics of the hypertable. This is done after ANALYZE on the
+ * hypertable, which only computes the statistics from the rows that are not
+ * compressed. Only chunks that have statistics of their own are included,
+ * which are computed when the chunk is compressed. If the hypertable doesn't
+ * have any compressed chunks with statistics, the statistics of ANALYZE are
+ * kept as they are.
+ *
+ * This only runs for ANALYZE statements, which go through the utility hook.
+ * An ANALYZE of the hypertable by autovacuum replaces the merged statistics
+ * with the statistics of the uncompressed rows until the next ANALYZE
+ * statement. Autovacuum only analyzes a hypertable when its own, usually
+ * empty, table has changed, so this is rare. The statistics of the chunks
+ * themselves are not affected, since ANALYZE doesn't replace statistics when
+ * it doesn't find any rows.
+ */
+void
+ts_attstats_merge_compressed_chunks(const Hypertable *ht, List *va_cols)
+{
+	List *chunks = ts_chunk_get_by_hypertable_id(ht->fd.id);
+	CompressedChunkRows *compressed = palloc(sizeof(CompressedChunkRows) * list_length(chunks));
+	int ncompressed = 0;
+	double heap_rows = 0;
+	AttStatsInput *inputs;
+	MemoryContext merge_mcxt;
+	MemoryContext oldmcxt;
+	Relation htrel;
+	TupleDesc tupdesc;
+	ListCell *lc;
+
+	foreach (lc, chunks)
+	{
+		Chunk *chunk = lfirst(lc);
+		HeapTuple classtup;
+		Form_pg_class classform;
+
+		if (chunk->fd.dropped || chunk->fd.osm_chunk || !OidIsValid(chunk->table_id))
+			continue;
+
+		classtup = SearchSysCache1(RELOID, ObjectIdGetDatum(chunk->table_id));
+
+		if (!HeapTupleIsValid(classtup))
+			continue;
+
+		classform = (Form_pg_class) GETSTRUCT(classtup);
+
+		/*
+		 * Hypercore chunks and the non-compressed rows of partially
+		 * compressed chunks are sampled by ANALYZE.
+		 */
+		if (ts_chunk_is_compressed(chunk) && !ts_chunk_is_partial(chunk) &&
+			!ts_is_hypercore_am(classform->relam))
+		{
+			int64 rowcount = ts_compression_chunk_size_row_count(chunk->fd.id);
+
+			if (rowcount > 0)
+			{
+				compressed[ncompressed].relid = chunk->table_id;
+				compressed[ncompressed].rows = rowcount;
+				ncompressed++;
+			}
+		}
+		else if (classform->reltuples > 0)
+			heap_rows += classform->reltuples;
+
+		ReleaseSysCache(classtup);
+	}
+
+	if (ncompressed == 0)
+		return;
+
+	inputs = palloc(sizeof(AttStatsInput) * (ncompressed + 1));
+	merge_mcxt = AllocSetContextCreate(CurrentMemoryContext,
+									   "Hypertable statistics merge",
+									   ALLOCSET_DEFAULT_SIZES);
+
+	htrel = table_open(ht->main_table_relid, ShareUpdateExclusiveLock);
+	tupdesc = RelationGetDescr(htrel);
+
+	for (int i = 0; i < tupdesc->natts; i++)
+	{
+		Form_pg_attribute attr = TupleDescAttr(tupdesc, i);
+		int ninputs = 0;
+		bool have_chunk_stats = false;
+
+		if (attr->attisdropped)
+			continue;
+
+		if (va_cols != NIL)
+		{
+			ListCell *lc_col;
+			bool found = false;
+
+			foreach (lc_col, va_cols)
+			{
+				if (namestrcmp(&attr->attname, strVal(lfirst(lc_col))) == 0)
+					found = true;
+			}
+
+			if (!found)
+				continue;
+		}
+
+		/*
+		 * The statistics that ANALYZE computed from the rows of the
+		 * non-compressed chunks. If there are no such rows, the statistics
+		 * might be left over from before and must not be merged again.
+		 */
+		if (heap_rows > 0)
+		{
+			HeapTuple tuple = SearchSysCache3(STATRELATTINH,
+											  ObjectIdGetDatum(ht->main_table_relid),
+											  Int16GetDatum(attr->attnum),
+											  BoolGetDatum(true));
+
+			if (HeapTupleIsValid(tuple))
+				inputs[ninputs++] = (AttStatsInput){ .tuple = tuple, .rows = heap_rows };
+		}
+
+		for (int c = 0; c < ncompressed; c++)
+		{
+			AttrNumber chunk_attnum = get_attnum(compressed[c].relid, NameStr(attr->attname));
+			HeapTuple tuple;
+
+			if (chunk_attnum == InvalidAttrNumber)
+				continue;
+
+			tuple = SearchSysCache3(STATRELATTINH,
+									ObjectIdGetDatum(compressed[c].relid),
+									Int16GetDatum(chunk_attnum),
+									BoolGetDatum(false));
+
+			if (HeapTupleIsValid(tuple))
+			{
+				inputs[ninputs++] = (AttStatsInput){ .tuple = tuple, .rows = compressed[c].rows };
+				have_chunk_stats = true;
+			}
+		}
+
+		if (have_chunk_stats)
+		{
+			oldmcxt = MemoryContextSwitchTo(merge_mcxt);
+			attstats_merge_column(ht->main_table_relid, attr->attnum, inputs, ninputs);
+			MemoryContextSwitchTo(oldmcxt);
+			MemoryContextReset(merge_mcxt);
+		}
+
+		for (int j = 0; j < ninputs; j++)
+			ReleaseSysCache(inputs[j].tuple);
+	}
+
+	table_close(htrel, NoLock);
+	MemoryContextDelete(merge_mcxt);
+	pfree(inputs);
+	pfree(compressed);
+
+	/* Make the statistics visible */
+	CommandCounterIncrement();
+}
@@ -0,0 +1,17 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+#include <commands/vacuum.h>
+#include <nodes/pg_list.h>
+
+#include "export.h"
+#include "hypertable.h"
+
+extern TSDLLEXPORT void ts_attstats_store(Oid relid, AttrNumber attnum, bool inherited,
+										  const VacAttrStats *stats);
+extern void ts_attstats_merge_compressed_chunks(const Hypertable *ht, List *va_cols);
@@ -42,6 +42,7 @@
 #include "extension.h"
 #include "job.h"
 #include "job_stat.h"
+#include "job_stat_history.h"
 #include "license_guc.h"
 #include "scan_iterator.h"
 #include "scanner.h"
@@ -1177,6 +1178,8 @@ ts_bgw_job_entrypoint(PG_FUNCTION_ARGS)
 	if (scheduler_test_hook == NULL)
 		ts_begin_tss_store_callback();
 
+	ts_bgw_job_profile_begin();
+
 	PG_TRY();
 	{
 		/*
@@ -1275,6 +1278,7 @@ ts_bgw_job_entrypoint(PG_FUNCTION_ARGS)
 	}
 
 	CommitTransactionCommand();
+	ts_bgw_job_profile_finish();
 
 	INSTR_TIME_SET_CURRENT(duration);
 	INSTR_TIME_SUBTRACT(duration, start);
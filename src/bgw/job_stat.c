@@ -10,12 +10,14 @@
 #include <stdlib.h>
 #include <utils/builtins.h>
 #include <utils/fmgrprotos.h>
+#include <utils/hsearch.h>
 #include <utils/resowner.h>
 
 #include "guc.h"
 #include "job_stat.h"
 #include "job_stat_history.h"
 #include "jsonb_utils.h"
+#include "scan_iterator.h"
 #include "scanner.h"
 #include "time_bucket.h"
 #include "timer.h"
@@ -100,6 +102,42 @@ ts_bgw_job_stat_find(int32 bgw_job_id)
 	return job_stat;
 }
 
+/*
+ * Load the statistics of all jobs into a hash table keyed on job id.
+ *
+ * This is used by the scheduler when it rebuilds its job list so that the
+ * statistics for all jobs are read with a single scan of the table instead
+ * of one index scan per job.
+ */
+HTAB *
+ts_bgw_job_stat_find_all(MemoryContext mctx)
+{
+	HASHCTL hctl = {
+		.keysize = sizeof(int32),
+		.entrysize = sizeof(BgwJobStat),
+		.hcxt = mctx,
+	};
+	HTAB *job_stats =
+		hash_create("bgw job stats", 128, &hctl, HASH_ELEM | HASH_CONTEXT | HASH_BLOBS);
+	ScanIterator iterator = ts_scan_iterator_create(BGW_JOB_STAT, AccessShareLock, mctx);
+
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		bool should_free;
+		HeapTuple tuple = ts_scanner_fetch_heap_tuple(ti, false, &should_free);
+		FormData_bgw_job_stat *fd = (FormData_bgw_job_stat *) GETSTRUCT(tuple);
+		BgwJobStat *job_stat = hash_search(job_stats, &fd->id, HASH_ENTER, NULL);
+
+		memcpy(&job_stat->fd, fd, sizeof(FormData_bgw_job_stat));
+
+		if (should_free)
+			heap_freetuple(tuple);
+	}
+
+	return job_stats;
+}
+
 static ScanTupleResult
 bgw_job_stat_tuple_delete(TupleInfo *ti, void *const data)
 {
@@ -296,23 +334,67 @@ calculate_next_start_on_success_drifting(TimestampTz last_finish, BgwJob *job)
 }
 
 static TimestampTz
-calculate_next_start_on_success(TimestampTz finish_time, BgwJob *job)
+calculate_next_start_on_success_regular(TimestampTz last_finish, BgwJob *job)
+{
+	/* calculate next_start differently depending on drift/no drift */
+	if (job->fd.fixed_schedule)
+		return calculate_next_start_on_success_fixed(last_finish, job);
+	else
+		return calculate_next_start_on_success_drifting(last_finish, job);
+}
+
+static bool
+job_uses_adaptive_schedule(BgwJob *job)
+{
+	bool found;
+
+	if (job->fd.config == NULL)
+		return false;
+
+	return ts_jsonb_get_bool_field(job->fd.config, "adaptive_schedule", &found);
+}
+
+/*
+ * Adaptive scheduling adjusts the next start to the backlog reported by the
+ * job and the duration of the run that just finished.
+ *
+ * If the job reported remaining backlog, it starts again after a pause as
+ * long as the run itself, which keeps the lag bounded while leaving the
+ * worker free for other jobs half of the time. Otherwise the regular schedule
+ * is used, but a job that takes longer than its schedule interval is delayed
+ * so that it does not run back to back.
+ */
+static TimestampTz
+calculate_next_start_on_success_adaptive(TimestampTz last_finish, int64 run_usecs, BgwJob *job)
+{
+	TimestampTz regular = calculate_next_start_on_success_regular(last_finish, job);
+	TimestampTz earliest = last_finish + Max(run_usecs, 0);
+
+	if (ts_bgw_job_profile_get_count("backlog") > 0)
+		return Min(regular, earliest);
+
+	if (regular < earliest)
+		return calculate_next_start_on_success_regular(earliest, job);
+
+	return regular;
+}
+
+static TimestampTz
+calculate_next_start_on_success(TimestampTz finish_time, TimestampTz start_time, BgwJob *job)
 {
 	/* next_start is the previously calculated next_start for this job */
-	TimestampTz ts;
 	TimestampTz last_finish = finish_time;
 	if (!IS_VALID_TIMESTAMP(finish_time))
 	{
 		last_finish = ts_timer_get_current_timestamp();
 	}
 
-	/* calculate next_start differently depending on drift/no drift */
-	if (job->fd.fixed_schedule)
-		ts = calculate_next_start_on_success_fixed(last_finish, job);
-	else
-		ts = calculate_next_start_on_success_drifting(last_finish, job);
+	if (job_uses_adaptive_schedule(job) && IS_VALID_TIMESTAMP(start_time))
+		return calculate_next_start_on_success_adaptive(last_finish,
+														last_finish - start_time,
+														job);
 
-	return ts;
+	return calculate_next_start_on_success_regular(last_finish, job);
 }
 
 static float8
@@ -503,7 +585,9 @@ bgw_job_stat_tuple_mark_end(TupleInfo *ti, void *const data)
 												   IntervalPGetDatum(duration)));
 		/* Mark the next start at the end if the job itself hasn't */
 		if (!bgw_job_stat_next_start_was_set(fd))
-			fd->next_start = calculate_next_start_on_success(fd->last_finish, result_ctx->job);
+			fd->next_start = calculate_next_start_on_success(fd->last_finish,
+																fd->last_start,
+																result_ctx->job);
 	}
 	else
 	{
@@ -5,6 +5,9 @@
  */
 #pragma once
 
+#include <postgres.h>
+#include <utils/hsearch.h>
+
 #include "job.h"
 #include "ts_catalog/catalog.h"
 
@@ -17,6 +20,7 @@ typedef struct BgwJobStat
 } BgwJobStat;
 
 extern TSDLLEXPORT BgwJobStat *ts_bgw_job_stat_find(int job_id);
+extern HTAB *ts_bgw_job_stat_find_all(MemoryContext mctx);
 extern void ts_bgw_job_stat_delete(int job_id);
 extern TSDLLEXPORT void ts_bgw_job_stat_mark_start(BgwJob *job);
 extern void ts_bgw_job_stat_mark_end(BgwJob *job, JobResult result, Jsonb *edata);
@@ -6,7 +6,10 @@
 #include <postgres.h>
 
 #include <access/xact.h>
+#include <nodes/pg_list.h>
+#include <portability/instr_time.h>
 #include <utils/jsonb.h>
+#include <utils/memutils.h>
 
 #include "compat/compat.h"
 #include "guc.h"
@@ -23,6 +26,207 @@ typedef struct BgwJobStatHistoryContext
 	Jsonb *edata;
 } BgwJobStatHistoryContext;
 
+/*
+ * Profile of the job execution in this background worker.
+ *
+ * Policies record the time spent in each phase of their execution and
+ * counters for the work done. The profile is added to the job history when
+ * the end of the job is marked.
+ */
+typedef struct BgwJobProfileEntry
+{
+	NameData name;
+	bool is_phase;
+	/* Counter value, or total time of the phase in microseconds */
+	int64 value;
+	/* Start of the currently running phase */
+	instr_time phase_start;
+} BgwJobProfileEntry;
+
+static List *job_profile = NIL;
+static bool job_profile_enabled = false;
+
+static void
+bgw_job_profile_reset(void)
+{
+	list_free_deep(job_profile);
+	job_profile = NIL;
+}
+
+/*
+ * Start collecting the profile of the job executed by this process.
+ */
+void
+ts_bgw_job_profile_begin(void)
+{
+	bgw_job_profile_reset();
+	job_profile_enabled = true;
+}
+
+/*
+ * Stop collecting the profile and throw away the collected data.
+ */
+void
+ts_bgw_job_profile_finish(void)
+{
+	bgw_job_profile_reset();
+	job_profile_enabled = false;
+}
+
+static BgwJobProfileEntry *
+bgw_job_profile_get_entry(const char *name, bool is_phase)
+{
+	BgwJobProfileEntry *entry;
+	ListCell *lc;
+	MemoryContext oldcontext;
+
+	foreach (lc, job_profile)
+	{
+		entry = lfirst(lc);
+
+		if (entry->is_phase == is_phase && strcmp(NameStr(entry->name), name) == 0)
+			return entry;
+	}
+
+	/* The profile has to survive the transactions of the job */
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	entry = palloc0(sizeof(BgwJobProfileEntry));
+	namestrcpy(&entry->name, name);
+	entry->is_phase = is_phase;
+	job_profile = lappend(job_profile, entry);
+	MemoryContextSwitchTo(oldcontext);
+
+	return entry;
+}
+
+TSDLLEXPORT void
+ts_bgw_job_profile_phase_start(const char *phase)
+{
+	if (!job_profile_enabled)
+		return;
+
+	BgwJobProfileEntry *entry = bgw_job_profile_get_entry(phase, true);
+	INSTR_TIME_SET_CURRENT(entry->phase_start);
+}
+
+TSDLLEXPORT void
+ts_bgw_job_profile_phase_end(const char *phase)
+{
+	instr_time duration;
+
+	if (!job_profile_enabled)
+		return;
+
+	BgwJobProfileEntry *entry = bgw_job_profile_get_entry(phase, true);
+
+	if (INSTR_TIME_IS_ZERO(entry->phase_start))
+		return;
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, entry->phase_start);
+	entry->value += INSTR_TIME_GET_MICROSEC(duration);
+	INSTR_TIME_SET_ZERO(entry->phase_start);
+}
+
+TSDLLEXPORT void
+ts_bgw_job_profile_count(const char *counter, int64 value)
+{
+	if (!job_profile_enabled)
+		return;
+
+	bgw_job_profile_get_entry(counter, false)->value += value;
+}
+
+/*
+ * Get the value of a counter in the profile, or zero if the job did not
+ * count it.
+ */
+int64
+ts_bgw_job_profile_get_count(const char *counter)
+{
+	ListCell *lc;
+
+	foreach (lc, job_profile)
+	{
+		BgwJobProfileEntry *entry = lfirst(lc);
+
+		if (!entry->is_phase && strcmp(NameStr(entry->name), counter) == 0)
+			return entry->value;
+	}
+
+	return 0;
+}
+
+/*
+ * Report the amount of work that the running job left for later runs.
+ *
+ * The backlog is recorded in the profile and is used to compute the next
+ * start of jobs with adaptive scheduling. Outside of a background worker
+ * this does nothing.
+ */
+TS_FUNCTION_INFO_V1(ts_bgw_job_report_backlog);
+
+Datum
+ts_bgw_job_report_backlog(PG_FUNCTION_ARGS)
+{
+	int64 backlog = PG_GETARG_INT64(0);
+
+	if (backlog < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("backlog cannot be negative")));
+
+	ts_bgw_job_profile_count("backlog", backlog);
+
+	PG_RETURN_VOID();
+}
+
+static Jsonb *
+build_job_profile_entries(bool is_phase)
+{
+	JsonbParseState *parse_state = NULL;
+	ListCell *lc;
+
+	pushJsonbValue(&parse_state, WJB_BEGIN_OBJECT, NULL);
+
+	foreach (lc, job_profile)
+	{
+		BgwJobProfileEntry *entry = lfirst(lc);
+		JsonbValue value;
+
+		if (entry->is_phase != is_phase)
+			continue;
+
+		if (is_phase)
+			/* Phase timings are reported in milliseconds */
+			ts_jsonb_set_value_by_type(&value,
+									   FLOAT8OID,
+									   Float8GetDatum(entry->value / 1000.0));
+		else
+			ts_jsonb_set_value_by_type(&value, INT8OID, Int64GetDatum(entry->value));
+
+		ts_jsonb_add_value(parse_state, NameStr(entry->name), &value);
+	}
+
+	return JsonbValueToJsonb(pushJsonbValue(&parse_state, WJB_END_OBJECT, NULL));
+}
+
+static Jsonb *
+build_job_profile(void)
+{
+	JsonbParseState *parse_state = NULL;
+	JsonbValue value = { 0 };
+
+	pushJsonbValue(&parse_state, WJB_BEGIN_OBJECT, NULL);
+
+	JsonbToJsonbValue(build_job_profile_entries(true), &value);
+	ts_jsonb_add_value(parse_state, "phases", &value);
+	JsonbToJsonbValue(build_job_profile_entries(false), &value);
+	ts_jsonb_add_value(parse_state, "counters", &value);
+
+	return JsonbValueToJsonb(pushJsonbValue(&parse_state, WJB_END_OBJECT, NULL));
+}
+
 static Jsonb *
 build_job_info(BgwJob *job)
 {
@@ -79,6 +283,13 @@ ts_bgw_job_stat_history_build_data_info(BgwJobStatHistoryContext *context)
 	JsonbToJsonbValue(build_job_info(context->job), &value);
 	ts_jsonb_add_value(parse_state, "job", &value);
 
+	if (job_profile != NIL)
+	{
+		/* execution profile jsonb */
+		JsonbToJsonbValue(build_job_profile(), &value);
+		ts_jsonb_add_value(parse_state, "profile", &value);
+	}
+
 	if (context->edata != NULL)
 	{
 		/* error information jsonb */
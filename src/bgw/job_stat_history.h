@@ -13,3 +13,10 @@
 
 extern void ts_bgw_job_stat_history_mark_start(BgwJob *job);
 extern void ts_bgw_job_stat_history_mark_end(BgwJob *job, JobResult result, Jsonb *edata);
+
+extern void ts_bgw_job_profile_begin(void);
+extern void ts_bgw_job_profile_finish(void);
+extern TSDLLEXPORT void ts_bgw_job_profile_phase_start(const char *phase);
+extern TSDLLEXPORT void ts_bgw_job_profile_phase_end(const char *phase);
+extern TSDLLEXPORT void ts_bgw_job_profile_count(const char *counter, int64 value);
+extern TSDLLEXPORT int64 ts_bgw_job_profile_get_count(const char *counter);
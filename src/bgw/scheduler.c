@@ -13,6 +13,7 @@
 #include <postgres.h>
 
 #include <access/xact.h>
+#include <lib/binaryheap.h>
 #include <miscadmin.h>
 #include <nodes/pg_list.h>
 #include <pgstat.h>
@@ -24,6 +25,7 @@
 #include <storage/shmem.h>
 #include <tcop/tcopprot.h>
 #include <utils/acl.h>
+#include <utils/hsearch.h>
 #include <utils/inval.h>
 #include <utils/jsonb.h>
 #include <utils/memutils.h>
@@ -64,6 +66,12 @@ static List *scheduled_jobs = NIL;
 static MemoryContext scheduler_mctx;
 static MemoryContext scratch_mctx;
 
+/*
+ * Statistics of all jobs, loaded with a single scan while the jobs list is
+ * updated. Only valid for the duration of ts_update_scheduled_jobs_list().
+ */
+static HTAB *job_stats_snapshot = NULL;
+
 /* See the README for a state transition diagram */
 typedef enum JobState
 {
@@ -109,6 +117,33 @@ typedef struct ScheduledBgwJob
 	int32 consecutive_failed_launches;
 } ScheduledBgwJob;
 
+/*
+ * Entry in the heap of scheduled jobs. The next start is copied into the
+ * entry since the heap must not change order while the job is in it.
+ */
+typedef struct ScheduledBgwJobEntry
+{
+	ScheduledBgwJob *sjob;
+	TimestampTz next_start;
+} ScheduledBgwJobEntry;
+
+/*
+ * Scheduled jobs ordered by next start, and the jobs that are started or
+ * terminating. Both are kept across wakeups, so a wakeup only looks at the
+ * jobs that are due and at the running jobs instead of at all jobs.
+ *
+ * A job gets a heap entry when it transitions to the scheduled state. The
+ * entry is not removed when the job leaves the scheduled state in another
+ * way, so an entry is only valid if the job is still scheduled to start at
+ * the time of the entry. Both are rebuilt from the jobs list when the list
+ * is updated, since the list is replaced then, and the heap is also rebuilt
+ * when it fills up with stale entries.
+ */
+static binaryheap *jobs_by_next_start = NULL;
+static List *started_jobs = NIL;
+static bool job_indexes_valid = false;
+static MemoryContext job_indexes_mctx;
+
 static void on_failure_to_start_job(ScheduledBgwJob *sjob);
 
 static volatile sig_atomic_t got_SIGHUP = false;
@@ -272,6 +307,147 @@ worker_state_cleanup(ScheduledBgwJob *sjob)
 	}
 }
 
+/*
+ * Find the statistics for a job.
+ *
+ * While the jobs list is updated, the statistics are taken from the snapshot
+ * of all job statistics, unless they might have been changed since the
+ * snapshot was taken.
+ */
+static BgwJobStat *
+scheduled_bgw_job_stat_find(ScheduledBgwJob *sjob, bool stat_changed)
+{
+	if (job_stats_snapshot != NULL && !stat_changed)
+		return hash_search(job_stats_snapshot, &sjob->job.fd.id, HASH_FIND, NULL);
+
+	return ts_bgw_job_stat_find(sjob->job.fd.id);
+}
+
+/*
+ * Compare the next start of two jobs in the binary heap.
+ *
+ * The binary heap keeps the largest element on top, so the order is inverted
+ * to have the job with the earliest next start on top. Jobs with the same
+ * next start are started in job id order.
+ */
+static int
+cmp_next_start(Datum left, Datum right, void *arg)
+{
+	ScheduledBgwJobEntry *left_entry = (ScheduledBgwJobEntry *) DatumGetPointer(left);
+	ScheduledBgwJobEntry *right_entry = (ScheduledBgwJobEntry *) DatumGetPointer(right);
+
+	if (left_entry->next_start != right_entry->next_start)
+		return (left_entry->next_start < right_entry->next_start) ? 1 : -1;
+
+	if (left_entry->sjob->job.fd.id != right_entry->sjob->job.fd.id)
+		return (left_entry->sjob->job.fd.id < right_entry->sjob->job.fd.id) ? 1 : -1;
+
+	return 0;
+}
+
+static void
+invalidate_job_indexes(void)
+{
+	jobs_by_next_start = NULL;
+	started_jobs = NIL;
+	job_indexes_valid = false;
+
+	if (job_indexes_mctx != NULL)
+		MemoryContextReset(job_indexes_mctx);
+}
+
+static ScheduledBgwJobEntry *
+make_job_entry(ScheduledBgwJob *sjob)
+{
+	ScheduledBgwJobEntry *entry = MemoryContextAlloc(job_indexes_mctx, sizeof(*entry));
+
+	entry->sjob = sjob;
+	entry->next_start = sjob->next_start;
+	return entry;
+}
+
+static void
+build_job_indexes(void)
+{
+	MemoryContext oldcontext;
+	ListCell *lc;
+
+	if (job_indexes_valid)
+		return;
+
+	invalidate_job_indexes();
+	oldcontext = MemoryContextSwitchTo(job_indexes_mctx);
+
+	/* leave room for the entries added until the jobs list is updated */
+	jobs_by_next_start =
+		binaryheap_allocate(Max(2 * list_length(scheduled_jobs), 64), cmp_next_start, NULL);
+
+	foreach (lc, scheduled_jobs)
+	{
+		ScheduledBgwJob *sjob = lfirst(lc);
+
+		if (sjob->state == JOB_STATE_SCHEDULED)
+			binaryheap_add_unordered(jobs_by_next_start, PointerGetDatum(make_job_entry(sjob)));
+		else if (sjob->state == JOB_STATE_STARTED || sjob->state == JOB_STATE_TERMINATING)
+			started_jobs = lappend(started_jobs, sjob);
+	}
+
+	binaryheap_build(jobs_by_next_start);
+	MemoryContextSwitchTo(oldcontext);
+	job_indexes_valid = true;
+}
+
+/* Keep the heap and the started jobs in sync with a state transition */
+static void
+update_job_indexes(ScheduledBgwJob *sjob, JobState prev_state, JobState new_state)
+{
+	if (!job_indexes_valid)
+		return;
+
+	if (new_state == JOB_STATE_STARTED && prev_state != JOB_STATE_STARTED)
+	{
+		MemoryContext oldcontext = MemoryContextSwitchTo(job_indexes_mctx);
+
+		started_jobs = lappend(started_jobs, sjob);
+		MemoryContextSwitchTo(oldcontext);
+	}
+	else if ((prev_state == JOB_STATE_STARTED || prev_state == JOB_STATE_TERMINATING) &&
+			 (new_state == JOB_STATE_SCHEDULED || new_state == JOB_STATE_DISABLED))
+		started_jobs = list_delete_ptr(started_jobs, sjob);
+
+	if (new_state == JOB_STATE_SCHEDULED)
+	{
+		/* the stale entries are dropped when the heap is rebuilt */
+		if (jobs_by_next_start->bh_size >= jobs_by_next_start->bh_space)
+			job_indexes_valid = false;
+		else
+			binaryheap_add(jobs_by_next_start, PointerGetDatum(make_job_entry(sjob)));
+	}
+}
+
+/*
+ * Return the heap entry of the job that should be started next, removing
+ * stale entries from the top of the heap.
+ */
+static ScheduledBgwJobEntry *
+first_scheduled_job(void)
+{
+	while (!binaryheap_empty(jobs_by_next_start))
+	{
+		ScheduledBgwJobEntry *entry =
+			(ScheduledBgwJobEntry *) DatumGetPointer(binaryheap_first(jobs_by_next_start));
+
+		if (entry->sjob->state == JOB_STATE_SCHEDULED &&
+			entry->sjob->next_start == entry->next_start)
+			return entry;
+
+		binaryheap_remove_first(jobs_by_next_start);
+		pfree(entry);
+	}
+
+	return NULL;
+}
+
 /* Set the state of the job.
  * This function is responsible for setting all of the variables in ScheduledBgwJob
  * except for the job itself.
@@ -279,11 +455,9 @@ worker_state_cleanup(ScheduledBgwJob *sjob)
 static void
 scheduled_bgw_job_transition_state_to(ScheduledBgwJob *sjob, JobState new_state)
 {
-#ifdef USE_ASSERT_CHECKING
 	JobState prev_state = sjob->state;
-#endif
-
 	BgwJobStat *job_stat;
+	bool stat_changed;
 
 	switch (new_state)
 	{
@@ -294,9 +468,11 @@ scheduled_bgw_job_transition_state_to(ScheduledBgwJob *sjob, JobState new_state)
 		case JOB_STATE_SCHEDULED:
 			/* prev_state can be any value, including itself */
 
+			/* the cleanup might mark the end of the job and update its stats */
+			stat_changed = sjob->may_need_mark_end;
 			worker_state_cleanup(sjob);
 
-			job_stat = ts_bgw_job_stat_find(sjob->job.fd.id);
+			job_stat = scheduled_bgw_job_stat_find(sjob, stat_changed);
 
 			Assert(!sjob->reserved_worker);
 			sjob->next_start =
@@ -374,6 +550,7 @@ scheduled_bgw_job_transition_state_to(ScheduledBgwJob *sjob, JobState new_state)
 			break;
 	}
 	sjob->state = new_state;
+	update_job_indexes(sjob, prev_state, new_state);
 }
 
 static void
@@ -479,16 +656,17 @@ terminate_and_cleanup_job(ScheduledBgwJob *sjob)
  *  copy over any existing scheduler info from the given jobs list.
  *  Assume that both lists are ordered by job ID.
  *  Note that this function call will destroy cur_jobs_list and return a new list.
+ *
+ *  The job statistics needed to compute the next start of the jobs are
+ *  loaded up front with a single scan, since doing an index scan per job
+ *  gets expensive when there are thousands of jobs.
  */
-List *
-ts_update_scheduled_jobs_list(List *cur_jobs_list, MemoryContext mctx)
+static void
+update_scheduled_jobs_list(List *cur_jobs_list, List *new_jobs)
 {
-	List *new_jobs = ts_bgw_job_get_scheduled(sizeof(ScheduledBgwJob), mctx);
 	ListCell *new_ptr = list_head(new_jobs);
 	ListCell *cur_ptr = list_head(cur_jobs_list);
 
-	elog(DEBUG2, "updating scheduled jobs list");
-
 	while (cur_ptr != NULL && new_ptr != NULL)
 	{
 		ScheduledBgwJob *new_sjob = lfirst(new_ptr);
@@ -554,6 +732,32 @@ ts_update_scheduled_jobs_list(List *cur_jobs_list, MemoryContext mctx)
 
 	/* Free the old list */
 	list_free_deep(cur_jobs_list);
+}
+
+List *
+ts_update_scheduled_jobs_list(List *cur_jobs_list, MemoryContext mctx)
+{
+	List *new_jobs = ts_bgw_job_get_scheduled(sizeof(ScheduledBgwJob), mctx);
+
+	elog(DEBUG2, "updating scheduled jobs list");
+
+	/* the jobs list is replaced, so the heap and started jobs are rebuilt */
+	invalidate_job_indexes();
+
+	Assert(job_stats_snapshot == NULL);
+	job_stats_snapshot = ts_bgw_job_stat_find_all(CurrentMemoryContext);
+
+	PG_TRY();
+	{
+		update_scheduled_jobs_list(cur_jobs_list, new_jobs);
+	}
+	PG_FINALLY();
+	{
+		hash_destroy(job_stats_snapshot);
+		job_stats_snapshot = NULL;
+	}
+	PG_END_TRY();
+
 	return new_jobs;
 }
 
@@ -580,15 +784,15 @@ ts_populate_scheduled_job_tuple(ScheduledBgwJob *sjob, Datum *values)
 #endif
 
 static int
-cmp_next_start(const ListCell *left_cell, const ListCell *right_cell)
+cmp_job_id(const ListCell *left_cell, const ListCell *right_cell)
 {
 	ScheduledBgwJob *left_sjob = lfirst(left_cell);
 	ScheduledBgwJob *right_sjob = lfirst(right_cell);
 
-	if (left_sjob->next_start < right_sjob->next_start)
+	if (left_sjob->job.fd.id < right_sjob->job.fd.id)
 		return -1;
 
-	if (left_sjob->next_start > right_sjob->next_start)
+	if (left_sjob->job.fd.id > right_sjob->job.fd.id)
 		return 1;
 
 	return 0;
@@ -597,37 +801,47 @@ cmp_next_start(const ListCell *left_cell, const ListCell *right_cell)
 static void
 start_scheduled_jobs(register_background_worker_callback_type bgw_register)
 {
-	List *ordered_scheduled_jobs;
+	List *due_jobs = NIL;
+	ScheduledBgwJobEntry *entry;
 	ListCell *lc;
 	Assert(CurrentMemoryContext == scratch_mctx);
 
-	/* Order jobs by increasing next_start */
-	/* list_sort does in-place sort - so make a copy and sort that */
-	ordered_scheduled_jobs = list_copy(scheduled_jobs);
-	list_sort(ordered_scheduled_jobs, cmp_next_start);
+	build_job_indexes();
 
-	foreach (lc, ordered_scheduled_jobs)
+	/*
+	 * Pop the jobs that are due, in order of increasing next_start, before
+	 * starting them. Jobs that fail to start are scheduled again, which must
+	 * not make them due again in this wakeup.
+	 */
+	while ((entry = first_scheduled_job()) != NULL)
 	{
-		ScheduledBgwJob *sjob = lfirst(lc);
-
+		ScheduledBgwJob *sjob = entry->sjob;
 		int64 job_start_diff = sjob->next_start - ts_timer_get_current_timestamp();
 
-		if (sjob->state == JOB_STATE_SCHEDULED &&
-			(job_start_diff <= 0 || sjob->next_start == DT_NOBEGIN))
-		{
-			elog(DEBUG2, "starting scheduled job %d", sjob->job.fd.id);
-			scheduled_ts_bgw_job_start(sjob, bgw_register);
-		}
-		else
+		if (job_start_diff > 0 && sjob->next_start != DT_NOBEGIN)
 		{
+			/* All remaining jobs are scheduled to start later */
 			elog(DEBUG5,
 				 "starting scheduled job %d in " INT64_FORMAT " seconds",
 				 sjob->job.fd.id,
 				 job_start_diff / ONE_SECOND_IN_MICROSECONDS);
+			break;
 		}
+
+		binaryheap_remove_first(jobs_by_next_start);
+		pfree(entry);
+		due_jobs = lappend(due_jobs, sjob);
+	}
+
+	foreach (lc, due_jobs)
+	{
+		ScheduledBgwJob *sjob = lfirst(lc);
+
+		elog(DEBUG2, "starting scheduled job %d", sjob->job.fd.id);
+		scheduled_ts_bgw_job_start(sjob, bgw_register);
 	}
 
-	list_free(ordered_scheduled_jobs);
+	list_free(due_jobs);
 }
 
 /* Returns the earliest time the scheduler should start a job that is waiting to be started */
@@ -637,6 +851,17 @@ earliest_wakeup_to_start_next_job()
 	ListCell *lc;
 	TimestampTz earliest = DT_NOEND;
 	TimestampTz now = ts_timer_get_current_timestamp();
+	ScheduledBgwJobEntry *entry;
+
+	build_job_indexes();
+	entry = first_scheduled_job();
+
+	if (entry == NULL)
+		return DT_NOEND;
+
+	/* all jobs are scheduled in the future, so the first one is the earliest */
+	if (entry->next_start >= now)
+		return entry->next_start;
 
 	foreach (lc, scheduled_jobs)
 	{
@@ -662,7 +887,9 @@ earliest_job_timeout()
 	ListCell *lc;
 	TimestampTz earliest = DT_NOEND;
 
-	foreach (lc, scheduled_jobs)
+	build_job_indexes();
+
+	foreach (lc, started_jobs)
 	{
 		ScheduledBgwJob *sjob = lfirst(lc);
 
@@ -720,9 +947,16 @@ wait_for_all_jobs_to_shutdown()
 static void
 check_for_stopped_and_timed_out_jobs()
 {
+	List *jobs;
 	ListCell *lc;
 
-	foreach (lc, scheduled_jobs)
+	build_job_indexes();
+
+	/* the state transitions below remove jobs from the started jobs */
+	jobs = list_copy(started_jobs);
+	list_sort(jobs, cmp_job_id);
+
+	foreach (lc, jobs)
 	{
 		BgwHandleStatus status;
 		pid_t pid;
@@ -762,6 +996,8 @@ check_for_stopped_and_timed_out_jobs()
 				break;
 		}
 	}
+
+	list_free(jobs);
 }
 
 /* This is the guts of the scheduler which runs the main loop.
@@ -879,6 +1115,7 @@ scheduler_exit:
 	wait_for_all_jobs_to_shutdown();
 	check_for_stopped_and_timed_out_jobs();
 	scheduled_jobs = NIL;
+	invalidate_job_indexes();
 }
 
 static void
@@ -902,6 +1139,8 @@ ts_bgw_scheduler_setup_mctx()
 	scheduler_mctx = AllocSetContextCreate(TopMemoryContext, "Scheduler", ALLOCSET_DEFAULT_SIZES);
 	scratch_mctx =
 		AllocSetContextCreate(scheduler_mctx, "SchedulerScratch", ALLOCSET_DEFAULT_SIZES);
+	job_indexes_mctx =
+		AllocSetContextCreate(scheduler_mctx, "SchedulerJobIndexes", ALLOCSET_DEFAULT_SIZES);
 	MemoryContextSwitchTo(scratch_mctx);
 }
 
@@ -10,6 +10,7 @@
 #include "bgw/job.h"
 #include "chunk_stats.h"
 #include "policy.h"
+#include "scan_iterator.h"
 #include "ts_catalog/catalog.h"
 #include "utils.h"
 
@@ -89,6 +90,47 @@ ts_bgw_policy_chunk_stats_delete_by_chunk_id(int32 chunk_id)
 						NULL);
 }
 
+/*
+ * Delete the chunk_stat rows of many chunks. The table is scanned once and the
+ * deletes are cascaded via the job delete function afterwards, like for a
+ * single chunk.
+ */
+void
+ts_bgw_policy_chunk_stats_delete_by_chunk_ids(const int32 *chunk_ids, int num_chunk_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(BGW_POLICY_CHUNK_STATS, AccessShareLock, CurrentMemoryContext);
+	Bitmapset *chunks = NULL;
+	List *job_ids = NIL;
+	ListCell *lc;
+
+	for (int i = 0; i < num_chunk_ids; i++)
+		chunks = bms_add_member(chunks, chunk_ids[i]);
+
+	ts_scanner_foreach(&iterator)
+	{
+		bool chunk_isnull, job_isnull;
+		Datum chunk_id = slot_getattr(ts_scan_iterator_slot(&iterator),
+									  Anum_bgw_policy_chunk_stats_chunk_id,
+									  &chunk_isnull);
+		Datum job_id = slot_getattr(ts_scan_iterator_slot(&iterator),
+									Anum_bgw_policy_chunk_stats_job_id,
+									&job_isnull);
+
+		Assert(!chunk_isnull && !job_isnull);
+		if (bms_is_member(DatumGetInt32(chunk_id), chunks))
+			job_ids = list_append_unique_int(job_ids, DatumGetInt32(job_id));
+	}
+	ts_scan_iterator_close(&iterator);
+
+	/* This will actually delete the rows for us */
+	foreach (lc, job_ids)
+		ts_bgw_job_delete_by_id(lfirst_int(lc));
+
+	bms_free(chunks);
+	list_free(job_ids);
+}
+
 static void
 ts_bgw_policy_chunk_stats_insert_with_relation(Relation rel, BgwPolicyChunkStats *chunk_stats)
 {
@@ -17,5 +17,7 @@ extern TSDLLEXPORT void ts_bgw_policy_chunk_stats_insert(BgwPolicyChunkStats *ch
 extern BgwPolicyChunkStats *ts_bgw_policy_chunk_stats_find(int32 job_id, int32 chunk_id);
 extern void ts_bgw_policy_chunk_stats_delete_row_only_by_job_id(int32 job_id);
 extern void ts_bgw_policy_chunk_stats_delete_by_chunk_id(int32 chunk_id);
+extern void ts_bgw_policy_chunk_stats_delete_by_chunk_ids(const int32 *chunk_ids,
+														  int num_chunk_ids);
 extern TSDLLEXPORT void ts_bgw_policy_chunk_stats_record_job_run(int32 job_id, int32 chunk_id,
 																 TimestampTz last_time_job_run);
@@ -6,6 +6,7 @@
 #include <postgres.h>
 #include <access/xact.h>
 #include <catalog/namespace.h>
+#include <commands/trigger.h>
 #include <miscadmin.h>
 #include <nodes/nodes.h>
 #include <utils/inval.h>
@@ -14,7 +15,10 @@
 
 #include "compat/compat.h"
 #include "annotations.h"
+#include "chunk.h"
+#include "dimension.h"
 #include "extension.h"
+#include "hypertable.h"
 #include "hypertable_cache.h"
 #include "ts_catalog/catalog.h"
 
@@ -48,6 +52,18 @@
  * (e.g., when replacing a negative hypertable entry with a positive one). Note,
  * also, that INSERTS can taint the cache if the transaction that did the INSERT
  * fails. This is why we also need to invalidate caches on transaction failure.
+ *
+ * Changes of the chunks of a hypertable, which are frequent, only invalidate the
+ * cache entry of that hypertable. For this, we signal a relcache invalidation
+ * of the hypertable itself instead of the proxy table, so that the other
+ * backends keep the cache entries of the other hypertables.
+ *
+ * A relcache invalidation of the hypertable also invalidates the cached plans
+ * on the hypertable. This is intended: a plan only references the chunks that
+ * were not excluded when it was planned, so after the range or status of a
+ * chunk changes, only invalidating the hypertable makes plans that excluded
+ * the chunk see the change. PostgreSQL does not offer a relation-scoped
+ * invalidation message that extensions can receive without this.
  */
 
 void _cache_invalidate_init(void);
@@ -63,11 +79,85 @@ cache_invalidate_relcache_all(void)
 static Oid hypertable_proxy_table_oid = InvalidOid;
 static Oid bgw_proxy_table_oid = InvalidOid;
 
+/*
+ * The hypertables of the last changed chunk and dimension, so that changing
+ * many catalog rows of the same chunk or hypertable doesn't need lookups for
+ * each row. The ids are not reused as long as the extension exists, so these
+ * are reset together with the catalog.
+ */
+static struct
+{
+	int32 chunk_id;
+	int32 chunk_hypertable_id;
+	int32 dimension_id;
+	int32 dimension_hypertable_id;
+	int32 hypertable_id;
+	Oid hypertable_relid;
+} last_owner;
+
 void
 ts_cache_invalidate_set_proxy_tables(Oid hypertable_proxy_oid, Oid bgw_proxy_oid)
 {
 	hypertable_proxy_table_oid = hypertable_proxy_oid;
 	bgw_proxy_table_oid = bgw_proxy_oid;
+	MemSet(&last_owner, 0, sizeof(last_owner));
+}
+
+/*
+ * Invalidate the hypertable cache entry of the hypertable that owns a chunk
+ * (CHUNK), the chunk of a chunk constraint (CHUNK_CONSTRAINT) or the dimension
+ * of a dimension slice (DIMENSION_SLICE), given the id from the changed
+ * catalog row.
+ *
+ * Returns false if the hypertable is not found, e.g. because the chunk was
+ * already deleted, and the caller has to invalidate the entire cache.
+ */
+bool
+ts_cache_invalidate_hypertable_of(CatalogTable table, int32 id)
+{
+	int32 hypertable_id;
+
+	switch (table)
+	{
+		case CHUNK:
+			hypertable_id = id;
+			break;
+		case CHUNK_CONSTRAINT:
+			if (last_owner.chunk_id != id)
+			{
+				last_owner.chunk_hypertable_id = ts_chunk_get_hypertable_id_by_id(id);
+				last_owner.chunk_id = last_owner.chunk_hypertable_id > 0 ? id : 0;
+			}
+			hypertable_id = last_owner.chunk_hypertable_id;
+			break;
+		case DIMENSION_SLICE:
+			if (last_owner.dimension_id != id)
+			{
+				last_owner.dimension_hypertable_id = ts_dimension_get_hypertable_id(id);
+				last_owner.dimension_id = last_owner.dimension_hypertable_id > 0 ? id : 0;
+			}
+			hypertable_id = last_owner.dimension_hypertable_id;
+			break;
+		default:
+			return false;
+	}
+
+	if (hypertable_id <= 0)
+		return false;
+
+	if (last_owner.hypertable_id != hypertable_id)
+	{
+		last_owner.hypertable_relid = ts_hypertable_id_to_relid(hypertable_id, true);
+		last_owner.hypertable_id = OidIsValid(last_owner.hypertable_relid) ? hypertable_id : 0;
+	}
+
+	/* The hypertable might have been dropped in this transaction */
+	if (!OidIsValid(last_owner.hypertable_relid) ||
+		!SearchSysCacheExists1(RELOID, ObjectIdGetDatum(last_owner.hypertable_relid)))
+		return false;
+
+	CacheInvalidateRelcacheByRelid(last_owner.hypertable_relid);
+	return true;
 }
 
 /*
@@ -99,6 +189,10 @@ cache_invalidate_relcache_callback(Datum arg, Oid relid)
 	{
 		ts_bgw_job_cache_invalidate_callback();
 	}
+	else
+	{
+		ts_hypertable_cache_invalidate_entry(relid);
+	}
 }
 
 TS_FUNCTION_INFO_V1(ts_timescaledb_invalidate_cache);
@@ -119,6 +213,27 @@ ts_timescaledb_invalidate_cache(PG_FUNCTION_ARGS)
 	PG_RETURN_VOID();
 }
 
+TS_FUNCTION_INFO_V1(ts_catalog_invalidate_cache_trigger);
+
+/*
+ * Statement trigger on the chunk catalog tables that invalidates the caches
+ * when the tables are modified with SQL instead of the catalog API, so that
+ * the chunk map of the hypertable cache doesn't miss the changes.
+ */
+Datum
+ts_catalog_invalidate_cache_trigger(PG_FUNCTION_ARGS)
+{
+	TriggerData *trigdata = (TriggerData *) fcinfo->context;
+
+	if (!CALLED_AS_TRIGGER(fcinfo))
+		elog(ERROR, "catalog_invalidate_cache_trigger: not called by trigger manager");
+
+	if (ts_extension_is_loaded())
+		ts_catalog_invalidate_cache(RelationGetRelid(trigdata->tg_relation), CMD_UPDATE);
+
+	return PointerGetDatum(NULL);
+}
+
 static void
 cache_invalidate_xact_end(XactEvent event, void *arg)
 {
@@ -7,4 +7,7 @@
 
 #include <postgres.h>
 
+#include "ts_catalog/catalog.h"
+
 extern void ts_cache_invalidate_set_proxy_tables(Oid hypertable_proxy_oid, Oid bgw_proxy_oid);
+extern bool ts_cache_invalidate_hypertable_of(CatalogTable table, int32 id);
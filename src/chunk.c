@@ -10,6 +10,7 @@
 #include <access/reloptions.h>
 #include <access/tupdesc.h>
 #include <access/xact.h>
+#include <catalog/dependency.h>
 #include <catalog/indexing.h>
 #include <catalog/namespace.h>
 #include <catalog/pg_class.h>
@@ -36,6 +37,7 @@
 #include <utils/hsearch.h>
 #include <utils/lsyscache.h>
 #include <utils/palloc.h>
+#include <utils/resowner.h>
 #include <utils/syscache.h>
 #include <utils/timestamp.h>
 
@@ -44,6 +46,7 @@
 #include "compat/compat.h"
 #include "bgw_policy/chunk_stats.h"
 #include "cache.h"
+#include "cache_invalidate.h"
 #include "chunk_index.h"
 #include "chunk_scan.h"
 #include "cross_module_fn.h"
@@ -2724,6 +2727,22 @@ ts_chunk_get_hypertable_id_by_reloid(Oid reloid)
 	return 0;
 }
 
+/*
+ * Returns 0 if there is no chunk with such id.
+ */
+int32
+ts_chunk_get_hypertable_id_by_id(int32 chunk_id)
+{
+	FormData_chunk form;
+
+	if (chunk_simple_scan_by_id(chunk_id, &form, /* missing_ok = */ true))
+	{
+		return form.hypertable_id;
+	}
+
+	return 0;
+}
+
 FormData_chunk
 ts_chunk_get_formdata(int32 chunk_id)
 {
@@ -2804,6 +2823,23 @@ typedef enum ChunkDeleteResult
 	CHUNK_ALREADY_MARKED_DROPPED,
 } ChunkDeleteResult;
 
+/*
+ * State used when dropping several chunks at once.
+ *
+ * Instead of dropping each chunk table separately, the tables are collected
+ * and dropped with a single dependency deletion once all catalog rows are
+ * gone. Dimension slices that might be orphaned are collected as well (and
+ * locked) and checked in a single pass at the end, so that slices shared by
+ * many of the dropped chunks are only checked once.
+ */
+typedef struct ChunkDropState
+{
+	ObjectAddresses *objects;
+	List *slice_ids;
+	int32 hypertable_id;
+	int32 compressed_hypertable_id;
+} ChunkDropState;
+
 /* Delete the chunk tuple.
  *
  * preserve_chunk_catalog_row - instead of deleting the row, mark it as dropped.
@@ -2821,8 +2857,28 @@ typedef enum ChunkDeleteResult
  * shouldn't scan the updated tuples at all since it means double the number
  * of tuples to process.
  */
+static void ts_chunk_drop_internal(const Chunk *chunk, DropBehavior behavior, int32 log_level,
+								   bool preserve_catalog_row, ChunkDropState *state);
+
+static void
+warn_missing_dimension_slice(int32 hypertable_id, const char *schema_name, const char *table_name)
+{
+	const Hypertable *const ht = ts_hypertable_get_by_id(hypertable_id);
+
+	ereport(WARNING,
+			(errmsg("unexpected state for chunk %s.%s, dropping anyway",
+					quote_identifier(schema_name),
+					quote_identifier(table_name)),
+			 errdetail("The integrity of hypertable %s.%s might be "
+					   "compromised "
+					   "since one of its chunks lacked a dimension slice.",
+					   quote_identifier(NameStr(ht->fd.schema_name)),
+					   quote_identifier(NameStr(ht->fd.table_name)))));
+}
+
 static ChunkDeleteResult
-chunk_tuple_delete(TupleInfo *ti, DropBehavior behavior, bool preserve_chunk_catalog_row)
+chunk_tuple_delete(TupleInfo *ti, DropBehavior behavior, bool preserve_chunk_catalog_row,
+				   ChunkDropState *state)
 {
 	FormData_chunk form;
 	CatalogSecurityContext sec_ctx;
@@ -2879,17 +2935,13 @@ chunk_tuple_delete(TupleInfo *ti, DropBehavior behavior, bool preserve_chunk_cat
 				 * anyway since users need to be able to drop broken tables or
 				 * remove broken chunks. */
 				if (!slice)
+					warn_missing_dimension_slice(form.hypertable_id,
+												 NameStr(form.schema_name),
+												 NameStr(form.table_name));
+				else if (state != NULL)
 				{
-					const Hypertable *const ht = ts_hypertable_get_by_id(form.hypertable_id);
-					ereport(WARNING,
-							(errmsg("unexpected state for chunk %s.%s, dropping anyway",
-									quote_identifier(NameStr(form.schema_name)),
-									quote_identifier(NameStr(form.table_name))),
-							 errdetail("The integrity of hypertable %s.%s might be "
-									   "compromised "
-									   "since one of its chunks lacked a dimension slice.",
-									   quote_identifier(NameStr(ht->fd.schema_name)),
-									   quote_identifier(NameStr(ht->fd.table_name)))));
+					/* The slice is locked, so it is safe to check it later */
+					state->slice_ids = lappend_int(state->slice_ids, slice->fd.id);
 				}
 				else if (ts_chunk_constraint_scan_by_dimension_slice_id(slice->fd.id,
 																		NULL,
@@ -2918,7 +2970,7 @@ chunk_tuple_delete(TupleInfo *ti, DropBehavior behavior, bool preserve_chunk_cat
 			/* Plain drop without preserving catalog row because this is the compressed
 			 * chunk */
 			ts_compression_settings_delete(compressed_chunk->table_id);
-			ts_chunk_drop(compressed_chunk, behavior, DEBUG1);
+			ts_chunk_drop_internal(compressed_chunk, behavior, DEBUG1, false, state);
 		}
 	}
 
@@ -2971,7 +3023,8 @@ init_scan_by_qualified_table_name(ScanIterator *iterator, const char *schema_nam
 }
 
 static int
-chunk_delete(ScanIterator *iterator, DropBehavior behavior, bool preserve_chunk_catalog_row)
+chunk_delete(ScanIterator *iterator, DropBehavior behavior, bool preserve_chunk_catalog_row,
+			 ChunkDropState *state)
 {
 	int count = 0;
 
@@ -2981,7 +3034,8 @@ chunk_delete(ScanIterator *iterator, DropBehavior behavior, bool preserve_chunk_
 
 		res = chunk_tuple_delete(ts_scan_iterator_tuple_info(iterator),
 								 behavior,
-								 preserve_chunk_catalog_row);
+								 preserve_chunk_catalog_row,
+								 state);
 
 		switch (res)
 		{
@@ -3000,13 +3054,13 @@ chunk_delete(ScanIterator *iterator, DropBehavior behavior, bool preserve_chunk_
 
 static int
 ts_chunk_delete_by_name_internal(const char *schema, const char *table, DropBehavior behavior,
-								 bool preserve_chunk_catalog_row)
+								 bool preserve_chunk_catalog_row, ChunkDropState *state)
 {
 	ScanIterator iterator = ts_scan_iterator_create(CHUNK, RowExclusiveLock, CurrentMemoryContext);
 	int count;
 
 	init_scan_by_qualified_table_name(&iterator, schema, table);
-	count = chunk_delete(&iterator, behavior, preserve_chunk_catalog_row);
+	count = chunk_delete(&iterator, behavior, preserve_chunk_catalog_row, state);
 
 	/* (schema,table) names and (hypertable_id) are unique so should only have
 	 * dropped one chunk or none (if not found) */
@@ -3018,11 +3072,12 @@ ts_chunk_delete_by_name_internal(const char *schema, const char *table, DropBeha
 int
 ts_chunk_delete_by_name(const char *schema, const char *table, DropBehavior behavior)
 {
-	return ts_chunk_delete_by_name_internal(schema, table, behavior, false);
+	return ts_chunk_delete_by_name_internal(schema, table, behavior, false, NULL);
 }
 
 static int
-ts_chunk_delete_by_relid(Oid relid, DropBehavior behavior, bool preserve_chunk_catalog_row)
+ts_chunk_delete_by_relid(Oid relid, DropBehavior behavior, bool preserve_chunk_catalog_row,
+						 ChunkDropState *state)
 {
 	if (!OidIsValid(relid))
 		return 0;
@@ -3030,7 +3085,8 @@ ts_chunk_delete_by_relid(Oid relid, DropBehavior behavior, bool preserve_chunk_c
 	return ts_chunk_delete_by_name_internal(get_namespace_name(get_rel_namespace(relid)),
 											get_rel_name(relid),
 											behavior,
-											preserve_chunk_catalog_row);
+											preserve_chunk_catalog_row,
+											state);
 }
 
 static void
@@ -3051,7 +3107,7 @@ ts_chunk_delete_by_hypertable_id(int32 hypertable_id)
 
 	init_scan_by_hypertable_id(&iterator, hypertable_id);
 
-	return chunk_delete(&iterator, DROP_RESTRICT, false);
+	return chunk_delete(&iterator, DROP_RESTRICT, false, NULL);
 }
 
 bool
@@ -3720,9 +3776,15 @@ show_chunks_return_srf(FunctionCallInfo fcinfo)
 		SRF_RETURN_DONE(funcctx);
 }
 
+/*
+ * Drop a chunk.
+ *
+ * If a drop state is given, the chunk table is not dropped immediately but
+ * added to the objects to drop in chunk_drop_state_finish().
+ */
 static void
 ts_chunk_drop_internal(const Chunk *chunk, DropBehavior behavior, int32 log_level,
-					   bool preserve_catalog_row)
+					   bool preserve_catalog_row, ChunkDropState *state)
 {
 	ObjectAddress objaddr = {
 		.classId = RelationRelationId,
@@ -3736,22 +3798,289 @@ ts_chunk_drop_internal(const Chunk *chunk, DropBehavior behavior, int32 log_leve
 			 NameStr(chunk->fd.table_name));
 
 	/* Remove the chunk from the chunk table */
-	ts_chunk_delete_by_relid(chunk->table_id, behavior, preserve_catalog_row);
+	ts_chunk_delete_by_relid(chunk->table_id, behavior, preserve_catalog_row, state);
 
 	/* Drop the table */
-	performDeletion(&objaddr, behavior, 0);
+	if (state != NULL)
+		add_exact_object_address(&objaddr, state->objects);
+	else
+		performDeletion(&objaddr, behavior, 0);
 }
 
 void
 ts_chunk_drop(const Chunk *chunk, DropBehavior behavior, int32 log_level)
 {
-	ts_chunk_drop_internal(chunk, behavior, log_level, false);
+	ts_chunk_drop_internal(chunk, behavior, log_level, false, NULL);
 }
 
 void
 ts_chunk_drop_preserve_catalog_row(const Chunk *chunk, DropBehavior behavior, int32 log_level)
 {
-	ts_chunk_drop_internal(chunk, behavior, log_level, true);
+	ts_chunk_drop_internal(chunk, behavior, log_level, true, NULL);
+}
+
+static void
+invalidate_hypertable_of_chunks(int32 hypertable_id)
+{
+	if (!ts_cache_invalidate_hypertable_of(CHUNK, hypertable_id))
+		ts_catalog_invalidate_cache(catalog_get_table_id(ts_catalog_get(), CHUNK), CMD_DELETE);
+}
+
+/*
+ * Finish dropping the chunks collected in the drop state.
+ *
+ * All chunk constraints of the dropped chunks are deleted at this point, so
+ * the collected dimension slices are checked for remaining references with a
+ * single scan, and the orphaned ones are deleted together. The chunk tables
+ * are then dropped with a single dependency deletion.
+ */
+static void
+chunk_drop_state_finish(ChunkDropState *state, DropBehavior behavior)
+{
+	if (state->slice_ids != NIL)
+	{
+		ScanIterator iterator =
+			ts_scan_iterator_create(CHUNK_CONSTRAINT, AccessShareLock, CurrentMemoryContext);
+		Bitmapset *referenced_slices = NULL;
+		int32 *slice_ids;
+		int num_slice_ids = 0;
+		int num_orphaned = 0;
+		ListCell *lc;
+
+		list_sort(state->slice_ids, list_int_cmp);
+
+		slice_ids = palloc(sizeof(int32) * list_length(state->slice_ids));
+		foreach (lc, state->slice_ids)
+		{
+			int32 slice_id = lfirst_int(lc);
+
+			if (num_slice_ids == 0 || slice_ids[num_slice_ids - 1] != slice_id)
+				slice_ids[num_slice_ids++] = slice_id;
+		}
+
+		ts_chunk_constraint_scan_iterator_set_slice_ids(&iterator, slice_ids, num_slice_ids);
+		ts_scanner_foreach(&iterator)
+		{
+			bool isnull;
+			Datum slice_id = slot_getattr(ts_scan_iterator_slot(&iterator),
+										  Anum_chunk_constraint_dimension_slice_id,
+										  &isnull);
+
+			Assert(!isnull);
+			referenced_slices = bms_add_member(referenced_slices, DatumGetInt32(slice_id));
+		}
+
+		for (int i = 0; i < num_slice_ids; i++)
+		{
+			if (!bms_is_member(slice_ids[i], referenced_slices))
+				slice_ids[num_orphaned++] = slice_ids[i];
+		}
+
+		/*
+		 * The slices are deleted without invalidating the cache for each
+		 * row, so invalidate the hypertables of the slices once.
+		 */
+		if (num_orphaned > 0)
+		{
+			ts_dimension_slice_delete_by_ids(slice_ids, num_orphaned);
+			invalidate_hypertable_of_chunks(state->hypertable_id);
+			if (state->compressed_hypertable_id != INVALID_HYPERTABLE_ID)
+				invalidate_hypertable_of_chunks(state->compressed_hypertable_id);
+		}
+
+		bms_free(referenced_slices);
+		pfree(slice_ids);
+	}
+
+	performMultipleDeletions(state->objects, behavior, 0);
+
+	free_object_addresses(state->objects);
+	list_free(state->slice_ids);
+}
+
+/*
+ * Lock all the chunks, and their compressed chunks, that are going to be
+ * dropped. The relids of the compressed chunks are returned in
+ * compressed_relids, or InvalidOid for chunks that are not compressed.
+ *
+ * Taking all the locks up front, in relid order, means that we wait for
+ * concurrent queries on all the chunks before deleting any catalog rows, and
+ * that the chunk tables are always locked in the same order. The tuple locks
+ * that get_chunks_in_time_range() took on the catalog rows are still held
+ * while waiting.
+ */
+static void
+lock_chunks_to_drop(Chunk **chunks, int num_chunks, Oid *compressed_relids)
+{
+	Oid *relids = palloc(sizeof(Oid) * num_chunks * 2);
+	int num_relids = 0;
+
+	for (int i = 0; i < num_chunks; i++)
+	{
+		relids[num_relids++] = chunks[i]->table_id;
+		compressed_relids[i] = InvalidOid;
+
+		if (chunks[i]->fd.compressed_chunk_id != INVALID_CHUNK_ID)
+		{
+			compressed_relids[i] = ts_chunk_get_relid(chunks[i]->fd.compressed_chunk_id, true);
+
+			if (OidIsValid(compressed_relids[i]))
+				relids[num_relids++] = compressed_relids[i];
+		}
+	}
+
+	qsort(relids, num_relids, sizeof(Oid), oid_cmp);
+
+	for (int i = 0; i < num_relids; i++)
+		LockRelationOid(relids[i], AccessExclusiveLock);
+
+	pfree(relids);
+}
+
+/*
+ * Drop chunks of a hypertable, and their compressed chunks, without
+ * preserving the catalog rows.
+ *
+ * This does the same as dropping the chunks one by one, but the catalog rows
+ * of all the chunks are deleted with one scan per catalog table and the
+ * hypertable cache is invalidated once. The constraints and indexes of the
+ * chunks are not dropped one by one either, since they go away with the chunk
+ * tables in chunk_drop_state_finish().
+ */
+static void
+chunk_drop_multiple(const Hypertable *ht, Chunk **chunks, const Oid *compressed_relids,
+					int num_chunks, int32 log_level, ChunkDropState *state)
+{
+	int32 *chunk_ids = palloc(sizeof(int32) * num_chunks * 2);
+	int num_chunk_ids = 0;
+	bool has_compressed_chunks = false;
+	List *dimension_constraints;
+	CatalogSecurityContext sec_ctx;
+
+	for (int i = 0; i < num_chunks; i++)
+	{
+		const Chunk *chunk = chunks[i];
+		ObjectAddress objaddr = {
+			.classId = RelationRelationId,
+			.objectId = chunk->table_id,
+		};
+
+		if (log_level >= 0)
+			elog(log_level,
+				 "dropping chunk %s.%s",
+				 NameStr(chunk->fd.schema_name),
+				 NameStr(chunk->fd.table_name));
+
+		chunk_ids[num_chunk_ids++] = chunk->fd.id;
+		add_exact_object_address(&objaddr, state->objects);
+
+		/* The compressed chunk may have been deleted by a CASCADE */
+		if (OidIsValid(compressed_relids[i]))
+		{
+			ObjectAddress compressed_objaddr = {
+				.classId = RelationRelationId,
+				.objectId = compressed_relids[i],
+			};
+
+			elog(DEBUG1,
+				 "dropping chunk %s.%s",
+				 get_namespace_name(get_rel_namespace(compressed_relids[i])),
+				 get_rel_name(compressed_relids[i]));
+
+			chunk_ids[num_chunk_ids++] = chunk->fd.compressed_chunk_id;
+			has_compressed_chunks = true;
+			ts_compression_settings_delete(compressed_relids[i]);
+			add_exact_object_address(&compressed_objaddr, state->objects);
+		}
+	}
+
+	dimension_constraints =
+		ts_chunk_constraint_delete_metadata_by_chunk_ids(chunk_ids, num_chunk_ids);
+
+	/*
+	 * Lock the dimension slices of the chunks before they are checked for
+	 * remaining references in chunk_drop_state_finish(). See
+	 * chunk_tuple_delete() for why they need to be locked.
+	 */
+	if (dimension_constraints != NIL)
+	{
+		ScanTupLock tuplock = {
+			.lockmode = LockTupleExclusive,
+			.waitpolicy = LockWaitBlock,
+		};
+		ScanIterator iterator = ts_dimension_slice_scan_iterator_create(&tuplock,
+																		CurrentMemoryContext);
+		int32 *slice_ids = palloc(sizeof(int32) * list_length(dimension_constraints));
+		int num_slice_ids = 0;
+		Bitmapset *found_slices = NULL;
+		TupleInfo *ti;
+		ListCell *lc;
+
+		foreach (lc, dimension_constraints)
+			slice_ids[num_slice_ids++] = ((ChunkConstraint *) lfirst(lc))->fd.dimension_slice_id;
+
+		ts_dimension_slice_scan_iterator_set_slice_ids(&iterator,
+													   slice_ids,
+													   num_slice_ids,
+													   &tuplock);
+		ts_scan_iterator_start_scan(&iterator);
+
+		while ((ti = ts_scan_iterator_next(&iterator)) != NULL)
+		{
+			bool isnull;
+			int32 slice_id =
+				DatumGetInt32(slot_getattr(ti->slot, Anum_dimension_slice_id, &isnull));
+
+			found_slices = bms_add_member(found_slices, slice_id);
+			state->slice_ids = lappend_int(state->slice_ids, slice_id);
+		}
+		ts_scan_iterator_close(&iterator);
+
+		/*
+		 * A missing slice means that the table is broken, but users need to
+		 * be able to remove broken chunks.
+		 */
+		foreach (lc, dimension_constraints)
+		{
+			const ChunkConstraint *cc = lfirst(lc);
+			FormData_chunk form;
+
+			if (!bms_is_member(cc->fd.dimension_slice_id, found_slices) &&
+				chunk_simple_scan_by_id(cc->fd.chunk_id, &form, true))
+				warn_missing_dimension_slice(form.hypertable_id,
+											 NameStr(form.schema_name),
+											 NameStr(form.table_name));
+		}
+
+		bms_free(found_slices);
+		pfree(slice_ids);
+	}
+
+	ts_chunk_index_delete_metadata_by_chunk_ids(chunk_ids, num_chunk_ids);
+	ts_compression_chunk_size_delete_by_chunk_ids(chunk_ids, num_chunk_ids);
+	ts_bgw_policy_chunk_stats_delete_by_chunk_ids(chunk_ids, num_chunk_ids);
+	ts_chunk_column_stats_delete_by_chunk_ids(chunk_ids, num_chunk_ids);
+
+	ScanIterator iterator = ts_scan_iterator_create(CHUNK, RowExclusiveLock, CurrentMemoryContext);
+
+	ts_chunk_scan_iterator_set_chunk_ids(&iterator, chunk_ids, num_chunk_ids);
+	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+
+		ts_catalog_delete_tid_without_invalidation(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+	}
+	ts_catalog_restore_user(&sec_ctx);
+
+	invalidate_hypertable_of_chunks(ht->fd.id);
+	if (has_compressed_chunks)
+		invalidate_hypertable_of_chunks(ht->fd.compressed_hypertable_id);
+
+	/* Make catalog changes visible */
+	CommandCounterIncrement();
+
+	pfree(chunk_ids);
 }
 
 static void
@@ -3778,6 +4107,76 @@ lock_referenced_tables(Oid table_relid)
 		LockRelationOid(lfirst_oid(lf), AccessExclusiveLock);
 }
 
+/*
+ * Drop the chunks together, with a single dependency deletion for all the
+ * chunk tables.
+ *
+ * When other objects depend on the chunks, the error of the single deletion
+ * doesn't say which chunk or which of its objects they depend on. So the
+ * chunks are dropped in a subtransaction, and on such an error they are
+ * dropped one by one instead, which reports the object that can't be
+ * dropped.
+ */
+static void
+chunk_drop_batched(const Hypertable *ht, Chunk **chunks, const Oid *compressed_relids,
+				   int num_chunks, int32 log_level, bool preserve_catalog_row)
+{
+	MemoryContext oldcontext = CurrentMemoryContext;
+	ResourceOwner oldowner = CurrentResourceOwner;
+	volatile bool has_dependent_objects = false;
+
+	BeginInternalSubTransaction("drop chunks");
+
+	PG_TRY();
+	{
+		ChunkDropState state = {
+			.objects = new_object_addresses(),
+			.slice_ids = NIL,
+			.hypertable_id = ht->fd.id,
+			.compressed_hypertable_id = ht->fd.compressed_hypertable_id,
+		};
+
+		if (preserve_catalog_row)
+		{
+			for (int i = 0; i < num_chunks; i++)
+				ts_chunk_drop_internal(chunks[i], DROP_RESTRICT, log_level, true, &state);
+		}
+		else
+			chunk_drop_multiple(ht, chunks, compressed_relids, num_chunks, log_level, &state);
+
+		chunk_drop_state_finish(&state, DROP_RESTRICT);
+
+		ReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldcontext);
+		CurrentResourceOwner = oldowner;
+	}
+	PG_CATCH();
+	{
+		ErrorData *edata;
+
+		MemoryContextSwitchTo(oldcontext);
+		edata = CopyErrorData();
+		FlushErrorState();
+		RollbackAndReleaseCurrentSubTransaction();
+		MemoryContextSwitchTo(oldcontext);
+		CurrentResourceOwner = oldowner;
+
+		if (edata->sqlerrcode != ERRCODE_DEPENDENT_OBJECTS_STILL_EXIST)
+			ReThrowError(edata);
+
+		FreeErrorData(edata);
+		has_dependent_objects = true;
+	}
+	PG_END_TRY();
+
+	/* The chunks were already logged, and dropping them raises the error */
+	if (has_dependent_objects)
+	{
+		for (int i = 0; i < num_chunks; i++)
+			ts_chunk_drop_internal(chunks[i], DROP_RESTRICT, -1, preserve_catalog_row, NULL);
+	}
+}
+
 List *
 ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int32 log_level,
 						Oid time_type, Oid arg_type, bool older_newer)
@@ -3923,10 +4322,11 @@ ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int3
 
 	bool all_caggs_finalized = ts_continuous_agg_hypertable_all_finalized(hypertable_id);
 	List *dropped_chunk_names = NIL;
+	Chunk **chunks_to_drop = palloc(sizeof(Chunk *) * (num_chunks + 1));
+	int num_chunks_to_drop = 0;
+
 	for (uint64 i = 0; i < num_chunks; i++)
 	{
-		char *chunk_name;
-
 		ASSERT_IS_VALID_CHUNK(&chunks[i]);
 
 		/* frozen chunks are skipped. Not dropped. */
@@ -3938,17 +4338,38 @@ ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int3
 			continue;
 		}
 
-		/* store chunk name for output */
-		schema_name = quote_identifier(NameStr(chunks[i].fd.schema_name));
-		table_name = quote_identifier(NameStr(chunks[i].fd.table_name));
-		chunk_name = psprintf("%s.%s", schema_name, table_name);
-		dropped_chunk_names = lappend(dropped_chunk_names, chunk_name);
+		chunks_to_drop[num_chunks_to_drop++] = &chunks[i];
+	}
 
-		if (has_continuous_aggs && !all_caggs_finalized)
-			ts_chunk_drop_preserve_catalog_row(chunks + i, DROP_RESTRICT, log_level);
-		else
-			ts_chunk_drop(chunks + i, DROP_RESTRICT, log_level);
+	if (num_chunks_to_drop > 0)
+	{
+		Oid *compressed_relids = palloc(sizeof(Oid) * num_chunks_to_drop);
+		bool preserve_catalog_row = has_continuous_aggs && !all_caggs_finalized;
+
+		lock_chunks_to_drop(chunks_to_drop, num_chunks_to_drop, compressed_relids);
+
+		for (int i = 0; i < num_chunks_to_drop; i++)
+		{
+			const Chunk *chunk = chunks_to_drop[i];
+			char *chunk_name;
+
+			/* store chunk name for output */
+			schema_name = quote_identifier(NameStr(chunk->fd.schema_name));
+			table_name = quote_identifier(NameStr(chunk->fd.table_name));
+			chunk_name = psprintf("%s.%s", schema_name, table_name);
+			dropped_chunk_names = lappend(dropped_chunk_names, chunk_name);
+		}
+
+		chunk_drop_batched(ht,
+						   chunks_to_drop,
+						   compressed_relids,
+						   num_chunks_to_drop,
+						   log_level,
+						   preserve_catalog_row);
+		pfree(compressed_relids);
 	}
+
+	pfree(chunks_to_drop);
 	// if we have tiered chunks cascade drop to tiering layer as well
 	if (osm_chunk_id != INVALID_CHUNK_ID)
 	{
@@ -4351,6 +4772,10 @@ get_chunk_operation_str(ChunkOperation cmd)
 			return "decompress_chunk";
 		case CHUNK_DROP:
 			return "drop_chunk";
+		case CHUNK_MERGE:
+			return "merge_chunks";
+		case CHUNK_SPLIT:
+			return "split_chunk";
 		default:
 			return "Unsupported";
 	}
@@ -4397,6 +4822,8 @@ ts_chunk_validate_chunk_status_for_operation(const Chunk *chunk, ChunkOperation
 			case CHUNK_COMPRESS:
 			case CHUNK_DECOMPRESS:
 			case CHUNK_DROP:
+			case CHUNK_MERGE:
+			case CHUNK_SPLIT:
 			{
 				if (throw_error)
 					elog(ERROR,
@@ -4533,6 +4960,18 @@ ts_chunk_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id)
 								   Int32GetDatum(chunk_id));
 }
 
+/*
+ * Set the iterator to scan for all the given chunk IDs in one index scan. The
+ * chunks are returned in ID order.
+ */
+void
+ts_chunk_scan_iterator_set_chunk_ids(ScanIterator *it, const int32 *chunk_ids, int num_chunk_ids)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(), CHUNK, CHUNK_ID_INDEX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_init_int32_array(it, Anum_chunk_idx_id, chunk_ids, num_chunk_ids);
+}
+
 /*
  * Create a hypercube for the OSM chunk
  * The initial range for the OSM chunk will be from INT64_MAX - 1 to INT64_MAX.
@@ -4589,6 +5028,13 @@ add_foreign_table_as_chunk(Oid relid, Hypertable *parent_ht)
 	if (hs->num_dimensions > 1)
 		elog(ERROR,
 			 "cannot attach a  foreign table to a hypertable that has more than 1 dimension");
+	/*
+	 * Serialize chunk creation around the root hypertable, like the other ways
+	 * of creating chunks, so that the chunk IDs of a hypertable become visible
+	 * in increasing order, see ts_chunk_map_has_new_chunks().
+	 */
+	LockRelationOid(parent_ht->main_table_relid, ShareUpdateExclusiveLock);
+
 	/* Create a new chunk based on the hypercube */
 	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
 	chunk = ts_chunk_create_base(ts_catalog_table_next_seq_id(catalog, CHUNK),
@@ -4649,7 +5095,6 @@ ts_chunk_merge_on_dimension(const Hypertable *ht, Chunk *chunk, const Chunk *mer
 							int32 dimension_id)
 {
 	const DimensionSlice *slice, *merge_slice;
-	int num_ccs = 0;
 	bool dimension_slice_found = false;
 
 	if (chunk->hypertable_relid != merge_chunk->hypertable_relid)
@@ -4696,6 +5141,49 @@ ts_chunk_merge_on_dimension(const Hypertable *ht, Chunk *chunk, const Chunk *mer
 						 get_rel_name(merge_chunk->table_id),
 						 dimension_id)));
 
+	ts_chunk_set_dimension_slice(chunk,
+								 dimension_id,
+								 slice->fd.range_start,
+								 merge_slice->fd.range_end);
+	ts_chunk_constraint_recreate_dimension(ht, chunk, dimension_id);
+
+	ts_chunk_drop(merge_chunk, DROP_RESTRICT, 1);
+}
+
+/*
+ * Move a chunk to a slice covering [range_start, range_end) in the given
+ * dimension.
+ *
+ * Only the catalog is updated. The old slice is deleted if this chunk was the
+ * only one using it. The CHECK constraint on the chunk table keeps the old
+ * range until ts_chunk_constraint_recreate_dimension() is called, which
+ * requires an AccessExclusiveLock on the chunk, so callers can defer it until
+ * they hold that lock anyway.
+ */
+void
+ts_chunk_set_dimension_slice(Chunk *chunk, int32 dimension_id, int64 range_start, int64 range_end)
+{
+	DimensionSlice *slice = NULL;
+	DimensionSlice *new_slice;
+	int slice_index;
+	int num_ccs;
+
+	for (slice_index = 0; slice_index < chunk->cube->num_slices; slice_index++)
+	{
+		if (chunk->cube->slices[slice_index]->fd.dimension_id == dimension_id)
+		{
+			slice = chunk->cube->slices[slice_index];
+			break;
+		}
+	}
+
+	if (slice == NULL)
+		ereport(ERROR,
+				(errmsg("cannot find slice for dimension"),
+				 errhint("chunk: \"%s\", dimension ID %d",
+						 get_rel_name(chunk->table_id),
+						 dimension_id)));
+
 	num_ccs =
 		ts_chunk_constraint_scan_by_dimension_slice_id(slice->fd.id, NULL, CurrentMemoryContext);
 
@@ -4709,11 +5197,10 @@ ts_chunk_merge_on_dimension(const Hypertable *ht, Chunk *chunk, const Chunk *mer
 						 get_rel_name(chunk->table_id),
 						 slice->fd.id)));
 
-	DimensionSlice *new_slice =
-		ts_dimension_slice_create(dimension_id, slice->fd.range_start, merge_slice->fd.range_end);
+	new_slice = ts_dimension_slice_create(dimension_id, range_start, range_end);
 
-	/* Only if there is exactly one chunk constraint for the merged dimension slice
-	 * we can go ahead and delete it since we are dropping the chunk.
+	/* Only if there is exactly one chunk constraint for the dimension slice
+	 * we can go ahead and delete it since we are moving the chunk away from it.
 	 */
 	if (num_ccs == 1)
 		ts_dimension_slice_delete_by_id(slice->fd.id, false);
@@ -4728,74 +5215,23 @@ ts_chunk_merge_on_dimension(const Hypertable *ht, Chunk *chunk, const Chunk *mer
 		ts_dimension_slice_insert(new_slice);
 	}
 
-	ts_chunk_constraint_update_slice_id(chunk->fd.id, slice->fd.id, new_slice->fd.id);
-	ChunkConstraints *ccs = ts_chunk_constraints_alloc(1, CurrentMemoryContext);
-	ScanIterator iterator =
-		ts_scan_iterator_create(CHUNK_CONSTRAINT, AccessShareLock, CurrentMemoryContext);
-
-	ts_chunk_constraint_scan_iterator_set_slice_id(&iterator, new_slice->fd.id);
-
-	ts_scanner_foreach(&iterator)
-	{
-		bool isnull;
-		Datum d;
-
-		d = slot_getattr(ts_scan_iterator_slot(&iterator), Anum_chunk_constraint_chunk_id, &isnull);
-
-		if (!isnull && DatumGetInt32(d) == chunk->fd.id)
-		{
-			num_ccs++;
-			ts_chunk_constraints_add_from_tuple(ccs, ts_scan_iterator_tuple_info(&iterator));
-		}
-	}
-
-	if (num_ccs <= 0)
+	if (!ts_chunk_constraint_update_slice_id(chunk->fd.id, slice->fd.id, new_slice->fd.id))
 		ereport(ERROR,
-				(errmsg("missing chunk constraint for merged dimension slice"),
+				(errmsg("missing chunk constraint for dimension slice"),
 				 errhint("chunk: \"%s\", slice ID %d",
 						 get_rel_name(chunk->table_id),
-						 new_slice->fd.id)));
-
-	/* Update the slice in the chunk's hypercube. Needed to make recreate constraints work. */
-	for (int i = 0; i < chunk->cube->num_slices; i++)
-	{
-		if (chunk->cube->slices[i]->fd.dimension_id == dimension_id)
-		{
-			chunk->cube->slices[i] = new_slice;
-			break;
-		}
-	}
+						 slice->fd.id)));
 
-	/* Delete the old constraint */
+	/* Update the in-memory chunk so that the constraint can be recreated from it */
 	for (int i = 0; i < chunk->constraints->num_constraints; i++)
 	{
-		const ChunkConstraint *cc = &chunk->constraints->constraints[i];
+		ChunkConstraint *cc = &chunk->constraints->constraints[i];
 
 		if (cc->fd.dimension_slice_id == slice->fd.id)
-		{
-			ObjectAddress constrobj = {
-				.classId = ConstraintRelationId,
-				.objectId = get_relation_constraint_oid(chunk->table_id,
-														NameStr(cc->fd.constraint_name),
-														false),
-			};
-
-			performDeletion(&constrobj, DROP_RESTRICT, 0);
-			break;
-		}
+			cc->fd.dimension_slice_id = new_slice->fd.id;
 	}
 
-	/* We have to recreate the chunk constraints since we are changing
-	 * table constraints when updating the slice.
-	 */
-	ChunkConstraints *oldccs = chunk->constraints;
-	chunk->constraints = ccs;
-	ts_process_utility_set_expect_chunk_modification(true);
-	ts_chunk_constraints_create(ht, chunk);
-	ts_process_utility_set_expect_chunk_modification(false);
-	chunk->constraints = oldccs;
-
-	ts_chunk_drop(merge_chunk, DROP_RESTRICT, 1);
+	chunk->cube->slices[slice_index] = new_slice;
 }
 
 /* Internal API used by OSM extension. OSM table is a foreign table that is
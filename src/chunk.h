@@ -45,6 +45,8 @@ typedef enum ChunkOperation
 	CHUNK_SELECT,
 	CHUNK_COMPRESS,
 	CHUNK_DECOMPRESS,
+	CHUNK_MERGE,
+	CHUNK_SPLIT,
 } ChunkOperation;
 
 typedef struct Hypercube Hypercube;
@@ -177,6 +179,7 @@ extern TSDLLEXPORT Chunk *ts_chunk_get_by_relid(Oid relid, bool fail_if_not_foun
 extern TSDLLEXPORT void ts_chunk_free(Chunk *chunk);
 extern bool ts_chunk_exists(const char *schema_name, const char *table_name);
 extern TSDLLEXPORT int32 ts_chunk_get_hypertable_id_by_reloid(Oid reloid);
+extern int32 ts_chunk_get_hypertable_id_by_id(int32 chunk_id);
 extern TSDLLEXPORT FormData_chunk ts_chunk_get_formdata(int32 chunk_id);
 extern TSDLLEXPORT bool ts_chunk_simple_scan_by_reloid(Oid reloid, FormData_chunk *form,
 													   bool missing_ok);
@@ -238,10 +241,14 @@ extern Chunk *ts_chunk_build_from_tuple_and_stub(Chunk **chunkptr, TupleInfo *ti
 
 extern ScanIterator ts_chunk_scan_iterator_create(MemoryContext result_mcxt);
 extern void ts_chunk_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id);
+extern void ts_chunk_scan_iterator_set_chunk_ids(ScanIterator *it, const int32 *chunk_ids,
+												 int num_chunk_ids);
 extern bool ts_chunk_lock_if_exists(Oid chunk_oid, LOCKMODE chunk_lockmode);
 int ts_chunk_get_osm_chunk_id(int hypertable_id);
 extern TSDLLEXPORT void ts_chunk_merge_on_dimension(const Hypertable *ht, Chunk *chunk,
 													const Chunk *merge_chunk, int32 dimension_id);
+extern TSDLLEXPORT void ts_chunk_set_dimension_slice(Chunk *chunk, int32 dimension_id,
+													 int64 range_start, int64 range_end);
 
 #define chunk_get_by_name(schema_name, table_name, fail_if_not_found)                              \
 	ts_chunk_get_by_name_with_memory_context(schema_name,                                          \
@@ -24,6 +24,7 @@
 #include <utils/syscache.h>
 
 #include "compat/compat.h"
+#include "cache_invalidate.h"
 #include "chunk.h"
 #include "chunk_constraint.h"
 #include "chunk_index.h"
@@ -205,6 +206,9 @@ ts_chunk_constraints_insert_metadata(const ChunkConstraints *ccs)
 
 /*
  * Insert a single chunk constraints into the metadata catalog.
+ *
+ * This adds a constraint to an existing chunk, so unlike the inserts for new
+ * chunks, it has to invalidate the chunk map of the hypertable.
  */
 void
 ts_chunk_constraint_insert(ChunkConstraint *constraint)
@@ -219,6 +223,9 @@ ts_chunk_constraint_insert(ChunkConstraint *constraint)
 	chunk_constraint_insert_relation(rel, constraint);
 	ts_catalog_restore_user(&sec_ctx);
 	table_close(rel, RowExclusiveLock);
+
+	if (!ts_cache_invalidate_hypertable_of(CHUNK_CONSTRAINT, constraint->fd.chunk_id))
+		ts_catalog_invalidate_cache(catalog_get_table_id(catalog, CHUNK_CONSTRAINT), CMD_UPDATE);
 }
 
 ChunkConstraint *
@@ -378,11 +385,53 @@ create_dimension_check_constraint(const Dimension *dim, const DimensionSlice *sl
 	return constr;
 }
 
+/*
+ * Create a primary key, unique or exclusion constraint of a chunk directly
+ * from the index of the hypertable constraint, which avoids parsing an ALTER
+ * TABLE statement for every new chunk. Returns false if the constraint was not
+ * created, and has to be added with ALTER TABLE.
+ */
+static bool
+chunk_constraint_create_from_index(const ChunkConstraint *cc, Oid chunk_oid, Oid hypertable_oid)
+{
+	Oid hypertable_constraint_oid;
+	HeapTuple tuple;
+	bool created = false;
+
+	hypertable_constraint_oid =
+		get_relation_constraint_oid(hypertable_oid,
+									NameStr(cc->fd.hypertable_constraint_name),
+									true);
+
+	if (!OidIsValid(hypertable_constraint_oid))
+		return false;
+
+	tuple = SearchSysCache1(CONSTROID, ObjectIdGetDatum(hypertable_constraint_oid));
+
+	if (HeapTupleIsValid(tuple))
+	{
+		Form_pg_constraint constr = (Form_pg_constraint) GETSTRUCT(tuple);
+
+		if ((constr->contype == CONSTRAINT_PRIMARY || constr->contype == CONSTRAINT_UNIQUE ||
+			 constr->contype == CONSTRAINT_EXCLUSION) &&
+			OidIsValid(constr->conindid))
+			created = OidIsValid(
+				ts_chunk_index_create_for_constraint(hypertable_oid,
+													 chunk_oid,
+													 constr,
+													 NameStr(cc->fd.constraint_name)));
+
+		ReleaseSysCache(tuple);
+	}
+
+	return created;
+}
+
 /*
  * Add a constraint to a chunk table.
  */
 static Oid
-chunk_constraint_create_on_table(const ChunkConstraint *cc, Oid chunk_oid)
+chunk_constraint_create_on_table(const ChunkConstraint *cc, Oid chunk_oid, Oid hypertable_oid)
 {
 	HeapTuple tuple;
 	Datum values[Natts_chunk_constraint];
@@ -390,6 +439,9 @@ chunk_constraint_create_on_table(const ChunkConstraint *cc, Oid chunk_oid)
 	CatalogSecurityContext sec_ctx;
 	Relation rel;
 
+	if (chunk_constraint_create_from_index(cc, chunk_oid, hypertable_oid))
+		return get_relation_constraint_oid(chunk_oid, NameStr(cc->fd.constraint_name), false);
+
 	chunk_constraint_fill_tuple_values(cc, values, nulls);
 
 	rel = RelationIdGetRelation(catalog_get_table_id(ts_catalog_get(), CHUNK_CONSTRAINT));
@@ -417,7 +469,7 @@ create_non_dimensional_constraint(const ChunkConstraint *cc, Oid chunk_oid, int3
 	Assert(!is_dimension_constraint(cc));
 
 	ts_process_utility_set_expect_chunk_modification(true);
-	chunk_constraint_oid = chunk_constraint_create_on_table(cc, chunk_oid);
+	chunk_constraint_oid = chunk_constraint_create_on_table(cc, chunk_oid, hypertable_oid);
 	ts_process_utility_set_expect_chunk_modification(false);
 
 	/*
@@ -526,6 +578,83 @@ ts_chunk_constraints_create(const Hypertable *ht, const Chunk *chunk)
 	ts_chunk_copy_referencing_fk(ht, chunk);
 }
 
+/*
+ * Replace the CHECK constraint of a chunk for the given dimension with one
+ * matching the chunk's current slice in that dimension.
+ *
+ * The new constraint is not validated, so the caller has to make sure that
+ * the chunk data fits the new range.
+ */
+void
+ts_chunk_constraint_recreate_dimension(const Hypertable *ht, const Chunk *chunk,
+									   int32 dimension_id)
+{
+	const Dimension *dim = ts_hyperspace_get_dimension_by_id(ht->space, dimension_id);
+	const DimensionSlice *slice = NULL;
+
+	Ensure(dim != NULL, "dimension %d not found", dimension_id);
+
+	for (int i = 0; i < chunk->cube->num_slices; i++)
+	{
+		if (chunk->cube->slices[i]->fd.dimension_id == dimension_id)
+		{
+			slice = chunk->cube->slices[i];
+			break;
+		}
+	}
+
+	Ensure(slice != NULL,
+		   "slice for dimension %d not found for chunk \"%s\"",
+		   dimension_id,
+		   get_rel_name(chunk->table_id));
+
+	for (int i = 0; i < chunk->constraints->num_constraints; i++)
+	{
+		const ChunkConstraint *cc = &chunk->constraints->constraints[i];
+		Constraint *constr;
+		Oid constroid;
+
+		if (cc->fd.dimension_slice_id != slice->fd.id)
+			continue;
+
+		constroid =
+			get_relation_constraint_oid(chunk->table_id, NameStr(cc->fd.constraint_name), true);
+
+		if (OidIsValid(constroid))
+		{
+			ObjectAddress constrobj = {
+				.classId = ConstraintRelationId,
+				.objectId = constroid,
+			};
+
+			performDeletion(&constrobj, DROP_RESTRICT, 0);
+		}
+
+		constr = create_dimension_check_constraint(dim, slice, NameStr(cc->fd.constraint_name));
+
+		if (constr != NULL)
+		{
+			Relation rel = table_open(chunk->table_id, AccessExclusiveLock);
+
+			AddRelationNewConstraints(rel,
+									  NIL /* List *newColDefaults */,
+									  list_make1(constr),
+									  false /* allow_merge */,
+									  true /* is_local */,
+									  false /* is_internal */,
+									  NULL /* query string */);
+			table_close(rel, NoLock);
+		}
+
+		CommandCounterIncrement();
+		return;
+	}
+
+	ereport(ERROR,
+			(errmsg("missing chunk constraint for dimension slice"),
+			 errhint("chunk: \"%s\", slice ID %d", get_rel_name(chunk->table_id), slice->fd.id)));
+}
+
 ScanIterator
 ts_chunk_constraint_scan_iterator_create(MemoryContext result_mcxt)
 {
@@ -563,6 +692,41 @@ ts_chunk_constraint_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id)
 								   Int32GetDatum(chunk_id));
 }
 
+/*
+ * Set the iterator to scan for the constraints of all the given chunks in one
+ * index scan. The constraints are returned ordered by chunk ID.
+ */
+void
+ts_chunk_constraint_scan_iterator_set_chunk_ids(ScanIterator *it, const int32 *chunk_ids,
+												int num_chunk_ids)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(),
+									  CHUNK_CONSTRAINT,
+									  CHUNK_CONSTRAINT_CHUNK_ID_CONSTRAINT_NAME_IDX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_init_int32_array(
+		it, Anum_chunk_constraint_chunk_id_constraint_name_idx_chunk_id, chunk_ids, num_chunk_ids);
+}
+
+/*
+ * Set the iterator to scan for the constraints that reference any of the given
+ * dimension slices in one index scan.
+ */
+void
+ts_chunk_constraint_scan_iterator_set_slice_ids(ScanIterator *it, const int32 *slice_ids,
+												int num_slice_ids)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(),
+									  CHUNK_CONSTRAINT,
+									  CHUNK_CONSTRAINT_DIMENSION_SLICE_ID_IDX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_init_int32_array(
+		it,
+		Anum_chunk_constraint_dimension_slice_id_idx_dimension_slice_id,
+		slice_ids,
+		num_slice_ids);
+}
+
 static void
 init_scan_by_chunk_id_constraint_name(ScanIterator *iterator, int32 chunk_id,
 									  const char *constraint_name)
@@ -1008,6 +1172,49 @@ ts_chunk_constraint_delete_by_chunk_id(int32 chunk_id, ChunkConstraints *ccs)
 	return count;
 }
 
+/*
+ * Delete the constraint metadata of many chunks in one scan. This is for
+ * chunks whose tables are dropped afterwards, so the constraints and their
+ * indexes are dropped together with the tables and not one by one here. The
+ * caller also has to delete the chunk index metadata and invalidate the
+ * hypertable cache.
+ *
+ * Returns the deleted dimension constraints, so that the caller can check the
+ * dimension slices for remaining references.
+ */
+List *
+ts_chunk_constraint_delete_metadata_by_chunk_ids(const int32 *chunk_ids, int num_chunk_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(CHUNK_CONSTRAINT, RowExclusiveLock, CurrentMemoryContext);
+	List *dimension_constraints = NIL;
+
+	ts_chunk_constraint_scan_iterator_set_chunk_ids(&iterator, chunk_ids, num_chunk_ids);
+
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		bool isnull;
+		Datum slice_id = slot_getattr(ti->slot, Anum_chunk_constraint_dimension_slice_id, &isnull);
+
+		if (!isnull)
+		{
+			ChunkConstraint *cc = palloc0(sizeof(ChunkConstraint));
+
+			cc->fd.chunk_id =
+				DatumGetInt32(slot_getattr(ti->slot, Anum_chunk_constraint_chunk_id, &isnull));
+			cc->fd.dimension_slice_id = DatumGetInt32(slice_id);
+			dimension_constraints = lappend(dimension_constraints, cc);
+		}
+
+		ts_catalog_delete_tid_without_invalidation(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+	}
+
+	CommandCounterIncrement();
+
+	return dimension_constraints;
+}
+
 int
 ts_chunk_constraint_delete_by_dimension_slice_id(int32 dimension_slice_id)
 {
@@ -59,6 +59,9 @@ extern TSDLLEXPORT int ts_chunk_constraints_add_inheritable_check_constraints(
 	ChunkConstraints *ccs, int32 chunk_id, const char chunk_relkind, Oid hypertable_oid);
 extern TSDLLEXPORT void ts_chunk_constraints_insert_metadata(const ChunkConstraints *ccs);
 extern TSDLLEXPORT void ts_chunk_constraints_create(const Hypertable *ht, const Chunk *chunk);
+extern TSDLLEXPORT void ts_chunk_constraint_recreate_dimension(const Hypertable *ht,
+															   const Chunk *chunk,
+															   int32 dimension_id);
 extern void ts_chunk_constraint_create_on_chunk(const Hypertable *ht, const Chunk *chunk,
 												Oid constraint_oid);
 extern int ts_chunk_constraint_delete_by_hypertable_constraint_name(
@@ -88,3 +91,11 @@ extern ChunkConstraint *ts_chunk_constraints_add_from_tuple(ChunkConstraints *cc
 extern ScanIterator ts_chunk_constraint_scan_iterator_create(MemoryContext result_mcxt);
 extern void ts_chunk_constraint_scan_iterator_set_slice_id(ScanIterator *it, int32 slice_id);
 extern void ts_chunk_constraint_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id);
+extern void ts_chunk_constraint_scan_iterator_set_chunk_ids(ScanIterator *it,
+															const int32 *chunk_ids,
+															int num_chunk_ids);
+extern void ts_chunk_constraint_scan_iterator_set_slice_ids(ScanIterator *it,
+															const int32 *slice_ids,
+															int num_slice_ids);
+extern List *ts_chunk_constraint_delete_metadata_by_chunk_ids(const int32 *chunk_ids,
+															  int num_chunk_ids);
@@ -40,6 +40,9 @@ static bool chunk_index_insert(int32 chunk_id, const char *chunk_index, int32 hy
 static Oid ts_chunk_index_create_post_adjustment(int32 hypertable_id, Relation template_indexrel,
 												 Relation chunkrel, IndexInfo *indexinfo,
 												 bool isconstraint, Oid index_tablespace);
+static Oid chunk_index_create_relation(Relation template_indexrel, Relation chunkrel,
+									   IndexInfo *indexinfo, const char *indexname,
+									   Oid tablespace, bits16 flags, bits16 constr_flags);
 
 static List *
 create_index_colnames(Relation indexrel)
@@ -193,14 +196,13 @@ ts_chunk_index_get_tablespace(int32 hypertable_id, Relation template_indexrel, R
 }
 
 /*
- * Create a chunk index based on the configuration of the "parent" index.
+ * Build the IndexInfo of a chunk index from the "parent" index, with the
+ * attnos adjusted to the chunk.
  */
-static Oid
-chunk_relation_index_create(Relation htrel, Relation template_indexrel, Relation chunkrel,
-							bool isconstraint, Oid index_tablespace)
+static IndexInfo *
+chunk_index_build_info(Relation htrel, Relation template_indexrel, Relation chunkrel)
 {
 	IndexInfo *indexinfo = BuildIndexInfo(template_indexrel);
-	int32 hypertable_id;
 	bool skip_mapping = false;
 
 	/*
@@ -221,6 +223,19 @@ chunk_relation_index_create(Relation htrel, Relation template_indexrel, Relation
 		chunk_index_need_attnos_adjustment(RelationGetDescr(htrel), RelationGetDescr(chunkrel)))
 		ts_adjust_indexinfo_attnos(indexinfo, htrel->rd_id, chunkrel);
 
+	return indexinfo;
+}
+
+/*
+ * Create a chunk index based on the configuration of the "parent" index.
+ */
+static Oid
+chunk_relation_index_create(Relation htrel, Relation template_indexrel, Relation chunkrel,
+							bool isconstraint, Oid index_tablespace)
+{
+	IndexInfo *indexinfo = chunk_index_build_info(htrel, template_indexrel, chunkrel);
+	int32 hypertable_id;
+
 	hypertable_id = ts_hypertable_relid_to_id(htrel->rd_id);
 	Assert(hypertable_id != INVALID_HYPERTABLE_ID);
 
@@ -237,16 +252,49 @@ ts_chunk_index_create_post_adjustment(int32 hypertable_id, Relation template_ind
 									  Relation chunkrel, IndexInfo *indexinfo, bool isconstraint,
 									  Oid index_tablespace)
 {
-	Oid chunk_indexrelid = InvalidOid;
 	const char *indexname;
+	Oid tablespace;
+	bits16 flags = 0;
+
+	indexname = chunk_index_choose_name(get_rel_name(RelationGetRelid(chunkrel)),
+										get_rel_name(RelationGetRelid(template_indexrel)),
+										get_rel_namespace(RelationGetRelid(chunkrel)));
+	if (OidIsValid(index_tablespace))
+		tablespace = index_tablespace;
+	else
+		tablespace = ts_chunk_index_get_tablespace(hypertable_id, template_indexrel, chunkrel);
+
+	/* assign flags for index creation and constraint creation */
+	if (isconstraint)
+		flags |= INDEX_CREATE_ADD_CONSTRAINT;
+	if (template_indexrel->rd_index->indisprimary)
+		flags |= INDEX_CREATE_IS_PRIMARY;
+
+	return chunk_index_create_relation(template_indexrel,
+									   chunkrel,
+									   indexinfo,
+									   indexname,
+									   tablespace,
+									   flags,
+									   0);
+}
+
+/*
+ * Create the index relation of a chunk index from the template index and the
+ * IndexInfo that is already adjusted to the chunk.
+ */
+static Oid
+chunk_index_create_relation(Relation template_indexrel, Relation chunkrel, IndexInfo *indexinfo,
+							const char *indexname, Oid tablespace, bits16 flags,
+							bits16 constr_flags)
+{
+	Oid chunk_indexrelid = InvalidOid;
 	HeapTuple tuple;
 	bool isnull;
 	Datum reloptions;
 	Datum indclass;
 	oidvector *indclassoid;
 	List *colnames = create_index_colnames(template_indexrel);
-	Oid tablespace;
-	bits16 flags = 0;
 
 	tuple = SearchSysCache1(RELOID, ObjectIdGetDatum(RelationGetRelid(template_indexrel)));
 
@@ -264,20 +312,6 @@ ts_chunk_index_create_post_adjustment(int32 hypertable_id, Relation template_ind
 	Assert(!isnull);
 	indclassoid = (oidvector *) DatumGetPointer(indclass);
 
-	indexname = chunk_index_choose_name(get_rel_name(RelationGetRelid(chunkrel)),
-										get_rel_name(RelationGetRelid(template_indexrel)),
-										get_rel_namespace(RelationGetRelid(chunkrel)));
-	if (OidIsValid(index_tablespace))
-		tablespace = index_tablespace;
-	else
-		tablespace = ts_chunk_index_get_tablespace(hypertable_id, template_indexrel, chunkrel);
-
-	/* assign flags for index creation and constraint creation */
-	if (isconstraint)
-		flags |= INDEX_CREATE_ADD_CONSTRAINT;
-	if (template_indexrel->rd_index->indisprimary)
-		flags |= INDEX_CREATE_IS_PRIMARY;
-
 	chunk_indexrelid = index_create_compat(chunkrel,
 										   indexname,
 										   InvalidOid,
@@ -295,8 +329,7 @@ ts_chunk_index_create_post_adjustment(int32 hypertable_id, Relation template_ind
 										   NULL, /* stattargets */
 										   reloptions,
 										   flags,
-										   0,	  /* constr_flags constant and 0
-												   * for now */
+										   constr_flags,
 										   false, /* allow system table mods */
 										   false, /* is internal */
 										   NULL); /* constraintId */
@@ -306,6 +339,106 @@ ts_chunk_index_create_post_adjustment(int32 hypertable_id, Relation template_ind
 	return chunk_indexrelid;
 }
 
+/*
+ * Create a primary key, unique or exclusion constraint on a chunk, together
+ * with its index, from the index of the hypertable constraint.
+ *
+ * This does what ALTER TABLE ... ADD CONSTRAINT does with the definition of
+ * the hypertable constraint, but without deparsing the definition and parsing
+ * it again for every chunk. Returns InvalidOid, without creating anything, if
+ * the constraint needs the full ALTER TABLE treatment instead, e.g., because
+ * the columns of a primary key must be set NOT NULL first.
+ */
+Oid
+ts_chunk_index_create_for_constraint(Oid hypertable_relid, Oid chunk_relid,
+									 Form_pg_constraint ht_constraint, const char *constraint_name)
+{
+	Relation htrel;
+	Relation chunkrel;
+	Relation template_indexrel;
+	IndexInfo *indexinfo;
+	Oid chunk_indexrelid = InvalidOid;
+	bool isprimary;
+	bits16 flags = INDEX_CREATE_ADD_CONSTRAINT;
+	bits16 constr_flags = 0;
+	Oid tablespace = InvalidOid;
+
+	Assert(ht_constraint->contype == CONSTRAINT_PRIMARY ||
+		   ht_constraint->contype == CONSTRAINT_UNIQUE ||
+		   ht_constraint->contype == CONSTRAINT_EXCLUSION);
+	Assert(OidIsValid(ht_constraint->conindid));
+
+	htrel = table_open(hypertable_relid, AccessShareLock);
+	chunkrel = table_open(chunk_relid, AccessExclusiveLock);
+	template_indexrel = index_open(ht_constraint->conindid, AccessShareLock);
+	isprimary = template_indexrel->rd_index->indisprimary;
+
+	/*
+	 * Opclass options are not copied to chunk indexes, but they are part of
+	 * the constraint definition.
+	 */
+	for (int i = 0; i < IndexRelationGetNumberOfKeyAttributes(template_indexrel); i++)
+	{
+		if (get_attoptions(RelationGetRelid(template_indexrel), i + 1) != (Datum) 0)
+			goto done;
+	}
+
+	indexinfo = chunk_index_build_info(htrel, template_indexrel, chunkrel);
+
+	if (isprimary)
+	{
+		TupleDesc tupdesc = RelationGetDescr(chunkrel);
+
+		/* A chunk can only have one primary key */
+		RelationGetIndexList(chunkrel);
+		if (OidIsValid(chunkrel->rd_pkindex))
+			goto done;
+
+		for (int i = 0; i < indexinfo->ii_NumIndexKeyAttrs; i++)
+		{
+			AttrNumber attno = indexinfo->ii_IndexAttrNumbers[i];
+
+			if (attno <= 0 || !TupleDescAttr(tupdesc, AttrNumberGetAttrOffset(attno))->attnotnull)
+				goto done;
+		}
+
+		flags |= INDEX_CREATE_IS_PRIMARY;
+	}
+
+	if (ht_constraint->condeferrable)
+		constr_flags |= INDEX_CONSTR_CREATE_DEFERRABLE;
+	if (ht_constraint->condeferred)
+		constr_flags |= INDEX_CONSTR_CREATE_INIT_DEFERRED;
+
+	/*
+	 * The index of a primary key or unique constraint keeps the tablespace of
+	 * the hypertable index, otherwise it goes to the default tablespace like
+	 * with ALTER TABLE.
+	 */
+	if (ht_constraint->contype != CONSTRAINT_EXCLUSION)
+		tablespace = template_indexrel->rd_rel->reltablespace;
+	if (!OidIsValid(tablespace))
+		tablespace = GetDefaultTablespace(chunkrel->rd_rel->relpersistence, false);
+
+	chunk_indexrelid = chunk_index_create_relation(template_indexrel,
+												   chunkrel,
+												   indexinfo,
+												   constraint_name,
+												   tablespace,
+												   flags,
+												   constr_flags);
+
+	/* Make the new constraint visible */
+	CommandCounterIncrement();
+
+done:
+	index_close(template_indexrel, AccessShareLock);
+	table_close(chunkrel, NoLock);
+	table_close(htrel, AccessShareLock);
+
+	return chunk_indexrelid;
+}
+
 static bool
 chunk_index_insert_relation(Relation rel, int32 chunk_id, const char *chunk_index,
 							int32 hypertable_id, const char *parent_index)
@@ -386,11 +519,16 @@ chunk_index_create(Relation hypertable_rel, int32 hypertable_id, Relation hypert
 		return;
 	}
 
-	chunk_indexrelid = chunk_relation_index_create(hypertable_rel,
-												   hypertable_idxrel,
-												   chunkrel,
-												   false,
-												   index_tblspc);
+	/* The hypertable ID is known, so don't look it up for every index */
+	chunk_indexrelid =
+		ts_chunk_index_create_post_adjustment(hypertable_id,
+											  hypertable_idxrel,
+											  chunkrel,
+											  chunk_index_build_info(hypertable_rel,
+																	 hypertable_idxrel,
+																	 chunkrel),
+											  false,
+											  index_tblspc);
 
 	chunk_index_insert(chunk_id,
 					   get_rel_name(chunk_indexrelid),
@@ -776,6 +914,39 @@ ts_chunk_index_delete_by_chunk_id(int32 chunk_id, bool drop_index)
 								   &data);
 }
 
+/*
+ * Delete the index metadata of many chunks in one scan. The indexes are not
+ * dropped, so this is only for chunks whose tables are dropped afterwards,
+ * and the caller invalidates the hypertable cache entry of the chunks.
+ */
+int
+ts_chunk_index_delete_metadata_by_chunk_ids(const int32 *chunk_ids, int num_chunk_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(CHUNK_INDEX, RowExclusiveLock, CurrentMemoryContext);
+	int count = 0;
+
+	iterator.ctx.index =
+		catalog_get_index(ts_catalog_get(), CHUNK_INDEX, CHUNK_INDEX_CHUNK_ID_INDEX_NAME_IDX);
+	ts_scan_iterator_scan_key_init_int32_array(&iterator,
+											   Anum_chunk_index_chunk_id_index_name_idx_chunk_id,
+											   chunk_ids,
+											   num_chunk_ids);
+
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+
+		ts_catalog_delete_tid_without_invalidation(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+		count++;
+	}
+
+	if (count > 0)
+		CommandCounterIncrement();
+
+	return count;
+}
+
 static ScanTupleResult
 chunk_index_tuple_found(TupleInfo *ti, void *const data)
 {
@@ -7,6 +7,7 @@
 
 #include <postgres.h>
 #include <fmgr.h>
+#include <catalog/pg_constraint.h>
 #include <nodes/execnodes.h>
 #include <nodes/parsenodes.h>
 #include <utils/relcache.h>
@@ -38,6 +39,7 @@ extern TSDLLEXPORT void ts_chunk_index_create_all(int32 hypertable_id, Oid hyper
 extern TSDLLEXPORT void ts_chunk_index_move_all(Oid chunk_relid, Oid index_tblspc);
 extern int ts_chunk_index_delete(int32 chunk_id, const char *indexname, bool drop_index);
 extern int ts_chunk_index_delete_by_chunk_id(int32 chunk_id, bool drop_index);
+extern int ts_chunk_index_delete_metadata_by_chunk_ids(const int32 *chunk_ids, int num_chunk_ids);
 extern void ts_chunk_index_delete_by_name(const char *schema, const char *index_name,
 										  bool drop_index);
 extern int ts_chunk_index_rename(Chunk *chunk, Oid chunk_indexrelid, const char *new_name);
@@ -47,6 +49,9 @@ extern int ts_chunk_index_adjust_meta(int32 chunk_id, const char *ht_index_name,
 									  const char *old_name, const char *new_name);
 extern int ts_chunk_index_set_tablespace(Hypertable *ht, Oid hypertable_indexrelid,
 										 const char *tablespace);
+extern Oid ts_chunk_index_create_for_constraint(Oid hypertable_relid, Oid chunk_relid,
+												Form_pg_constraint ht_constraint,
+												const char *constraint_name);
 extern void ts_chunk_index_create_from_constraint(int32 hypertable_id, Oid hypertable_constraint,
 												  int32 chunk_id, Oid chunk_constraint);
 extern List *ts_chunk_index_get_mappings(Hypertable *ht, Oid hypertable_indexrelid);
@@ -7,6 +7,8 @@
 #include <catalog/namespace.h>
 #include <storage/lmgr.h>
 #include <utils/builtins.h>
+#include <utils/fmgroids.h>
+#include <utils/inval.h>
 #include <utils/syscache.h>
 
 #include "chunk.h"
@@ -17,58 +19,52 @@
 #include "guc.h"
 #include "hypercube.h"
 #include "hypertable.h"
+#include "hypertable_cache.h"
 #include "scan_iterator.h"
 #include "utils.h"
 
+static int
+int32_cmp(const void *left, const void *right)
+{
+	const int32 l = *((const int32 *) left);
+	const int32 r = *((const int32 *) right);
+
+	return (l > r) - (l < r);
+}
+
+static int
+slice_id_cmp(const void *key, const void *elem)
+{
+	const int32 id = *((const int32 *) key);
+	const DimensionSlice *slice = *((DimensionSlice *const *) elem);
+
+	return (id > slice->fd.id) - (id < slice->fd.id);
+}
+
 /*
- * Scan for chunks matching a query.
- *
- * Given a number of dimension slices that match a query (a vector of slices
- * is given for each dimension), find the chunks that reference one slice in
- * each of the given dimensions. The matching chunks are built across multiple
- * scans:
- *
- * 1. Dimensional chunk constraints
- * 2. Chunk metadata
- * 3. Additional chunk constraints
- * 4. Chunk data nodes
+ * Read the chunks with the given IDs from the "chunk" table, skipping the
+ * "dropped" chunks. The chunks are returned in ID order, without constraints
+ * and hypercubes, and the given IDs are replaced with the IDs of the returned
+ * chunks.
  *
- * For performance, try not to interleave scans of different metadata tables
- * in order to maintain data locality while scanning. Also, keep scanned
- * tables and indexes open until all the metadata is scanned for all chunks.
+ * If missing_ok is true, the chunks whose table doesn't exist anymore are
+ * skipped as well, otherwise this is an error.
  */
-Chunk **
-ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned int *num_chunks)
+static int
+chunk_scan_read_chunks(ScanIterator *chunk_it, const Hyperspace *hs, int32 *ids, int num_ids,
+					   bool missing_ok, Chunk **chunks, MemoryContext mcxt)
 {
-	MemoryContext work_mcxt =
-		AllocSetContextCreate(CurrentMemoryContext, "chunk-scan-work", ALLOCSET_DEFAULT_SIZES);
-	Chunk **locked_chunks = NULL;
-	int locked_chunk_count = 0;
-	ListCell *lc;
+	int num_found = 0;
+	TupleInfo *ti;
 
-	Assert(OidIsValid(hs->main_table_relid));
-	MemoryContext orig_mcxt = MemoryContextSwitchTo(work_mcxt);
+	if (num_ids == 0)
+		return 0;
 
-	/*
-	 * For each matching chunk, fill in the metadata from the "chunk" table.
-	 * Make sure to filter out "dropped" chunks.
-	 */
-	ScanIterator chunk_it = ts_chunk_scan_iterator_create(orig_mcxt);
-	locked_chunks =
-		(Chunk **) MemoryContextAlloc(orig_mcxt, sizeof(Chunk *) * list_length(chunk_ids));
-	foreach (lc, chunk_ids)
-	{
-		int chunk_id = lfirst_int(lc);
-
-		Assert(CurrentMemoryContext == work_mcxt);
+	ts_chunk_scan_iterator_set_chunk_ids(chunk_it, ids, num_ids);
+	ts_scan_iterator_start_or_restart_scan(chunk_it);
 
-		ts_chunk_scan_iterator_set_chunk_id(&chunk_it, chunk_id);
-		ts_scan_iterator_start_or_restart_scan(&chunk_it);
-		TupleInfo *ti = ts_scan_iterator_next(&chunk_it);
-		if (ti == NULL)
-		{
-			continue;
-		}
+	while ((ti = ts_scan_iterator_next(chunk_it)) != NULL)
+	{
 		bool isnull;
 		Datum datum = slot_getattr(ti->slot, Anum_chunk_dropped, &isnull);
 		const bool is_dropped = isnull ? false : DatumGetBool(datum);
@@ -77,95 +73,138 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 			continue;
 		}
 
-		/* We found a chunk that is not dropped. First, try to lock it. */
-		Name schema_name = DatumGetName(slot_getattr(ti->slot, Anum_chunk_schema_name, &isnull));
-		Assert(!isnull);
-		Name table_name = DatumGetName(slot_getattr(ti->slot, Anum_chunk_table_name, &isnull));
-		Assert(!isnull);
-
-		Oid chunk_reloid = ts_get_relation_relid(NameStr(*schema_name),
-												 NameStr(*table_name),
-												 /* return_invalid = */ false);
-		Assert(OidIsValid(chunk_reloid));
+		Chunk *chunk = MemoryContextAllocZero(mcxt, sizeof(Chunk));
 
-		/* Only one chunk should match */
-		Assert(ts_scan_iterator_next(&chunk_it) == NULL);
-
-		DEBUG_WAITPOINT("hypertable_expansion_before_lock_chunk");
-		if (!ts_chunk_lock_if_exists(chunk_reloid, AccessShareLock))
+		ts_chunk_formdata_fill(&chunk->fd, ti);
+		chunk->table_id = ts_get_relation_relid(NameStr(chunk->fd.schema_name),
+												NameStr(chunk->fd.table_name),
+												/* return_invalid = */ missing_ok);
+		if (!OidIsValid(chunk->table_id))
 		{
+			pfree(chunk);
 			continue;
 		}
 
-		/*
-		 * Now after we have locked the chunk, we have to reread its metadata.
-		 * It might have been modified concurrently by decompression, for
-		 * example.
-		 */
-		ts_chunk_scan_iterator_set_chunk_id(&chunk_it, chunk_id);
-		ts_scan_iterator_start_or_restart_scan(&chunk_it);
-		ti = ts_scan_iterator_next(&chunk_it);
-		Assert(ti != NULL);
-		Chunk *chunk = MemoryContextAllocZero(orig_mcxt, sizeof(Chunk));
-
-		ts_chunk_formdata_fill(&chunk->fd, ti);
-
 		chunk->constraints = NULL;
 		chunk->cube = NULL;
 		chunk->hypertable_relid = hs->main_table_relid;
-		chunk->table_id = chunk_reloid;
 
-		locked_chunks[locked_chunk_count] = chunk;
-		locked_chunk_count++;
-
-		/* Only one chunk should match */
-		Assert(ts_scan_iterator_next(&chunk_it) == NULL);
+		Assert(num_found == 0 || ids[num_found - 1] < chunk->fd.id);
+		ids[num_found] = chunk->fd.id;
+		chunks[num_found] = chunk;
+		num_found++;
 	}
 
-	ts_scan_iterator_close(&chunk_it);
+	return num_found;
+}
+
+/*
+ * Fill in the relation info, the constraints and the hypercubes of the given
+ * chunks, which are ordered by chunk ID. The IDs of the chunks are given
+ * separately for looking up the chunk of a catalog tuple.
+ *
+ * If missing_ok is true, returns false for chunks without dimension slices
+ * instead of raising an error.
+ */
+static bool
+chunk_scan_fill_chunks(Chunk **chunks, const int32 *ids, int num_chunks, bool missing_ok,
+					   MemoryContext orig_mcxt, MemoryContext work_mcxt)
+{
+	TupleInfo *ti;
 
-	Assert(locked_chunk_count == 0 || locked_chunks != NULL);
-	Assert(locked_chunk_count <= list_length(chunk_ids));
 	Assert(CurrentMemoryContext == work_mcxt);
 
-	for (int i = 0; i < locked_chunk_count; i++)
+	for (int i = 0; i < num_chunks; i++)
 	{
-		Chunk *chunk = locked_chunks[i];
+		Chunk *chunk = chunks[i];
 
+		Assert(ids[i] == chunk->fd.id);
 		ts_get_rel_info(chunk->table_id, &chunk->amoid, &chunk->relkind);
 
 		Assert(OidIsValid(chunk->amoid) || chunk->fd.osm_chunk);
+
+		chunk->constraints = ts_chunk_constraints_alloc(/* size_hint = */ 0, orig_mcxt);
 	}
 
 	/*
-	 * Fetch the chunk constraints.
+	 * Fetch the chunk constraints of all the chunks.
 	 */
 	ScanIterator constr_it = ts_chunk_constraint_scan_iterator_create(orig_mcxt);
 
-	for (int i = 0; i < locked_chunk_count; i++)
+	if (num_chunks > 0)
 	{
-		Chunk *chunk = locked_chunks[i];
-		chunk->constraints = ts_chunk_constraints_alloc(/* size_hint = */ 0, orig_mcxt);
-
-		ts_chunk_constraint_scan_iterator_set_chunk_id(&constr_it, chunk->fd.id);
-		ts_scan_iterator_start_or_restart_scan(&constr_it);
+		ts_chunk_constraint_scan_iterator_set_chunk_ids(&constr_it, ids, num_chunks);
+		ts_scan_iterator_start_scan(&constr_it);
 
-		while (ts_scan_iterator_next(&constr_it) != NULL)
+		while ((ti = ts_scan_iterator_next(&constr_it)) != NULL)
 		{
-			TupleInfo *constr_ti = ts_scan_iterator_tuple_info(&constr_it);
-			ts_chunk_constraints_add_from_tuple(chunk->constraints, constr_ti);
+			bool isnull;
+			const int32 chunk_id =
+				DatumGetInt32(slot_getattr(ti->slot, Anum_chunk_constraint_chunk_id, &isnull));
+			Assert(!isnull);
+
+			const int32 *id = bsearch(&chunk_id, ids, num_chunks, sizeof(int32), int32_cmp);
+			Assert(id != NULL);
+
+			ts_chunk_constraints_add_from_tuple(chunks[id - ids]->constraints, ti);
 		}
 	}
 	ts_scan_iterator_close(&constr_it);
 
 	/*
-	 * Build hypercubes for the chunks by finding and combining the dimension
-	 * slices that match the chunk constraints.
+	 * Fetch the dimension slices referenced by the chunk constraints. The
+	 * slices are often shared between chunks, and the index scan returns each
+	 * of them only once. Don't have to lock them because the chunks are
+	 * locked or their changes invalidate the chunk map.
 	 */
-	ScanIterator slice_iterator = ts_dimension_slice_scan_iterator_create(NULL, orig_mcxt);
-	for (int chunk_index = 0; chunk_index < locked_chunk_count; chunk_index++)
+	int num_slice_ids = 0;
+
+	for (int i = 0; i < num_chunks; i++)
+		num_slice_ids += chunks[i]->constraints->num_dimension_constraints;
+
+	int32 *slice_ids = palloc(sizeof(int32) * Max(num_slice_ids, 1));
+	DimensionSlice **slices = palloc(sizeof(DimensionSlice *) * Max(num_slice_ids, 1));
+	int num_slices = 0;
+
+	num_slice_ids = 0;
+	for (int i = 0; i < num_chunks; i++)
+	{
+		ChunkConstraints *constraints = chunks[i]->constraints;
+
+		for (int j = 0; j < constraints->num_constraints; j++)
+		{
+			if (is_dimension_constraint(&constraints->constraints[j]))
+				slice_ids[num_slice_ids++] = constraints->constraints[j].fd.dimension_slice_id;
+		}
+	}
+
+	ScanIterator slice_iterator = ts_dimension_slice_scan_iterator_create(NULL, work_mcxt);
+
+	if (num_slice_ids > 0)
 	{
-		Chunk *chunk = locked_chunks[chunk_index];
+		ts_dimension_slice_scan_iterator_set_slice_ids(&slice_iterator,
+													   slice_ids,
+													   num_slice_ids,
+													   /* tuplock = */ NULL);
+		ts_scan_iterator_start_scan(&slice_iterator);
+
+		while ((ti = ts_scan_iterator_next(&slice_iterator)) != NULL)
+		{
+			Assert(num_slices < num_slice_ids);
+			slices[num_slices] = ts_dimension_slice_from_tuple(ti);
+			Assert(num_slices == 0 || slices[num_slices - 1]->fd.id < slices[num_slices]->fd.id);
+			num_slices++;
+		}
+	}
+	ts_scan_iterator_close(&slice_iterator);
+
+	/*
+	 * Build hypercubes for the chunks by combining the dimension slices that
+	 * match the chunk constraints.
+	 */
+	for (int chunk_index = 0; chunk_index < num_chunks; chunk_index++)
+	{
+		Chunk *chunk = chunks[chunk_index];
 		ChunkConstraints *constraints = chunk->constraints;
 		MemoryContextSwitchTo(orig_mcxt);
 		Hypercube *cube = ts_hypercube_alloc(constraints->num_dimension_constraints);
@@ -179,24 +218,20 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 				continue;
 			}
 
-			/*
-			 * Find the slice by id. Don't have to lock it because the chunk is
-			 * locked.
-			 */
 			const int slice_id = constraint->fd.dimension_slice_id;
-			DimensionSlice *slice_ptr =
-				ts_dimension_slice_scan_iterator_get_by_id(&slice_iterator,
-														   slice_id,
-														   /* tuplock = */ NULL);
+			DimensionSlice **slice_ptr =
+				bsearch(&slice_id, slices, num_slices, sizeof(DimensionSlice *), slice_id_cmp);
 			if (slice_ptr == NULL)
 			{
+				if (missing_ok)
+					return false;
 				elog(ERROR, "dimension slice %d is not found", slice_id);
 			}
 			MemoryContextSwitchTo(orig_mcxt);
-			DimensionSlice *slice_copy = ts_dimension_slice_create(slice_ptr->fd.dimension_id,
-																   slice_ptr->fd.range_start,
-																   slice_ptr->fd.range_end);
-			slice_copy->fd.id = slice_ptr->fd.id;
+			DimensionSlice *slice_copy = ts_dimension_slice_create((*slice_ptr)->fd.dimension_id,
+																   (*slice_ptr)->fd.range_start,
+																   (*slice_ptr)->fd.range_end);
+			slice_copy->fd.id = (*slice_ptr)->fd.id;
 			MemoryContextSwitchTo(work_mcxt);
 			Assert(cube->capacity > cube->num_slices);
 			cube->slices[cube->num_slices++] = slice_copy;
@@ -204,6 +239,8 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 
 		if (cube->num_slices == 0)
 		{
+			if (missing_ok)
+				return false;
 			ereport(ERROR,
 					(errcode(ERRCODE_INTERNAL_ERROR),
 					 errmsg("chunk %s has no dimension slices", get_rel_name(chunk->table_id))));
@@ -212,7 +249,96 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 		ts_hypercube_slice_sort(cube);
 		chunk->cube = cube;
 	}
-	ts_scan_iterator_close(&slice_iterator);
+
+	return true;
+}
+
+/*
+ * Scan for chunks matching a query.
+ *
+ * Given the IDs of the chunks that match a query, build the chunks from the
+ * metadata in the following tables:
+ *
+ * 1. Chunk metadata
+ * 2. Chunk constraints
+ * 3. Dimension slices
+ *
+ * Each of the tables is read with a single index scan that looks up all the
+ * IDs at once ("id = ANY(ids)"), instead of one index scan per chunk. The
+ * scans return the tuples in ID order, so the chunks are returned ordered by
+ * chunk ID and the tuples are matched to their chunks with a binary search.
+ *
+ * For performance, try not to interleave scans of different metadata tables
+ * in order to maintain data locality while scanning.
+ */
+Chunk **
+ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned int *num_chunks)
+{
+	MemoryContext work_mcxt =
+		AllocSetContextCreate(CurrentMemoryContext, "chunk-scan-work", ALLOCSET_DEFAULT_SIZES);
+	Chunk **locked_chunks = NULL;
+	int locked_chunk_count = 0;
+	int num_ids = 0;
+	ListCell *lc;
+
+	Assert(OidIsValid(hs->main_table_relid));
+	MemoryContext orig_mcxt = MemoryContextSwitchTo(work_mcxt);
+
+	locked_chunks =
+		(Chunk **) MemoryContextAlloc(orig_mcxt, sizeof(Chunk *) * list_length(chunk_ids));
+
+	int32 *ids = palloc(sizeof(int32) * list_length(chunk_ids));
+	Chunk **found_chunks = palloc(sizeof(Chunk *) * list_length(chunk_ids));
+
+	foreach (lc, chunk_ids)
+		ids[num_ids++] = lfirst_int(lc);
+
+	/*
+	 * Find the matching chunks in the "chunk" table and lock them.
+	 */
+	ScanIterator chunk_it = ts_chunk_scan_iterator_create(orig_mcxt);
+	int num_found = chunk_scan_read_chunks(&chunk_it,
+										   hs,
+										   ids,
+										   num_ids,
+										   /* missing_ok = */ false,
+										   found_chunks,
+										   work_mcxt);
+	int num_locked = 0;
+
+	for (int i = 0; i < num_found; i++)
+	{
+		DEBUG_WAITPOINT("hypertable_expansion_before_lock_chunk");
+		if (!ts_chunk_lock_if_exists(found_chunks[i]->table_id, AccessShareLock))
+		{
+			continue;
+		}
+
+		ids[num_locked++] = ids[i];
+	}
+
+	/*
+	 * Now after we have locked the chunks, we have to reread their metadata.
+	 * It might have been modified concurrently by decompression, for example.
+	 */
+	locked_chunk_count = chunk_scan_read_chunks(&chunk_it,
+												hs,
+												ids,
+												num_locked,
+												/* missing_ok = */ false,
+												locked_chunks,
+												orig_mcxt);
+	ts_scan_iterator_close(&chunk_it);
+
+	Assert(locked_chunk_count == num_locked);
+	Assert(locked_chunk_count <= list_length(chunk_ids));
+
+	chunk_scan_fill_chunks(locked_chunks,
+						   ids,
+						   locked_chunk_count,
+						   /* missing_ok = */ false,
+						   orig_mcxt,
+						   work_mcxt);
 
 	Assert(CurrentMemoryContext == work_mcxt);
 	MemoryContextSwitchTo(orig_mcxt);
@@ -230,3 +356,206 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 	Assert(*num_chunks == 0 || locked_chunks != NULL);
 	return locked_chunks;
 }
+
+/*
+ * Build the chunk map of a hypertable in the given memory context.
+ *
+ * The chunks are not locked, so the map stays valid only as long as nothing
+ * changes the chunks, which the hypertable cache tracks. Returns NULL if the
+ * catalog is inconsistent, so that the errors are raised only when the
+ * affected chunks are actually used.
+ */
+ChunkMap *
+ts_chunk_map_build(const Hypertable *ht, MemoryContext mcxt)
+{
+	MemoryContext work_mcxt =
+		AllocSetContextCreate(CurrentMemoryContext, "chunk-map-work", ALLOCSET_DEFAULT_SIZES);
+	MemoryContext orig_mcxt = MemoryContextSwitchTo(work_mcxt);
+	List *chunk_ids = ts_chunk_get_chunk_ids_by_hypertable_id(ht->fd.id);
+	int num_ids = 0;
+	ListCell *lc;
+
+	list_sort(chunk_ids, list_int_cmp);
+
+	int32 *ids = palloc(sizeof(int32) * list_length(chunk_ids));
+
+	foreach (lc, chunk_ids)
+		ids[num_ids++] = lfirst_int(lc);
+
+	ChunkMap *map = MemoryContextAllocZero(mcxt, sizeof(ChunkMap));
+	map->chunks = MemoryContextAlloc(mcxt, sizeof(Chunk *) * Max(num_ids, 1));
+	map->osm_chunk_id = INVALID_CHUNK_ID;
+	map->exclusion_cache = MemoryContextAllocZero(mcxt, sizeof(ChunkExclusionCache));
+	map->exclusion_cache->mcxt = mcxt;
+
+	ScanIterator chunk_it = ts_chunk_scan_iterator_create(work_mcxt);
+	map->num_chunks = chunk_scan_read_chunks(&chunk_it,
+											 ht->space,
+											 ids,
+											 num_ids,
+											 /* missing_ok = */ true,
+											 map->chunks,
+											 mcxt);
+	ts_scan_iterator_close(&chunk_it);
+
+	if (!chunk_scan_fill_chunks(map->chunks,
+								ids,
+								map->num_chunks,
+								/* missing_ok = */ true,
+								mcxt,
+								work_mcxt))
+		map = NULL;
+
+	for (int i = 0; map != NULL && i < map->num_chunks; i++)
+	{
+		if (map->chunks[i]->fd.osm_chunk)
+			map->osm_chunk_id = map->chunks[i]->fd.id;
+	}
+
+	if (map != NULL)
+	{
+		/* The chunks that were read are a sorted subset of the IDs */
+		int i = 0;
+
+		while (i < map->num_chunks && map->chunks[i]->fd.id == ids[i])
+			i++;
+
+		if (i < num_ids)
+			map->new_chunk_id_start = ids[i];
+		else
+			map->new_chunk_id_start = num_ids > 0 ? ids[num_ids - 1] + 1 : 1;
+	}
+
+	MemoryContextSwitchTo(orig_mcxt);
+	MemoryContextDelete(work_mcxt);
+
+	return map;
+}
+
+/*
+ * Find a chunk of the chunk map by ID. NULL if the chunk is dropped or
+ * doesn't belong to the hypertable.
+ */
+const Chunk *
+ts_chunk_map_get_chunk(const ChunkMap *map, int32 chunk_id)
+{
+	int low = 0;
+	int high = map->num_chunks - 1;
+
+	while (low <= high)
+	{
+		const int middle = low + (high - low) / 2;
+		const Chunk *chunk = map->chunks[middle];
+
+		if (chunk->fd.id == chunk_id)
+			return chunk;
+
+		if (chunk->fd.id < chunk_id)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	return NULL;
+}
+
+/*
+ * Check if the catalog has chunks of the hypertable that are not in the chunk
+ * map.
+ *
+ * The invalidations of a committed transaction are only sent after its
+ * changes are already visible, so a query can still find the old map after a
+ * new chunk is visible to it. Since the chunks of a hypertable are created
+ * while holding a self-conflicting lock on it, their IDs become visible in
+ * increasing order, and only the IDs from new_chunk_id_start on need to be
+ * checked.
+ */
+bool
+ts_chunk_map_has_new_chunks(const Hypertable *ht, const ChunkMap *map)
+{
+	ScanIterator it = ts_scan_iterator_create(CHUNK, AccessShareLock, CurrentMemoryContext);
+	bool found = false;
+
+	it.ctx.index = catalog_get_index(ts_catalog_get(), CHUNK, CHUNK_ID_INDEX);
+	ts_scan_iterator_scan_key_init(&it,
+								   Anum_chunk_idx_id,
+								   BTGreaterEqualStrategyNumber,
+								   F_INT4GE,
+								   Int32GetDatum(map->new_chunk_id_start));
+
+	ts_scanner_foreach(&it)
+	{
+		TupleTableSlot *slot = ts_scan_iterator_slot(&it);
+		bool isnull;
+		int32 hypertable_id = DatumGetInt32(slot_getattr(slot, Anum_chunk_hypertable_id, &isnull));
+		bool dropped = DatumGetBool(slot_getattr(slot, Anum_chunk_dropped, &isnull));
+		int32 chunk_id = DatumGetInt32(slot_getattr(slot, Anum_chunk_id, &isnull));
+
+		if (hypertable_id == ht->fd.id && !dropped && ts_chunk_map_get_chunk(map, chunk_id) == NULL)
+		{
+			found = true;
+			break;
+		}
+	}
+
+	ts_scan_iterator_close(&it);
+
+	return found;
+}
+
+/*
+ * Get the chunks with the given IDs from the chunk map of a hypertable and lock
+ * them, as ts_chunk_scan_by_chunk_ids() does from the catalog.
+ *
+ * Locking a chunk waits for the concurrent changes of the chunk to commit, but
+ * the map doesn't reflect these changes. If the chunks changed, returns NULL,
+ * and the caller has to find the chunks in the catalog instead.
+ */
+Chunk **
+ts_chunk_scan_from_chunk_map(const Hypertable *ht, const ChunkMap *map, const List *chunk_ids,
+							 unsigned int *num_chunks)
+{
+	const Chunk **found_chunks = palloc(sizeof(Chunk *) * list_length(chunk_ids));
+	int num_found = 0;
+	ListCell *lc;
+
+	foreach (lc, chunk_ids)
+	{
+		const Chunk *chunk = ts_chunk_map_get_chunk(map, lfirst_int(lc));
+
+		if (chunk == NULL)
+		{
+			continue;
+		}
+
+		DEBUG_WAITPOINT("hypertable_expansion_before_lock_chunk");
+		if (!ts_chunk_lock_if_exists(chunk->table_id, AccessShareLock))
+		{
+			continue;
+		}
+
+		found_chunks[num_found++] = chunk;
+	}
+
+	/*
+	 * The invalidations are not processed when locking a chunk that is already
+	 * locked by this transaction, but the chunk could still have been changed
+	 * by a transaction that doesn't need a conflicting lock.
+	 */
+	AcceptInvalidationMessages();
+
+	if (!ts_hypertable_cache_chunk_map_is_current(ht, map))
+	{
+		pfree(found_chunks);
+		return NULL;
+	}
+
+	Chunk **chunks = palloc(sizeof(Chunk *) * Max(num_found, 1));
+
+	for (int i = 0; i < num_found; i++)
+		chunks[i] = ts_chunk_copy(found_chunks[i]);
+
+	pfree(found_chunks);
+	*num_chunks = num_found;
+	return chunks;
+}
@@ -9,5 +9,45 @@
 
 #include "hypertable.h"
 
+/*
+ * The results of chunk exclusion on a chunk map, so that queries with the same
+ * restrictions don't have to check all the chunks again. The cache lives as
+ * long as the chunk map and is filled in by hypertable_restrict_info.c.
+ */
+typedef struct ChunkExclusionCache
+{
+	MemoryContext mcxt;
+	/* The sorted slice boundaries of the restricted open dimensions */
+	List *dimension_bounds;
+	/* The cached results, most recently used first */
+	List *results;
+} ChunkExclusionCache;
+
+/*
+ * The chunks of a hypertable that are not dropped, ordered by chunk ID, with
+ * their constraints and hypercubes. The map is kept in the hypertable cache,
+ * so that planning queries on hypertables with many chunks doesn't have to
+ * read and join the chunk catalog tables every time.
+ */
+typedef struct ChunkMap
+{
+	int num_chunks;
+	int32 osm_chunk_id;
+	/*
+	 * Chunk IDs from which on new chunks of the hypertable can appear in the
+	 * catalog: the IDs after the last chunk, or from the first dropped chunk
+	 * on, since a dropped chunk can be created again with the same ID. See
+	 * ts_chunk_map_has_new_chunks().
+	 */
+	int32 new_chunk_id_start;
+	Chunk **chunks;
+	ChunkExclusionCache *exclusion_cache;
+} ChunkMap;
+
 extern Chunk **ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids,
 										  unsigned int *num_chunks);
+extern ChunkMap *ts_chunk_map_build(const Hypertable *ht, MemoryContext mcxt);
+extern const Chunk *ts_chunk_map_get_chunk(const ChunkMap *map, int32 chunk_id);
+extern bool ts_chunk_map_has_new_chunks(const Hypertable *ht, const ChunkMap *map);
+extern Chunk **ts_chunk_scan_from_chunk_map(const Hypertable *ht, const ChunkMap *map,
+											const List *chunk_ids, unsigned int *num_chunks);
@@ -384,6 +384,19 @@ get_reindex_options(ReindexStmt *stmt)
 	make_new_heap(tableOid, tableSpace, relpersistence, ExclusiveLock)
 #endif
 
+/*
+ * PG15 added the keep_buf argument to heap_fetch(). Before PG15, the buffer
+ * is always released when the tuple is not visible, which is the same as
+ * keep_buf = false.
+ */
+#if PG15_GE
+#define heap_fetch_compat(relation, snapshot, tuple, userbuf, keep_buf)                            \
+	heap_fetch(relation, snapshot, tuple, userbuf, keep_buf)
+#else
+#define heap_fetch_compat(relation, snapshot, tuple, userbuf, keep_buf)                            \
+	(AssertMacro(!(keep_buf)), heap_fetch(relation, snapshot, tuple, userbuf))
+#endif
+
 /*
  * PostgreSQL 15 removed "utils/int8.h" header and change the "scanint8"
  * function to "pg_strtoint64" in "utils/builtins.h".
@@ -93,6 +93,8 @@ CROSSMODULE_WRAPPER(cagg_try_repair);
 
 CROSSMODULE_WRAPPER(chunk_freeze_chunk);
 CROSSMODULE_WRAPPER(chunk_unfreeze_chunk);
+CROSSMODULE_WRAPPER(chunk_merge_chunks);
+CROSSMODULE_WRAPPER(chunk_split_chunk);
 
 CROSSMODULE_WRAPPER(chunk_create_empty_table);
 
@@ -403,6 +405,8 @@ TSDLLEXPORT CrossModuleFunctions ts_cm_functions_default = {
 	.create_chunk = error_no_default_fn_pg_community,
 	.chunk_freeze_chunk = error_no_default_fn_pg_community,
 	.chunk_unfreeze_chunk = error_no_default_fn_pg_community,
+	.chunk_merge_chunks = error_no_default_fn_pg_community,
+	.chunk_split_chunk = error_no_default_fn_pg_community,
 	.chunk_create_empty_table = error_no_default_fn_pg_community,
 	.recompress_chunk_segmentwise = error_no_default_fn_pg_community,
 	.get_compressed_chunk_index_for_recompression = error_no_default_fn_pg_community,
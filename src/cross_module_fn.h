@@ -157,6 +157,8 @@ typedef struct CrossModuleFunctions
 	PGFunction chunk_create_empty_table;
 	PGFunction chunk_freeze_chunk;
 	PGFunction chunk_unfreeze_chunk;
+	PGFunction chunk_merge_chunks;
+	PGFunction chunk_split_chunk;
 	PGFunction recompress_chunk_segmentwise;
 	PGFunction get_compressed_chunk_index_for_recompression;
 	void (*preprocess_query_tsl)(Query *parse, int *cursor_opts);
@@ -583,6 +583,45 @@ ts_dimension_slice_scan_iterator_set_range(ScanIterator *it, int32 dimension_id,
 	return it->ctx.nkeys;
 }
 
+static bool
+int64_cmp_strategy(int64 value, StrategyNumber strategy, int64 arg)
+{
+	switch (strategy)
+	{
+		case InvalidStrategy:
+			return true;
+		case BTLessStrategyNumber:
+			return value < arg;
+		case BTLessEqualStrategyNumber:
+			return value <= arg;
+		case BTEqualStrategyNumber:
+			return value == arg;
+		case BTGreaterEqualStrategyNumber:
+			return value >= arg;
+		case BTGreaterStrategyNumber:
+			return value > arg;
+		default:
+			elog(ERROR, "invalid btree strategy %d", strategy);
+			pg_unreachable();
+	}
+}
+
+/*
+ * Check if the slice matches the range conditions of
+ * ts_dimension_slice_scan_iterator_set_range(), without a catalog scan.
+ */
+bool
+ts_dimension_slice_matches_range(const DimensionSlice *slice, StrategyNumber start_strategy,
+								 int64 start_value, StrategyNumber end_strategy, int64 end_value)
+{
+	/* range_end is exclusive, see above */
+	if (end_strategy != InvalidStrategy && end_value != PG_INT64_MAX)
+		end_value = REMAP_LAST_COORDINATE(end_value + 1);
+
+	return int64_cmp_strategy(slice->fd.range_start, start_strategy, start_value) &&
+		   int64_cmp_strategy(slice->fd.range_end, end_strategy, end_value);
+}
+
 /*
  * Look for all dimension slices where (lower_bound, upper_bound) of the dimension_slice contains
  * the given (start_value, end_value) range
@@ -833,6 +872,40 @@ ts_dimension_slice_delete_by_id(int32 dimension_slice_id, bool delete_constraint
 	return true;
 }
 
+/*
+ * Delete many dimension slices in one scan. The slices should already be
+ * locked by the caller, which also has to invalidate the cache entries of the
+ * hypertables of the slices.
+ */
+int
+ts_dimension_slice_delete_by_ids(const int32 *dimension_slice_ids, int num_slice_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(DIMENSION_SLICE, RowExclusiveLock, CurrentMemoryContext);
+	CatalogSecurityContext sec_ctx;
+	int count = 0;
+
+	ts_dimension_slice_scan_iterator_set_slice_ids(&iterator,
+												   dimension_slice_ids,
+												   num_slice_ids,
+												   NULL);
+
+	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+
+		ts_catalog_delete_tid_without_invalidation(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+		count++;
+	}
+	ts_catalog_restore_user(&sec_ctx);
+
+	if (count > 0)
+		CommandCounterIncrement();
+
+	return count;
+}
+
 static ScanTupleResult
 dimension_slice_fill(TupleInfo *ti, void *data)
 {
@@ -982,6 +1055,24 @@ ts_dimension_slice_scan_iterator_set_slice_id(ScanIterator *it, int32 slice_id,
 	it->ctx.tuplock = tuplock;
 }
 
+/*
+ * Set the iterator to scan for all the given slice IDs in one index scan. The
+ * slices are returned in ID order, and only once even if an ID is given
+ * several times.
+ */
+void
+ts_dimension_slice_scan_iterator_set_slice_ids(ScanIterator *it, const int32 *slice_ids,
+											   int num_slice_ids, const ScanTupLock *tuplock)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(), DIMENSION_SLICE, DIMENSION_SLICE_ID_IDX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_init_int32_array(it,
+											   Anum_dimension_slice_id_idx_id,
+											   slice_ids,
+											   num_slice_ids);
+	it->ctx.tuplock = tuplock;
+}
+
 DimensionSlice *
 ts_dimension_slice_scan_iterator_get_by_id(ScanIterator *it, int32 slice_id,
 										   const ScanTupLock *tuplock)
@@ -1216,12 +1307,17 @@ ts_dimension_slice_nth_latest_slice(int32 dimension_id, int n)
 	return ret;
 }
 
-int32
-ts_dimension_slice_oldest_valid_chunk_for_reorder(int32 job_id, int32 dimension_id,
-												  StrategyNumber start_strategy, int64 start_value,
-												  StrategyNumber end_strategy, int64 end_value)
+/*
+ * Get the IDs of the oldest chunks that are valid for reordering, at most
+ * numchunks of them if numchunks is positive.
+ */
+List *
+ts_dimension_slice_get_chunkids_to_reorder(int32 job_id, int32 dimension_id,
+										   StrategyNumber start_strategy, int64 start_value,
+										   StrategyNumber end_strategy, int64 end_value,
+										   int32 numchunks)
 {
-	int32 result_chunk_id = -1;
+	List *result_chunk_ids = NIL;
 	ScanIterator it = ts_dimension_slice_scan_iterator_create(NULL, CurrentMemoryContext);
 	bool done = false;
 
@@ -1259,16 +1355,19 @@ ts_dimension_slice_oldest_valid_chunk_for_reorder(int32 job_id, int32 dimension_
 				ts_chunk_get_compression_status(chunk_id) == CHUNK_COMPRESS_NONE)
 			{
 				/* Save the chunk_id */
-				result_chunk_id = chunk_id;
-				done = true;
-				break;
+				result_chunk_ids = lappend_int(result_chunk_ids, chunk_id);
+				if (numchunks > 0 && list_length(result_chunk_ids) >= numchunks)
+				{
+					done = true;
+					break;
+				}
 			}
 		}
 	}
 
 	ts_scan_iterator_close(&it);
 
-	return result_chunk_id;
+	return result_chunk_ids;
 }
 
 List *
@@ -71,6 +71,7 @@ extern DimensionVec *ts_dimension_slice_scan_by_dimension_before_point(int32 dim
 																	   MemoryContext mctx);
 extern int ts_dimension_slice_delete_by_dimension_id(int32 dimension_id, bool delete_constraints);
 extern int ts_dimension_slice_delete_by_id(int32 dimension_slice_id, bool delete_constraints);
+extern int ts_dimension_slice_delete_by_ids(const int32 *dimension_slice_ids, int num_slice_ids);
 extern TSDLLEXPORT DimensionSlice *ts_dimension_slice_create(int dimension_id, int64 range_start,
 															 int64 range_end);
 extern TSDLLEXPORT DimensionSlice *ts_dimension_slice_copy(const DimensionSlice *original);
@@ -86,9 +87,9 @@ extern int ts_dimension_slice_cmp(const DimensionSlice *left, const DimensionSli
 extern int ts_dimension_slice_cmp_coordinate(const DimensionSlice *slice, int64 coord);
 
 extern TSDLLEXPORT DimensionSlice *ts_dimension_slice_nth_latest_slice(int32 dimension_id, int n);
-extern TSDLLEXPORT int32 ts_dimension_slice_oldest_valid_chunk_for_reorder(
+extern TSDLLEXPORT List *ts_dimension_slice_get_chunkids_to_reorder(
 	int32 job_id, int32 dimension_id, StrategyNumber start_strategy, int64 start_value,
-	StrategyNumber end_strategy, int64 end_value);
+	StrategyNumber end_strategy, int64 end_value, int32 numchunks);
 extern TSDLLEXPORT List *ts_dimension_slice_get_chunkids_to_compress(
 	int32 dimension_id, StrategyNumber start_strategy, int64 start_value,
 	StrategyNumber end_strategy, int64 end_value, bool compress, bool recompress, int32 numchunks);
@@ -98,6 +99,10 @@ extern ScanIterator ts_dimension_slice_scan_iterator_create(const ScanTupLock *t
 															MemoryContext result_mcxt);
 extern void ts_dimension_slice_scan_iterator_set_slice_id(ScanIterator *it, int32 slice_id,
 														  const ScanTupLock *tuplock);
+extern void ts_dimension_slice_scan_iterator_set_slice_ids(ScanIterator *it,
+														   const int32 *slice_ids,
+														   int num_slice_ids,
+														   const ScanTupLock *tuplock);
 extern DimensionSlice *ts_dimension_slice_scan_iterator_get_by_id(ScanIterator *it, int32 slice_id,
 																  const ScanTupLock *tuplock);
 
@@ -105,6 +110,9 @@ extern int ts_dimension_slice_scan_iterator_set_range(ScanIterator *it, int32 di
 													  StrategyNumber start_strategy,
 													  int64 start_value,
 													  StrategyNumber end_strategy, int64 end_value);
+extern bool ts_dimension_slice_matches_range(const DimensionSlice *slice,
+											 StrategyNumber start_strategy, int64 start_value,
+											 StrategyNumber end_strategy, int64 end_value);
 
 extern bool ts_osm_chunk_range_overlaps(int32 osm_dimension_slice_id, int32 dimension_id,
 										int64 range_start, int64 range_end);
@@ -26,6 +26,7 @@
 
 static HeapTuple relation_get_fk_constraint(Oid conrelid, Oid confrelid);
 static List *relation_get_referencing_fk(Oid reloid);
+static bool relation_has_referencing_fk_triggers(Relation rel);
 static Oid get_fk_index(Relation rel, int nkeys, AttrNumber *confkeys);
 static void constraint_get_trigger(Oid conoid, Oid *updtrigoid, Oid *deltrigoid);
 static char *ChooseForeignKeyConstraintNameAddition(int numkeys, AttrNumber *keys, Oid relid);
@@ -109,9 +110,22 @@ ts_chunk_copy_referencing_fk(const Hypertable *ht, const Chunk *chunk)
 {
 	ListCell *lc;
 	List *chunks = list_make1((Chunk *) chunk);
-	List *fks = relation_get_referencing_fk(ht->main_table_relid);
 
 	Relation ht_rel = table_open(ht->main_table_relid, AccessShareLock);
+
+	/*
+	 * Finding the referencing foreign keys needs a sequential scan of
+	 * pg_constraint, which grows with the number of chunks, so skip it for the
+	 * usual hypertables that are not referenced by any.
+	 */
+	if (!relation_has_referencing_fk_triggers(ht_rel))
+	{
+		table_close(ht_rel, NoLock);
+		return;
+	}
+
+	List *fks = relation_get_referencing_fk(ht->main_table_relid);
+
 	foreach (lc, fks)
 	{
 		HeapTuple fk_tuple = lfirst(lc);
@@ -418,6 +432,28 @@ createForeignKeyActionTriggers(Form_pg_constraint fk, Oid relid, Oid refRelOid,
 	CommandCounterIncrement();
 }
 
+/*
+ * Check if the relation has the action triggers of a foreign key that
+ * references it. The triggers are in the relcache, so this is cheaper than
+ * looking for the foreign keys in pg_constraint.
+ */
+static bool
+relation_has_referencing_fk_triggers(Relation rel)
+{
+	TriggerDesc *trigdesc = rel->trigdesc;
+
+	if (trigdesc == NULL)
+		return false;
+
+	for (int i = 0; i < trigdesc->numtriggers; i++)
+	{
+		if (RI_FKey_trigger_type(trigdesc->triggers[i].tgfoid) == RI_TRIGGER_PK)
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * Return a list of foreign key pg_constraint heap tuples referencing reloid.
  */
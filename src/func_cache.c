@@ -514,6 +514,40 @@ static FuncInfo funcinfo[] = {
 		.group_estimate = date_trunc_group_estimate,
 		.sort_transform = date_trunc_sort_transform,
 	},
+	/* Time-weighted aggregates that have a vectorized implementation */
+	{
+		.origin = ORIGIN_TIMESCALE,
+		.is_bucketing_func = false,
+		.allowed_in_cagg_definition = false,
+		.funcname = "time_weighted_avg",
+		.nargs = 2,
+		.arg_types = { TIMESTAMPTZOID, FLOAT8OID },
+	},
+	{
+		.origin = ORIGIN_TIMESCALE,
+		.is_bucketing_func = false,
+		.allowed_in_cagg_definition = false,
+		.funcname = "integral",
+		.nargs = 2,
+		.arg_types = { TIMESTAMPTZOID, FLOAT8OID },
+	},
+	{
+		.origin = ORIGIN_TIMESCALE,
+		.is_bucketing_func = false,
+		.allowed_in_cagg_definition = false,
+		.funcname = "counter_rate",
+		.nargs = 2,
+		.arg_types = { TIMESTAMPTZOID, FLOAT8OID },
+	},
+	/* Quantile sketch aggregate that has a vectorized implementation */
+	{
+		.origin = ORIGIN_TIMESCALE,
+		.is_bucketing_func = false,
+		.allowed_in_cagg_definition = false,
+		.funcname = "approx_percentile",
+		.nargs = 2,
+		.arg_types = { FLOAT8OID, FLOAT8OID },
+	},
 };
 
 #define _MAX_CACHE_FUNCTIONS (sizeof(funcinfo) / sizeof(funcinfo[0]))
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <postgres.h>
+#include <nodes/pathnodes.h>
 #include <nodes/primnodes.h>
 
 #include "export.h"
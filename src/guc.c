@@ -132,6 +132,7 @@ TSDLLEXPORT bool ts_guc_enable_cagg_sort_pushdown = true;
 #endif
 TSDLLEXPORT bool ts_guc_enable_cagg_watermark_constify = true;
 TSDLLEXPORT int ts_guc_cagg_max_individual_materializations = 10;
+TSDLLEXPORT int ts_guc_reorder_swap_lock_timeout = 0;
 bool ts_guc_enable_osm_reads = true;
 TSDLLEXPORT bool ts_guc_enable_compressed_direct_batch_delete = true;
 TSDLLEXPORT bool ts_guc_enable_dml_decompression = true;
@@ -143,11 +144,14 @@ TSDLLEXPORT bool ts_guc_enable_decompression_sorted_merge = true;
 bool ts_guc_enable_chunkwise_aggregation = true;
 bool ts_guc_enable_vectorized_aggregation = true;
 bool ts_guc_enable_custom_hashagg = false;
+TSDLLEXPORT bool ts_guc_enable_partitionwise_gapfill = true;
+TSDLLEXPORT bool ts_guc_enable_eager_aggregation = true;
 TSDLLEXPORT bool ts_guc_enable_compression_indexscan = false;
 TSDLLEXPORT bool ts_guc_enable_bulk_decompression = true;
 TSDLLEXPORT bool ts_guc_auto_sparse_indexes = true;
 TSDLLEXPORT bool ts_guc_default_hypercore_use_access_method = false;
 bool ts_guc_enable_chunk_skipping = false;
+bool ts_guc_enable_chunk_map = true;
 TSDLLEXPORT bool ts_guc_enable_segmentwise_recompression = true;
 
 /* Enable of disable columnar scans for columnar-oriented storage engines. If
@@ -160,6 +164,7 @@ static char *ts_guc_default_orderby_fn = NULL;
 TSDLLEXPORT bool ts_guc_enable_job_execution_logging = false;
 bool ts_guc_enable_tss_callbacks = true;
 TSDLLEXPORT bool ts_guc_enable_delete_after_compression = false;
+TSDLLEXPORT bool ts_guc_enable_compression_analyze = true;
 TSDLLEXPORT bool ts_guc_enable_merge_on_cagg_refresh = false;
 TSDLLEXPORT char *ts_guc_hypercore_indexam_whitelist;
 TSDLLEXPORT HypercoreCopyToBehavior ts_guc_hypercore_copy_to_behavior =
@@ -719,6 +724,18 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_chunk_map"),
+							 "Enable the cached chunk map",
+							 "Find the chunks matching a query in the cached per-hypertable map "
+							 "of chunks instead of the chunk catalog tables",
+							 &ts_guc_enable_chunk_map,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_segmentwise_recompression"),
 							 "Enable segmentwise recompression functionality",
 							 "Enable segmentwise recompression",
@@ -750,6 +767,29 @@ _guc_init(void)
 							NULL,
 							NULL);
 
+	/*
+	 * Define how long reorder retries to take the lock for the final table
+	 * swap without queueing behind concurrent readers. While the request for
+	 * the AccessExclusiveLock is queued, every new reader of the chunk blocks
+	 * behind it, so retrying the lock conditionally keeps reads flowing.
+	 */
+	DefineCustomIntVariable(MAKE_EXTOPTION("reorder_swap_lock_timeout"),
+							"Time reorder retries the swap lock without queueing",
+							"Time in milliseconds that reorder retries to acquire the "
+							"exclusive lock for swapping in the reordered chunk without "
+							"blocking concurrent readers. When the time is exceeded, reorder "
+							"waits for the lock. Setting this to 0 waits for the lock "
+							"immediately.",
+							&ts_guc_reorder_swap_lock_timeout,
+							0,
+							0,
+							INT_MAX,
+							PGC_USERSET,
+							GUC_UNIT_MS,
+							NULL,
+							NULL,
+							NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_tiered_reads"),
 							 "Enable tiered data reads",
 							 "Enable reading of tiered data by including a foreign table "
@@ -774,6 +814,30 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_partitionwise_gapfill"),
+							 "Enable partition-wise gapfill",
+							 "Enable running a separate gapfill for every space"
+							 " partition when grouping by the space partitioning column",
+							 &ts_guc_enable_partitionwise_gapfill,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_eager_aggregation"),
+							 "Enable eager aggregation",
+							 "Enable the pushdown of chunk-wise partial aggregation"
+							 " below a join of a hypertable with another table",
+							 &ts_guc_enable_eager_aggregation,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_custom_hashagg"),
 							 "Enable custom hash aggregation",
 							 "Enable creating custom hash aggregation plans",
@@ -906,6 +970,18 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_compression_analyze"),
+							 "Compute column statistics of chunks during compression",
+							 "Compute the column statistics of a chunk from a sample of the rows "
+							 "that are compressed, which ANALYZE can't see afterwards",
+							 &ts_guc_enable_compression_analyze,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 #ifdef USE_TELEMETRY
 	DefineCustomEnumVariable(MAKE_EXTOPTION("telemetry_level"),
 							 "Telemetry settings level",
@@ -42,6 +42,7 @@ extern bool ts_guc_enable_runtime_exclusion;
 extern bool ts_guc_enable_constraint_exclusion;
 extern bool ts_guc_enable_cagg_reorder_groupby;
 extern TSDLLEXPORT int ts_guc_cagg_max_individual_materializations;
+extern TSDLLEXPORT int ts_guc_reorder_swap_lock_timeout;
 extern bool ts_guc_enable_now_constify;
 extern bool ts_guc_enable_foreign_key_propagation;
 extern bool ts_guc_enable_osm_reads;
@@ -60,14 +61,18 @@ extern TSDLLEXPORT bool ts_guc_enable_skip_scan;
 extern TSDLLEXPORT bool ts_guc_enable_chunkwise_aggregation;
 extern TSDLLEXPORT bool ts_guc_enable_vectorized_aggregation;
 extern TSDLLEXPORT bool ts_guc_enable_custom_hashagg;
+extern TSDLLEXPORT bool ts_guc_enable_partitionwise_gapfill;
+extern TSDLLEXPORT bool ts_guc_enable_eager_aggregation;
 extern bool ts_guc_restoring;
 extern int ts_guc_max_open_chunks_per_insert;
 extern int ts_guc_max_cached_chunks_per_hypertable;
 extern TSDLLEXPORT bool ts_guc_enable_job_execution_logging;
 extern bool ts_guc_enable_tss_callbacks;
 extern TSDLLEXPORT bool ts_guc_enable_delete_after_compression;
+extern TSDLLEXPORT bool ts_guc_enable_compression_analyze;
 extern TSDLLEXPORT bool ts_guc_enable_merge_on_cagg_refresh;
 extern bool ts_guc_enable_chunk_skipping;
+extern bool ts_guc_enable_chunk_map;
 extern TSDLLEXPORT bool ts_guc_enable_segmentwise_recompression;
 
 #ifdef USE_TELEMETRY
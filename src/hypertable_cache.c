@@ -10,6 +10,7 @@
 #include <utils/lsyscache.h>
 
 #include "cache.h"
+#include "chunk_scan.h"
 #include "dimension.h"
 #include "errors.h"
 #include "hypertable.h"
@@ -39,6 +40,14 @@ typedef struct
 {
 	Oid relid;
 	Hypertable *hypertable;
+	/*
+	 * The memory of the hypertable, so that a single entry can be invalidated
+	 * and freed. NULL for negative entries.
+	 */
+	MemoryContext mcxt;
+	/* The chunks of the hypertable, built when the entry is used again */
+	ChunkMap *chunk_map;
+	bool chunk_map_requested;
 } HypertableCacheEntry;
 
 static bool
@@ -82,6 +91,13 @@ hypertable_cache_create()
 
 static Cache *hypertable_cache_current = NULL;
 
+/*
+ * The memory of the entries that were invalidated while the current cache was
+ * pinned. The holders of the pins might still use these hypertables, so they
+ * are freed only when the cache is not pinned anymore.
+ */
+static MemoryContext hypertable_cache_retired_mcxt = NULL;
+
 static ScanTupleResult
 hypertable_tuple_found(TupleInfo *ti, void *data)
 {
@@ -98,6 +114,17 @@ hypertable_cache_create_entry(Cache *cache, CacheQuery *query)
 	HypertableCacheEntry *cache_entry = query->result;
 	int number_found;
 
+	/*
+	 * The lookups below can process invalidation messages, so the entry must
+	 * be recognizable as one that is being created.
+	 */
+	cache_entry->hypertable = NULL;
+	cache_entry->chunk_map = NULL;
+	cache_entry->chunk_map_requested = false;
+	cache_entry->mcxt = AllocSetContextCreate(ts_cache_memory_ctx(cache),
+											  "Hypertable cache entry",
+											  ALLOCSET_SMALL_SIZES);
+
 	if (NULL == hq->schema)
 		hq->schema = get_namespace_name(get_rel_namespace(hq->relid));
 
@@ -109,13 +136,15 @@ hypertable_cache_create_entry(Cache *cache, CacheQuery *query)
 														  hypertable_tuple_found,
 														  query->result,
 														  AccessShareLock,
-														  ts_cache_memory_ctx(cache));
+														  cache_entry->mcxt);
 
 	switch (number_found)
 	{
 		case 0:
 			/* Negative cache entry: table is not a hypertable */
 			cache_entry->hypertable = NULL;
+			MemoryContextDelete(cache_entry->mcxt);
+			cache_entry->mcxt = NULL;
 			break;
 		case 1:
 			Assert(strncmp(NameStr(cache_entry->hypertable->fd.schema_name),
@@ -154,6 +183,153 @@ ts_hypertable_cache_invalidate_callback(void)
 {
 	ts_cache_invalidate(hypertable_cache_current);
 	hypertable_cache_current = hypertable_cache_create();
+	/* The retired entries are freed together with the old cache */
+	hypertable_cache_retired_mcxt = NULL;
+}
+
+/*
+ * Invalidate the cache entry of a single relation, e.g. when the chunks of a
+ * hypertable change. This is called for every relcache invalidation, so it has
+ * to be cheap for the relations that are not in the cache.
+ */
+void
+ts_hypertable_cache_invalidate_entry(Oid relid)
+{
+	Cache *cache = hypertable_cache_current;
+	HypertableCacheEntry *entry;
+
+	if (cache == NULL)
+		return;
+
+	entry = hash_search(cache->htab, &relid, HASH_FIND, NULL);
+
+	if (entry == NULL)
+		return;
+
+	/*
+	 * The entry is being created right now, from the catalog state that is
+	 * current after the invalidation.
+	 */
+	if (entry->hypertable == NULL && entry->mcxt != NULL)
+		return;
+
+	if (entry->mcxt != NULL)
+	{
+		if (cache->refcount > 1)
+		{
+			if (hypertable_cache_retired_mcxt == NULL)
+				hypertable_cache_retired_mcxt =
+					AllocSetContextCreate(ts_cache_memory_ctx(cache),
+										  "Hypertable cache retired entries",
+										  ALLOCSET_SMALL_SIZES);
+
+			MemoryContextSetParent(entry->mcxt, hypertable_cache_retired_mcxt);
+		}
+		else
+			MemoryContextDelete(entry->mcxt);
+	}
+
+	hash_search(cache->htab, &relid, HASH_REMOVE, NULL);
+	cache->stats.numelements--;
+}
+
+/*
+ * Find the entry of the given hypertable in the current cache. Returns NULL if
+ * the entry was invalidated, i.e. the hypertable is from an older entry that
+ * is only kept until the cache is released.
+ */
+static HypertableCacheEntry *
+hypertable_cache_find_entry(const Hypertable *ht)
+{
+	Cache *cache = hypertable_cache_current;
+	HypertableCacheEntry *entry = hash_search(cache->htab, &ht->main_table_relid, HASH_FIND, NULL);
+
+	if (entry == NULL || entry->hypertable != ht)
+		return NULL;
+
+	return entry;
+}
+
+/*
+ * Get the chunk map of a hypertable, building it on second use. The entry is
+ * invalidated whenever the existing chunks of the hypertable change, and the
+ * map is rebuilt when new chunks are found in the catalog. Returns NULL if the
+ * entry was invalidated already, or the map can't be built.
+ */
+const ChunkMap *
+ts_hypertable_cache_get_chunk_map(const Hypertable *ht)
+{
+	HypertableCacheEntry *entry = hypertable_cache_find_entry(ht);
+
+	/*
+	 * The memory of the invalidated entries is kept only while the cache is
+	 * pinned, and the map has to survive the invalidations until the caller
+	 * checks it with ts_hypertable_cache_chunk_map_is_current().
+	 */
+	if (entry == NULL || hypertable_cache_current->refcount <= 1)
+		return NULL;
+
+	if (entry->chunk_map != NULL)
+	{
+		const ChunkMap *map = entry->chunk_map;
+		bool has_new_chunks = ts_chunk_map_has_new_chunks(ht, map);
+
+		/* Reading the catalog can invalidate the entry, see below */
+		entry = hypertable_cache_find_entry(ht);
+
+		if (entry == NULL || entry->chunk_map != map)
+			return NULL;
+
+		if (!has_new_chunks)
+			return map;
+
+		/* The hypertable is in use, so rebuild the map right away */
+		MemoryContextDelete(GetMemoryChunkContext(entry->chunk_map));
+		entry->chunk_map = NULL;
+	}
+	else if (!entry->chunk_map_requested)
+	{
+		/*
+		 * Building the map reads all the chunks of the hypertable, so it only
+		 * pays off if the hypertable is queried again, not for one-off
+		 * queries.
+		 */
+		entry->chunk_map_requested = true;
+		return NULL;
+	}
+
+	/*
+	 * Reading the catalog can process invalidation messages, which free the
+	 * entry memory, so build the map in its own context first.
+	 */
+	MemoryContext map_mcxt =
+		AllocSetContextCreate(CurrentMemoryContext, "Hypertable chunk map", ALLOCSET_DEFAULT_SIZES);
+	ChunkMap *map = ts_chunk_map_build(ht, map_mcxt);
+
+	entry = hypertable_cache_find_entry(ht);
+
+	if (entry == NULL || map == NULL)
+	{
+		MemoryContextDelete(map_mcxt);
+		return NULL;
+	}
+
+	MemoryContextSetParent(map_mcxt, entry->mcxt);
+	entry->chunk_map = map;
+
+	return map;
+}
+
+/*
+ * Check that the chunk map is still the current one of the hypertable, i.e.
+ * no chunks of the hypertable have changed since it was built.
+ */
+bool
+ts_hypertable_cache_chunk_map_is_current(const Hypertable *ht, const ChunkMap *map)
+{
+	HypertableCacheEntry *entry = hypertable_cache_find_entry(ht);
+
+	return entry != NULL && entry->chunk_map == map;
 }
 
 /* Get hypertable cache entry. If the entry is not in the cache, add it. */
@@ -217,6 +393,13 @@ ts_hypertable_cache_get_entry_with_table(Cache *cache, const Oid relid, const ch
 extern TSDLLEXPORT Cache *
 ts_hypertable_cache_pin()
 {
+	/* Nobody can use the retired entries if the cache is not pinned */
+	if (hypertable_cache_retired_mcxt != NULL && hypertable_cache_current->refcount == 1)
+	{
+		MemoryContextDelete(hypertable_cache_retired_mcxt);
+		hypertable_cache_retired_mcxt = NULL;
+	}
+
 	return ts_cache_pin(hypertable_cache_current);
 }
 
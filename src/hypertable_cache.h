@@ -51,7 +51,12 @@ ts_hypertable_cache_get_entry_with_table(Cache *cache, const Oid relid, const ch
 extern TSDLLEXPORT Hypertable *ts_hypertable_cache_get_entry_by_id(Cache *cache,
 																   const int32 hypertable_id);
 
+extern const struct ChunkMap *ts_hypertable_cache_get_chunk_map(const Hypertable *ht);
+extern bool ts_hypertable_cache_chunk_map_is_current(const Hypertable *ht,
+													 const struct ChunkMap *map);
+
 extern void ts_hypertable_cache_invalidate_callback(void);
+extern void ts_hypertable_cache_invalidate_entry(Oid relid);
 
 extern TSDLLEXPORT Cache *ts_hypertable_cache_pin(void);
 
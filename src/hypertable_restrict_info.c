@@ -24,6 +24,7 @@
 #include "expression_utils.h"
 #include "guc.h"
 #include "hypercube.h"
+#include "hypertable_cache.h"
 #include "partitioning.h"
 #include "scan_iterator.h"
 #include "ts_catalog/chunk_column_stats.h"
@@ -644,35 +645,378 @@ gather_restriction_dimension_vectors(const HypertableRestrictInfo *hri)
 	return dimension_vecs;
 }
 
-Chunk **
-ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *ht,
-									   bool include_osm, unsigned int *num_chunks)
+/*
+ * Check that the chunk from the chunk map matches all the restrictions. This
+ * is the in-memory equivalent of gather_restriction_dimension_vectors()
+ * followed by ts_chunk_id_find_in_subspace().
+ */
+static bool
+hypertable_restrict_info_chunk_matches(const HypertableRestrictInfo *hri, const Chunk *chunk)
 {
-	/*
-	 * Remove the dimensions for which we don't have a restriction, that is,
-	 * the entire range of the dimension matches. Such dimensions do not
-	 * influence the result set, because their every slice matches, so we can
-	 * just ignore them when searching for the matching chunks.
-	 */
-	const int old_dimensions = hri->num_dimensions;
-	hri->num_dimensions = 0;
-	for (int i = 0; i < old_dimensions; i++)
+	for (int i = 0; i < hri->num_dimensions; i++)
 	{
-		DimensionRestrictInfo *dri = hri->dimension_restriction[i];
-		if (!dimension_restrict_info_is_trivial(dri))
+		const DimensionRestrictInfo *dri = hri->dimension_restriction[i];
+		const DimensionSlice *slice =
+			ts_hypercube_get_slice_by_dimension_id(chunk->cube, dri->dimension->fd.id);
+
+		if (slice == NULL)
+			return false;
+
+		switch (dri->dimension->type)
 		{
-			hri->dimension_restriction[hri->num_dimensions] = dri;
-			hri->num_dimensions++;
+			case DIMENSION_TYPE_OPEN:
+			{
+				const DimensionRestrictInfoOpen *open = (const DimensionRestrictInfoOpen *) dri;
+
+				if (!ts_dimension_slice_matches_range(slice,
+													  open->upper_strategy,
+													  open->upper_bound,
+													  open->lower_strategy,
+													  open->lower_bound))
+					return false;
+				break;
+			}
+			case DIMENSION_TYPE_CLOSED:
+			{
+				const DimensionRestrictInfoClosed *closed =
+					(const DimensionRestrictInfoClosed *) dri;
+				bool found = false;
+				ListCell *cell;
+
+				foreach (cell, closed->partitions)
+				{
+					int32 partition = lfirst_int(cell);
+
+					if (ts_dimension_slice_matches_range(slice,
+														 BTLessEqualStrategyNumber,
+														 partition,
+														 BTGreaterEqualStrategyNumber,
+														 partition))
+					{
+						found = true;
+						break;
+					}
+				}
+
+				if (!found)
+					return false;
+				break;
+			}
+			default:
+				elog(ERROR, "unexpected dimension type %d", dri->dimension->type);
+				return false;
 		}
 	}
 
+	return true;
+}
+
+/*
+ * The number of restrictions whose matching chunks are kept in the exclusion
+ * cache of a chunk map.
+ */
+#define CHUNK_EXCLUSION_CACHE_SIZE 16
+
+/*
+ * The distinct range starts and ends of the slices of an open dimension,
+ * sorted.
+ */
+typedef struct DimensionSliceBounds
+{
+	int32 dimension_id;
+	int num_starts;
+	int64 *starts;
+	int num_ends;
+	int64 *ends;
+} DimensionSliceBounds;
+
+typedef struct ChunkExclusionResult
+{
+	int keylen;
+	int64 *key;
+	List *chunk_ids;
+} ChunkExclusionResult;
+
+static int
+int64_cmp(const void *a, const void *b)
+{
+	return VALUE_CMP(*(const int64 *) a, *(const int64 *) b);
+}
+
+static int
+sort_distinct_int64(int64 *values, int num_values)
+{
+	int num_distinct = 0;
+
+	qsort(values, num_values, sizeof(int64), int64_cmp);
+
+	for (int i = 0; i < num_values; i++)
+	{
+		if (num_distinct == 0 || values[num_distinct - 1] != values[i])
+			values[num_distinct++] = values[i];
+	}
+
+	return num_distinct;
+}
+
+static const DimensionSliceBounds *
+chunk_exclusion_cache_get_bounds(ChunkExclusionCache *cache, const ChunkMap *map,
+								 int32 dimension_id)
+{
+	ListCell *lc;
+
+	foreach (lc, cache->dimension_bounds)
+	{
+		DimensionSliceBounds *bounds = lfirst(lc);
+
+		if (bounds->dimension_id == dimension_id)
+			return bounds;
+	}
+
+	MemoryContext old = MemoryContextSwitchTo(cache->mcxt);
+	DimensionSliceBounds *bounds = palloc(sizeof(DimensionSliceBounds));
+	int num_slices = 0;
+
+	bounds->dimension_id = dimension_id;
+	bounds->starts = palloc(sizeof(int64) * Max(map->num_chunks, 1));
+	bounds->ends = palloc(sizeof(int64) * Max(map->num_chunks, 1));
+
+	for (int i = 0; i < map->num_chunks; i++)
+	{
+		const DimensionSlice *slice =
+			ts_hypercube_get_slice_by_dimension_id(map->chunks[i]->cube, dimension_id);
+
+		if (slice == NULL)
+			continue;
+
+		bounds->starts[num_slices] = slice->fd.range_start;
+		bounds->ends[num_slices] = slice->fd.range_end;
+		num_slices++;
+	}
+
+	bounds->num_starts = sort_distinct_int64(bounds->starts, num_slices);
+	bounds->num_ends = sort_distinct_int64(bounds->ends, num_slices);
+	cache->dimension_bounds = lappend(cache->dimension_bounds, bounds);
+	MemoryContextSwitchTo(old);
+
+	return bounds;
+}
+
+/*
+ * The number of range starts that match the upper bound of the restriction.
+ * These are the smallest ones.
+ */
+static int
+dimension_slice_bounds_count_starts(const DimensionSliceBounds *bounds,
+									const DimensionRestrictInfoOpen *open)
+{
+	int low = 0;
+	int high = bounds->num_starts;
+
+	while (low < high)
+	{
+		const int middle = low + (high - low) / 2;
+		DimensionSlice slice = { .fd.range_start = bounds->starts[middle] };
+
+		if (ts_dimension_slice_matches_range(&slice,
+											 open->upper_strategy,
+											 open->upper_bound,
+											 InvalidStrategy,
+											 0))
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/*
+ * The number of range ends that don't match the lower bound of the
+ * restriction. These are the smallest ones.
+ */
+static int
+dimension_slice_bounds_count_ends(const DimensionSliceBounds *bounds,
+								  const DimensionRestrictInfoOpen *open)
+{
+	int low = 0;
+	int high = bounds->num_ends;
+
+	while (low < high)
+	{
+		const int middle = low + (high - low) / 2;
+		DimensionSlice slice = { .fd.range_end = bounds->ends[middle] };
+
+		if (ts_dimension_slice_matches_range(&slice,
+											 InvalidStrategy,
+											 0,
+											 open->lower_strategy,
+											 open->lower_bound))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return low;
+}
+
+/*
+ * Build the key of the restrictions in the exclusion cache. The bounds on open
+ * dimensions are replaced by their positions among the slice boundaries of the
+ * chunk map, so that all the restrictions that match the same slices have the
+ * same key. E.g. "time > now() - interval '1 hour'" gets the same key in every
+ * query until the range crosses a chunk boundary. Returns false if the
+ * restrictions can't be cached.
+ */
+static bool
+chunk_exclusion_cache_make_key(const HypertableRestrictInfo *hri, ChunkExclusionCache *cache,
+							   const ChunkMap *map, int64 **key, int *keylen)
+{
+	int len = 0;
+	int maxlen = 0;
+
+	for (int i = 0; i < hri->num_dimensions; i++)
+	{
+		const DimensionRestrictInfo *dri = hri->dimension_restriction[i];
+
+		if (dri->dimension->type == DIMENSION_TYPE_OPEN)
+			maxlen += 3;
+		else if (dri->dimension->type == DIMENSION_TYPE_CLOSED)
+			maxlen += 2 + list_length(((const DimensionRestrictInfoClosed *) dri)->partitions);
+		else
+			return false;
+	}
+
+	int64 *values = palloc(sizeof(int64) * Max(maxlen, 1));
+
+	for (int i = 0; i < hri->num_dimensions; i++)
+	{
+		const DimensionRestrictInfo *dri = hri->dimension_restriction[i];
+
+		values[len++] = dri->dimension->fd.id;
+
+		if (dri->dimension->type == DIMENSION_TYPE_OPEN)
+		{
+			const DimensionRestrictInfoOpen *open = (const DimensionRestrictInfoOpen *) dri;
+			const DimensionSliceBounds *bounds =
+				chunk_exclusion_cache_get_bounds(cache, map, dri->dimension->fd.id);
+
+			values[len++] = dimension_slice_bounds_count_starts(bounds, open);
+			values[len++] = dimension_slice_bounds_count_ends(bounds, open);
+		}
+		else
+		{
+			const DimensionRestrictInfoClosed *closed = (const DimensionRestrictInfoClosed *) dri;
+			const int first = len + 1;
+			ListCell *lc;
+
+			values[len++] = list_length(closed->partitions);
+
+			foreach (lc, closed->partitions)
+				values[len++] = lfirst_int(lc);
+
+			qsort(&values[first], len - first, sizeof(int64), int64_cmp);
+		}
+	}
+
+	*key = values;
+	*keylen = len;
+	return true;
+}
+
+/*
+ * Get the IDs of the chunks of the chunk map that match the restrictions, in
+ * ID order. The result is kept in the exclusion cache of the map, which is
+ * discarded together with the map when the chunks of the hypertable change.
+ */
+static List *
+chunk_map_get_matching_chunk_ids(const HypertableRestrictInfo *hri, const ChunkMap *map)
+{
+	ChunkExclusionCache *cache = map->exclusion_cache;
+	List *chunk_ids = NIL;
+	int64 *key = NULL;
+	int keylen;
+
+	if (chunk_exclusion_cache_make_key(hri, cache, map, &key, &keylen))
+	{
+		ListCell *lc;
+
+		foreach (lc, cache->results)
+		{
+			ChunkExclusionResult *result = lfirst(lc);
+
+			if (result->keylen != keylen || memcmp(result->key, key, sizeof(int64) * keylen) != 0)
+				continue;
+
+			if (foreach_current_index(lc) > 0)
+			{
+				MemoryContext old = MemoryContextSwitchTo(cache->mcxt);
+
+				cache->results = foreach_delete_current(cache->results, lc);
+				cache->results = lcons(result, cache->results);
+				MemoryContextSwitchTo(old);
+			}
+
+			pfree(key);
+			return list_copy(result->chunk_ids);
+		}
+	}
+
+	for (int i = 0; i < map->num_chunks; i++)
+	{
+		if (hypertable_restrict_info_chunk_matches(hri, map->chunks[i]))
+			chunk_ids = lappend_int(chunk_ids, map->chunks[i]->fd.id);
+	}
+
+	if (key != NULL)
+	{
+		MemoryContext old = MemoryContextSwitchTo(cache->mcxt);
+		ChunkExclusionResult *result = palloc(sizeof(ChunkExclusionResult));
+
+		result->keylen = keylen;
+		result->key = palloc(sizeof(int64) * Max(keylen, 1));
+		memcpy(result->key, key, sizeof(int64) * keylen);
+		result->chunk_ids = list_copy(chunk_ids);
+
+		if (list_length(cache->results) >= CHUNK_EXCLUSION_CACHE_SIZE)
+		{
+			ChunkExclusionResult *last = llast(cache->results);
+
+			cache->results = list_delete_last(cache->results);
+			pfree(last->key);
+			list_free(last->chunk_ids);
+			pfree(last);
+		}
+
+		cache->results = lcons(result, cache->results);
+		MemoryContextSwitchTo(old);
+		pfree(key);
+	}
+
+	return chunk_ids;
+}
+
+/*
+ * Get the IDs of the chunks matching the restrictions, in ID order. Uses the
+ * chunk map if one is given, otherwise the catalog.
+ */
+static List *
+hypertable_restrict_info_get_chunk_ids(HypertableRestrictInfo *hri, Hypertable *ht,
+									   bool include_osm, const ChunkMap *map)
+{
 	List *chunk_ids = NIL;
 	if (hri->num_dimensions == 0)
 	{
 		/*
 		 * No restrictions on hyperspace. Just enumerate all the chunks.
 		 */
-		chunk_ids = ts_chunk_get_chunk_ids_by_hypertable_id(ht->fd.id);
+		if (map != NULL)
+		{
+			for (int i = 0; i < map->num_chunks; i++)
+				chunk_ids = lappend_int(chunk_ids, map->chunks[i]->fd.id);
+		}
+		else
+			chunk_ids = ts_chunk_get_chunk_ids_by_hypertable_id(ht->fd.id);
 
 		/*
 		 * If the hypertable has an OSM chunk it would end up in the list
@@ -681,32 +1025,44 @@ ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *
 		 */
 		if (!include_osm || !ts_guc_enable_osm_reads)
 		{
-			int32 osm_chunk_id = ts_chunk_get_osm_chunk_id(ht->fd.id);
+			int32 osm_chunk_id =
+				map != NULL ? map->osm_chunk_id : ts_chunk_get_osm_chunk_id(ht->fd.id);
 
 			chunk_ids = list_delete_int(chunk_ids, osm_chunk_id);
 		}
 	}
 	else
 	{
-		/*
-		 * Have some restrictions, enumerate the matching dimension slices.
-		 */
-		List *dimension_vectors = gather_restriction_dimension_vectors(hri);
-		if (list_length(dimension_vectors) == 0)
+		if (map != NULL)
 		{
 			/*
-			 * No dimension slices match for some dimension for which there is
-			 * a restriction. This means that no chunks match.
+			 * Have some restrictions, check them against the hypercubes of the
+			 * chunks in the map.
 			 */
-			chunk_ids = NIL;
+			chunk_ids = chunk_map_get_matching_chunk_ids(hri, map);
 		}
 		else
 		{
-			/* Find the chunks matching these dimension ranges/slices. */
-			chunk_ids = ts_chunk_id_find_in_subspace(ht, dimension_vectors);
+			/*
+			 * Have some restrictions, enumerate the matching dimension slices.
+			 */
+			List *dimension_vectors = gather_restriction_dimension_vectors(hri);
+			if (list_length(dimension_vectors) == 0)
+			{
+				/*
+				 * No dimension slices match for some dimension for which there
+				 * is a restriction. This means that no chunks match.
+				 */
+				chunk_ids = NIL;
+			}
+			else
+			{
+				/* Find the chunks matching these dimension ranges/slices. */
+				chunk_ids = ts_chunk_id_find_in_subspace(ht, dimension_vectors);
+			}
 		}
 
-		int32 osm_chunk_id = ts_chunk_get_osm_chunk_id(ht->fd.id);
+		int32 osm_chunk_id = map != NULL ? map->osm_chunk_id : ts_chunk_get_osm_chunk_id(ht->fd.id);
 
 		if (osm_chunk_id != INVALID_CHUNK_ID)
 		{
@@ -751,6 +1107,62 @@ ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *
 	 */
 	list_sort(chunk_ids, list_int_cmp);
 
+	return chunk_ids;
+}
+
+Chunk **
+ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *ht,
+									   bool include_osm, unsigned int *num_chunks)
+{
+	/*
+	 * Remove the dimensions for which we don't have a restriction, that is,
+	 * the entire range of the dimension matches. Such dimensions do not
+	 * influence the result set, because their every slice matches, so we can
+	 * just ignore them when searching for the matching chunks.
+	 */
+	const int old_dimensions = hri->num_dimensions;
+	/*
+	 * The chunks of the internal compressed hypertables are created without
+	 * locking the hypertable, so ts_chunk_map_has_new_chunks() can't find the
+	 * new ones.
+	 */
+	bool use_chunk_map =
+		ts_guc_enable_chunk_map && !TS_HYPERTABLE_IS_INTERNAL_COMPRESSION_TABLE(ht);
+	hri->num_dimensions = 0;
+	for (int i = 0; i < old_dimensions; i++)
+	{
+		DimensionRestrictInfo *dri = hri->dimension_restriction[i];
+		if (!dimension_restrict_info_is_trivial(dri))
+		{
+			hri->dimension_restriction[hri->num_dimensions] = dri;
+			hri->num_dimensions++;
+
+			/* The chunk ranges of these are only in the chunk_column_stats catalog */
+			if (dri->dimension->type == DIMENSION_TYPE_STATS)
+				use_chunk_map = false;
+		}
+	}
+
+	if (use_chunk_map)
+	{
+		const ChunkMap *map = ts_hypertable_cache_get_chunk_map(ht);
+
+		if (map != NULL)
+		{
+			List *chunk_ids = hypertable_restrict_info_get_chunk_ids(hri, ht, include_osm, map);
+			Chunk **chunks = ts_chunk_scan_from_chunk_map(ht, map, chunk_ids, num_chunks);
+
+			if (chunks != NULL)
+				return chunks;
+		}
+	}
+
+	/*
+	 * The chunk map is not available or the chunks changed while we were
+	 * locking them, so find them in the catalog.
+	 */
+	List *chunk_ids = hypertable_restrict_info_get_chunk_ids(hri, ht, include_osm, NULL);
+
 	return ts_chunk_scan_by_chunk_ids(ht->space, chunk_ids, num_chunks);
 }
 
@@ -65,6 +65,8 @@ get_convert_func(Oid typeid)
 			return int4_numeric;
 		case INT8OID:
 			return int8_numeric;
+		case FLOAT8OID:
+			return float8_numeric;
 		default:
 			return NULL;
 	}
@@ -83,6 +85,7 @@ ts_jsonb_set_value_by_type(JsonbValue *value, Oid typeid, Datum datum)
 		case INT2OID:
 		case INT4OID:
 		case INT8OID:
+		case FLOAT8OID:
 		case NUMERICOID:
 			func = get_convert_func(typeid);
 			value->type = jbvNumeric;
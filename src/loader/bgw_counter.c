@@ -6,16 +6,20 @@
 /* needed for initializing shared memory and using various locks */
 #include <postgres.h>
 
+#include <catalog/pg_type.h>
 #include <miscadmin.h>
 #include <storage/ipc.h>
 #include <storage/latch.h>
 #include <storage/lwlock.h>
 #include <storage/shmem.h>
 #include <storage/spin.h>
+#include <utils/array.h>
 #include <utils/guc.h>
 #include <utils/hsearch.h>
+#include <utils/timestamp.h>
 
 #include "bgw_counter.h"
+#include "export.h"
 #include "extension_constants.h"
 
 #define BGW_COUNTER_STATE_NAME "ts_bgw_counter_state"
@@ -30,14 +34,44 @@ int ts_guc_max_background_workers = 16;
  * be accessible to code outside of postgres core in any meaningful way. So
  * we're not using that.
  */
+/*
+ * Job workers reserved by the scheduler of a database.
+ *
+ * When the pool of workers runs out, a database that is denied a worker is
+ * remembered as waiting for a while. As long as other databases are waiting,
+ * a database cannot reserve more than its fair share of the job workers, so
+ * that one busy database cannot starve the schedulers of the others.
+ */
+typedef struct DbWorkerCount
+{
+	Oid db_oid;
+	int workers;
+	TimestampTz last_denied; /* last time a reservation was denied, or 0 */
+} DbWorkerCount;
+
+/*
+ * A database counts as waiting for a worker this long after it was denied
+ * one. Schedulers retry launching a job within a minute.
+ */
+#define BGW_DB_WAITING_WINDOW_MS 60000
+
 typedef struct CounterState
 {
 	/*
 	 * Using an slock because we're only taking it for very brief periods to
 	 * read a single value so no need for an lwlock
 	 */
-	slock_t mutex; /* controls modification of total_workers */
+	slock_t mutex; /* controls modification of total_workers and db_workers */
 	int total_workers;
+	/*
+	 * Databases that have job workers or are waiting for one are kept at the
+	 * start of db_workers, so the scans done while holding the spinlock only
+	 * visit the active databases. Every database with a job worker also holds
+	 * a worker for its scheduler, so there are never more than
+	 * max_background_workers of them.
+	 */
+	int num_dbs;
+	DbWorkerCount db_workers[BGW_MAX_BACKGROUND_WORKERS];
 } CounterState;
 
 static CounterState *ct = NULL;
@@ -54,6 +88,7 @@ bgw_counter_state_init()
 		memset(ct, 0, sizeof(CounterState));
 		SpinLockInit(&ct->mutex);
 		ct->total_workers = 0;
+		ct->num_dbs = 0;
 	}
 	LWLockRelease(AddinShmemInitLock);
 }
@@ -69,8 +104,7 @@ ts_bgw_counter_setup_gucs(void)
 							&ts_guc_max_background_workers,
 							ts_guc_max_background_workers,
 							0,
-							1000, /* no reasonable way to have more than
-								   * 1000 background workers */
+							BGW_MAX_BACKGROUND_WORKERS,
 							PGC_POSTMASTER,
 							0,
 							NULL,
@@ -100,6 +134,7 @@ ts_bgw_counter_reinit(void)
 	/* set counter back to zero on startup */
 	SpinLockAcquire(&ct->mutex);
 	ct->total_workers = 0;
+	ct->num_dbs = 0;
 	SpinLockRelease(&ct->mutex);
 }
 
@@ -165,3 +200,252 @@ ts_bgw_total_workers_get()
 	SpinLockRelease(&ct->mutex);
 	return nworkers;
 }
+
+static inline bool
+db_worker_count_is_waiting(const DbWorkerCount *entry, TimestampTz now)
+{
+	return entry->last_denied != 0 &&
+		   !TimestampDifferenceExceeds(entry->last_denied, now, BGW_DB_WAITING_WINDOW_MS);
+}
+
+static inline bool
+db_worker_count_is_active(const DbWorkerCount *entry, TimestampTz now)
+{
+	return entry->workers > 0 || db_worker_count_is_waiting(entry, now);
+}
+
+/*
+ * Remove an entry by moving the last entry into its place.
+ */
+static void
+db_worker_count_remove(CounterState *state, DbWorkerCount *entry)
+{
+	DbWorkerCount *last = &state->db_workers[state->num_dbs - 1];
+
+	if (entry != last)
+		*entry = *last;
+	state->num_dbs--;
+}
+
+/*
+ * Find the entry for a database, or add one. Entries of databases that are no
+ * longer active are removed on the way. Must be called with the mutex held.
+ * Returns NULL if there is no room for the database, which should not happen.
+ */
+static DbWorkerCount *
+db_worker_count_get(CounterState *state, int max_workers, Oid db_oid, TimestampTz now)
+{
+	DbWorkerCount *entry;
+	DbWorkerCount *evict = NULL;
+	int i = 0;
+
+	while (i < state->num_dbs)
+	{
+		entry = &state->db_workers[i];
+
+		if (entry->db_oid == db_oid)
+			return entry;
+
+		if (!db_worker_count_is_active(entry, now))
+		{
+			db_worker_count_remove(state, entry);
+			continue;
+		}
+
+		/* Remember the database without workers that was denied the longest ago */
+		if (entry->workers == 0 && (evict == NULL || entry->last_denied < evict->last_denied))
+			evict = entry;
+		i++;
+	}
+
+	if (state->num_dbs < max_workers)
+		entry = &state->db_workers[state->num_dbs++];
+	else
+	{
+		/*
+		 * All entries are active. At most max_workers - 1 databases can have
+		 * job workers, so one of them is only waiting. Forget about it, which
+		 * only means it is not considered when sharing the workers.
+		 */
+		Assert(evict != NULL);
+		if (evict == NULL)
+			return NULL;
+		entry = evict;
+	}
+
+	entry->db_oid = db_oid;
+	entry->workers = 0;
+	entry->last_denied = 0;
+
+	return entry;
+}
+
+/*
+ * Check if a database may take one more job worker. Must be called with the
+ * mutex held.
+ *
+ * If no other database is waiting for a worker, any free worker can be
+ * taken. Otherwise the job workers are shared equally between the databases
+ * that have workers or are waiting for one.
+ */
+static bool
+db_worker_count_within_fair_share(const CounterState *state, int max_workers,
+								  const DbWorkerCount *self, TimestampTz now)
+{
+	int job_workers = 0;
+	int active_dbs = 0;
+	bool others_waiting = false;
+	int pool;
+
+	if (state->total_workers + 1 > max_workers)
+		return false;
+
+	for (int i = 0; i < state->num_dbs; i++)
+	{
+		const DbWorkerCount *entry = &state->db_workers[i];
+
+		job_workers += entry->workers;
+
+		if (entry != self && db_worker_count_is_waiting(entry, now))
+			others_waiting = true;
+
+		active_dbs++;
+	}
+
+	if (!others_waiting)
+		return true;
+
+	/* The launcher and the schedulers hold the workers that are not job workers */
+	pool = max_workers - (state->total_workers - job_workers);
+
+	return self->workers * active_dbs < pool;
+}
+
+/*
+ * Reserve a job worker for a database, sharing the workers fairly between
+ * databases when they run out. Must be called with the mutex held.
+ */
+static bool
+db_workers_reserve(CounterState *state, int max_workers, Oid db_oid, TimestampTz now)
+{
+	DbWorkerCount *entry = db_worker_count_get(state, max_workers, db_oid, now);
+
+	/* Never reserve a worker that is not accounted to the database */
+	if (entry == NULL)
+		return false;
+
+	if (!db_worker_count_within_fair_share(state, max_workers, entry, now))
+	{
+		entry->last_denied = now;
+		return false;
+	}
+
+	state->total_workers++;
+	entry->workers++;
+	entry->last_denied = 0;
+	return true;
+}
+
+/*
+ * Release a job worker of a database. Must be called with the mutex held.
+ */
+static void
+db_workers_release(CounterState *state, Oid db_oid, TimestampTz now)
+{
+	for (int i = 0; i < state->num_dbs; i++)
+	{
+		DbWorkerCount *entry = &state->db_workers[i];
+
+		if (entry->db_oid == db_oid)
+		{
+			if (entry->workers > 0)
+				entry->workers--;
+			if (!db_worker_count_is_active(entry, now))
+				db_worker_count_remove(state, entry);
+			break;
+		}
+	}
+}
+
+extern bool
+ts_bgw_db_workers_increment(Oid db_oid)
+{
+	TimestampTz now = GetCurrentTimestamp();
+	bool incremented;
+
+	SpinLockAcquire(&ct->mutex);
+	incremented = db_workers_reserve(ct, ts_guc_max_background_workers, db_oid, now);
+	SpinLockRelease(&ct->mutex);
+
+	return incremented;
+}
+
+extern void
+ts_bgw_db_workers_decrement(Oid db_oid)
+{
+	TimestampTz now = GetCurrentTimestamp();
+
+	SpinLockAcquire(&ct->mutex);
+	db_workers_release(ct, db_oid, now);
+	SpinLockRelease(&ct->mutex);
+
+	ts_bgw_total_workers_decrement();
+}
+
+#ifdef TS_DEBUG
+/*
+ * Run job worker reservations on a private counter state, to test how the
+ * workers are shared between databases.
+ *
+ * The launcher and the schedulers hold other_workers of the max_workers
+ * workers. Each element of ops reserves a job worker for the database with
+ * that OID, or releases one if it is negative. Returns if each reservation
+ * succeeded, with NULL for the releases.
+ */
+TS_FUNCTION_INFO_V1(ts_bgw_counter_test_reserve);
+
+Datum
+ts_bgw_counter_test_reserve(PG_FUNCTION_ARGS)
+{
+	int32 max_workers = PG_GETARG_INT32(0);
+	int32 other_workers = PG_GETARG_INT32(1);
+	ArrayType *ops = PG_GETARG_ARRAYTYPE_P(2);
+	TimestampTz now = GetCurrentTimestamp();
+	CounterState *state;
+	Datum *op_datums;
+	Datum *results;
+	bool *nulls;
+	int nops;
+	int dims[1];
+	int lbs[1] = { 1 };
+
+	if (max_workers < 1 || max_workers > BGW_MAX_BACKGROUND_WORKERS || other_workers < 1 ||
+		other_workers > max_workers)
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("invalid worker counts")));
+
+	deconstruct_array(ops, INT4OID, 4, true, TYPALIGN_INT, &op_datums, NULL, &nops);
+
+	state = palloc0(sizeof(CounterState));
+	state->total_workers = other_workers;
+	results = palloc0(sizeof(Datum) * nops);
+	nulls = palloc0(sizeof(bool) * nops);
+
+	for (int i = 0; i < nops; i++)
+	{
+		int32 op = DatumGetInt32(op_datums[i]);
+
+		if (op > 0)
+			results[i] = BoolGetDatum(db_workers_reserve(state, max_workers, (Oid) op, now));
+		else
+		{
+			db_workers_release(state, (Oid) -op, now);
+			state->total_workers--;
+			nulls[i] = true;
+		}
+	}
+
+	dims[0] = nops;
+	PG_RETURN_ARRAYTYPE_P(
+		construct_md_array(results, nulls, 1, dims, lbs, BOOLOID, 1, true, TYPALIGN_CHAR));
+}
+#endif
@@ -7,6 +7,9 @@
 
 #include <postgres.h>
 
+/* no reasonable way to have more than 1000 background workers */
+#define BGW_MAX_BACKGROUND_WORKERS 1000
+
 extern int ts_guc_max_background_workers;
 
 extern void ts_bgw_counter_shmem_alloc(void);
@@ -20,3 +23,5 @@ extern void ts_bgw_total_workers_decrement(void);
 extern int ts_bgw_total_workers_get(void);
 extern bool ts_bgw_total_workers_increment_by(int increment_by);
 extern void ts_bgw_total_workers_decrement_by(int decrement_by);
+extern bool ts_bgw_db_workers_increment(Oid db_oid);
+extern void ts_bgw_db_workers_decrement(Oid db_oid);
@@ -46,13 +46,13 @@ ts_bgw_interface_register_api_version()
 Datum
 ts_bgw_worker_reserve(PG_FUNCTION_ARGS)
 {
-	PG_RETURN_BOOL(ts_bgw_total_workers_increment());
+	PG_RETURN_BOOL(ts_bgw_db_workers_increment(MyDatabaseId));
 }
 
 Datum
 ts_bgw_worker_release(PG_FUNCTION_ARGS)
 {
-	ts_bgw_total_workers_decrement();
+	ts_bgw_db_workers_decrement(MyDatabaseId);
 	PG_RETURN_VOID();
 }
 
@@ -174,6 +174,19 @@ get_func_strategy(Oid func_oid)
 	return NULL;
 }
 
+/*
+ * Get the comparison strategy of a FIRST/LAST aggregate, i.e. whether it
+ * returns the value for the smallest or the largest comparison element.
+ * Returns InvalidStrategy for any other function.
+ */
+StrategyNumber
+ts_first_last_agg_strategy(Oid aggfnoid)
+{
+	FuncStrategy *func_strategy = get_func_strategy(aggfnoid);
+
+	return func_strategy != NULL ? func_strategy->strategy : InvalidStrategy;
+}
+
 static bool
 is_first_last_node(Node *node, List **context)
 {
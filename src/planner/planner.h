@@ -6,6 +6,7 @@
 #pragma once
 
 #include <postgres.h>
+#include <access/stratnum.h>
 #include <nodes/parsenodes.h>
 #include <nodes/pathnodes.h>
 #include <nodes/pg_list.h>
@@ -98,6 +99,7 @@ bool ts_plan_process_partialize_agg(PlannerInfo *root, RelOptInfo *output_rel);
 
 extern void ts_plan_add_hashagg(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *output_rel);
 extern void ts_preprocess_first_last_aggregates(PlannerInfo *root, List *tlist);
+extern TSDLLEXPORT StrategyNumber ts_first_last_agg_strategy(Oid aggfnoid);
 extern void ts_plan_expand_hypertable_chunks(Hypertable *ht, PlannerInfo *root, RelOptInfo *rel,
 											 bool include_osm);
 extern void ts_plan_expand_timebucket_annotate(PlannerInfo *root, RelOptInfo *rel);
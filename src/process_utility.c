@@ -50,6 +50,7 @@
 
 #include "compat/compat.h"
 #include "annotations.h"
+#include "attstats.h"
 #include "chunk.h"
 #include "chunk_index.h"
 #include "compression_with_clause.h"
@@ -1036,11 +1037,22 @@ process_vacuum(ProcessUtilityArgs *args)
 	ListCell *lc;
 	Hypertable *ht;
 	List *vacuum_rels = NIL;
+	List *analyzed_hypertables = NIL;
 	bool is_vacuumcmd;
+	bool is_analyze;
 	/* save original VacuumRelation list */
 	List *saved_stmt_rels = stmt->rels;
 
 	is_vacuumcmd = stmt->is_vacuumcmd;
+	is_analyze = !is_vacuumcmd;
+
+	foreach (lc, stmt->options)
+	{
+		DefElem *opt = (DefElem *) lfirst(lc);
+
+		if (strcmp(opt->defname, "analyze") == 0)
+			is_analyze = defGetBoolean(opt);
+	}
 
 #if PG16_GE
 	if (is_vacuumcmd)
@@ -1082,6 +1094,9 @@ process_vacuum(ProcessUtilityArgs *args)
 
 					ctx.ht_vacuum_rel = vacuum_rel;
 					foreach_chunk(ht, add_chunk_to_vacuum, &ctx);
+
+					if (is_analyze)
+						analyzed_hypertables = lappend(analyzed_hypertables, vacuum_rel);
 				}
 			}
 			vacuum_rels = lappend(vacuum_rels, vacuum_rel);
@@ -1100,6 +1115,33 @@ process_vacuum(ProcessUtilityArgs *args)
 		/* ACL permission checks inside vacuum_rel and analyze_rel called by this ExecVacuum */
 		ExecVacuum(args->parse_state, stmt, is_toplevel);
 	}
+
+	/*
+	 * ANALYZE doesn't see the rows of compressed chunks, so merge the
+	 * statistics of the compressed chunks into the statistics of the
+	 * hypertable. Autovacuum doesn't run through here, see
+	 * ts_attstats_merge_compressed_chunks().
+	 */
+	if (analyzed_hypertables != NIL)
+	{
+		Cache *hcache = ts_hypertable_cache_pin();
+
+		foreach (lc, analyzed_hypertables)
+		{
+			VacuumRelation *vacuum_rel = lfirst_node(VacuumRelation, lc);
+			Oid table_relid = vacuum_rel->oid;
+
+			if (!OidIsValid(table_relid))
+				table_relid = RangeVarGetRelid(vacuum_rel->relation, NoLock, true);
+
+			ht = ts_hypertable_cache_get_entry(hcache, table_relid, CACHE_FLAG_MISSING_OK);
+
+			if (ht && object_ownercheck(RelationRelationId, table_relid, GetUserId()))
+				ts_attstats_merge_compressed_chunks(ht, vacuum_rel->va_cols);
+		}
+
+		ts_cache_release(hcache);
+	}
 	/*
 	Restore original list. stmt->rels which has references to
 	VacuumRelation list is freed up, however VacuumStmt is not
@@ -0,0 +1,361 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#include <postgres.h>
+#include <fmgr.h>
+#include <libpq/pqformat.h>
+
+#include "compat/compat.h"
+#include "quantile_sketch.h"
+
+/* aggregate approx_percentile:
+ *	 approx_percentile(fraction, value) returns the value at the given fraction
+ *	 of the ordered input values, like percentile_disc(), within the relative
+ *	 accuracy of QUANTILE_SKETCH_RELATIVE_ACCURACY.
+ *
+ * Usage:
+ *	 SELECT device, approx_percentile(0.99, latency) FROM table GROUP BY device;
+ *
+ * Description:
+ * Unlike the ordered-set aggregates, approx_percentile() doesn't have to sort
+ * its input, and the partial aggregates can be combined. So it can use the
+ * chunk-wise, vectorized and parallel aggregation, and it can be used in the
+ * continuous aggregates.
+ */
+
+TS_FUNCTION_INFO_V1(ts_quantile_sketch_sfunc);
+TS_FUNCTION_INFO_V1(ts_quantile_sketch_combinefunc);
+TS_FUNCTION_INFO_V1(ts_quantile_sketch_serializefunc);
+TS_FUNCTION_INFO_V1(ts_quantile_sketch_deserializefunc);
+TS_FUNCTION_INFO_V1(ts_approx_percentile_finalfunc);
+
+/* Number of buckets to add when a store grows, to avoid growing it for every new bucket */
+#define QUANTILE_SKETCH_GROW_BUCKETS 64
+
+void
+ts_quantile_sketch_init(QuantileSketch *sketch)
+{
+	sketch->fraction = -1;
+	sketch->zero_count = 0;
+	sketch->positive = (QuantileSketchStore){ 0 };
+	sketch->negative = (QuantileSketchStore){ 0 };
+}
+
+void
+ts_quantile_sketch_set_fraction_slow(QuantileSketch *sketch, float8 fraction)
+{
+	if (isnan(fraction) || fraction < 0 || fraction > 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+				 errmsg("percentile value %g is not between 0 and 1", fraction)));
+
+	if (sketch->fraction >= 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("percentile value must be the same for all rows of a group")));
+
+	sketch->fraction = fraction;
+}
+
+void
+ts_quantile_sketch_non_finite_error(void)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+			 errmsg("approx_percentile does not support infinite or NaN values")));
+	pg_unreachable();
+}
+
+/*
+ * Extend the store to include the bucket with the given index, and return the
+ * index of the bucket to use for it. If the store would exceed the maximum
+ * number of buckets, the buckets with the lowest indexes are collapsed into one.
+ */
+int32
+ts_quantile_sketch_store_grow(QuantileSketchStore *store, int32 index, MemoryContext mcxt)
+{
+	const int32 old_end = store->offset + store->nbuckets;
+	int32 lo = store->nbuckets == 0 ? index : Min(store->offset, index);
+	int32 hi = store->nbuckets == 0 ? index + 1 : Max(old_end, index + 1);
+
+	if (hi - lo >= QUANTILE_SKETCH_MAX_BUCKETS)
+	{
+		lo = hi - QUANTILE_SKETCH_MAX_BUCKETS;
+
+		/* The store is already full and collapsed at the lowest index */
+		if (store->nbuckets > 0 && lo == store->offset && hi == old_end)
+			return lo;
+	}
+	else
+	{
+		const int32 grow =
+			Min(QUANTILE_SKETCH_MAX_BUCKETS - (hi - lo), QUANTILE_SKETCH_GROW_BUCKETS);
+
+		if (store->nbuckets == 0)
+		{
+			lo -= grow / 2;
+			hi += grow - grow / 2;
+		}
+		else if (index < store->offset)
+			lo -= grow;
+		else
+			hi += grow;
+	}
+
+	int64 *counts = MemoryContextAllocZero(mcxt, sizeof(int64) * (hi - lo));
+
+	for (int32 i = 0; i < store->nbuckets; i++)
+		counts[Max(store->offset + i, lo) - lo] += store->counts[i];
+
+	if (store->counts != NULL)
+		pfree(store->counts);
+
+	store->counts = counts;
+	store->offset = lo;
+	store->nbuckets = hi - lo;
+
+	return Max(index, lo);
+}
+
+static void
+quantile_sketch_store_serialize(StringInfo buf, const QuantileSketchStore *store)
+{
+	int32 first = 0;
+	int32 end = store->nbuckets;
+
+	/* Skip the empty buckets at both ends */
+	while (first < end && store->counts[first] == 0)
+		first++;
+	while (end > first && store->counts[end - 1] == 0)
+		end--;
+
+	pq_sendint32(buf, store->offset + first);
+	pq_sendint32(buf, end - first);
+
+	for (int32 i = first; i < end; i++)
+		pq_sendint64(buf, store->counts[i]);
+}
+
+bytea *
+ts_quantile_sketch_serialize(const QuantileSketch *sketch)
+{
+	StringInfoData buf;
+
+	pq_begintypsend(&buf);
+	pq_sendfloat8(&buf, sketch->fraction);
+	pq_sendint64(&buf, sketch->zero_count);
+	quantile_sketch_store_serialize(&buf, &sketch->positive);
+	quantile_sketch_store_serialize(&buf, &sketch->negative);
+
+	return pq_endtypsend(&buf);
+}
+
+static void
+quantile_sketch_store_deserialize(StringInfo buf, QuantileSketchStore *store, MemoryContext mcxt)
+{
+	store->offset = pq_getmsgint(buf, 4);
+	store->nbuckets = pq_getmsgint(buf, 4);
+
+	if (store->nbuckets < 0 || store->nbuckets > QUANTILE_SKETCH_MAX_BUCKETS)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+				 errmsg("invalid number of buckets in quantile sketch: %d", store->nbuckets)));
+
+	store->counts = NULL;
+	if (store->nbuckets == 0)
+		return;
+
+	store->counts = MemoryContextAlloc(mcxt, sizeof(int64) * store->nbuckets);
+	for (int32 i = 0; i < store->nbuckets; i++)
+		store->counts[i] = pq_getmsgint64(buf);
+}
+
+static void
+quantile_sketch_store_combine(QuantileSketchStore *store1, const QuantileSketchStore *store2,
+							  MemoryContext mcxt)
+{
+	for (int32 i = 0; i < store2->nbuckets; i++)
+	{
+		if (store2->counts[i] != 0)
+			quantile_sketch_store_add(store1, store2->offset + i, store2->counts[i], mcxt);
+	}
+}
+
+/* quantile_sketch_sfunc(internal, double precision, double precision) => internal */
+Datum
+ts_quantile_sketch_sfunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	QuantileSketch *sketch = (QuantileSketch *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_quantile_sketch_sfunc called in non-aggregate context");
+	}
+
+	if (sketch == NULL)
+	{
+		sketch = MemoryContextAlloc(aggcontext, sizeof(QuantileSketch));
+		ts_quantile_sketch_init(sketch);
+	}
+
+	/* Rows without a fraction or a value don't contribute */
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+		PG_RETURN_POINTER(sketch);
+
+	ts_quantile_sketch_set_fraction(sketch, PG_GETARG_FLOAT8(1));
+	ts_quantile_sketch_add(sketch, PG_GETARG_FLOAT8(2), 1, aggcontext);
+
+	PG_RETURN_POINTER(sketch);
+}
+
+/* quantile_sketch_combinefunc(internal, internal) => internal */
+Datum
+ts_quantile_sketch_combinefunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	QuantileSketch *sketch1 = (QuantileSketch *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+	QuantileSketch *sketch2 = (QuantileSketch *) (PG_ARGISNULL(1) ? NULL : PG_GETARG_POINTER(1));
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_quantile_sketch_combinefunc called in non-aggregate context");
+	}
+
+	if (sketch2 == NULL || sketch2->fraction < 0)
+	{
+		if (sketch1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(sketch1);
+	}
+
+	if (sketch1 == NULL)
+	{
+		sketch1 = MemoryContextAlloc(aggcontext, sizeof(QuantileSketch));
+		ts_quantile_sketch_init(sketch1);
+	}
+
+	ts_quantile_sketch_set_fraction(sketch1, sketch2->fraction);
+	sketch1->zero_count += sketch2->zero_count;
+	quantile_sketch_store_combine(&sketch1->positive, &sketch2->positive, aggcontext);
+	quantile_sketch_store_combine(&sketch1->negative, &sketch2->negative, aggcontext);
+
+	PG_RETURN_POINTER(sketch1);
+}
+
+/* quantile_sketch_serializefunc(internal) => bytea */
+Datum
+ts_quantile_sketch_serializefunc(PG_FUNCTION_ARGS)
+{
+	Assert(!PG_ARGISNULL(0));
+
+	PG_RETURN_BYTEA_P(ts_quantile_sketch_serialize((QuantileSketch *) PG_GETARG_POINTER(0)));
+}
+
+/* quantile_sketch_deserializefunc(bytea, internal) => internal */
+Datum
+ts_quantile_sketch_deserializefunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	bytea *serialized;
+	StringInfoData buf;
+	QuantileSketch *sketch;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "ts_quantile_sketch_deserializefunc called in non-aggregate context");
+
+	Assert(!PG_ARGISNULL(0));
+	serialized = PG_GETARG_BYTEA_P(0);
+
+	buf.data = VARDATA(serialized);
+	buf.len = VARSIZE(serialized) - VARHDRSZ;
+	buf.maxlen = VARSIZE(serialized) - VARHDRSZ;
+	buf.cursor = 0;
+
+	sketch = MemoryContextAlloc(aggcontext, sizeof(QuantileSketch));
+	sketch->fraction = pq_getmsgfloat8(&buf);
+	sketch->zero_count = pq_getmsgint64(&buf);
+	quantile_sketch_store_deserialize(&buf, &sketch->positive, aggcontext);
+	quantile_sketch_store_deserialize(&buf, &sketch->negative, aggcontext);
+
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(sketch);
+}
+
+/* The value that represents the bucket within the relative accuracy */
+static float8
+quantile_sketch_bucket_value(int32 index)
+{
+	return (1.0 - QUANTILE_SKETCH_RELATIVE_ACCURACY) *
+		   exp((float8) index / QUANTILE_SKETCH_INV_LOG_GAMMA);
+}
+
+static int64
+quantile_sketch_store_count(const QuantileSketchStore *store)
+{
+	int64 count = 0;
+
+	for (int32 i = 0; i < store->nbuckets; i++)
+		count += store->counts[i];
+
+	return count;
+}
+
+/* approx_percentile_finalfunc(internal) => double precision */
+Datum
+ts_approx_percentile_finalfunc(PG_FUNCTION_ARGS)
+{
+	QuantileSketch *sketch;
+
+	if (!AggCheckCallContext(fcinfo, NULL))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_approx_percentile_finalfunc called in non-aggregate context");
+	}
+
+	sketch = (QuantileSketch *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (sketch == NULL || sketch->fraction < 0)
+		PG_RETURN_NULL();
+
+	const int64 total = sketch->zero_count + quantile_sketch_store_count(&sketch->negative) +
+						quantile_sketch_store_count(&sketch->positive);
+
+	if (total == 0)
+		PG_RETURN_NULL();
+
+	/*
+	 * The rank of the requested value in the ordered input, starting from
+	 * zero, computed like percentile_disc() does
+	 */
+	const float8 rank = Max(ceil(sketch->fraction * total), 1) - 1;
+	int64 count = 0;
+
+	/* The negative values, starting from the largest absolute value */
+	for (int32 i = sketch->negative.nbuckets - 1; i >= 0; i--)
+	{
+		count += sketch->negative.counts[i];
+		if (count > rank)
+			PG_RETURN_FLOAT8(-quantile_sketch_bucket_value(sketch->negative.offset + i));
+	}
+
+	count += sketch->zero_count;
+	if (count > rank)
+		PG_RETURN_FLOAT8(0);
+
+	for (int32 i = 0; i < sketch->positive.nbuckets; i++)
+	{
+		count += sketch->positive.counts[i];
+		if (count > rank)
+			PG_RETURN_FLOAT8(quantile_sketch_bucket_value(sketch->positive.offset + i));
+	}
+
+	/* The rank is less than the total count, so we should have found the value */
+	elog(ERROR, "invalid quantile sketch");
+	PG_RETURN_NULL();
+}
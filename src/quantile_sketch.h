@@ -0,0 +1,104 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+
+#pragma once
+
+#include <postgres.h>
+#include <math.h>
+
+#include "export.h"
+
+/*
+ * Transition state of the approx_percentile() aggregate.
+ *
+ * This is a DDSketch: the absolute values are counted in logarithmic buckets,
+ * so that every value of a bucket is within the relative accuracy of the value
+ * that represents the bucket. The sketches of different partial aggregates are
+ * merged by adding up the bucket counts, so the aggregate can be computed per
+ * chunk, per compressed batch or in parallel workers.
+ *
+ * The buckets are stored densely, and the number of buckets of a store is
+ * limited. When a store would grow beyond the limit, the buckets with the
+ * smallest absolute values are collapsed into one, so the accuracy is lost for
+ * the values closest to zero first.
+ */
+
+/* Relative accuracy of the quantiles. */
+#define QUANTILE_SKETCH_RELATIVE_ACCURACY 0.01
+
+/* 1 / log(gamma) with gamma = (1 + accuracy) / (1 - accuracy) */
+#define QUANTILE_SKETCH_INV_LOG_GAMMA                                                              \
+	(1.0 / log((1.0 + QUANTILE_SKETCH_RELATIVE_ACCURACY) /                                         \
+			   (1.0 - QUANTILE_SKETCH_RELATIVE_ACCURACY)))
+
+#define QUANTILE_SKETCH_MAX_BUCKETS 2048
+
+typedef struct QuantileSketchStore
+{
+	/* Bucket index of counts[0]. */
+	int32 offset;
+	int32 nbuckets;
+	int64 *counts;
+} QuantileSketchStore;
+
+typedef struct QuantileSketch
+{
+	/* The requested quantile, or -1 before the first row. */
+	float8 fraction;
+	int64 zero_count;
+	QuantileSketchStore positive;
+	QuantileSketchStore negative;
+} QuantileSketch;
+
+extern TSDLLEXPORT void ts_quantile_sketch_init(QuantileSketch *sketch);
+extern TSDLLEXPORT void ts_quantile_sketch_set_fraction_slow(QuantileSketch *sketch,
+															 float8 fraction);
+extern TSDLLEXPORT int32 ts_quantile_sketch_store_grow(QuantileSketchStore *store, int32 index,
+													   MemoryContext mcxt);
+extern TSDLLEXPORT pg_attribute_noreturn() void ts_quantile_sketch_non_finite_error(void);
+extern TSDLLEXPORT bytea *ts_quantile_sketch_serialize(const QuantileSketch *sketch);
+
+static inline void
+ts_quantile_sketch_set_fraction(QuantileSketch *sketch, float8 fraction)
+{
+	if (likely(sketch->fraction == fraction))
+		return;
+
+	ts_quantile_sketch_set_fraction_slow(sketch, fraction);
+}
+
+static inline void
+quantile_sketch_store_add(QuantileSketchStore *store, int32 index, int64 count,
+						  MemoryContext mcxt)
+{
+	if (unlikely(index < store->offset || index >= store->offset + store->nbuckets))
+		index = ts_quantile_sketch_store_grow(store, index, mcxt);
+
+	store->counts[index - store->offset] += count;
+}
+
+/*
+ * Add a value to the sketch the given number of times. The infinities and NaN
+ * can't be placed in a bucket.
+ */
+static inline void
+ts_quantile_sketch_add(QuantileSketch *sketch, float8 value, int64 count, MemoryContext mcxt)
+{
+	if (unlikely(!isfinite(value)))
+		ts_quantile_sketch_non_finite_error();
+
+	if (value == 0)
+	{
+		sketch->zero_count += count;
+		return;
+	}
+
+	const int32 index = (int32) ceil(log(fabs(value)) * QUANTILE_SKETCH_INV_LOG_GAMMA);
+	quantile_sketch_store_add(value > 0 ? &sketch->positive : &sketch->negative,
+							  index,
+							  count,
+							  mcxt);
+}
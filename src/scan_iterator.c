@@ -4,6 +4,10 @@
  * LICENSE-APACHE for a copy of the license.
  */
 #include <postgres.h>
+#include <catalog/pg_collation.h>
+#include <catalog/pg_type.h>
+#include <utils/array.h>
+#include <utils/fmgroids.h>
 
 #include "scan_iterator.h"
 
@@ -53,6 +57,53 @@ ts_scan_iterator_scan_key_init(ScanIterator *iterator, AttrNumber attributeNumbe
 	MemoryContextSwitchTo(oldmcxt);
 }
 
+/*
+ * Initialize a scan key that matches any of the given int32 values, like
+ * "attr = ANY(values)".
+ *
+ * The btree index sorts and deduplicates the values and returns the matching
+ * tuples in index order, so looking up many keys takes a single index scan
+ * instead of one scan per key. Heap scans cannot evaluate array keys, so this
+ * requires an index to be set on the iterator.
+ */
+TSDLLEXPORT void
+ts_scan_iterator_scan_key_init_int32_array(ScanIterator *iterator, AttrNumber attributeNumber,
+										   const int32 *values, int nvalues)
+{
+	MemoryContext oldmcxt;
+	Datum *elems;
+	ArrayType *array;
+
+	Assert(iterator->ctx.scankey == NULL || iterator->ctx.scankey == iterator->scankey);
+	iterator->ctx.scankey = iterator->scankey;
+
+	if (!OidIsValid(iterator->ctx.index))
+		elog(ERROR, "array scan keys require an index scan");
+
+	if (iterator->ctx.nkeys >= EMBEDDED_SCAN_KEY_SIZE)
+		elog(ERROR, "cannot scan more than %d keys", EMBEDDED_SCAN_KEY_SIZE);
+
+	/* The array has to live as long as the scan key */
+	oldmcxt = MemoryContextSwitchTo(iterator->ctx.internal.scan_mcxt);
+	elems = palloc(sizeof(Datum) * nvalues);
+
+	for (int i = 0; i < nvalues; i++)
+		elems[i] = Int32GetDatum(values[i]);
+
+	array = construct_array(elems, nvalues, INT4OID, sizeof(int32), true, TYPALIGN_INT);
+	pfree(elems);
+
+	ScanKeyEntryInitialize(&iterator->scankey[iterator->ctx.nkeys++],
+						   SK_SEARCHARRAY,
+						   attributeNumber,
+						   BTEqualStrategyNumber,
+						   InvalidOid,
+						   C_COLLATION_OID,
+						   F_INT4EQ,
+						   PointerGetDatum(array));
+	MemoryContextSwitchTo(oldmcxt);
+}
+
 TSDLLEXPORT void
 ts_scan_iterator_rescan(ScanIterator *iterator)
 {
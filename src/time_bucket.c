@@ -13,6 +13,7 @@
 #include <utils/timestamp.h>
 
 #include "time_bucket.h"
+#include "timezones.h"
 #include "utils.h"
 
 #define TIME_BUCKET(period, timestamp, offset, min, max, result)                                   \
@@ -344,8 +345,11 @@ ts_timestamptz_timezone_bucket(PG_FUNCTION_ARGS)
 	if (PG_ARGISNULL(0) || PG_ARGISNULL(1) || PG_ARGISNULL(2))
 		PG_RETURN_NULL();
 
+	TsTimezoneCache *tzcache = ts_timezone_cache_get(fcinfo->flinfo, tzname);
+	TimestampTz timestamptz = DatumGetTimestampTz(timestamp);
+
 	/* Convert to local timestamp according to timezone */
-	timestamp = DirectFunctionCall2(timestamptz_zone, tzname, timestamp);
+	timestamp = TimestampGetDatum(ts_timezone_cache_to_local(tzcache, tzname, timestamptz));
 	if (have_offset)
 	{
 		/* Apply offset. */
@@ -354,7 +358,8 @@ ts_timestamptz_timezone_bucket(PG_FUNCTION_ARGS)
 
 	if (have_origin)
 	{
-		Datum origin = DirectFunctionCall2(timestamptz_zone, tzname, PG_GETARG_DATUM(3));
+		Datum origin = TimestampGetDatum(
+			ts_timezone_cache_to_local(tzcache, tzname, PG_GETARG_TIMESTAMPTZ(3)));
 		timestamp = DirectFunctionCall3(ts_timestamp_bucket, period, timestamp, origin);
 	}
 	else
@@ -369,9 +374,8 @@ ts_timestamptz_timezone_bucket(PG_FUNCTION_ARGS)
 	}
 
 	/* Convert back to timezone */
-	timestamp = DirectFunctionCall2(timestamp_zone, tzname, timestamp);
-
-	PG_RETURN_DATUM(timestamp);
+	PG_RETURN_TIMESTAMPTZ(
+		ts_timezone_cache_to_utc(tzcache, tzname, DatumGetTimestamp(timestamp), timestamptz));
 }
 
 static inline void
@@ -720,14 +724,15 @@ ts_time_bucket_ng_timezone(PG_FUNCTION_ARGS)
 	Timestamp result;
 	Datum timestamp;
 	Datum interval = PG_GETARG_DATUM(0);
-	Datum timestamptz = PG_GETARG_DATUM(1);
+	TimestampTz timestamptz = PG_GETARG_TIMESTAMPTZ(1);
 	Datum tzname = PG_GETARG_DATUM(2);
+	TsTimezoneCache *tzcache = ts_timezone_cache_get(fcinfo->flinfo, tzname);
 
 	/*
 	 * Convert 'timestamptz' to TIMESTAMP at given 'tzname'.
 	 * The code is equal to 'timestamptz AT TIME ZONE tzname'.
 	 */
-	timestamp = DirectFunctionCall2(timestamptz_zone, tzname, timestamptz);
+	timestamp = TimestampGetDatum(ts_timezone_cache_to_local(tzcache, tzname, timestamptz));
 
 	/* Then treat resulting timestamp as a regular one */
 	result =
@@ -735,7 +740,7 @@ ts_time_bucket_ng_timezone(PG_FUNCTION_ARGS)
 	if (TIMESTAMP_NOT_FINITE(result))
 		PG_RETURN_TIMESTAMP(result);
 
-	PG_RETURN_DATUM(DirectFunctionCall2(timestamp_zone, tzname, TimestampGetDatum(result)));
+	PG_RETURN_TIMESTAMPTZ(ts_timezone_cache_to_utc(tzcache, tzname, result, timestamptz));
 }
 
 TS_FUNCTION_INFO_V1(ts_time_bucket_ng_timezone_origin);
@@ -745,18 +750,19 @@ ts_time_bucket_ng_timezone_origin(PG_FUNCTION_ARGS)
 	Timestamp result;
 	Datum timestamp, origin;
 	Datum interval = PG_GETARG_DATUM(0);
-	Datum timestamptz = PG_GETARG_DATUM(1);
-	Datum origintz = PG_GETARG_DATUM(2);
+	TimestampTz timestamptz = PG_GETARG_TIMESTAMPTZ(1);
+	TimestampTz origintz = PG_GETARG_TIMESTAMPTZ(2);
 	Datum tzname = PG_GETARG_DATUM(3);
+	TsTimezoneCache *tzcache = ts_timezone_cache_get(fcinfo->flinfo, tzname);
 
 	/*
 	 * Convert 'origin' to TIMESTAMP at given 'tzname'.
 	 * The code is equal to 'origin AT TIME ZONE tzname'.
 	 */
-	origin = DirectFunctionCall2(timestamptz_zone, tzname, origintz);
+	origin = TimestampGetDatum(ts_timezone_cache_to_local(tzcache, tzname, origintz));
 
 	/* Same for 'timestamptz' */
-	timestamp = DirectFunctionCall2(timestamptz_zone, tzname, timestamptz);
+	timestamp = TimestampGetDatum(ts_timezone_cache_to_local(tzcache, tzname, timestamptz));
 
 	/* Then treat resulting 'timestamp' and 'origin' as a regular ones */
 	result = DatumGetTimestamp(
@@ -764,5 +770,5 @@ ts_time_bucket_ng_timezone_origin(PG_FUNCTION_ARGS)
 	if (TIMESTAMP_NOT_FINITE(result))
 		PG_RETURN_TIMESTAMP(result);
 
-	PG_RETURN_DATUM(DirectFunctionCall2(timestamp_zone, tzname, TimestampGetDatum(result)));
+	PG_RETURN_TIMESTAMPTZ(ts_timezone_cache_to_utc(tzcache, tzname, result, timestamptz));
 }
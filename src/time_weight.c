@@ -0,0 +1,333 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#include <postgres.h>
+#include <fmgr.h>
+#include <libpq/pqformat.h>
+#include <utils/timestamp.h>
+
+#include "compat/compat.h"
+#include "time_weight.h"
+
+/* aggregates time_weighted_avg, integral and counter_rate:
+ *	 time_weighted_avg(time, value) returns the average of the values weighted by
+ *	 the time between them.
+ *	 integral(time, value) returns the area under the values over time, in
+ *	 value-seconds.
+ *	 counter_rate(time, value) returns the per-second increase of a counter that
+ *	 is reset to zero whenever the value decreases.
+ *
+ * Usage:
+ *	 SELECT device, time_weighted_avg(time, temp) FROM table GROUP BY device;
+ *
+ * Description:
+ * The values are linearly interpolated between consecutive points in time. The
+ * rows have to arrive in time order within each partial aggregate, which holds
+ * for the usual scans of hypertable chunks and compressed batches. Other input
+ * can be ordered with an ORDER BY in the aggregate call.
+ */
+
+TS_FUNCTION_INFO_V1(ts_time_weight_sfunc);
+TS_FUNCTION_INFO_V1(ts_time_weight_combinefunc);
+TS_FUNCTION_INFO_V1(ts_time_weight_serializefunc);
+TS_FUNCTION_INFO_V1(ts_time_weight_deserializefunc);
+TS_FUNCTION_INFO_V1(ts_time_weighted_avg_finalfunc);
+TS_FUNCTION_INFO_V1(ts_time_weight_integral_finalfunc);
+TS_FUNCTION_INFO_V1(ts_counter_rate_finalfunc);
+
+void
+ts_time_weight_unordered_error(void)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_DATA_EXCEPTION),
+			 errmsg("time-weighted aggregate input is not ordered by time"),
+			 errhint("Order the input by time, for example with ORDER BY in the aggregate call.")));
+	pg_unreachable();
+}
+
+void
+ts_time_weight_state_init(TimeWeightState *state)
+{
+	state->nruns = 0;
+	state->maxruns = 0;
+	state->runs = NULL;
+}
+
+void
+ts_time_weight_state_add_run(TimeWeightState *state, const TimeWeightRun *run, MemoryContext mcxt)
+{
+	if (state->nruns == state->maxruns)
+	{
+		state->maxruns = state->maxruns == 0 ? 4 : state->maxruns * 2;
+
+		if (state->runs == NULL)
+			state->runs = MemoryContextAlloc(mcxt, sizeof(TimeWeightRun) * state->maxruns);
+		else
+			state->runs = repalloc(state->runs, sizeof(TimeWeightRun) * state->maxruns);
+	}
+
+	state->runs[state->nruns++] = *run;
+}
+
+/* Append the run "after", which must not start before "before" ends, to "before" */
+static void
+time_weight_run_stitch(TimeWeightRun *before, const TimeWeightRun *after)
+{
+	Assert(before->last_time <= after->first_time);
+
+	before->area += after->area + time_weight_seconds(before->last_time, after->first_time) *
+									  ((before->last_value + after->first_value) / 2);
+	before->increase +=
+		after->increase + time_weight_counter_increase(before->last_value, after->first_value);
+	before->last_time = after->last_time;
+	before->last_value = after->last_value;
+}
+
+static int
+time_weight_run_cmp(const void *left, const void *right)
+{
+	const TimeWeightRun *l = (const TimeWeightRun *) left;
+	const TimeWeightRun *r = (const TimeWeightRun *) right;
+
+	if (l->first_time != r->first_time)
+		return l->first_time < r->first_time ? -1 : 1;
+	if (l->last_time != r->last_time)
+		return l->last_time < r->last_time ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Stitch all the runs together in time order. Overlapping runs mean that the
+ * input was not ordered by time, and there is no way to interpolate between
+ * their points anymore.
+ */
+static void
+time_weight_state_compact(TimeWeightState *state)
+{
+	if (state->nruns < 2)
+		return;
+
+	qsort(state->runs, state->nruns, sizeof(TimeWeightRun), time_weight_run_cmp);
+
+	for (int i = 1; i < state->nruns; i++)
+	{
+		if (state->runs[i].first_time < state->runs[0].last_time)
+			ts_time_weight_unordered_error();
+
+		time_weight_run_stitch(&state->runs[0], &state->runs[i]);
+	}
+
+	state->nruns = 1;
+}
+
+/*
+ * The runs are not stitched together here, because the partial states of
+ * other chunks or batches might fill the gaps between them.
+ */
+bytea *
+ts_time_weight_state_serialize(const TimeWeightState *state)
+{
+	StringInfoData buf;
+
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, state->nruns);
+
+	for (int32 i = 0; i < state->nruns; i++)
+	{
+		const TimeWeightRun *run = &state->runs[i];
+
+		pq_sendint64(&buf, run->first_time);
+		pq_sendint64(&buf, run->last_time);
+		pq_sendfloat8(&buf, run->first_value);
+		pq_sendfloat8(&buf, run->last_value);
+		pq_sendfloat8(&buf, run->area);
+		pq_sendfloat8(&buf, run->increase);
+	}
+
+	return pq_endtypsend(&buf);
+}
+
+/* time_weight_sfunc(internal, timestamptz, double precision) => internal */
+Datum
+ts_time_weight_sfunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	TimeWeightState *state = (TimeWeightState *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_time_weight_sfunc called in non-aggregate context");
+	}
+
+	if (state == NULL)
+	{
+		state = MemoryContextAlloc(aggcontext, sizeof(TimeWeightState));
+		ts_time_weight_state_init(state);
+	}
+
+	/* Rows without a time or a value don't contribute */
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+		PG_RETURN_POINTER(state);
+
+	ts_time_weight_state_add_point(state,
+								   PG_GETARG_TIMESTAMPTZ(1),
+								   PG_GETARG_FLOAT8(2),
+								   aggcontext);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* time_weight_combinefunc(internal, internal) => internal */
+Datum
+ts_time_weight_combinefunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	TimeWeightState *state1 = (TimeWeightState *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+	TimeWeightState *state2 = (TimeWeightState *) (PG_ARGISNULL(1) ? NULL : PG_GETARG_POINTER(1));
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_time_weight_combinefunc called in non-aggregate context");
+	}
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+	{
+		state1 = MemoryContextAlloc(aggcontext, sizeof(TimeWeightState));
+		ts_time_weight_state_init(state1);
+	}
+
+	for (int32 i = 0; i < state2->nruns; i++)
+		ts_time_weight_state_add_run(state1, &state2->runs[i], aggcontext);
+
+	PG_RETURN_POINTER(state1);
+}
+
+/* time_weight_serializefunc(internal) => bytea */
+Datum
+ts_time_weight_serializefunc(PG_FUNCTION_ARGS)
+{
+	Assert(!PG_ARGISNULL(0));
+
+	PG_RETURN_BYTEA_P(ts_time_weight_state_serialize((TimeWeightState *) PG_GETARG_POINTER(0)));
+}
+
+/* time_weight_deserializefunc(bytea, internal) => internal */
+Datum
+ts_time_weight_deserializefunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	bytea *serialized;
+	StringInfoData buf;
+	TimeWeightState *state;
+	int32 nruns;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "ts_time_weight_deserializefunc called in non-aggregate context");
+
+	Assert(!PG_ARGISNULL(0));
+	serialized = PG_GETARG_BYTEA_P(0);
+
+	buf.data = VARDATA(serialized);
+	buf.len = VARSIZE(serialized) - VARHDRSZ;
+	buf.maxlen = VARSIZE(serialized) - VARHDRSZ;
+	buf.cursor = 0;
+
+	nruns = pq_getmsgint(&buf, 4);
+
+	state = MemoryContextAlloc(aggcontext, sizeof(TimeWeightState));
+	ts_time_weight_state_init(state);
+
+	for (int32 i = 0; i < nruns; i++)
+	{
+		TimeWeightRun run = { 0 };
+
+		run.first_time = pq_getmsgint64(&buf);
+		run.last_time = pq_getmsgint64(&buf);
+		run.first_value = pq_getmsgfloat8(&buf);
+		run.last_value = pq_getmsgfloat8(&buf);
+		run.area = pq_getmsgfloat8(&buf);
+		run.increase = pq_getmsgfloat8(&buf);
+		ts_time_weight_state_add_run(state, &run, aggcontext);
+	}
+
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(state);
+}
+
+/*
+ * Stitch the runs of the final state together. Returns NULL if there were no
+ * input rows.
+ */
+static TimeWeightRun *
+time_weight_final_run(FunctionCallInfo fcinfo, const char *funcname)
+{
+	TimeWeightState *state;
+
+	if (!AggCheckCallContext(fcinfo, NULL))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "%s called in non-aggregate context", funcname);
+	}
+
+	state = (TimeWeightState *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (state == NULL)
+		return NULL;
+
+	time_weight_state_compact(state);
+
+	return state->nruns > 0 ? &state->runs[0] : NULL;
+}
+
+/* time_weighted_avg_finalfunc(internal) => double precision */
+Datum
+ts_time_weighted_avg_finalfunc(PG_FUNCTION_ARGS)
+{
+	TimeWeightRun *run = time_weight_final_run(fcinfo, "ts_time_weighted_avg_finalfunc");
+
+	if (run == NULL)
+		PG_RETURN_NULL();
+
+	/* All the rows are at the same point in time, so there is nothing to weigh */
+	if (run->first_time == run->last_time)
+		PG_RETURN_FLOAT8(run->last_value);
+
+	PG_RETURN_FLOAT8(run->area / time_weight_seconds(run->first_time, run->last_time));
+}
+
+/* time_weight_integral_finalfunc(internal) => double precision */
+Datum
+ts_time_weight_integral_finalfunc(PG_FUNCTION_ARGS)
+{
+	TimeWeightRun *run = time_weight_final_run(fcinfo, "ts_time_weight_integral_finalfunc");
+
+	if (run == NULL)
+		PG_RETURN_NULL();
+
+	PG_RETURN_FLOAT8(run->area);
+}
+
+/* counter_rate_finalfunc(internal) => double precision */
+Datum
+ts_counter_rate_finalfunc(PG_FUNCTION_ARGS)
+{
+	TimeWeightRun *run = time_weight_final_run(fcinfo, "ts_counter_rate_finalfunc");
+
+	/* A rate needs at least two different points in time */
+	if (run == NULL || run->first_time == run->last_time)
+		PG_RETURN_NULL();
+
+	PG_RETURN_FLOAT8(run->increase / time_weight_seconds(run->first_time, run->last_time));
+}
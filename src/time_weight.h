@@ -0,0 +1,150 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+
+#pragma once
+
+#include <postgres.h>
+#include <datatype/timestamp.h>
+
+#include "export.h"
+
+/*
+ * Transition state shared by the time_weighted_avg(), integral() and
+ * counter_rate() aggregates.
+ *
+ * The values are linearly interpolated between consecutive points in time, so
+ * the aggregates need their input ordered by time. Instead of collecting and
+ * sorting all the points, the state keeps "runs": stretches of input that
+ * arrived in time order (ascending or descending), summarized by their end
+ * points, the area under the interpolated values and the increase of the
+ * counter. Input that is sorted per chunk or per compressed batch forms one run
+ * per chunk or batch, and the runs are stitched together in time order by the
+ * final function. Runs that overlap in time cannot be stitched together, so the
+ * input is reported as unordered.
+ */
+typedef struct TimeWeightRun
+{
+	TimestampTz first_time;
+	TimestampTz last_time;
+	float8 first_value;
+	float8 last_value;
+	/* Area under the interpolated values, in value-seconds. */
+	float8 area;
+	/* Increase of the values treated as a counter that can reset to zero. */
+	float8 increase;
+	/* The run grows towards earlier points in time. */
+	bool descending;
+} TimeWeightRun;
+
+typedef struct TimeWeightState
+{
+	int32 nruns;
+	int32 maxruns;
+	TimeWeightRun *runs;
+} TimeWeightState;
+
+static inline float8
+time_weight_seconds(TimestampTz from, TimestampTz to)
+{
+	return (float8) (to - from) / USECS_PER_SEC;
+}
+
+/*
+ * A decrease of a counter means it was reset to zero and then counted up to
+ * the new value.
+ */
+static inline float8
+time_weight_counter_increase(float8 from, float8 to)
+{
+	return to >= from ? to - from : to;
+}
+
+static inline void
+time_weight_run_init(TimeWeightRun *run, TimestampTz time, float8 value)
+{
+	run->first_time = time;
+	run->last_time = time;
+	run->first_value = value;
+	run->last_value = value;
+	run->area = 0;
+	run->increase = 0;
+	run->descending = false;
+}
+
+/*
+ * Add the next point of the input to the run. Returns false if the point does
+ * not continue the run in its direction. Note that a point on the other side
+ * of the run doesn't necessarily follow the run: the input might have skipped
+ * some points that arrive later, e.g. in another compressed batch.
+ */
+static inline bool
+time_weight_run_extend(TimeWeightRun *run, TimestampTz time, float8 value)
+{
+	if (!run->descending && time >= run->last_time)
+	{
+		run->area +=
+			time_weight_seconds(run->last_time, time) * ((run->last_value + value) / 2);
+		run->increase += time_weight_counter_increase(run->last_value, value);
+		run->last_time = time;
+		run->last_value = value;
+		return true;
+	}
+
+	if (time <= run->first_time && (run->descending || run->first_time == run->last_time))
+	{
+		run->area +=
+			time_weight_seconds(time, run->first_time) * ((value + run->first_value) / 2);
+		run->increase += time_weight_counter_increase(value, run->first_value);
+		run->first_time = time;
+		run->first_value = value;
+		run->descending = true;
+		return true;
+	}
+
+	return false;
+}
+
+extern TSDLLEXPORT pg_attribute_noreturn() void ts_time_weight_unordered_error(void);
+extern TSDLLEXPORT void ts_time_weight_state_init(TimeWeightState *state);
+extern TSDLLEXPORT void ts_time_weight_state_add_run(TimeWeightState *state,
+													 const TimeWeightRun *run,
+													 MemoryContext mcxt);
+extern TSDLLEXPORT bytea *ts_time_weight_state_serialize(const TimeWeightState *state);
+
+/*
+ * Start a new run with the given point. A point that falls inside the previous
+ * run means that the input is not ordered by time.
+ */
+static inline void
+time_weight_run_restart(TimeWeightRun *run, TimestampTz time, float8 value)
+{
+	if (time > run->first_time && time < run->last_time)
+		ts_time_weight_unordered_error();
+
+	time_weight_run_init(run, time, value);
+}
+
+static inline void
+ts_time_weight_state_add_point(TimeWeightState *state, TimestampTz time, float8 value,
+							   MemoryContext mcxt)
+{
+	TimeWeightRun run;
+
+	if (state->nruns > 0)
+	{
+		TimeWeightRun *last = &state->runs[state->nruns - 1];
+
+		if (time_weight_run_extend(last, time, value))
+			return;
+
+		run = *last;
+		time_weight_run_restart(&run, time, value);
+	}
+	else
+		time_weight_run_init(&run, time, value);
+
+	ts_time_weight_state_add_run(state, &run, mcxt);
+}
@@ -8,10 +8,15 @@
 #include "timezones.h"
 #include <access/xact.h>
 #include <datatype/timestamp.h>
+#include <parser/scansup.h>
 #include <pgtime.h>
 #include <port.h>
+#include <utils/builtins.h>
+#include <utils/datetime.h>
 #include <utils/timestamp.h>
 
+#include "compat/compat.h"
+
 /* Checks if the given TZ name is valid. */
 bool
 ts_is_valid_timezone_name(const char *tz_name)
@@ -48,3 +53,333 @@ ts_is_valid_timezone_name(const char *tz_name)
 	pg_tzenumerate_end(tzenum);
 	return found;
 }
+
+/*
+ * A range of time with a constant UTC offset.
+ *
+ * When the offset decreases at the end of the range, local times of the last
+ * part of the range repeat right after the end. Those local times are
+ * converted back to the later instant, so a local time only maps into this
+ * range before unambiguous_end.
+ */
+typedef struct TimezoneOffsetRange
+{
+	TimestampTz start;
+	TimestampTz end;
+	TimestampTz unambiguous_end;
+	int64 offset; /* microseconds east of UTC */
+} TimezoneOffsetRange;
+
+/*
+ * The ranges are sorted by start and do not overlap. They are only computed
+ * for the times that are converted, so the ranges of a query usually cover
+ * the scanned time range after a few calls. Zones with a fixed offset have a
+ * single range covering all times. Dynamic abbreviations are not cached.
+ */
+struct TsTimezoneCache
+{
+	text *tzname;
+	bool cacheable;
+	pg_tz *tz; /* NULL for a fixed offset */
+	int nranges;
+	int maxranges;
+	int last;
+	TimezoneOffsetRange *ranges;
+};
+
+#define TIMEZONE_CACHE_MAX_RANGES 1024
+
+/* How far back to look for the transition starting a range */
+#define TIMEZONE_CACHE_LOOKBEHIND (400 * SECS_PER_DAY)
+
+#define UNIX_EPOCH_OFFSET_SECS ((int64) (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * SECS_PER_DAY)
+
+static pg_time_t
+timestamp_to_pg_time(TimestampTz timestamp)
+{
+	int64 secs = timestamp / USECS_PER_SEC;
+
+	if (timestamp % USECS_PER_SEC < 0)
+		secs--;
+
+	return secs + UNIX_EPOCH_OFFSET_SECS;
+}
+
+static TimestampTz
+pg_time_to_timestamp(pg_time_t time)
+{
+	return (time - UNIX_EPOCH_OFFSET_SECS) * USECS_PER_SEC;
+}
+
+static void
+timezone_cache_init(TsTimezoneCache *cache, Datum tzname)
+{
+	char tzbuf[TZ_STRLEN_MAX + 1];
+	int offset;
+	pg_tz *tz = NULL;
+	bool fixed = false;
+
+	cache->cacheable = false;
+	cache->tz = NULL;
+	cache->nranges = 0;
+	cache->last = 0;
+
+	text_to_cstring_buffer(DatumGetTextPP(tzname), tzbuf, sizeof(tzbuf));
+
+#if PG16_LT
+	char *lowzone = downcase_truncate_identifier(tzbuf, strlen(tzbuf), false);
+	int type = DecodeTimezoneAbbrev(0, lowzone, &offset, &tz);
+
+	if (type == TZ || type == DTZ)
+		fixed = true;
+	else if (type != DYNTZ)
+		tz = pg_tzset(tzbuf);
+	else
+		tz = NULL;
+#else
+	int type = DecodeTimezoneName(tzbuf, &offset, &tz);
+
+	if (type == TZNAME_FIXED_OFFSET)
+		fixed = true;
+	else if (type != TZNAME_ZONE)
+		tz = NULL;
+#endif
+
+	if (fixed)
+	{
+		/* a fixed offset is a single range */
+		cache->ranges[0] = (TimezoneOffsetRange){
+			.start = DT_NOBEGIN,
+			.end = DT_NOEND,
+			.unambiguous_end = DT_NOEND,
+			.offset = (int64) offset * USECS_PER_SEC,
+		};
+		cache->nranges = 1;
+		cache->cacheable = true;
+	}
+	else if (tz != NULL)
+	{
+		cache->tz = tz;
+		cache->cacheable = true;
+	}
+}
+
+TsTimezoneCache *
+ts_timezone_cache_get(FmgrInfo *flinfo, Datum tzname)
+{
+	TsTimezoneCache *cache;
+	text *name = DatumGetTextPP(tzname);
+
+	/* no cache when called with DirectFunctionCall */
+	if (flinfo == NULL)
+		return NULL;
+
+	cache = flinfo->fn_extra;
+
+	if (cache == NULL)
+	{
+		cache = MemoryContextAllocZero(flinfo->fn_mcxt, sizeof(TsTimezoneCache));
+		cache->maxranges = 16;
+		cache->ranges =
+			MemoryContextAlloc(flinfo->fn_mcxt, sizeof(TimezoneOffsetRange) * cache->maxranges);
+		flinfo->fn_extra = cache;
+	}
+	else if (VARSIZE_ANY_EXHDR(cache->tzname) == VARSIZE_ANY_EXHDR(name) &&
+			 memcmp(VARDATA_ANY(cache->tzname), VARDATA_ANY(name), VARSIZE_ANY_EXHDR(name)) == 0)
+		return cache;
+	else
+		pfree(cache->tzname);
+
+	MemoryContext oldcontext = MemoryContextSwitchTo(flinfo->fn_mcxt);
+	cache->tzname = DatumGetTextPCopy(PointerGetDatum(name));
+	timezone_cache_init(cache, tzname);
+	MemoryContextSwitchTo(oldcontext);
+
+	return cache;
+}
+
+/*
+ * Compute the range of constant offset containing the timestamp. Returns
+ * false if the time zone library cannot tell.
+ */
+static bool
+timezone_cache_compute_range(TsTimezoneCache *cache, TimestampTz timestamp,
+							 TimezoneOffsetRange *range)
+{
+	pg_time_t time = timestamp_to_pg_time(timestamp);
+	pg_time_t from = time - TIMEZONE_CACHE_LOOKBEHIND;
+	pg_time_t boundary = 0;
+	long int before_gmtoff, after_gmtoff;
+	int before_isdst, after_isdst;
+	int res;
+
+	range->start = pg_time_to_timestamp(from);
+
+	/* find the last transition before the timestamp and the first after it */
+	for (;;)
+	{
+		res = pg_next_dst_boundary(&from,
+								   &before_gmtoff,
+								   &before_isdst,
+								   &boundary,
+								   &after_gmtoff,
+								   &after_isdst,
+								   cache->tz);
+		if (res < 0)
+			return false;
+		if (res == 0 || boundary > time)
+			break;
+
+		from = boundary;
+		range->start = pg_time_to_timestamp(boundary);
+	}
+
+	range->offset = (int64) before_gmtoff * USECS_PER_SEC;
+
+	if (res == 0)
+	{
+		range->end = DT_NOEND;
+		range->unambiguous_end = DT_NOEND;
+	}
+	else
+	{
+		range->end = pg_time_to_timestamp(boundary);
+		range->unambiguous_end = range->end;
+		if (after_gmtoff < before_gmtoff)
+			range->unambiguous_end -= (int64) (before_gmtoff - after_gmtoff) * USECS_PER_SEC;
+	}
+
+	return true;
+}
+
+/*
+ * Find the range containing the timestamp, computing it if it is not cached
+ * yet. Returns NULL if no range can be determined.
+ */
+static const TimezoneOffsetRange *
+timezone_cache_lookup(TsTimezoneCache *cache, TimestampTz timestamp)
+{
+	TimezoneOffsetRange range;
+	int low = 0;
+	int high = cache->nranges;
+
+	if (cache->last < cache->nranges && cache->ranges[cache->last].start <= timestamp &&
+		timestamp < cache->ranges[cache->last].end)
+		return &cache->ranges[cache->last];
+
+	/* find the first range starting after the timestamp */
+	while (low < high)
+	{
+		int mid = low + (high - low) / 2;
+
+		if (cache->ranges[mid].start <= timestamp)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low > 0 && timestamp < cache->ranges[low - 1].end)
+	{
+		cache->last = low - 1;
+		return &cache->ranges[low - 1];
+	}
+
+	if (cache->tz == NULL || !timezone_cache_compute_range(cache, timestamp, &range))
+		return NULL;
+
+	/*
+	 * The start of a range is only a lower bound when there is no transition
+	 * shortly before it, so a cached range can end where the new one ends.
+	 */
+	if (low > 0 && cache->ranges[low - 1].end == range.end)
+	{
+		cache->ranges[low - 1].start = Min(cache->ranges[low - 1].start, range.start);
+		cache->last = low - 1;
+		return &cache->ranges[low - 1];
+	}
+	if (low < cache->nranges && cache->ranges[low].end == range.end)
+	{
+		cache->ranges[low].start = Min(cache->ranges[low].start, range.start);
+		cache->last = low;
+		return &cache->ranges[low];
+	}
+
+	if (cache->nranges == cache->maxranges)
+	{
+		if (cache->maxranges >= TIMEZONE_CACHE_MAX_RANGES)
+		{
+			cache->ranges[0] = range;
+			cache->nranges = 1;
+			cache->last = 0;
+			return &cache->ranges[0];
+		}
+
+		cache->maxranges *= 2;
+		cache->ranges = repalloc(cache->ranges, sizeof(TimezoneOffsetRange) * cache->maxranges);
+	}
+
+	memmove(&cache->ranges[low + 1],
+			&cache->ranges[low],
+			sizeof(TimezoneOffsetRange) * (cache->nranges - low));
+	cache->ranges[low] = range;
+	cache->nranges++;
+	cache->last = low;
+
+	return &cache->ranges[low];
+}
+
+/*
+ * Convert a timestamptz to the local time of the zone. Same as
+ * timestamptz_zone().
+ */
+Timestamp
+ts_timezone_cache_to_local(TsTimezoneCache *cache, Datum tzname, TimestampTz timestamp)
+{
+	if (cache != NULL && cache->cacheable && !TIMESTAMP_NOT_FINITE(timestamp))
+	{
+		const TimezoneOffsetRange *range = timezone_cache_lookup(cache, timestamp);
+
+		if (range != NULL && IS_VALID_TIMESTAMP(timestamp + range->offset))
+			return timestamp + range->offset;
+	}
+
+	return DatumGetTimestamp(
+		DirectFunctionCall2(timestamptz_zone, tzname, TimestampTzGetDatum(timestamp)));
+}
+
+/*
+ * Convert a local time of the zone to a timestamptz. Same as
+ * timestamp_zone(). The hint is a timestamptz close to the result, usually
+ * the one the local time was computed from.
+ */
+TimestampTz
+ts_timezone_cache_to_utc(TsTimezoneCache *cache, Datum tzname, Timestamp timestamp,
+						 TimestampTz hint)
+{
+	if (cache != NULL && cache->cacheable && !TIMESTAMP_NOT_FINITE(timestamp) &&
+		!TIMESTAMP_NOT_FINITE(hint))
+	{
+		const TimezoneOffsetRange *range = timezone_cache_lookup(cache, hint);
+
+		/*
+		 * Try the range of the hint first and then the range the result
+		 * would be in with the offset of the hint.
+		 */
+		for (int i = 0; range != NULL && i < 2; i++)
+		{
+			TimestampTz result = timestamp - range->offset;
+
+			if (range->start <= result && result < range->unambiguous_end &&
+				IS_VALID_TIMESTAMP(result))
+				return result;
+
+			if (!IS_VALID_TIMESTAMP(result))
+				break;
+
+			range = timezone_cache_lookup(cache, result);
+		}
+	}
+
+	return DatumGetTimestampTz(
+		DirectFunctionCall2(timestamp_zone, tzname, TimestampGetDatum(timestamp)));
+}
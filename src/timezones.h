@@ -6,6 +6,23 @@
 
 #pragma once
 
+#include <postgres.h>
+#include <fmgr.h>
+#include <datatype/timestamp.h>
+
 #include "export.h"
 
 extern TSDLLEXPORT bool ts_is_valid_timezone_name(const char *tz_name);
+
+/*
+ * Per call site cache of the UTC offsets of a time zone, used to convert
+ * between timestamptz and local timestamps without resolving the zone on
+ * every call.
+ */
+typedef struct TsTimezoneCache TsTimezoneCache;
+
+extern TSDLLEXPORT TsTimezoneCache *ts_timezone_cache_get(FmgrInfo *flinfo, Datum tzname);
+extern TSDLLEXPORT Timestamp ts_timezone_cache_to_local(TsTimezoneCache *cache, Datum tzname,
+														TimestampTz timestamp);
+extern TSDLLEXPORT TimestampTz ts_timezone_cache_to_utc(TsTimezoneCache *cache, Datum tzname,
+														Timestamp timestamp, TimestampTz hint);
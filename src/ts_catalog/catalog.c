@@ -4,6 +4,7 @@
  * LICENSE-APACHE for a copy of the license.
  */
 #include <postgres.h>
+#include <access/heapam.h>
 #include <access/htup_details.h>
 #include <access/xact.h>
 #include <catalog/indexing.h>
@@ -12,10 +13,12 @@
 #include <commands/dbcommands.h>
 #include <commands/sequence.h>
 #include <miscadmin.h>
+#include <storage/bufmgr.h>
 #include <utils/builtins.h>
 #include <utils/inval.h>
 #include <utils/lsyscache.h>
 #include <utils/regproc.h>
+#include <utils/snapmgr.h>
 #include <utils/syscache.h>
 
 #include "compat/compat.h"
@@ -656,11 +659,65 @@ ts_catalog_insert_datums(Relation rel, TupleDesc tupdesc, NullableDatum *datums)
 	heap_freetuple(tuple);
 }
 
+/*
+ * The column that identifies the hypertable of a row of the catalog tables
+ * whose changes invalidate only the cache entry of that hypertable, see
+ * ts_cache_invalidate_hypertable_of().
+ */
+static AttrNumber
+catalog_get_hypertable_owner_attno(CatalogTable table)
+{
+	switch (table)
+	{
+		case CHUNK:
+			return Anum_chunk_hypertable_id;
+		case CHUNK_CONSTRAINT:
+			return Anum_chunk_constraint_chunk_id;
+		case DIMENSION_SLICE:
+			return Anum_dimension_slice_dimension_id;
+		default:
+			return InvalidAttrNumber;
+	}
+}
+
+/*
+ * Invalidate the caches for an updated or deleted catalog row. The changes of
+ * the chunks of a hypertable only invalidate the cache entry of that
+ * hypertable. For a deleted row, the tuple is NULL and it is fetched by its
+ * tid.
+ */
+static void
+catalog_invalidate_cache_for_tuple(Relation rel, ItemPointer tid, HeapTuple tuple,
+								   CmdType operation)
+{
+	CatalogTable table = catalog_get_table(ts_catalog_get(), RelationGetRelid(rel));
+	AttrNumber owner_attno = catalog_get_hypertable_owner_attno(table);
+	HeapTupleData fetched = { .t_self = *tid };
+	Buffer buffer = InvalidBuffer;
+	Datum owner = 0;
+	bool isnull = true;
+
+	if (owner_attno != InvalidAttrNumber)
+	{
+		if (tuple == NULL && heap_fetch_compat(rel, SnapshotAny, &fetched, &buffer, false))
+			tuple = &fetched;
+
+		if (tuple != NULL)
+			owner = heap_getattr(tuple, owner_attno, RelationGetDescr(rel), &isnull);
+
+		if (BufferIsValid(buffer))
+			ReleaseBuffer(buffer);
+	}
+
+	if (isnull || !ts_cache_invalidate_hypertable_of(table, DatumGetInt32(owner)))
+		ts_catalog_invalidate_cache(RelationGetRelid(rel), operation);
+}
+
 void
 ts_catalog_update_tid_only(Relation rel, ItemPointer tid, HeapTuple tuple)
 {
 	CatalogTupleUpdate(rel, tid, tuple);
-	ts_catalog_invalidate_cache(RelationGetRelid(rel), CMD_UPDATE);
+	catalog_invalidate_cache_for_tuple(rel, tid, tuple, CMD_UPDATE);
 }
 
 void
@@ -680,8 +737,9 @@ ts_catalog_update(Relation rel, HeapTuple tuple)
 void
 ts_catalog_delete_tid_only(Relation rel, ItemPointer tid)
 {
+	/* The deleted row is needed to find the hypertable it belongs to */
+	catalog_invalidate_cache_for_tuple(rel, tid, NULL, CMD_DELETE);
 	CatalogTupleDelete(rel, tid);
-	ts_catalog_invalidate_cache(RelationGetRelid(rel), CMD_DELETE);
 }
 
 void
@@ -691,6 +749,18 @@ ts_catalog_delete_tid(Relation rel, ItemPointer tid)
 	CommandCounterIncrement();
 }
 
+/*
+ * Delete a row without invalidating the caches. This is for deleting the rows
+ * of many chunks of the same hypertable, where the caller invalidates the
+ * cache entry of the hypertable once instead of looking up the hypertable of
+ * every row.
+ */
+void
+ts_catalog_delete_tid_without_invalidation(Relation rel, ItemPointer tid)
+{
+	CatalogTupleDelete(rel, tid);
+}
+
 /*
  * Invalidate TimescaleDB catalog caches.
  *
@@ -725,6 +795,13 @@ ts_catalog_invalidate_cache(Oid catalog_relid, CmdType operation)
 		case CHUNK:
 		case CHUNK_CONSTRAINT:
 		case DIMENSION_SLICE:
+			/*
+			 * Inserts are for new chunks, whose tables already invalidate the
+			 * relcache of the hypertable when they inherit from it, and the
+			 * chunk maps check for new chunks with
+			 * ts_chunk_map_has_new_chunks(). Invalidating for every inserted
+			 * row would only add work to chunk creation.
+			 */
 			if (operation == CMD_UPDATE || operation == CMD_DELETE)
 			{
 				relid = ts_catalog_get_cache_proxy_id(catalog, CACHE_TYPE_HYPERTABLE);
@@ -1355,6 +1355,7 @@ extern TSDLLEXPORT void ts_catalog_update_tid(Relation rel, ItemPointer tid, Hea
 extern TSDLLEXPORT void ts_catalog_update(Relation rel, HeapTuple tuple);
 extern TSDLLEXPORT void ts_catalog_delete_tid_only(Relation rel, ItemPointer tid);
 extern TSDLLEXPORT void ts_catalog_delete_tid(Relation rel, ItemPointer tid);
+extern void ts_catalog_delete_tid_without_invalidation(Relation rel, ItemPointer tid);
 extern TSDLLEXPORT void ts_catalog_invalidate_cache(Oid catalog_relid, CmdType operation);
 extern TSDLLEXPORT void ts_catalog_index_insert(ResultRelInfo *indstate, HeapTuple heapTuple);
 
@@ -966,6 +966,44 @@ ts_chunk_column_stats_delete_by_chunk_id(int32 chunk_id)
 	return count;
 }
 
+/*
+ * Delete the entries of many chunks in one scan of the table.
+ */
+int
+ts_chunk_column_stats_delete_by_chunk_ids(const int32 *chunk_ids, int num_chunk_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(CHUNK_COLUMN_STATS, RowExclusiveLock, CurrentMemoryContext);
+	Bitmapset *chunks = NULL;
+	CatalogSecurityContext sec_ctx;
+	int count = 0;
+
+	for (int i = 0; i < num_chunk_ids; i++)
+		chunks = bms_add_member(chunks, chunk_ids[i]);
+
+	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		bool isnull;
+		Datum chunk_id = slot_getattr(ti->slot, Anum_chunk_column_stats_chunk_id, &isnull);
+
+		if (isnull || !bms_is_member(DatumGetInt32(chunk_id), chunks))
+			continue;
+
+		ts_catalog_delete_tid_only(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+		count++;
+	}
+	ts_catalog_restore_user(&sec_ctx);
+
+	if (count > 0)
+		CommandCounterIncrement();
+
+	bms_free(chunks);
+
+	return count;
+}
+
 int
 ts_chunk_column_stats_reset_by_chunk_id(int32 chunk_id)
 {
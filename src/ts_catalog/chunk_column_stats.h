@@ -41,6 +41,7 @@ extern int ts_chunk_column_stats_insert(const Hypertable *ht, const Chunk *chunk
 extern void ts_chunk_column_stats_drop(const Hypertable *ht, const char *col_name, bool *dropped);
 extern int ts_chunk_column_stats_delete_by_ht_colname(int32 hypertable_id, const char *col_name);
 extern TSDLLEXPORT int ts_chunk_column_stats_delete_by_chunk_id(int32 chunk_id);
+extern int ts_chunk_column_stats_delete_by_chunk_ids(const int32 *chunk_ids, int num_chunk_ids);
 extern TSDLLEXPORT int ts_chunk_column_stats_reset_by_chunk_id(int32 chunk_id);
 extern int ts_chunk_column_stats_delete_by_hypertable_id(int32 hypertable_id);
 extern Dimension *ts_chunk_column_stats_fill_dummy_dimension(FormData_chunk_column_stats *r,
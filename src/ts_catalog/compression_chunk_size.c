@@ -43,3 +43,139 @@ ts_compression_chunk_size_delete(int32 uncompressed_chunk_id)
 
 	return count;
 }
+
+/*
+ * Delete the compression sizes of many chunks in one scan.
+ */
+int
+ts_compression_chunk_size_delete_by_chunk_ids(const int32 *uncompressed_chunk_ids,
+											  int num_chunk_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, RowExclusiveLock, CurrentMemoryContext);
+	int count = 0;
+
+	iterator.ctx.index =
+		catalog_get_index(ts_catalog_get(), COMPRESSION_CHUNK_SIZE, COMPRESSION_CHUNK_SIZE_PKEY);
+	ts_scan_iterator_scan_key_init_int32_array(&iterator,
+											   Anum_compression_chunk_size_pkey_chunk_id,
+											   uncompressed_chunk_ids,
+											   num_chunk_ids);
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		ts_catalog_delete_tid_only(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+		count++;
+	}
+
+	/* Make catalog changes visible */
+	if (count > 0)
+		CommandCounterIncrement();
+
+	return count;
+}
+
+/*
+ * Get the number of rows that were compressed into the chunk, or -1 if it is
+ * not known.
+ */
+int64
+ts_compression_chunk_size_row_count(int32 uncompressed_chunk_id)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, AccessShareLock, CurrentMemoryContext);
+	int64 rowcount = -1;
+
+	init_scan_by_uncompressed_chunk_id(&iterator, uncompressed_chunk_id);
+	ts_scanner_foreach(&iterator)
+	{
+		bool isnull;
+		Datum numrows = slot_getattr(ts_scan_iterator_slot(&iterator),
+									 Anum_compression_chunk_size_numrows_pre_compression,
+									 &isnull);
+
+		if (!isnull)
+			rowcount = DatumGetInt64(numrows);
+	}
+	ts_scan_iterator_close(&iterator);
+
+	return rowcount;
+}
+
+/*
+ * Add the compression sizes and row counts of the merged chunks to the ones
+ * of the chunk they were merged into.
+ *
+ * The rows of the merged chunks are left in place since they are deleted
+ * together with the chunks.
+ */
+TSDLLEXPORT void
+ts_compression_chunk_size_merge(int32 uncompressed_chunk_id, const int32 *merged_chunk_ids,
+								int num_merged_chunk_ids)
+{
+	ScanIterator iterator =
+		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, RowExclusiveLock, CurrentMemoryContext);
+	int64 totals[Natts_compression_chunk_size] = { 0 };
+
+	iterator.ctx.index =
+		catalog_get_index(ts_catalog_get(), COMPRESSION_CHUNK_SIZE, COMPRESSION_CHUNK_SIZE_PKEY);
+	ts_scan_iterator_scan_key_init_int32_array(&iterator,
+											   Anum_compression_chunk_size_pkey_chunk_id,
+											   merged_chunk_ids,
+											   num_merged_chunk_ids);
+	ts_scanner_foreach(&iterator)
+	{
+		TupleTableSlot *slot = ts_scan_iterator_slot(&iterator);
+
+		for (AttrNumber attno = Anum_compression_chunk_size_uncompressed_heap_size;
+			 attno <= Natts_compression_chunk_size;
+			 attno++)
+		{
+			bool isnull;
+			Datum value = slot_getattr(slot, attno, &isnull);
+
+			if (!isnull)
+				totals[AttrNumberGetAttrOffset(attno)] += DatumGetInt64(value);
+		}
+	}
+	ts_scan_iterator_close(&iterator);
+
+	iterator =
+		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, RowExclusiveLock, CurrentMemoryContext);
+	init_scan_by_uncompressed_chunk_id(&iterator, uncompressed_chunk_id);
+	ts_scanner_foreach(&iterator)
+	{
+		Datum values[Natts_compression_chunk_size];
+		bool nulls[Natts_compression_chunk_size];
+		bool repl[Natts_compression_chunk_size] = { false };
+		bool should_free;
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		HeapTuple tuple = ts_scanner_fetch_heap_tuple(ti, false, &should_free);
+		HeapTuple new_tuple;
+
+		heap_deform_tuple(tuple, ts_scanner_get_tupledesc(ti), values, nulls);
+
+		for (AttrNumber attno = Anum_compression_chunk_size_uncompressed_heap_size;
+			 attno <= Natts_compression_chunk_size;
+			 attno++)
+		{
+			int i = AttrNumberGetAttrOffset(attno);
+
+			values[i] = Int64GetDatum(totals[i] + (nulls[i] ? 0 : DatumGetInt64(values[i])));
+			nulls[i] = false;
+			repl[i] = true;
+		}
+
+		new_tuple = heap_modify_tuple(tuple, ts_scanner_get_tupledesc(ti), values, nulls, repl);
+		ts_catalog_update(ti->scanrel, new_tuple);
+		heap_freetuple(new_tuple);
+
+		if (should_free)
+			heap_freetuple(tuple);
+
+		/* Do not visit the updated tuple again */
+		break;
+	}
+	ts_scan_iterator_end(&iterator);
+	ts_scan_iterator_close(&iterator);
+}
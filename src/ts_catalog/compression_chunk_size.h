@@ -9,3 +9,9 @@
 #include <postgres.h>
 
 extern TSDLLEXPORT int ts_compression_chunk_size_delete(int32 uncompressed_chunk_id);
+extern int ts_compression_chunk_size_delete_by_chunk_ids(const int32 *uncompressed_chunk_ids,
+														 int num_chunk_ids);
+extern int64 ts_compression_chunk_size_row_count(int32 uncompressed_chunk_id);
+extern TSDLLEXPORT void ts_compression_chunk_size_merge(int32 uncompressed_chunk_id,
+														const int32 *merged_chunk_ids,
+														int num_merged_chunk_ids);
@@ -0,0 +1,30 @@
+# This file and its contents are licensed under the Apache License 2.0.
+# Please see the included NOTICE for copyright information and
+# LICENSE-APACHE for a copy of the license.
+
+setup {
+  CREATE TABLE readings (time timestamptz NOT NULL, device int, temp float);
+  SELECT create_hypertable('readings', 'time', chunk_time_interval => interval '1 day');
+  INSERT INTO readings VALUES ('2024-01-01 10:30+0', 1, 1.0), ('2024-01-02 10:30+0', 2, 2.0);
+}
+
+teardown {
+  DROP TABLE readings;
+}
+
+#
+# Test that a transaction whose queries use the chunk map of a hypertable
+# finds the chunks that were created concurrently, while it already holds a
+# lock on the hypertable.
+#
+
+session "s1"
+step "s1_begin" { BEGIN; }
+step "s1_query" { SELECT count(*) FROM readings WHERE time > '2024-01-01 12:00+0'; }
+step "s1_commit" { COMMIT; }
+
+session "s2"
+step "s2_insert" { INSERT INTO readings VALUES ('2024-01-05 10:30+0', 3, 3.0); }
+step "s2_show_num_chunks" { SELECT count(*) FROM show_chunks('readings'); }
+
+permutation "s1_begin" "s1_query" "s1_query" "s2_insert" "s1_query" "s1_commit" "s2_show_num_chunks"
@@ -0,0 +1,38 @@
+# This file and its contents are licensed under the Apache License 2.0.
+# Please see the included NOTICE for copyright information and
+# LICENSE-APACHE for a copy of the license.
+
+setup {
+  CREATE TABLE drop_lock_t1 (time timestamptz NOT NULL, device int, temp float);
+  SELECT create_hypertable('drop_lock_t1', 'time', chunk_time_interval => interval '1 day');
+  INSERT INTO drop_lock_t1 VALUES ('2024-01-01 10:30+0', 1, 1.0), ('2024-01-02 10:30+0', 2, 2.0), ('2024-01-03 10:30+0', 3, 3.0);
+}
+
+teardown {
+  DROP TABLE drop_lock_t1;
+}
+
+#
+# drop_chunks locks all the chunks to drop in relid order before it deletes
+# any catalog rows. While it waits for a query on the last chunk, it already
+# holds the locks on the other chunks, so inserts into them wait, but the
+# catalog rows of the chunks are not deleted yet.
+#
+
+session "s1"
+step "s1_begin" { BEGIN; }
+step "s1_query_last_chunk" { SELECT count(*) FROM drop_lock_t1 WHERE time > '2024-01-03 00:00+0'; }
+step "s1_commit" { COMMIT; }
+
+session "s2"
+step "s2_drop_chunks" { SELECT count(*) FROM drop_chunks('drop_lock_t1', TIMESTAMPTZ '2024-01-05 00:00+0'); }
+
+session "s3"
+step "s3_insert_first_chunk" { INSERT INTO drop_lock_t1 VALUES ('2024-01-01 11:30+0', 4, 4.0); }
+
+session "s4"
+step "s4_lock_chunk_rows" { SELECT count(*) FROM (SELECT FROM _timescaledb_catalog.chunk c JOIN _timescaledb_catalog.hypertable h ON h.id = c.hypertable_id WHERE h.table_name = 'drop_lock_t1' FOR KEY SHARE OF c NOWAIT) c; }
+step "s4_show_chunks" { SELECT count(*) FROM show_chunks('drop_lock_t1'); }
+step "s4_show_data" { SELECT * FROM drop_lock_t1 ORDER BY 1; }
+
+permutation "s1_begin" "s1_query_last_chunk" "s2_drop_chunks" "s4_lock_chunk_rows" "s3_insert_first_chunk" "s1_commit" "s4_show_chunks" "s4_show_data"
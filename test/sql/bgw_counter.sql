@@ -0,0 +1,33 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+\c :TEST_DBNAME :ROLE_SUPERUSER
+-- Runs job worker reservations on a private counter state. Positive values
+-- reserve a job worker for the database with that OID, negative values
+-- release one.
+CREATE OR REPLACE FUNCTION test.bgw_counter_reserve(max_workers INT, other_workers INT, ops INT[]) RETURNS BOOL[]
+    AS '$libdir/timescaledb', 'ts_bgw_counter_test_reserve' LANGUAGE C VOLATILE STRICT;
+
+-- a single database can take all free workers
+SELECT test.bgw_counter_reserve(8, 3, '{1,1,1,1,1,1}');
+
+-- once database 2 was denied a worker, database 1 cannot take a freed worker
+-- beyond its fair share, but database 2 can
+SELECT test.bgw_counter_reserve(8, 3, '{1,1,1,1,1,2,-1,1,2}');
+
+-- database 2 got a worker and stops waiting, so database 1 can take freed
+-- workers again
+SELECT test.bgw_counter_reserve(8, 3, '{1,1,1,1,1,2,-1,2,1,-1,1}');
+
+-- workers are shared between all waiting databases
+SELECT test.bgw_counter_reserve(9, 3, '{1,1,1,1,1,1,2,3,-1,-1,-1,1,2,3,2,3,1}');
+
+-- a database that releases all of its workers is forgotten
+SELECT test.bgw_counter_reserve(4, 3, '{1,2,3,4,5,-1,2}');
+
+-- with all entries taken, a database that is only waiting is forgotten to
+-- make room
+SELECT test.bgw_counter_reserve(4, 1, '{1,2,3,4,5,-1,5}');
+
+DROP FUNCTION test.bgw_counter_reserve(INT, INT, INT[]);
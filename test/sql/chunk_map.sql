@@ -0,0 +1,68 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+-- The chunks matching a query are found in the chunk map of the hypertable
+-- cache from the second query on. Check that it finds the same chunks as the
+-- catalog, and that it sees the changes of the chunks. Restrictions that
+-- match the same chunk boundaries share the cached chunk exclusion result, so
+-- some of the queries differ only in how close they are to the boundaries.
+\c :TEST_DBNAME :ROLE_SUPERUSER
+
+CREATE TABLE map(time timestamptz NOT NULL, device int, value float);
+SELECT table_name FROM create_hypertable('map', 'time', 'device', 3, chunk_time_interval => interval '1 day');
+INSERT INTO map SELECT t, d, 1 FROM generate_series('2024-01-01'::timestamptz, '2024-01-05', '1 hour') t, generate_series(1, 6) d;
+
+CREATE FUNCTION planned_chunks(query text) RETURNS int[] LANGUAGE plpgsql AS $$
+DECLARE
+    line text;
+    chunks int[] := '{}';
+BEGIN
+    FOR line IN EXECUTE 'EXPLAIN (costs off) ' || query LOOP
+        chunks := chunks || (regexp_match(line, '_hyper_\d+_(\d+)_chunk'))[1]::int;
+    END LOOP;
+    RETURN ARRAY(SELECT DISTINCT c FROM unnest(chunks) c WHERE c IS NOT NULL ORDER BY c);
+END
+$$;
+
+CREATE VIEW map_chunks AS
+SELECT label, planned_chunks(query) AS chunks
+FROM (VALUES
+    ('all', 'SELECT * FROM map'),
+    ('time', $$SELECT * FROM map WHERE time >= '2024-01-03' AND time < '2024-01-04'$$),
+    ('time open', $$SELECT * FROM map WHERE time > '2024-01-04'$$),
+    ('time within', $$SELECT * FROM map WHERE time >= '2024-01-03 06:00+00' AND time < '2024-01-03 18:00+00'$$),
+    ('time before', $$SELECT * FROM map WHERE time < '2024-01-03 00:00+00'$$),
+    ('time until', $$SELECT * FROM map WHERE time <= '2024-01-03 00:00+00'$$),
+    ('time after', $$SELECT * FROM map WHERE time > '2024-01-02 23:59:59.999999+00'$$),
+    ('time from', $$SELECT * FROM map WHERE time >= '2024-01-03 00:00+00'$$),
+    ('device', $$SELECT * FROM map WHERE device = 2 AND time < '2024-01-02'$$),
+    ('devices', $$SELECT * FROM map WHERE device IN (1, 2) AND time < '2024-01-02'$$),
+    ('none', $$SELECT * FROM map WHERE time > '2025-01-01'$$)
+) q(label, query);
+
+SET timescaledb.enable_chunk_map = off;
+SELECT * FROM map_chunks;
+RESET timescaledb.enable_chunk_map;
+SELECT * FROM map_chunks;
+SELECT * FROM map_chunks;
+
+-- new and dropped chunks
+INSERT INTO map VALUES ('2024-01-10', 1, 1);
+SELECT * FROM map_chunks;
+SELECT count(*) FROM drop_chunks('map', older_than => '2024-01-02'::timestamptz);
+SELECT * FROM map_chunks;
+SELECT * FROM map_chunks;
+
+-- changes of the catalog with SQL invalidate the chunk map as well
+UPDATE _timescaledb_catalog.dimension_slice s SET range_start = range_start + 10 * 86400000000::bigint, range_end = range_end + 10 * 86400000000::bigint
+FROM _timescaledb_catalog.dimension d
+WHERE d.id = s.dimension_id AND d.column_name = 'time' AND s.range_start = _timescaledb_functions.to_unix_microseconds('2024-01-03 00:00+00');
+SELECT * FROM map_chunks;
+SET timescaledb.enable_chunk_map = off;
+SELECT * FROM map_chunks;
+RESET timescaledb.enable_chunk_map;
+
+DROP VIEW map_chunks;
+DROP FUNCTION planned_chunks(text);
+DROP TABLE map;
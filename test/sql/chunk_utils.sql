@@ -672,3 +672,21 @@ CREATE VIEW test_view_part_few AS SELECT project_id,
   WHERE project_id = ANY (ARRAY[5, 10, 15]);
 -- Complicated query on a view involving a range check and a sort
 SELECT * FROM test_view_part_few WHERE ts BETWEEN '2024-01-04 00:00:00+00'AND '2024-01-05 00:00:00' ORDER BY ts LIMIT 1000;
+
+-- Dropping several chunks at once deletes the dimension slices that
+-- are no longer referenced, including slices shared by the dropped
+-- chunks, and keeps the slices of the remaining chunks.
+CREATE TABLE drop_chunk_test_space(time int NOT NULL, device int, value float);
+SELECT table_name FROM create_hypertable('drop_chunk_test_space', 'time', 'device', 3, chunk_time_interval => 10);
+INSERT INTO drop_chunk_test_space SELECT t, d, 1.0 FROM generate_series(0, 39) t, generate_series(1, 6) d;
+SELECT count(*) FROM show_chunks('drop_chunk_test_space');
+SELECT count(*) FROM drop_chunks('drop_chunk_test_space', older_than => 20);
+SELECT count(*) FROM show_chunks('drop_chunk_test_space');
+SELECT d.column_name, ds.range_start, ds.range_end,
+       (SELECT count(*) FROM _timescaledb_catalog.chunk_constraint cc WHERE cc.dimension_slice_id = ds.id) AS num_constraints
+FROM _timescaledb_catalog.dimension_slice ds
+INNER JOIN _timescaledb_catalog.dimension d ON (d.id = ds.dimension_id)
+INNER JOIN _timescaledb_catalog.hypertable h ON (h.id = d.hypertable_id)
+WHERE h.table_name = 'drop_chunk_test_space'
+ORDER BY d.column_name, ds.range_start;
+DROP TABLE drop_chunk_test_space;
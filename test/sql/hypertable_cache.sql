@@ -0,0 +1,62 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+\c :TEST_DBNAME :ROLE_SUPERUSER
+CREATE OR REPLACE FUNCTION test_hypertable_cache_contains(REGCLASS) RETURNS BOOL
+AS :MODULE_PATHNAME, 'ts_test_hypertable_cache_contains' LANGUAGE C VOLATILE STRICT;
+
+CREATE TABLE cache_a(time timestamptz NOT NULL, value float);
+CREATE TABLE cache_b(time timestamptz NOT NULL, value float);
+SELECT table_name FROM create_hypertable('cache_a', 'time', chunk_time_interval => interval '1 day');
+SELECT table_name FROM create_hypertable('cache_b', 'time', chunk_time_interval => interval '1 day');
+INSERT INTO cache_a SELECT t, 1 FROM generate_series('2024-01-01'::timestamptz, '2024-01-04', '1 hour') t;
+INSERT INTO cache_b SELECT t, 1 FROM generate_series('2024-01-01'::timestamptz, '2024-01-04', '1 hour') t;
+
+CREATE VIEW cache_entries AS
+SELECT test_hypertable_cache_contains('cache_a') AS a, test_hypertable_cache_contains('cache_b') AS b;
+
+SELECT count(*) FROM cache_a;
+SELECT count(*) FROM cache_b;
+SELECT * FROM cache_entries;
+
+-- Dropping the chunks of one hypertable only invalidates its cache entry
+SELECT count(*) FROM drop_chunks('cache_a', older_than => '2024-01-02'::timestamptz);
+SELECT * FROM cache_entries;
+
+-- New chunks can be created in place of the dropped ones
+INSERT INTO cache_a VALUES ('2024-01-01 12:00', 2);
+SELECT count(*), sum(value) FROM cache_a WHERE time < '2024-01-02';
+SELECT count(*) FROM show_chunks('cache_a');
+SELECT * FROM cache_entries;
+
+-- Creating a chunk only invalidates the entry of its hypertable
+INSERT INTO cache_b VALUES ('2024-01-10', 1);
+SELECT * FROM cache_entries;
+
+-- Several changes in one transaction, with the cache pinned while the chunks
+-- of the hypertable are dropped and created
+BEGIN;
+SELECT count(*) FROM drop_chunks('cache_b', older_than => '2024-01-03'::timestamptz);
+INSERT INTO cache_b SELECT t, 3 FROM generate_series('2024-01-01'::timestamptz, '2024-01-02', '1 hour') t;
+SELECT count(*) FROM drop_chunks('cache_b', newer_than => '2024-01-05'::timestamptz);
+COMMIT;
+SELECT * FROM cache_entries;
+SELECT count(*), sum(value) FROM cache_b;
+SELECT count(*) FROM show_chunks('cache_b');
+
+-- Changes of a dimension still invalidate all entries
+SELECT count(*) FROM cache_a;
+SELECT * FROM cache_entries;
+SELECT set_chunk_time_interval('cache_a', interval '2 days');
+SELECT * FROM cache_entries;
+
+-- Dropping a hypertable with chunks
+DROP VIEW cache_entries;
+SELECT count(*) FROM cache_b;
+DROP TABLE cache_a;
+SELECT test_hypertable_cache_contains('cache_b');
+SELECT count(*) FROM cache_b;
+
+DROP TABLE cache_b;
+DROP FUNCTION test_hypertable_cache_contains(REGCLASS);
@@ -157,6 +157,27 @@ SELECT * FROM _timescaledb_catalog.hypertable;
 SELECT proname, pronamespace, pronargs
 FROM pg_proc WHERE proname = 'custom_calculate_chunk_interval';
 
+-- The statement triggers that invalidate the caches when the chunk catalog
+-- is changed with SQL come with the extension, once per table
+SELECT tgrelid::regclass AS table, tgenabled FROM pg_trigger
+WHERE tgname = 'catalog_invalidate_cache_trigger' ORDER BY tgrelid::regclass::text;
+
+-- Chunk exclusion finds the restored chunks, also with the chunk map that is
+-- built on the second query
+SELECT count(*) FROM "test_schema"."two_Partitions" WHERE "timeCustom" >= 1257897600000000000;
+SELECT count(*) FROM "test_schema"."two_Partitions" WHERE "timeCustom" >= 1257897600000000000;
+
+-- Changing the restored catalog rows with SQL fires the triggers, so the
+-- chunk map sees the change
+BEGIN;
+UPDATE _timescaledb_catalog.dimension_slice s
+SET range_start = range_start - 1000000000000000000, range_end = range_end - 1000000000000000000
+FROM _timescaledb_catalog.chunk_constraint cc, _timescaledb_catalog.chunk c, _timescaledb_catalog.dimension d
+WHERE cc.dimension_slice_id = s.id AND cc.chunk_id = c.id AND d.id = s.dimension_id
+    AND c.table_name = '_hyper_1_2_chunk' AND d.column_name = 'timeCustom';
+SELECT count(*) FROM "test_schema"."two_Partitions" WHERE "timeCustom" >= 1257897600000000000;
+ROLLBACK;
+
 --check simple ddl still works
 ALTER TABLE "test_schema"."two_Partitions" ADD COLUMN series_3 integer;
 INSERT INTO "test_schema"."two_Partitions"("timeCustom", device_id, series_0, series_1, series_3) VALUES
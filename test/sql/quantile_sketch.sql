@@ -0,0 +1,79 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+CREATE TABLE qs(device int, value float8);
+INSERT INTO qs VALUES
+  (1, 1), (1, 2), (1, 3), (1, 4), (1, 5),
+  (2, -10), (2, -1), (2, 0), (2, 0), (2, 1), (2, 100),
+  (3, 42),
+  (4, NULL), (4, 7), (4, NULL);
+
+-- The results are within 1% of the exact percentiles
+SELECT device, round(approx_percentile(0, value)::numeric, 4) p0,
+  round(approx_percentile(0.5, value)::numeric, 4) p50,
+  round(approx_percentile(1, value)::numeric, 4) p100
+FROM qs GROUP BY device ORDER BY device;
+
+-- The same ranks as percentile_disc() for a few input values
+SELECT n, f, round(approx_percentile(f, v)::numeric, 4) AS approx,
+  percentile_disc(f) WITHIN GROUP (ORDER BY v) AS exact
+FROM (VALUES (1, 1::float8), (2, 1), (2, 100), (3, 1), (3, 10), (3, 100),
+  (4, 1), (4, 10), (4, 100), (4, 1000)) t(n, v),
+  unnest(ARRAY[0, 0.1, 0.25, 0.5, 0.75, 0.9, 1]) f
+GROUP BY n, f ORDER BY n, f;
+
+-- No input rows
+SELECT approx_percentile(0.5, value) FROM qs WHERE device = 5;
+SELECT approx_percentile(0.5, value) FROM qs WHERE device = 4 AND value IS NULL;
+
+-- The rows with a null fraction don't contribute
+SELECT round(approx_percentile(CASE WHEN value > 1 THEN 0.5 END, value)::numeric, 4)
+FROM qs WHERE device = 1;
+
+\set ON_ERROR_STOP 0
+SELECT approx_percentile(1.5, value) FROM qs;
+SELECT approx_percentile(-0.1, value) FROM qs;
+SELECT approx_percentile(value / 1000, value) FROM qs;
+SELECT approx_percentile(0.5, v) FROM (VALUES (1::float8), ('infinity'), (3)) t(v);
+SELECT approx_percentile(0.5, v) FROM (VALUES (1::float8), ('nan'), (3)) t(v);
+\set ON_ERROR_STOP 1
+
+-- Compare with the exact percentiles on a hypertable, where the sketches are
+-- computed per chunk and merged
+CREATE TABLE qs_ht(time timestamptz NOT NULL, device int, value float8);
+SELECT table_name FROM create_hypertable('qs_ht', 'time', chunk_time_interval => interval '1 day');
+INSERT INTO qs_ht
+SELECT '2024-01-01'::timestamptz + i * interval '1 minute', d, ((i * 7919) % 10007) * d - 1000
+FROM generate_series(0, 10006) i, generate_series(1, 3) d;
+ANALYZE qs_ht;
+
+SELECT a.device, a.fraction,
+  abs(a.approx - p.exact) <= 0.01 * abs(p.exact) AS ok
+FROM (
+  SELECT device, f AS fraction, approx_percentile(f, value) AS approx
+  FROM qs_ht, unnest(ARRAY[0.01, 0.25, 0.5, 0.9, 0.99]) f
+  GROUP BY device, f) a
+JOIN (
+  SELECT device, f AS fraction, percentile_disc(f) WITHIN GROUP (ORDER BY value) AS exact
+  FROM qs_ht, unnest(ARRAY[0.01, 0.25, 0.5, 0.9, 0.99]) f
+  GROUP BY device, f) p ON a.device = p.device AND a.fraction = p.fraction
+ORDER BY a.device, a.fraction;
+
+-- The sketches are merged from parallel workers
+SELECT proname, proparallel FROM pg_proc WHERE proname = 'approx_percentile';
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+SET max_parallel_workers_per_gather = 2;
+SELECT device, round(approx_percentile(0.5, value)::numeric, 4)
+FROM qs_ht GROUP BY device ORDER BY device;
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+RESET max_parallel_workers_per_gather;
+SELECT device, round(approx_percentile(0.5, value)::numeric, 4)
+FROM qs_ht GROUP BY device ORDER BY device;
+
+DROP TABLE qs;
+DROP TABLE qs_ht;
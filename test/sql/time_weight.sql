@@ -0,0 +1,77 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+-- The values are linearly interpolated between the points in time
+CREATE TABLE tw(time timestamptz, device int, value float8);
+INSERT INTO tw VALUES
+  ('2024-01-01 00:00:00+00', 1, 0),
+  ('2024-01-01 00:00:10+00', 1, 10),
+  ('2024-01-01 00:00:30+00', 1, 10),
+  ('2024-01-01 00:01:00+00', 1, 40),
+  ('2024-01-01 00:00:00+00', 2, 5),
+  ('2024-01-01 00:00:20+00', 2, 15),
+  ('2024-01-01 00:00:40+00', 2, 3),
+  ('2024-01-01 00:01:00+00', 2, 8),
+  ('2024-01-01 00:00:00+00', 3, 7),
+  ('2024-01-01 00:00:10+00', 4, NULL),
+  ('2024-01-01 00:00:20+00', 4, 2),
+  (NULL, 4, 6),
+  ('2024-01-01 00:00:50+00', 4, 4);
+
+SELECT device, integral(time, value), time_weighted_avg(time, value), counter_rate(time, value)
+FROM tw GROUP BY device ORDER BY device;
+
+-- No input rows
+SELECT integral(time, value), time_weighted_avg(time, value), counter_rate(time, value)
+FROM tw WHERE device = 5;
+
+-- The input can be ordered by time in either direction
+SELECT device, integral(time, value), time_weighted_avg(time, value), counter_rate(time, value)
+FROM (SELECT * FROM tw ORDER BY device, time DESC) s GROUP BY device ORDER BY device;
+
+-- Unordered input is an error unless it is ordered in the aggregate call
+\set ON_ERROR_STOP 0
+SELECT integral(time, value)
+FROM (SELECT * FROM tw WHERE device = 1 ORDER BY value DESC, time) s;
+\set ON_ERROR_STOP 1
+SELECT integral(time, value ORDER BY time)
+FROM (SELECT * FROM tw WHERE device = 1 ORDER BY value DESC, time) s;
+
+-- Compare with the computation using window functions on a hypertable, where
+-- the aggregates are computed per chunk and combined
+CREATE TABLE tw_ht(time timestamptz NOT NULL, device int, value float8);
+SELECT table_name FROM create_hypertable('tw_ht', 'time', chunk_time_interval => interval '1 day');
+INSERT INTO tw_ht
+SELECT t, d, (extract(epoch from t)::int % (600 * d)) / 10.0
+FROM generate_series('2024-01-01'::timestamptz, '2024-01-05', interval '37 seconds') t,
+  generate_series(1, 3) d;
+ANALYZE tw_ht;
+
+WITH points AS (
+  SELECT device, time, value,
+    lag(time) OVER w AS prev_time, lag(value) OVER w AS prev_value
+  FROM tw_ht WINDOW w AS (PARTITION BY device ORDER BY time)),
+reference AS (
+  SELECT device,
+    sum(extract(epoch FROM time - prev_time) * (value + prev_value) / 2) AS integral,
+    extract(epoch FROM max(time) - min(time)) AS duration,
+    sum(CASE WHEN value >= prev_value THEN value - prev_value ELSE value END) AS increase
+  FROM points GROUP BY device)
+SELECT r.device,
+  abs(a.integral - r.integral) < 1e-6 * r.integral AS integral_ok,
+  abs(a.time_weighted_avg - r.integral / r.duration) < 1e-9 AS avg_ok,
+  abs(a.counter_rate - r.increase / r.duration) < 1e-9 AS rate_ok
+FROM reference r JOIN (
+  SELECT device, integral(time, value), time_weighted_avg(time, value),
+    counter_rate(time, value)
+  FROM tw_ht GROUP BY device) a ON a.device = r.device
+ORDER BY r.device;
+
+-- The aggregates are not parallelized, because a parallel scan does not keep
+-- the time order
+SELECT proname, proparallel FROM pg_proc
+WHERE proname IN ('time_weighted_avg', 'integral', 'counter_rate') ORDER BY proname;
+
+DROP TABLE tw;
+DROP TABLE tw_ht;
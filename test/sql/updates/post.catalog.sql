@@ -10,6 +10,13 @@
 \d+ _timescaledb_catalog.chunk_index
 \d+ _timescaledb_catalog.tablespace
 
+-- The statement triggers that invalidate the caches when the chunk catalog is
+-- changed with SQL
+SELECT tgrelid::regclass::text AS table, tgname, tgenabled
+FROM pg_trigger
+WHERE tgname = 'catalog_invalidate_cache_trigger'
+ORDER BY 1;
+
 SELECT nspname AS Schema,
        relname AS Name,
        -- PG17 introduced MAINTAIN acl (m) so removed it to keep output backward compatible
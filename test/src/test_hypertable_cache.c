@@ -0,0 +1,26 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#include <postgres.h>
+#include <fmgr.h>
+
+#include "hypertable_cache.h"
+#include "test_utils.h"
+
+/*
+ * Check whether the hypertable cache has an entry for the relation, without
+ * creating one.
+ */
+TS_TEST_FN(ts_test_hypertable_cache_contains)
+{
+	Cache *hcache = ts_hypertable_cache_pin();
+	Hypertable *ht = ts_hypertable_cache_get_entry(hcache,
+												   PG_GETARG_OID(0),
+												   CACHE_FLAG_MISSING_OK | CACHE_FLAG_NOCREATE);
+
+	ts_cache_release(hcache);
+
+	PG_RETURN_BOOL(ht != NULL);
+}
@@ -100,6 +100,26 @@ TS_TEST_FN(ts_test_scanner)
 		elog(NOTICE, "4. IndexScan: \"%s.%s\"", NameStr(fd.schema_name), NameStr(fd.table_name));
 	}
 
+	/* Index scan with an array of unsorted and duplicate keys */
+	int32 chunk_ids[3] = { chunk_id[1], chunk_id[0], chunk_id[1] };
+
+	ts_scan_iterator_scan_key_reset(&it);
+	ts_scan_iterator_scan_key_init_int32_array(&it, Anum_chunk_idx_id, chunk_ids, 3);
+	ts_scan_iterator_rescan(&it);
+
+	ts_scanner_foreach(&it)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&it);
+		FormData_chunk fd;
+
+		ts_chunk_formdata_fill(&fd, ti);
+
+		elog(NOTICE,
+			 "5. IndexScan with array: \"%s.%s\"",
+			 NameStr(fd.schema_name),
+			 NameStr(fd.table_name));
+	}
+
 	ts_scan_iterator_close(&it);
 
 	PG_RETURN_VOID();
@@ -28,6 +28,7 @@
 #include "compat/compat.h"
 #include "bgw/job.h"
 #include "bgw/job_stat.h"
+#include "bgw/job_stat_history.h"
 #include "bgw/timer.h"
 #include "bgw_policy/chunk_stats.h"
 #include "bgw_policy/compression_api.h"
@@ -36,6 +37,7 @@
 #include "bgw_policy/reorder_api.h"
 #include "bgw_policy/retention_api.h"
 #include "compression/api.h"
+#include "continuous_aggs/invalidation.h"
 #include "continuous_aggs/materialize.h"
 #include "continuous_aggs/refresh.h"
 #include "ts_catalog/continuous_agg.h"
@@ -56,6 +58,7 @@
 #include "utils.h"
 
 #define REORDER_SKIP_RECENT_DIM_SLICES_N 3
+#define REFRESH_BACKLOG_MAX_COUNT 1000
 
 static void
 log_retention_boundary(int elevel, PolicyRetentionData *policy_data, const char *message)
@@ -100,7 +103,8 @@ enable_fast_restart(int32 job_id, const char *job_name)
 }
 
 /*
- * Returns the ID of a chunk to reorder. Eligible chunks must be at least the
+ * Returns the IDs of the chunks to reorder, at most numchunks of them.
+ * Eligible chunks must be at least the
  * 3rd newest chunk in the hypertable (not entirely exact because we use the number
  * of dimension slices as a proxy for the number of chunks),
  * not compressed, not dropped and hasn't been reordered recently.
@@ -108,8 +112,8 @@ enable_fast_restart(int32 job_id, const char *job_name)
  * recently" means the chunk has not been reordered at all. This information
  * is available in the bgw_policy_chunk_stats metadata table.
  */
-static int
-get_chunk_id_to_reorder(int32 job_id, Hypertable *ht)
+static List *
+get_chunk_ids_to_reorder(int32 job_id, Hypertable *ht, int32 numchunks)
 {
 	const Dimension *time_dimension = hyperspace_get_open_dimension(ht->space, 0);
 	const DimensionSlice *nth_dimension =
@@ -117,16 +121,17 @@ get_chunk_id_to_reorder(int32 job_id, Hypertable *ht)
 											REORDER_SKIP_RECENT_DIM_SLICES_N);
 
 	if (!nth_dimension)
-		return -1;
+		return NIL;
 
 	Assert(time_dimension != NULL);
 
-	return ts_dimension_slice_oldest_valid_chunk_for_reorder(job_id,
-															 time_dimension->fd.id,
-															 BTLessEqualStrategyNumber,
-															 nth_dimension->fd.range_start,
-															 InvalidStrategy,
-															 -1);
+	return ts_dimension_slice_get_chunkids_to_reorder(job_id,
+													  time_dimension->fd.id,
+													  BTLessEqualStrategyNumber,
+													  nth_dimension->fd.range_start,
+													  InvalidStrategy,
+													  -1,
+													  numchunks);
 }
 
 /*
@@ -218,46 +223,106 @@ check_valid_index(Hypertable *ht, const char *index_name)
 bool
 policy_reorder_execute(int32 job_id, Jsonb *config)
 {
-	int chunk_id;
-	Chunk *chunk;
+	List *chunkid_lst;
+	ListCell *lc;
 	PolicyReorderData policy;
+	Oid index_relid;
+	bool used_portalcxt = false;
+	bool more_chunks = false;
+	MemoryContext saved_cxt, multitxn_cxt;
 
 	policy_reorder_read_and_validate_config(config, &policy);
+	index_relid = policy.index_relid;
 
-	/* Find a chunk to reorder in the selected hypertable */
-	chunk_id = get_chunk_id_to_reorder(job_id, policy.hypertable);
+	/* we want the chunk id list to survive across transactions. So alloc in
+	 * a different context
+	 */
+	if (PortalContext)
+	{
+		/*if we have a portal context use that - it will get freed automatically*/
+		multitxn_cxt = PortalContext;
+		used_portalcxt = true;
+	}
+	else
+	{
+		/* background worker job does not go via usual CALL path, so we do
+		 * not have a PortalContext */
+		multitxn_cxt =
+			AllocSetContextCreate(TopMemoryContext, "ReorderJobCxt", ALLOCSET_DEFAULT_SIZES);
+	}
 
-	if (chunk_id == -1)
+	/* Fetch one chunk more than we reorder to know if there is work left */
+	saved_cxt = MemoryContextSwitchTo(multitxn_cxt);
+	chunkid_lst = get_chunk_ids_to_reorder(job_id, policy.hypertable, policy.maxchunks + 1);
+	MemoryContextSwitchTo(saved_cxt);
+
+	if (!chunkid_lst)
 	{
 		elog(NOTICE,
 			 "no chunks need reordering for hypertable %s.%s",
 			 NameStr(policy.hypertable->fd.schema_name),
 			 NameStr(policy.hypertable->fd.table_name));
+		if (!used_portalcxt)
+			MemoryContextDelete(multitxn_cxt);
 		return true;
 	}
 
+	if (list_length(chunkid_lst) > policy.maxchunks)
+	{
+		chunkid_lst = list_truncate(chunkid_lst, policy.maxchunks);
+		more_chunks = true;
+	}
+
+	if (ActiveSnapshotSet())
+		PopActiveSnapshot();
 	/*
-	 * NOTE: We pass the Oid of the hypertable's index, and the true reorder
-	 * function should translate this to the Oid of the index on the specific
-	 * chunk.
+	 * Reorder each chunk in a new transaction so that the locks taken on a
+	 * chunk are released as soon as it is done.
 	 */
-	chunk = ts_chunk_get_by_id(chunk_id, false);
-	elog(DEBUG1,
-		 "reordering chunk %s.%s",
-		 NameStr(chunk->fd.schema_name),
-		 NameStr(chunk->fd.table_name));
-	reorder_chunk(chunk->table_id, policy.index_relid, false, InvalidOid, InvalidOid, InvalidOid);
-	elog(DEBUG1,
-		 "completed reordering chunk %s.%s",
-		 NameStr(chunk->fd.schema_name),
-		 NameStr(chunk->fd.table_name));
-
-	/* Now update chunk_stats table */
-	ts_bgw_policy_chunk_stats_record_job_run(job_id, chunk_id, ts_timer_get_current_timestamp());
-
-	if (get_chunk_id_to_reorder(job_id, policy.hypertable) != -1)
+	foreach (lc, chunkid_lst)
+	{
+		CommitTransactionCommand();
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+
+		int32 chunk_id = lfirst_int(lc);
+		Chunk *chunk = ts_chunk_get_by_id(chunk_id, false);
+
+		/* The chunk might have been dropped since we listed it */
+		if (chunk == NULL)
+		{
+			PopActiveSnapshot();
+			continue;
+		}
+
+		/*
+		 * NOTE: We pass the Oid of the hypertable's index, and the true reorder
+		 * function should translate this to the Oid of the index on the specific
+		 * chunk.
+		 */
+		elog(DEBUG1,
+			 "reordering chunk %s.%s",
+			 NameStr(chunk->fd.schema_name),
+			 NameStr(chunk->fd.table_name));
+		reorder_chunk(chunk->table_id, index_relid, false, InvalidOid, InvalidOid, InvalidOid);
+		elog(DEBUG1,
+			 "completed reordering chunk %s.%s",
+			 NameStr(chunk->fd.schema_name),
+			 NameStr(chunk->fd.table_name));
+
+		/* Now update chunk_stats table */
+		ts_bgw_policy_chunk_stats_record_job_run(job_id,
+												 chunk_id,
+												 ts_timer_get_current_timestamp());
+		PopActiveSnapshot();
+	}
+
+	if (more_chunks)
 		enable_fast_restart(job_id, "reorder");
 
+	if (!used_portalcxt)
+		MemoryContextDelete(multitxn_cxt);
+
 	return true;
 }
 
@@ -274,12 +339,14 @@ policy_reorder_read_and_validate_config(Jsonb *config, PolicyReorderData *policy
 
 	const char *index_name = policy_reorder_get_index_name(config);
 	check_valid_index(ht, index_name);
+	int32 maxchunks = policy_reorder_get_maxchunks(config);
 
 	if (policy)
 	{
 		policy->hypertable = ht;
 		policy->index_relid =
 			ts_get_relation_relid(NameStr(ht->fd.schema_name), (char *) index_name, false);
+		policy->maxchunks = maxchunks;
 	}
 }
 
@@ -295,10 +362,13 @@ policy_retention_execute(int32 job_id, Jsonb *config)
 	if (verbose_log)
 		log_retention_boundary(LOG, &policy_data, "applying retention policy to hypertable");
 
-	chunk_invoke_drop_chunks(policy_data.object_relid,
-							 policy_data.boundary,
-							 policy_data.boundary_type,
-							 policy_data.use_creation_time);
+	ts_bgw_job_profile_phase_start("drop_chunks");
+	int num_dropped = chunk_invoke_drop_chunks(policy_data.object_relid,
+											   policy_data.boundary,
+											   policy_data.boundary_type,
+											   policy_data.use_creation_time);
+	ts_bgw_job_profile_phase_end("drop_chunks");
+	ts_bgw_job_profile_count("chunks_dropped", num_dropped);
 
 	return true;
 }
@@ -373,12 +443,29 @@ policy_refresh_cagg_execute(int32 job_id, Jsonb *config)
 	PolicyContinuousAggData policy_data;
 
 	policy_refresh_cagg_read_and_validate_config(config, &policy_data);
+	int32 raw_hypertable_id = policy_data.cagg->data.raw_hypertable_id;
+
 	continuous_agg_refresh_internal(policy_data.cagg,
 									&policy_data.refresh_window,
 									CAGG_REFRESH_POLICY,
 									policy_data.start_is_null,
 									policy_data.end_is_null);
 
+	/*
+	 * With adaptive scheduling, modifications to the refresh window that
+	 * arrived while refreshing are reported as backlog so that the job starts
+	 * again early. Only the presence of a backlog changes the schedule, so
+	 * the count is capped to keep the scan of the log short.
+	 */
+	if (policy_get_adaptive_schedule(config))
+	{
+		int64 backlog = invalidation_hyper_log_count_in_window(raw_hypertable_id,
+															   &policy_data.refresh_window,
+															   REFRESH_BACKLOG_MAX_COUNT);
+
+		ts_bgw_job_profile_count("backlog", backlog);
+	}
+
 	return true;
 }
 
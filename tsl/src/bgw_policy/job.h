@@ -17,11 +17,13 @@
 
 /* Add config keys common across job types here */
 #define CONFIG_KEY_VERBOSE_LOG "verbose_log" /*used only by retention now*/
+#define CONFIG_KEY_ADAPTIVE_SCHEDULE "adaptive_schedule"
 
 typedef struct PolicyReorderData
 {
 	Hypertable *hypertable;
 	Oid index_relid;
+	int32 maxchunks;
 } PolicyReorderData;
 
 typedef struct PolicyRetentionData
@@ -163,3 +163,12 @@ policy_get_verbose_log(const Jsonb *config)
 
 	return found ? verbose_log : false;
 }
+
+bool
+policy_get_adaptive_schedule(const Jsonb *config)
+{
+	bool found;
+	bool adaptive = ts_jsonb_get_bool_field(config, CONFIG_KEY_ADAPTIVE_SCHEDULE, &found);
+
+	return found ? adaptive : false;
+}
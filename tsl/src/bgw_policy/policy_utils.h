@@ -15,3 +15,4 @@ int64 subtract_integer_from_now_internal(int64 interval, Oid time_dim_type, Oid
 Datum subtract_interval_from_now(Interval *lag, Oid time_dim_type);
 const Dimension *get_open_dimension_for_hypertable(const Hypertable *ht, bool fail_if_not_found);
 bool policy_get_verbose_log(const Jsonb *config);
+bool policy_get_adaptive_schedule(const Jsonb *config);
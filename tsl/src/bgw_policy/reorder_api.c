@@ -50,6 +50,7 @@
 
 #define CONFIG_KEY_HYPERTABLE_ID "hypertable_id"
 #define CONFIG_KEY_INDEX_NAME "index_name"
+#define CONFIG_KEY_MAXCHUNKS_TO_REORDER "maxchunks_to_reorder"
 
 #define POLICY_REORDER_PROC_NAME "policy_reorder"
 #define POLICY_REORDER_CHECK_NAME "policy_reorder_check"
@@ -84,6 +85,25 @@ policy_reorder_get_index_name(const Jsonb *config)
 	return index_name;
 }
 
+/*
+ * Number of chunks to reorder in a single run of the policy. Each chunk is
+ * reordered in its own transaction, so locks on a reordered chunk are released
+ * before the next one is processed. Defaults to a single chunk per run.
+ */
+int32
+policy_reorder_get_maxchunks(const Jsonb *config)
+{
+	bool found;
+	int32 maxchunks = ts_jsonb_get_int32_field(config, CONFIG_KEY_MAXCHUNKS_TO_REORDER, &found);
+
+	if (found && maxchunks < 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("%s must be greater than 0", CONFIG_KEY_MAXCHUNKS_TO_REORDER)));
+
+	return found ? maxchunks : 1;
+}
+
 static void
 check_valid_index(Hypertable *ht, Name index_name)
 {
@@ -15,3 +15,4 @@ extern Datum policy_reorder_check(PG_FUNCTION_ARGS);
 
 extern int32 policy_reorder_get_hypertable_id(const Jsonb *config);
 extern char *policy_reorder_get_index_name(const Jsonb *config);
+extern int32 policy_reorder_get_maxchunks(const Jsonb *config);
@@ -0,0 +1,850 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Merging and splitting of chunks.
+ *
+ * Both operations copy the data of the affected chunks into transient heaps
+ * while holding an ExclusiveLock on the chunks, so reads continue while the
+ * data is copied. The rows are copied with the heap rewrite code of CLUSTER,
+ * which keeps their transaction information, so transactions with snapshots
+ * taken before the operation committed still see the rows after it. The
+ * indexes are built once on the filled heaps. The transient heaps are then
+ * swapped into the chunks the same way reorder does it, and the catalog is
+ * updated, which is the only part that needs an AccessExclusiveLock on the
+ * chunks.
+ */
+#include <postgres.h>
+#include <access/heapam.h>
+#include <access/multixact.h>
+#include <access/rewriteheap.h>
+#include <access/tableam.h>
+#include <access/tupconvert.h>
+#include <access/xact.h>
+#include <catalog/indexing.h>
+#include <catalog/pg_am.h>
+#include <commands/cluster.h>
+#include <commands/vacuum.h>
+#include <executor/tuptable.h>
+#include <miscadmin.h>
+#include <storage/bufmgr.h>
+#include <storage/lmgr.h>
+#include <utils/array.h>
+#include <utils/builtins.h>
+#include <utils/lsyscache.h>
+#include <utils/snapmgr.h>
+#include <utils/syscache.h>
+
+#include "compat/compat.h"
+#include "chunk.h"
+#include "chunk_constraint.h"
+#include "chunk_merge.h"
+#include "compression/create.h"
+#include "dimension.h"
+#include "dimension_slice.h"
+#include "hypercube.h"
+#include "hypertable_cache.h"
+#include "partitioning.h"
+#include "reorder.h"
+#include "time_utils.h"
+#include "ts_catalog/array_utils.h"
+#include "ts_catalog/chunk_column_stats.h"
+#include "ts_catalog/compression_chunk_size.h"
+#include "ts_catalog/compression_settings.h"
+#include "utils.h"
+
+/*
+ * Copies rows from one or more chunk heaps into a transient heap with the
+ * heap rewrite machinery that CLUSTER uses. The rows keep their transaction
+ * information, so snapshots that are older than the operation still see them
+ * after the heaps are swapped.
+ */
+typedef struct ChunkRewriter
+{
+	Relation rel;
+	/* Rewrite state and tuple conversion map of the heap that is copied */
+	RewriteState rwstate;
+	TupleConversionMap *map;
+	Datum *values;
+	bool *isnull;
+	/* The new relfrozenxid and relminmxid of the transient heap */
+	TransactionId frozen_xid;
+	MultiXactId cutoff_multi;
+	double ntuples;
+} ChunkRewriter;
+
+static void
+chunk_rewriter_init(ChunkRewriter *rewriter, Oid relid)
+{
+	memset(rewriter, 0, sizeof(ChunkRewriter));
+	/* We created the transient heap, so we already hold an ExclusiveLock on it */
+	rewriter->rel = table_open(relid, NoLock);
+	rewriter->values = palloc(sizeof(Datum) * RelationGetDescr(rewriter->rel)->natts);
+	rewriter->isnull = palloc(sizeof(bool) * RelationGetDescr(rewriter->rel)->natts);
+	rewriter->frozen_xid = InvalidTransactionId;
+	rewriter->cutoff_multi = InvalidMultiXactId;
+}
+
+/*
+ * Start copying the rows of a heap. Dead rows are weeded out and old rows
+ * are frozen with the same cutoffs CLUSTER uses.
+ */
+static void
+chunk_rewriter_begin_heap(ChunkRewriter *rewriter, Relation old_heap, TransactionId oldest_xmin,
+						  TransactionId freeze_xid, MultiXactId cutoff_multi)
+{
+	rewriter->rwstate =
+		begin_heap_rewrite(old_heap, rewriter->rel, oldest_xmin, freeze_xid, cutoff_multi);
+	/* Chunks of the same hypertable can have different physical layouts */
+	rewriter->map =
+		convert_tuples_by_name(RelationGetDescr(old_heap), RelationGetDescr(rewriter->rel));
+
+	if (!TransactionIdIsValid(rewriter->frozen_xid) ||
+		TransactionIdPrecedes(freeze_xid, rewriter->frozen_xid))
+		rewriter->frozen_xid = freeze_xid;
+	if (!MultiXactIdIsValid(rewriter->cutoff_multi) ||
+		MultiXactIdPrecedes(cutoff_multi, rewriter->cutoff_multi))
+		rewriter->cutoff_multi = cutoff_multi;
+}
+
+static void
+chunk_rewriter_add(ChunkRewriter *rewriter, Relation old_heap, HeapTuple tuple, bool isdead)
+{
+	TupleDesc tupdesc = RelationGetDescr(rewriter->rel);
+	HeapTuple new_tuple;
+
+	/* The rewrite needs to see dead rows as well, to resolve update chains */
+	if (isdead)
+	{
+		rewrite_heap_dead_tuple(rewriter->rwstate, tuple);
+		return;
+	}
+
+	if (rewriter->map != NULL)
+		new_tuple = execute_attr_map_tuple(tuple, rewriter->map);
+	else
+	{
+		heap_deform_tuple(tuple, RelationGetDescr(old_heap), rewriter->values, rewriter->isnull);
+
+		for (int i = 0; i < tupdesc->natts; i++)
+		{
+			if (TupleDescAttr(tupdesc, i)->attisdropped)
+				rewriter->isnull[i] = true;
+		}
+
+		new_tuple = heap_form_tuple(tupdesc, rewriter->values, rewriter->isnull);
+	}
+
+	rewrite_heap_tuple(rewriter->rwstate, tuple, new_tuple);
+	heap_freetuple(new_tuple);
+	rewriter->ntuples++;
+}
+
+static void
+chunk_rewriter_end_heap(ChunkRewriter *rewriter)
+{
+	end_heap_rewrite(rewriter->rwstate);
+	rewriter->rwstate = NULL;
+
+	if (rewriter->map != NULL)
+	{
+		free_conversion_map(rewriter->map);
+		rewriter->map = NULL;
+	}
+}
+
+/*
+ * Finish the transient heap and update its size in pg_class, which is
+ * swapped into the chunk together with the heap.
+ */
+static void
+chunk_rewriter_finish(ChunkRewriter *rewriter)
+{
+	Relation relrel = table_open(RelationRelationId, RowExclusiveLock);
+	HeapTuple reltup =
+		SearchSysCacheCopy1(RELOID, ObjectIdGetDatum(RelationGetRelid(rewriter->rel)));
+	Form_pg_class relform;
+
+	if (!HeapTupleIsValid(reltup))
+		elog(ERROR, "cache lookup failed for relation %u", RelationGetRelid(rewriter->rel));
+
+	relform = (Form_pg_class) GETSTRUCT(reltup);
+	relform->relpages = RelationGetNumberOfBlocks(rewriter->rel);
+	relform->reltuples = rewriter->ntuples;
+	CatalogTupleUpdate(relrel, &reltup->t_self, reltup);
+
+	heap_freetuple(reltup);
+	table_close(relrel, RowExclusiveLock);
+	pfree(rewriter->values);
+	pfree(rewriter->isnull);
+	table_close(rewriter->rel, NoLock);
+
+	/* Make the update visible */
+	CommandCounterIncrement();
+}
+
+/*
+ * Decide which rows of a heap are copied, like CLUSTER does. Returns true if
+ * the row is dead and can be removed.
+ */
+static bool
+chunk_tuple_is_dead(Relation rel, HeapTuple tuple, Buffer buffer, TransactionId oldest_xmin)
+{
+	bool isdead = false;
+
+	LockBuffer(buffer, BUFFER_LOCK_SHARE);
+
+	switch (HeapTupleSatisfiesVacuum(tuple, oldest_xmin, buffer))
+	{
+		case HEAPTUPLE_DEAD:
+			isdead = true;
+			break;
+		case HEAPTUPLE_RECENTLY_DEAD:
+		case HEAPTUPLE_LIVE:
+			break;
+		case HEAPTUPLE_INSERT_IN_PROGRESS:
+			/*
+			 * We hold an ExclusiveLock on the chunk, so the row should have
+			 * been inserted by our own transaction. Copy it in any case.
+			 */
+			if (!TransactionIdIsCurrentTransactionId(HeapTupleHeaderGetXmin(tuple->t_data)))
+				elog(WARNING,
+					 "concurrent insert in progress within table \"%s\"",
+					 RelationGetRelationName(rel));
+			break;
+		case HEAPTUPLE_DELETE_IN_PROGRESS:
+			if (!TransactionIdIsCurrentTransactionId(HeapTupleHeaderGetUpdateXid(tuple->t_data)))
+				elog(WARNING,
+					 "concurrent delete in progress within table \"%s\"",
+					 RelationGetRelationName(rel));
+			break;
+		default:
+			elog(ERROR, "unexpected HeapTupleSatisfiesVacuum result");
+			break;
+	}
+
+	LockBuffer(buffer, BUFFER_LOCK_UNLOCK);
+
+	return isdead;
+}
+
+/*
+ * Routes a row of a split chunk to one of the rewriters.
+ */
+typedef int (*chunk_row_route_func)(TupleTableSlot *slot, void *arg);
+
+/*
+ * Copy all row versions of a relation that are still needed by any snapshot
+ * into the rewriters. Without a routing function, all rows go to the first
+ * rewriter.
+ */
+static void
+rewrite_relation_data(Oid relid, ChunkRewriter *rewriters, int nrewriters,
+					  chunk_row_route_func route, void *route_arg)
+{
+	Relation rel = table_open(relid, NoLock);
+	TupleTableSlot *slot = table_slot_create(rel, NULL);
+	TableScanDesc scan;
+	TransactionId oldest_xmin;
+	TransactionId freeze_xid;
+	MultiXactId cutoff_multi;
+
+	/*
+	 * Keep autovacuum from removing toast rows of the rows that we consider
+	 * recently dead, see copy_heap_data() in reorder.c.
+	 */
+	if (OidIsValid(rel->rd_rel->reltoastrelid))
+		LockRelationOid(rel->rd_rel->reltoastrelid, ExclusiveLock);
+
+	vacuum_set_xid_limits_compat(rel, 0, 0, 0, 0, &oldest_xmin, &freeze_xid, &cutoff_multi);
+
+	/* The cutoffs must not go backwards */
+	if (TransactionIdPrecedes(freeze_xid, rel->rd_rel->relfrozenxid))
+		freeze_xid = rel->rd_rel->relfrozenxid;
+	if (MultiXactIdPrecedes(cutoff_multi, rel->rd_rel->relminmxid))
+		cutoff_multi = rel->rd_rel->relminmxid;
+
+	for (int i = 0; i < nrewriters; i++)
+		chunk_rewriter_begin_heap(&rewriters[i], rel, oldest_xmin, freeze_xid, cutoff_multi);
+
+	scan = table_beginscan(rel, SnapshotAny, 0, NULL);
+	while (table_scan_getnextslot(scan, ForwardScanDirection, slot))
+	{
+		HeapTuple tuple = ExecFetchSlotHeapTuple(slot, false, NULL);
+		Buffer buffer = ((BufferHeapTupleTableSlot *) slot)->buffer;
+		bool isdead = chunk_tuple_is_dead(rel, tuple, buffer, oldest_xmin);
+		int index = route != NULL ? route(slot, route_arg) : 0;
+
+		CHECK_FOR_INTERRUPTS();
+		chunk_rewriter_add(&rewriters[index], rel, tuple, isdead);
+	}
+	table_endscan(scan);
+
+	for (int i = 0; i < nrewriters; i++)
+		chunk_rewriter_end_heap(&rewriters[i]);
+
+	ExecDropSingleTupleTableSlot(slot);
+	table_close(rel, NoLock);
+}
+
+/*
+ * Create an empty transient heap with the same layout as the given relation.
+ */
+static Oid
+make_transient_heap(Oid relid)
+{
+	Relation rel = table_open(relid, NoLock);
+	Oid heap_relid = make_new_heap_compat(relid,
+										  rel->rd_rel->reltablespace,
+										  rel->rd_rel->relam,
+										  rel->rd_rel->relpersistence,
+										  ExclusiveLock);
+
+	table_close(rel, NoLock);
+	return heap_relid;
+}
+
+static void
+check_chunk_can_be_rewritten(const Chunk *chunk, ChunkOperation operation)
+{
+	ts_chunk_validate_chunk_status_for_operation(chunk, operation, true);
+
+	if (chunk->relkind != RELKIND_RELATION || chunk->amoid != HEAP_TABLE_AM_OID)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot %s chunk \"%s\"",
+						operation == CHUNK_MERGE ? "merge" : "split",
+						get_rel_name(chunk->table_id)),
+				 errdetail("Only chunks using the heap access method are supported.")));
+}
+
+static int
+chunk_cmp_by_relid(const void *left, const void *right)
+{
+	const Chunk *c1 = *((const Chunk **) left);
+	const Chunk *c2 = *((const Chunk **) right);
+
+	if (c1->table_id == c2->table_id)
+		return 0;
+
+	return c1->table_id < c2->table_id ? -1 : 1;
+}
+
+static int
+chunk_cmp_by_slice_start(const void *left, const void *right, void *arg)
+{
+	const Chunk *c1 = *((const Chunk **) left);
+	const Chunk *c2 = *((const Chunk **) right);
+	int dimension_index = *((int *) arg);
+	int64 start1 = c1->cube->slices[dimension_index]->fd.range_start;
+	int64 start2 = c2->cube->slices[dimension_index]->fd.range_start;
+
+	if (start1 == start2)
+		return 0;
+
+	return start1 < start2 ? -1 : 1;
+}
+
+/*
+ * Find the one dimension in which the chunks differ. All other slices must
+ * be the same for the chunks to be mergeable.
+ */
+static int
+find_merge_dimension_index(Chunk **chunks, int nchunks)
+{
+	int index = -1;
+
+	for (int i = 0; i < chunks[0]->cube->num_slices; i++)
+	{
+		for (int j = 1; j < nchunks; j++)
+		{
+			if (chunks[j]->cube->slices[i]->fd.id != chunks[0]->cube->slices[i]->fd.id)
+			{
+				if (index >= 0 && index != i)
+					ereport(ERROR,
+							(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+							 errmsg("cannot merge chunks with different partitioning schemas"),
+							 errdetail("Chunks \"%s\" and \"%s\" differ in more than one "
+									   "dimension.",
+									   get_rel_name(chunks[0]->table_id),
+									   get_rel_name(chunks[j]->table_id))));
+				index = i;
+			}
+		}
+	}
+
+	/* Distinct chunks always differ in at least one dimension */
+	Ensure(index >= 0, "merged chunks do not differ in any dimension");
+
+	return index;
+}
+
+/*
+ * Merged compressed batches are only known to be in order if the merged
+ * chunks follow each other in the primary dimension and the compressed data
+ * is ordered by it in ascending order, which is the same rule compression uses
+ * when it merges a chunk into an existing compressed chunk.
+ */
+static bool
+merged_chunk_is_ordered(const Hypertable *ht, const Dimension *dim)
+{
+	const Dimension *time_dim = hyperspace_get_open_dimension(ht->space, 0);
+	CompressionSettings *settings = ts_compression_settings_get(ht->main_table_relid);
+	int index;
+
+	if (dim != time_dim || settings == NULL || settings->fd.orderby == NULL)
+		return false;
+
+	index = ts_array_position(settings->fd.orderby, NameStr(time_dim->fd.column_name));
+
+	return index == 1 && !ts_array_get_element_bool(settings->fd.orderby_desc, index);
+}
+
+/*
+ * Merge adjacent chunks into the first one.
+ *
+ * The chunks must belong to the same hypertable and differ in exactly one
+ * dimension, where their slices have to cover a contiguous range. Either all
+ * of them or none of them can be compressed. Returns the merged chunk.
+ */
+Datum
+chunk_merge_chunks(PG_FUNCTION_ARGS)
+{
+	ArrayType *chunk_array = PG_ARGISNULL(0) ? NULL : PG_GETARG_ARRAYTYPE_P(0);
+	Datum *relids;
+	bool *nulls;
+	int nchunks;
+	Chunk **chunks;
+	Chunk *target;
+	Cache *hcache;
+	Hypertable *ht;
+	const Dimension *dim;
+	int merge_dimension_index;
+	const DimensionSlice *slice;
+	int64 range_start, range_end;
+	int num_compressed = 0;
+	Oid new_heap;
+	Oid new_compressed_heap = InvalidOid;
+	ChunkRewriter rewriter;
+	ChunkRewriter compressed_rewriter;
+	bool partial = false;
+	bool unordered = false;
+	int32 *merged_chunk_ids;
+
+	TS_PREVENT_FUNC_IF_READ_ONLY();
+
+	if (chunk_array == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("chunks cannot be NULL")));
+
+	deconstruct_array(chunk_array,
+					  REGCLASSOID,
+					  sizeof(Oid),
+					  true,
+					  TYPALIGN_INT,
+					  &relids,
+					  &nulls,
+					  &nchunks);
+
+	if (nchunks < 2)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("must specify at least two chunks to merge")));
+
+	chunks = palloc(sizeof(Chunk *) * nchunks);
+
+	for (int i = 0; i < nchunks; i++)
+	{
+		if (nulls[i])
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("chunks cannot contain NULL values")));
+
+		chunks[i] = ts_chunk_get_by_relid(DatumGetObjectId(relids[i]), false);
+
+		if (chunks[i] == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("\"%s\" is not a chunk", get_rel_name(DatumGetObjectId(relids[i])))));
+
+		if (chunks[i]->hypertable_relid != chunks[0]->hypertable_relid)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("cannot merge chunks from different hypertables"),
+					 errhint("chunk 1: \"%s\", chunk 2: \"%s\"",
+							 get_rel_name(chunks[0]->table_id),
+							 get_rel_name(chunks[i]->table_id))));
+	}
+
+	ht = ts_hypertable_cache_get_cache_and_entry(chunks[0]->hypertable_relid,
+												 CACHE_FLAG_NONE,
+												 &hcache);
+	ts_hypertable_permissions_check(ht->main_table_relid, GetUserId());
+
+	/*
+	 * Lock the chunks in a consistent order to avoid deadlocks with
+	 * concurrent merges. The ExclusiveLock blocks writes to the chunks but
+	 * allows reads while the data is copied.
+	 */
+	qsort(chunks, nchunks, sizeof(Chunk *), chunk_cmp_by_relid);
+	LockRelationOid(ht->main_table_relid, AccessShareLock);
+
+	for (int i = 0; i < nchunks; i++)
+	{
+		if (i > 0 && chunks[i]->table_id == chunks[i - 1]->table_id)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("cannot merge chunk \"%s\" with itself",
+							get_rel_name(chunks[i]->table_id))));
+
+		LockRelationOid(chunks[i]->table_id, ExclusiveLock);
+
+		/* Re-read the chunk now that it cannot change anymore */
+		chunks[i] = ts_chunk_get_by_relid(chunks[i]->table_id, true);
+		check_chunk_can_be_rewritten(chunks[i], CHUNK_MERGE);
+
+		if (ts_chunk_is_compressed(chunks[i]))
+		{
+			LockRelationOid(ts_chunk_get_relid(chunks[i]->fd.compressed_chunk_id, false),
+							ExclusiveLock);
+			num_compressed++;
+		}
+
+		partial |= ts_chunk_is_partial(chunks[i]);
+		unordered |= ts_chunk_is_unordered(chunks[i]);
+	}
+
+	if (num_compressed > 0 && num_compressed < nchunks)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot merge compressed and uncompressed chunks"),
+				 errhint("Compress or decompress the chunks before merging them.")));
+
+	merge_dimension_index = find_merge_dimension_index(chunks, nchunks);
+	qsort_arg(chunks, nchunks, sizeof(Chunk *), chunk_cmp_by_slice_start, &merge_dimension_index);
+
+	for (int i = 1; i < nchunks; i++)
+	{
+		const DimensionSlice *prev = chunks[i - 1]->cube->slices[merge_dimension_index];
+		const DimensionSlice *next = chunks[i]->cube->slices[merge_dimension_index];
+
+		if (prev->fd.range_end != next->fd.range_start)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("cannot merge non-adjacent chunks"),
+					 errhint("chunk 1: \"%s\", chunk 2: \"%s\"",
+							 get_rel_name(chunks[i - 1]->table_id),
+							 get_rel_name(chunks[i]->table_id))));
+	}
+
+	target = chunks[0];
+	slice = target->cube->slices[merge_dimension_index];
+	dim = ts_hyperspace_get_dimension_by_id(ht->space, slice->fd.dimension_id);
+	range_start = slice->fd.range_start;
+	range_end = chunks[nchunks - 1]->cube->slices[merge_dimension_index]->fd.range_end;
+
+	if (num_compressed > 0)
+	{
+		Oid relid = ts_chunk_get_relid(target->fd.compressed_chunk_id, false);
+		CompressionSettings *settings = ts_compression_settings_get(relid);
+
+		/* Batches merged from another chunk would reuse its sequence numbers */
+		if (get_attnum(relid, COMPRESSION_COLUMN_METADATA_SEQUENCE_NUM_NAME) != InvalidAttrNumber)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("cannot merge compressed chunks with sequence numbers"),
+					 errhint("Decompress the chunks before merging them.")));
+
+		for (int i = 1; i < nchunks; i++)
+		{
+			Oid other_relid = ts_chunk_get_relid(chunks[i]->fd.compressed_chunk_id, false);
+
+			if (!ts_compression_settings_equal(settings,
+											   ts_compression_settings_get(other_relid)))
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("cannot merge compressed chunks with different compression "
+								"settings"),
+						 errhint("chunk 1: \"%s\", chunk 2: \"%s\"",
+								 get_rel_name(target->table_id),
+								 get_rel_name(chunks[i]->table_id))));
+		}
+	}
+
+	/* Copy the data of all chunks into new heaps for the target chunk */
+	new_heap = make_transient_heap(target->table_id);
+	chunk_rewriter_init(&rewriter, new_heap);
+	for (int i = 0; i < nchunks; i++)
+		rewrite_relation_data(chunks[i]->table_id, &rewriter, 1, NULL, NULL);
+	chunk_rewriter_finish(&rewriter);
+
+	if (num_compressed > 0)
+	{
+		new_compressed_heap =
+			make_transient_heap(ts_chunk_get_relid(target->fd.compressed_chunk_id, false));
+		chunk_rewriter_init(&compressed_rewriter, new_compressed_heap);
+		for (int i = 0; i < nchunks; i++)
+			rewrite_relation_data(ts_chunk_get_relid(chunks[i]->fd.compressed_chunk_id, false),
+								  &compressed_rewriter,
+								  1,
+								  NULL,
+								  NULL);
+		chunk_rewriter_finish(&compressed_rewriter);
+	}
+
+	/*
+	 * Take all AccessExclusiveLocks needed for the swap and the catalog update
+	 * up front, again in relid order.
+	 */
+	qsort(chunks, nchunks, sizeof(Chunk *), chunk_cmp_by_relid);
+	for (int i = 0; i < nchunks; i++)
+		reorder_lock_relation_for_swap(chunks[i]->table_id);
+	for (int i = 0; i < nchunks && num_compressed > 0; i++)
+		reorder_lock_relation_for_swap(
+			ts_chunk_get_relid(chunks[i]->fd.compressed_chunk_id, false));
+	qsort_arg(chunks, nchunks, sizeof(Chunk *), chunk_cmp_by_slice_start, &merge_dimension_index);
+
+	reorder_swap_chunk_heap(target->table_id,
+							new_heap,
+							rewriter.frozen_xid,
+							rewriter.cutoff_multi);
+	if (num_compressed > 0)
+		reorder_swap_chunk_heap(ts_chunk_get_relid(target->fd.compressed_chunk_id, false),
+								new_compressed_heap,
+								compressed_rewriter.frozen_xid,
+								compressed_rewriter.cutoff_multi);
+
+	/* Update the catalog and drop the chunks that were merged into the target */
+	merged_chunk_ids = palloc(sizeof(int32) * (nchunks - 1));
+	for (int i = 1; i < nchunks; i++)
+		merged_chunk_ids[i - 1] = chunks[i]->fd.id;
+
+	ts_chunk_set_dimension_slice(target, dim->fd.id, range_start, range_end);
+	ts_chunk_constraint_recreate_dimension(ht, target, dim->fd.id);
+
+	if (num_compressed > 0)
+	{
+		ts_compression_chunk_size_merge(target->fd.id, merged_chunk_ids, nchunks - 1);
+
+		if (unordered || !merged_chunk_is_ordered(ht, dim))
+			ts_chunk_set_unordered(target);
+		if (partial)
+			ts_chunk_set_partial(target);
+	}
+
+	for (int i = 1; i < nchunks; i++)
+		ts_chunk_drop(chunks[i], DROP_RESTRICT, DEBUG1);
+
+	/* The ranges of the merged chunk are recalculated on next compression */
+	ts_chunk_column_stats_reset_by_chunk_id(target->fd.id);
+
+	ts_cache_release(hcache);
+	PG_RETURN_OID(target->table_id);
+}
+
+/*
+ * Get the internal value of the dimension that a chunk row is partitioned on.
+ */
+static int64
+chunk_row_dimension_value(const Dimension *dim, AttrNumber attno, Oid collation,
+						  TupleTableSlot *slot)
+{
+	bool isnull;
+	Datum value = slot_getattr(slot, attno, &isnull);
+
+	/* Partitioning columns are NOT NULL */
+	Ensure(!isnull, "NULL value in partitioning column \"%s\"", NameStr(dim->fd.column_name));
+
+	if (dim->partitioning != NULL)
+		value = ts_partitioning_func_apply(dim->partitioning, collation, value);
+
+	return ts_time_value_to_internal(value, ts_dimension_get_partition_type(dim));
+}
+
+typedef struct SplitRoute
+{
+	const Dimension *dim;
+	AttrNumber attno;
+	Oid collation;
+	int64 split_at;
+} SplitRoute;
+
+/* Route the rows below the split point to the first rewriter */
+static int
+split_chunk_route_row(TupleTableSlot *slot, void *arg)
+{
+	const SplitRoute *route = arg;
+	int64 value = chunk_row_dimension_value(route->dim, route->attno, route->collation, slot);
+
+	return value < route->split_at ? 0 : 1;
+}
+
+/*
+ * Split a chunk in two at a point in its primary dimension.
+ *
+ * The chunk keeps the lower part of its range and the rows in it. A new chunk
+ * is created for the upper part and the rows in it are moved there. Without a
+ * split point, the chunk is split in the middle. Returns the new chunk.
+ */
+Datum
+chunk_split_chunk(PG_FUNCTION_ARGS)
+{
+	Oid chunk_relid = PG_ARGISNULL(0) ? InvalidOid : PG_GETARG_OID(0);
+	Chunk *chunk;
+	Chunk *new_chunk;
+	Cache *hcache;
+	Hypertable *ht;
+	const Dimension *dim;
+	const DimensionSlice *slice;
+	Hypercube *cube;
+	int64 range_start, range_end, split_at;
+	bool created = false;
+	Oid lower_heap, upper_heap;
+	ChunkRewriter rewriters[2];
+	SplitRoute route;
+	Oid typid;
+	int32 typmod;
+
+	TS_PREVENT_FUNC_IF_READ_ONLY();
+
+	if (!OidIsValid(chunk_relid))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("chunk cannot be NULL")));
+
+	chunk = ts_chunk_get_by_relid(chunk_relid, false);
+
+	if (chunk == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("\"%s\" is not a chunk", get_rel_name(chunk_relid))));
+
+	ht = ts_hypertable_cache_get_cache_and_entry(chunk->hypertable_relid, CACHE_FLAG_NONE, &hcache);
+	ts_hypertable_permissions_check(ht->main_table_relid, GetUserId());
+
+	LockRelationOid(ht->main_table_relid, AccessShareLock);
+	LockRelationOid(chunk_relid, ExclusiveLock);
+
+	/* Re-read the chunk now that it cannot change anymore */
+	chunk = ts_chunk_get_by_relid(chunk_relid, true);
+	check_chunk_can_be_rewritten(chunk, CHUNK_SPLIT);
+
+	if (ts_chunk_is_compressed(chunk))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot split compressed chunk \"%s\"", get_rel_name(chunk_relid)),
+				 errhint("Decompress the chunk before splitting it.")));
+
+	dim = hyperspace_get_open_dimension(ht->space, 0);
+	Ensure(dim != NULL,
+		   "hypertable \"%s\" has no open dimension",
+		   get_rel_name(ht->main_table_relid));
+	slice = ts_hypercube_get_slice_by_dimension_id(chunk->cube, dim->fd.id);
+	Ensure(slice != NULL,
+		   "chunk \"%s\" has no slice for the primary dimension",
+		   get_rel_name(chunk_relid));
+	range_start = slice->fd.range_start;
+	range_end = slice->fd.range_end;
+
+	if (PG_ARGISNULL(1))
+	{
+		if (range_start == PG_INT64_MIN || range_end == PG_INT64_MAX)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("cannot split chunk \"%s\" with unbounded range in the middle",
+							get_rel_name(chunk_relid)),
+					 errhint("Specify a split point.")));
+
+		split_at = range_start + (range_end - range_start) / 2;
+	}
+	else
+	{
+		Oid partition_type = ts_dimension_get_partition_type(dim);
+		Oid argtype = get_fn_expr_argtype(fcinfo->flinfo, 1);
+		Datum arg = ts_time_datum_convert_arg(PG_GETARG_DATUM(1), &argtype, partition_type);
+
+		if (argtype != partition_type)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("invalid type of split point \"%s\"", format_type_be(argtype)),
+					 errhint("The split point must be of type \"%s\".",
+							 format_type_be(partition_type))));
+
+		split_at = ts_time_value_to_internal(arg, partition_type);
+	}
+
+	if (split_at <= range_start || split_at >= range_end)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("split point is outside the range of chunk \"%s\"",
+						get_rel_name(chunk_relid))));
+
+	/*
+	 * Shrink the chunk in the catalog first so that the new chunk does not
+	 * collide with it. The CHECK constraint on the chunk is replaced when the
+	 * data is swapped.
+	 */
+	cube = ts_hypercube_copy(chunk->cube);
+	ts_chunk_set_dimension_slice(chunk, dim->fd.id, range_start, split_at);
+
+	for (int i = 0; i < cube->num_slices; i++)
+	{
+		if (cube->slices[i]->fd.dimension_id == dim->fd.id)
+			cube->slices[i] = ts_dimension_slice_create(dim->fd.id, split_at, range_end);
+	}
+
+	new_chunk = ts_chunk_find_or_create_without_cuts(ht,
+													 cube,
+													 NameStr(ht->fd.associated_schema_name),
+													 NULL,
+													 InvalidOid,
+													 &created);
+	Ensure(created, "split chunk collides with chunk \"%s\"", get_rel_name(new_chunk->table_id));
+
+	/*
+	 * Route the rows of the chunk into new heaps for the lower and upper part
+	 * in a single scan. An update chain that crosses the split point is cut,
+	 * so the older row version looks deleted instead of updated to the
+	 * transactions that still see it.
+	 */
+	route.dim = dim;
+	route.attno = get_attnum(chunk_relid, NameStr(dim->fd.column_name));
+	get_atttypetypmodcoll(chunk_relid, route.attno, &typid, &typmod, &route.collation);
+	route.split_at = split_at;
+
+	lower_heap = make_transient_heap(chunk_relid);
+	upper_heap = make_transient_heap(new_chunk->table_id);
+	chunk_rewriter_init(&rewriters[0], lower_heap);
+	chunk_rewriter_init(&rewriters[1], upper_heap);
+	rewrite_relation_data(chunk_relid, rewriters, 2, split_chunk_route_row, &route);
+	chunk_rewriter_finish(&rewriters[0]);
+	chunk_rewriter_finish(&rewriters[1]);
+
+	elog(DEBUG1,
+		 "split chunk \"%s\": %.0f rows kept, %.0f rows moved to \"%s\"",
+		 get_rel_name(chunk_relid),
+		 rewriters[0].ntuples,
+		 rewriters[1].ntuples,
+		 get_rel_name(new_chunk->table_id));
+
+	/* The new chunk is not visible to other transactions, so no lock waits here */
+	reorder_swap_chunk_heap(new_chunk->table_id,
+							upper_heap,
+							rewriters[1].frozen_xid,
+							rewriters[1].cutoff_multi);
+
+	reorder_lock_relation_for_swap(chunk_relid);
+	ts_chunk_constraint_recreate_dimension(ht, chunk, dim->fd.id);
+	reorder_swap_chunk_heap(chunk_relid,
+							lower_heap,
+							rewriters[0].frozen_xid,
+							rewriters[0].cutoff_multi);
+
+	/* The ranges of the split chunk are recalculated on next compression */
+	ts_chunk_column_stats_reset_by_chunk_id(chunk->fd.id);
+
+	ts_cache_release(hcache);
+	PG_RETURN_OID(new_chunk->table_id);
+}
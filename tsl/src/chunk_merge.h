@@ -0,0 +1,12 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+#include <fmgr.h>
+
+extern Datum chunk_merge_chunks(PG_FUNCTION_ARGS);
+extern Datum chunk_split_chunk(PG_FUNCTION_ARGS);
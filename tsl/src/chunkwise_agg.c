@@ -5,12 +5,18 @@
  */
 #include <postgres.h>
 
+#include <access/nbtree.h>
 #include <optimizer/appendinfo.h>
 #include <optimizer/cost.h>
+#include <optimizer/optimizer.h>
 #include <optimizer/pathnode.h>
 #include <optimizer/paths.h>
 #include <optimizer/prep.h>
+#include <optimizer/restrictinfo.h>
 #include <optimizer/tlist.h>
+#include <parser/parse_oper.h>
+#include <utils/lsyscache.h>
+#include <utils/selfuncs.h>
 
 #include "chunkwise_agg.h"
 
@@ -245,7 +251,8 @@ create_sorted_partial_agg_path(PlannerInfo *root, Path *path, PathTarget *target
  */
 static AggPath *
 create_hashed_partial_agg_path(PlannerInfo *root, Path *path, PathTarget *target,
-							   double d_num_groups, GroupPathExtraData *extra_data)
+							   List *group_clause, double d_num_groups,
+							   GroupPathExtraData *extra_data)
 {
 	/* Determine costs for aggregations */
 	AggClauseCosts *agg_partial_costs = &extra_data->agg_partial_costs;
@@ -256,11 +263,7 @@ create_hashed_partial_agg_path(PlannerInfo *root, Path *path, PathTarget *target
 										 target,
 										 AGG_HASHED,
 										 AGGSPLIT_INITIAL_SERIAL,
-#if PG16_LT
-										 root->parse->groupClause,
-#else
-										 root->processed_groupClause,
-#endif
+										 group_clause,
 										 NIL,
 										 agg_partial_costs,
 										 d_num_groups);
@@ -272,9 +275,10 @@ create_hashed_partial_agg_path(PlannerInfo *root, Path *path, PathTarget *target
  */
 static void
 add_partially_aggregated_subpaths(PlannerInfo *root, PathTarget *input_target,
-								  PathTarget *partial_grouping_target, double d_num_groups,
-								  GroupPathExtraData *extra_data, bool can_sort, bool can_hash,
-								  Path *subpath, List **sorted_paths, List **hashed_paths)
+								  PathTarget *partial_grouping_target, List *group_clause,
+								  double d_num_groups, GroupPathExtraData *extra_data,
+								  bool can_sort, bool can_hash, Path *subpath,
+								  List **sorted_paths, List **hashed_paths)
 {
 	/* Translate targetlist for partition */
 	AppendRelInfo *appinfo = ts_get_appendrelinfo(root, subpath->parent->relid, false);
@@ -337,6 +341,7 @@ add_partially_aggregated_subpaths(PlannerInfo *root, PathTarget *input_target,
 		AggPath *agg_path = create_hashed_partial_agg_path(root,
 														   subpath,
 														   chunk_grouped_target,
+														   group_clause,
 														   d_num_groups,
 														   extra_data);
 
@@ -345,49 +350,16 @@ add_partially_aggregated_subpaths(PlannerInfo *root, PathTarget *input_target,
 }
 
 /*
- * Generate a total aggregation path for partial aggregations.
- *
- * The generated paths contain partial aggregations (created by using AGGSPLIT_INITIAL_SERIAL).
- * These aggregations need to be finished by the caller by adding a node that performs the
- * AGGSPLIT_FINAL_DESERIAL step.
- *
- * The original path can be either parallel or non-parallel aggregation, and the
- * resulting path will be parallel accordingly.
+ * Add partially aggregated paths on top of the subpaths of an append-like path
  */
 static void
-generate_agg_pushdown_path(PlannerInfo *root, Path *cheapest_total_path, RelOptInfo *input_rel,
-						   RelOptInfo *output_rel, RelOptInfo *partially_grouped_rel,
-						   PathTarget *grouping_target, PathTarget *partial_grouping_target,
-						   bool can_sort, bool can_hash, double d_num_groups,
-						   GroupPathExtraData *extra_data)
+add_partially_aggregated_append_subpaths(PlannerInfo *root, List *subpaths,
+										 PathTarget *input_target,
+										 PathTarget *partial_grouping_target, List *group_clause,
+										 double d_num_groups, GroupPathExtraData *extra_data,
+										 bool can_sort, bool can_hash, List **sorted_subpaths,
+										 List **hashed_subpaths)
 {
-	/* Get subpaths */
-	List *subpaths = NIL;
-	Path *top_gather = NULL;
-	Path *top_append = NULL;
-	get_subpaths_from_append_path(cheapest_total_path, &subpaths, &top_append, &top_gather);
-
-	/* No subpaths available or unsupported append node */
-	if (subpaths == NIL)
-	{
-		return;
-	}
-
-	Assert(top_append != NULL);
-
-	if (list_length(subpaths) < 2)
-	{
-		/*
-		 * Doesn't make sense to add per-chunk aggregation paths if there's
-		 * only one chunk.
-		 */
-		return;
-	}
-
-	/* Generate agg paths on top of the append children */
-	List *sorted_subpaths = NIL;
-	List *hashed_subpaths = NIL;
-
 	ListCell *lc;
 	foreach (lc, subpaths)
 	{
@@ -420,8 +392,9 @@ generate_agg_pushdown_path(PlannerInfo *root, Path *cheapest_total_path, RelOptI
 				Path *partially_compressed_path = lfirst(lc2);
 
 				add_partially_aggregated_subpaths(root,
-												  input_rel->reltarget,
+												  input_target,
 												  partial_grouping_target,
+												  group_clause,
 												  d_num_groups,
 												  extra_data,
 												  can_sort,
@@ -433,37 +406,101 @@ generate_agg_pushdown_path(PlannerInfo *root, Path *cheapest_total_path, RelOptI
 
 			if (can_sort)
 			{
-				sorted_subpaths = lappend(sorted_subpaths,
-										  copy_append_like_path(root,
-																partially_compressed_append,
-																partially_compressed_sorted,
-																subpath->pathtarget));
+				*sorted_subpaths = lappend(*sorted_subpaths,
+										   copy_append_like_path(root,
+																 partially_compressed_append,
+																 partially_compressed_sorted,
+																 subpath->pathtarget));
 			}
 
 			if (can_hash)
 			{
-				hashed_subpaths = lappend(hashed_subpaths,
-										  copy_append_like_path(root,
-																partially_compressed_append,
-																partially_compressed_hashed,
-																subpath->pathtarget));
+				*hashed_subpaths = lappend(*hashed_subpaths,
+										   copy_append_like_path(root,
+																 partially_compressed_append,
+																 partially_compressed_hashed,
+																 subpath->pathtarget));
 			}
 		}
 		else
 		{
 			add_partially_aggregated_subpaths(root,
-											  input_rel->reltarget,
+											  input_target,
 											  partial_grouping_target,
+											  group_clause,
 											  d_num_groups,
 											  extra_data,
 											  can_sort,
 											  can_hash,
 											  subpath,
-											  &sorted_subpaths /* Result paths */,
-											  &hashed_subpaths /* Result paths */);
+											  sorted_subpaths /* Result paths */,
+											  hashed_subpaths /* Result paths */);
 		}
 	}
 
+}
+
+/*
+ * Generate a total aggregation path for partial aggregations.
+ *
+ * The generated paths contain partial aggregations (created by using AGGSPLIT_INITIAL_SERIAL).
+ * These aggregations need to be finished by the caller by adding a node that performs the
+ * AGGSPLIT_FINAL_DESERIAL step.
+ *
+ * The original path can be either parallel or non-parallel aggregation, and the
+ * resulting path will be parallel accordingly.
+ */
+static void
+generate_agg_pushdown_path(PlannerInfo *root, Path *cheapest_total_path, RelOptInfo *input_rel,
+						   RelOptInfo *output_rel, RelOptInfo *partially_grouped_rel,
+						   PathTarget *grouping_target, PathTarget *partial_grouping_target,
+						   bool can_sort, bool can_hash, double d_num_groups,
+						   GroupPathExtraData *extra_data)
+{
+	/* Get subpaths */
+	List *subpaths = NIL;
+	Path *top_gather = NULL;
+	Path *top_append = NULL;
+	get_subpaths_from_append_path(cheapest_total_path, &subpaths, &top_append, &top_gather);
+
+	/* No subpaths available or unsupported append node */
+	if (subpaths == NIL)
+	{
+		return;
+	}
+
+	Assert(top_append != NULL);
+
+	if (list_length(subpaths) < 2)
+	{
+		/*
+		 * Doesn't make sense to add per-chunk aggregation paths if there's
+		 * only one chunk.
+		 */
+		return;
+	}
+
+	/* Generate agg paths on top of the append children */
+	List *sorted_subpaths = NIL;
+	List *hashed_subpaths = NIL;
+	add_partially_aggregated_append_subpaths(root,
+											 subpaths,
+											 input_rel->reltarget,
+											 partial_grouping_target,
+#if PG16_LT
+											 root->parse->groupClause,
+#else
+											 root->processed_groupClause,
+#endif
+											 d_num_groups,
+											 extra_data,
+											 can_sort,
+											 can_hash,
+											 &sorted_subpaths,
+											 &hashed_subpaths);
+
+	ListCell *lc;
+
 	/* Create new append paths */
 	if (top_gather == NULL)
 	{
@@ -586,6 +623,429 @@ contains_path_plain_or_sorted_agg(Path *path)
 	return true;
 }
 
+/*
+ * Find the hypertable in a join of a hypertable with one other base relation.
+ * Returns NULL if the join has a different shape.
+ */
+static RelOptInfo *
+get_joined_hypertable_rel(PlannerInfo *root, RelOptInfo *joinrel)
+{
+	RelOptInfo *ht_rel = NULL;
+	int relid = -1;
+
+	/* On PG16 and later, the relids of outer joins also include the join itself */
+	if (joinrel->reloptkind != RELOPT_JOINREL || bms_num_members(joinrel->relids) != 2)
+		return NULL;
+
+	while ((relid = bms_next_member(joinrel->relids, relid)) >= 0)
+	{
+		RelOptInfo *rel = root->simple_rel_array[relid];
+		Hypertable *ht;
+
+		if (rel == NULL || rel->reloptkind != RELOPT_BASEREL)
+			return NULL;
+
+		if (ts_classify_relation(root, rel, &ht) == TS_REL_HYPERTABLE)
+		{
+			/* Joins of two hypertables are not supported */
+			if (ht_rel != NULL)
+				return NULL;
+
+			ht_rel = rel;
+		}
+	}
+
+	return ht_rel;
+}
+
+/*
+ * Add the hypertable Vars used in the expression to the list. Returns false if
+ * the expression uses something that cannot be a grouping column of the
+ * partial aggregation below the join.
+ */
+static bool
+add_hypertable_vars(Node *expr, Index ht_relid, List **vars)
+{
+	List *expr_vars = pull_var_clause(expr, PVC_INCLUDE_PLACEHOLDERS);
+	ListCell *lc;
+
+	foreach (lc, expr_vars)
+	{
+		Var *var = lfirst(lc);
+
+		if (!IsA(var, Var))
+			return false;
+
+		if (var->varno != (int) ht_relid)
+			continue;
+
+		/* Whole-row Vars of the hypertable are not supported */
+		if (var->varattno == InvalidAttrNumber)
+			return false;
+
+		*vars = list_append_unique(*vars, var);
+	}
+
+	return true;
+}
+
+/*
+ * Check that values that are equal according to the ordering operator are
+ * also identical, e.g. not numeric 1.0 and 1.00 or float -0 and +0. The
+ * partial aggregation below the join only outputs one of the equal values of
+ * a group, so grouping by a different expression of the value above the join
+ * would be wrong otherwise. This is what the btree deduplication checks as
+ * well.
+ */
+static bool
+sortop_has_equal_image(Oid sortop, Oid collation)
+{
+	Oid opfamily;
+	Oid opcintype;
+	int16 strategy;
+
+	if (!get_ordering_op_properties(sortop, &opfamily, &opcintype, &strategy))
+		return false;
+
+	Oid equalimage_proc = get_opfamily_proc(opfamily, opcintype, opcintype, BTEQUALIMAGE_PROC);
+	if (!OidIsValid(equalimage_proc))
+		return false;
+
+	return DatumGetBool(
+		OidFunctionCall1Coll(equalimage_proc, collation, ObjectIdGetDatum(opcintype)));
+}
+
+/*
+ * Create a join path that joins the partially aggregated chunks of the
+ * hypertable instead of the hypertable scan. The chunks are grouped by the
+ * hypertable columns that are used by the join clauses or above the join, so
+ * the join sees the same groups as the original aggregation, only with fewer
+ * rows. A chunk group that matches several rows of the other relation is
+ * duplicated by the join, and combining the duplicated partial aggregates in
+ * the final aggregation gives the same result as aggregating the duplicated
+ * rows. Returns NULL if the path is not supported.
+ */
+static Path *
+create_partially_aggregated_join_path(PlannerInfo *root, Path *path, RelOptInfo *ht_rel,
+									  RelOptInfo *grouped_join_rel, List *above_join_vars,
+									  PathTarget *join_target, GroupPathExtraData *extra_data)
+{
+	if (!IsA(path, HashPath) && !IsA(path, NestPath))
+		return NULL;
+
+	JoinPath *join_path = (JoinPath *) path;
+
+	if (join_path->jointype != JOIN_INNER || join_path->path.param_info != NULL ||
+		join_path->outerjoinpath->param_info != NULL ||
+		join_path->innerjoinpath->param_info != NULL)
+		return NULL;
+
+	bool ht_is_outer = join_path->outerjoinpath->parent == ht_rel;
+	Path *ht_path = ht_is_outer ? join_path->outerjoinpath : join_path->innerjoinpath;
+	if (ht_path->parent != ht_rel)
+		return NULL;
+
+	List *subpaths = NIL;
+	Path *append = NULL;
+	Path *gather = NULL;
+	get_subpaths_from_append_path(ht_path, &subpaths, &append, &gather);
+
+	/*
+	 * The hashed partial aggregation loses the ordering of the chunks, so only
+	 * unordered appends are supported.
+	 */
+	if (list_length(subpaths) < 2 || gather != NULL || append->pathkeys != NIL ||
+		IsA(append, MergeAppendPath))
+		return NULL;
+
+	/* Group the chunks by the hypertable columns needed for the join and above */
+	List *group_vars = list_copy(above_join_vars);
+	List *join_clauses = extract_actual_clauses(join_path->joinrestrictinfo, false);
+	if (!add_hypertable_vars((Node *) join_clauses, ht_rel->relid, &group_vars) ||
+		group_vars == NIL)
+		return NULL;
+
+	PathTarget *input_target = copy_pathtarget(ht_rel->reltarget);
+	input_target->sortgrouprefs = palloc0(sizeof(Index) * list_length(input_target->exprs));
+	PathTarget *partial_target = create_empty_pathtarget();
+	List *group_clause = NIL;
+	ListCell *lc;
+
+	foreach (lc, group_vars)
+	{
+		Var *var = lfirst(lc);
+		Oid sortop;
+		Oid eqop;
+		bool hashable;
+		int i = 0;
+		ListCell *lc2;
+
+		get_sort_group_operators(var->vartype,
+								 false,
+								 false,
+								 false,
+								 &sortop,
+								 &eqop,
+								 NULL,
+								 &hashable);
+		if (!OidIsValid(eqop) || !hashable || !OidIsValid(sortop) ||
+			!sortop_has_equal_image(sortop, var->varcollid))
+			return NULL;
+
+		SortGroupClause *sgc = makeNode(SortGroupClause);
+		sgc->tleSortGroupRef = list_length(group_clause) + 1;
+		sgc->eqop = eqop;
+		sgc->sortop = sortop;
+		sgc->nulls_first = false;
+		sgc->hashable = true;
+		group_clause = lappend(group_clause, sgc);
+
+		/* Label the grouping column in the input of the partial aggregation */
+		foreach (lc2, input_target->exprs)
+		{
+			if (equal(lfirst(lc2), var))
+				break;
+			i++;
+		}
+
+		if (lc2 == NULL)
+			return NULL;
+
+		input_target->sortgrouprefs[i] = sgc->tleSortGroupRef;
+		add_column_to_pathtarget(partial_target, (Expr *) var, sgc->tleSortGroupRef);
+	}
+
+	foreach (lc, join_target->exprs)
+	{
+		Expr *expr = lfirst(lc);
+
+		if (IsA(expr, Aggref))
+			add_column_to_pathtarget(partial_target, expr, 0);
+	}
+
+	set_pathtarget_cost_width(root, partial_target);
+
+	/* The chunks are usually similar, so estimate the groups of an average chunk */
+	double d_num_chunk_groups = estimate_num_groups(root,
+													group_vars,
+													clamp_row_est(ht_rel->rows /
+																  list_length(subpaths)),
+													NULL,
+													NULL);
+
+	List *sorted_subpaths = NIL;
+	List *hashed_subpaths = NIL;
+	add_partially_aggregated_append_subpaths(root,
+											 subpaths,
+											 input_target,
+											 partial_target,
+											 group_clause,
+											 d_num_chunk_groups,
+											 extra_data,
+											 /* can_sort = */ false,
+											 /* can_hash = */ true,
+											 &sorted_subpaths,
+											 &hashed_subpaths);
+
+	Path *grouped_ht_path = copy_append_like_path(root, append, hashed_subpaths, partial_target);
+	Path *outer_path = ht_is_outer ? grouped_ht_path : join_path->outerjoinpath;
+	Path *inner_path = ht_is_outer ? join_path->innerjoinpath : grouped_ht_path;
+
+	/*
+	 * The join produces fewer rows in the same proportion as the hypertable
+	 * side. All paths join the same relations with the same clauses, so the
+	 * first path estimates the rows of the grouped join relation.
+	 */
+	if (grouped_join_rel->rows <= 0)
+		grouped_join_rel->rows =
+			clamp_row_est(join_path->path.rows * grouped_ht_path->rows / ht_path->rows);
+
+	/*
+	 * The grouped hypertable side is unique on the join keys, but the other
+	 * side might not be, so we don't assume unique inner rows.
+	 */
+	JoinPathExtraData join_extra = {
+		.restrictlist = join_path->joinrestrictinfo,
+		.inner_unique = false,
+	};
+	JoinCostWorkspace workspace;
+
+	if (IsA(join_path, HashPath))
+	{
+		HashPath *hash_path = castNode(HashPath, join_path);
+
+		initial_cost_hashjoin(root,
+							  &workspace,
+							  JOIN_INNER,
+							  hash_path->path_hashclauses,
+							  outer_path,
+							  inner_path,
+							  &join_extra,
+							  /* parallel_hash = */ false);
+
+		return (Path *) create_hashjoin_path(root,
+											 grouped_join_rel,
+											 JOIN_INNER,
+											 &workspace,
+											 &join_extra,
+											 outer_path,
+											 inner_path,
+											 /* parallel_hash = */ false,
+											 join_path->joinrestrictinfo,
+											 /* required_outer = */ NULL,
+											 hash_path->path_hashclauses);
+	}
+
+	initial_cost_nestloop(root, &workspace, JOIN_INNER, outer_path, inner_path, &join_extra);
+
+	return (Path *) create_nestloop_path(root,
+										 grouped_join_rel,
+										 JOIN_INNER,
+										 &workspace,
+										 &join_extra,
+										 outer_path,
+										 inner_path,
+										 join_path->joinrestrictinfo,
+										 /* pathkeys = */ NIL,
+										 /* required_outer = */ NULL);
+}
+
+/*
+ * Eager aggregation: push the chunk-wise partial aggregation below a join of
+ * the hypertable with another relation, and finalize the aggregation above
+ * the join. This is possible when all the aggregates only use the columns of
+ * the hypertable.
+ *
+ * Generated aggregation paths:
+ *
+ * Finalize Aggregate
+ *   -> Hash Join
+ *      -> Append
+ *         -> Partial Aggregation
+ *            - Chunk 1
+ *         ...
+ *         -> Partial Aggregation
+ *            - Chunk N
+ *      -> Hash
+ *         -> Scan on other relation
+ *
+ * The new paths compete with the existing ones on cost.
+ */
+static void
+pushdown_partial_agg_below_join(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *output_rel,
+								PathTarget *grouping_target, bool can_sort, bool can_hash,
+								double d_num_groups, GroupPathExtraData *extra_data)
+{
+	Query *parse = root->parse;
+
+	/* The partial aggregation below the join uses hashing */
+	if (!enable_hashagg)
+		return;
+
+	RelOptInfo *ht_rel = get_joined_hypertable_rel(root, input_rel);
+	if (ht_rel == NULL)
+		return;
+
+	/*
+	 * The join outputs the partial aggregates, the grouping columns and the
+	 * columns needed above the aggregation, like for a partial aggregation
+	 * directly on top of the join.
+	 */
+	PathTarget *join_target = ts_make_partial_grouping_target(root, grouping_target);
+	List *above_join_vars = NIL;
+	ListCell *lc;
+
+	foreach (lc, join_target->exprs)
+	{
+		Node *expr = lfirst(lc);
+
+		if (!IsA(expr, Aggref))
+		{
+			if (!add_hypertable_vars(expr, ht_rel->relid, &above_join_vars))
+				return;
+			continue;
+		}
+
+		/* The aggregates can only use the columns of the hypertable */
+		Aggref *aggref = castNode(Aggref, expr);
+		if (aggref->aggorder != NIL || aggref->aggdistinct != NIL ||
+			!bms_is_subset(pull_varnos(root, expr), ht_rel->relids))
+			return;
+	}
+
+	RelOptInfo *grouped_join_rel =
+		fetch_upper_rel(root, UPPERREL_PARTIAL_GROUP_AGG, input_rel->relids);
+	grouped_join_rel->reloptkind = input_rel->reloptkind;
+	grouped_join_rel->consider_startup = input_rel->consider_startup;
+	grouped_join_rel->reltarget = join_target;
+
+	AggClauseCosts *agg_final_costs = &extra_data->agg_final_costs;
+	foreach (lc, input_rel->pathlist)
+	{
+		Path *input_path = lfirst(lc);
+
+		/* The join computes the grouping input itself, so we don't need the projection */
+		if (IsA(input_path, ProjectionPath))
+			input_path = castNode(ProjectionPath, input_path)->subpath;
+
+		Path *join_path = create_partially_aggregated_join_path(root,
+																input_path,
+																ht_rel,
+																grouped_join_rel,
+																above_join_vars,
+																join_target,
+																extra_data);
+		if (join_path == NULL)
+			continue;
+
+		if (can_hash && parse->groupClause != NIL)
+		{
+			add_path(output_rel,
+					 (Path *) create_agg_path(root,
+											  output_rel,
+											  join_path,
+											  grouping_target,
+											  AGG_HASHED,
+											  AGGSPLIT_FINAL_DESERIAL,
+#if PG16_LT
+											  parse->groupClause,
+#else
+											  root->processed_groupClause,
+#endif
+											  (List *) parse->havingQual,
+											  agg_final_costs,
+											  d_num_groups));
+		}
+
+		if (can_sort)
+		{
+			Path *sorted_path = join_path;
+
+			if (!pathkeys_contained_in(root->group_pathkeys, join_path->pathkeys))
+			{
+				sorted_path = (Path *)
+					create_sort_path(root, output_rel, join_path, root->group_pathkeys, -1.0);
+			}
+
+			add_path(output_rel,
+					 (Path *) create_agg_path(root,
+											  output_rel,
+											  sorted_path,
+											  grouping_target,
+											  parse->groupClause ? AGG_SORTED : AGG_PLAIN,
+											  AGGSPLIT_FINAL_DESERIAL,
+#if PG16_LT
+											  parse->groupClause,
+#else
+											  root->processed_groupClause,
+#endif
+											  (List *) parse->havingQual,
+											  agg_final_costs,
+											  d_num_groups));
+		}
+	}
+}
+
 /*
  * Replan the aggregation and create a partial aggregation at chunk level and finalize the
  * aggregation on top of an append node.
@@ -614,8 +1074,8 @@ tsl_pushdown_partial_agg(PlannerInfo *root, Hypertable *ht, RelOptInfo *input_re
 {
 	Query *parse = root->parse;
 
-	/* We are only interested in hypertables */
-	if (!ht)
+	/* We are only interested in hypertables and joins with hypertables */
+	if (!ht && !IS_JOIN_REL(input_rel))
 		return;
 
 	/* Perform partial aggregation planning only if there is an aggregation is requested */
@@ -659,22 +1119,6 @@ tsl_pushdown_partial_agg(PlannerInfo *root, Hypertable *ht, RelOptInfo *input_re
 	double d_num_groups = existing_agg_path->numGroups;
 	Assert(d_num_groups > 0);
 
-	/* Construct partial group agg upper relation */
-	RelOptInfo *partially_grouped_rel =
-		fetch_upper_rel(root, UPPERREL_PARTIAL_GROUP_AGG, input_rel->relids);
-	partially_grouped_rel->consider_parallel = input_rel->consider_parallel;
-	partially_grouped_rel->consider_startup = input_rel->consider_startup;
-	partially_grouped_rel->reloptkind = input_rel->reloptkind;
-	partially_grouped_rel->serverid = input_rel->serverid;
-	partially_grouped_rel->userid = input_rel->userid;
-	partially_grouped_rel->useridiscurrent = input_rel->useridiscurrent;
-	partially_grouped_rel->fdwroutine = input_rel->fdwroutine;
-
-	/* Build target list for partial aggregate paths */
-	PathTarget *grouping_target = output_rel->reltarget;
-	PathTarget *partial_grouping_target = ts_make_partial_grouping_target(root, grouping_target);
-	partially_grouped_rel->reltarget = partial_grouping_target;
-
 	/* Calculate aggregation costs */
 	if (!extra_data->partial_costs_set)
 	{
@@ -691,6 +1135,39 @@ tsl_pushdown_partial_agg(PlannerInfo *root, Hypertable *ht, RelOptInfo *input_re
 		extra_data->partial_costs_set = true;
 	}
 
+	PathTarget *grouping_target = output_rel->reltarget;
+
+	if (ht == NULL)
+	{
+		if (ts_guc_enable_eager_aggregation && !ts_is_gapfill_path(linitial(output_rel->pathlist)))
+		{
+			pushdown_partial_agg_below_join(root,
+											input_rel,
+											output_rel,
+											grouping_target,
+											can_sort,
+											can_hash,
+											d_num_groups,
+											extra_data);
+		}
+		return;
+	}
+
+	/* Construct partial group agg upper relation */
+	RelOptInfo *partially_grouped_rel =
+		fetch_upper_rel(root, UPPERREL_PARTIAL_GROUP_AGG, input_rel->relids);
+	partially_grouped_rel->consider_parallel = input_rel->consider_parallel;
+	partially_grouped_rel->consider_startup = input_rel->consider_startup;
+	partially_grouped_rel->reloptkind = input_rel->reloptkind;
+	partially_grouped_rel->serverid = input_rel->serverid;
+	partially_grouped_rel->userid = input_rel->userid;
+	partially_grouped_rel->useridiscurrent = input_rel->useridiscurrent;
+	partially_grouped_rel->fdwroutine = input_rel->fdwroutine;
+
+	/* Build target list for partial aggregate paths */
+	PathTarget *partial_grouping_target = ts_make_partial_grouping_target(root, grouping_target);
+	partially_grouped_rel->reltarget = partial_grouping_target;
+
 	/*
 	 * For queries with LIMIT, the aggregated relation can have a path with low
 	 * total cost, and a path with low startup cost. We must partialize both, so
@@ -39,6 +39,7 @@
 #include "compat/compat.h"
 #include "annotations.h"
 #include "api.h"
+#include "bgw/job_stat_history.h"
 #include "cache.h"
 #include "chunk.h"
 #include "compression.h"
@@ -413,12 +414,14 @@ compress_chunk_impl(Oid hypertable_relid, Oid chunk_relid)
 			(errmsg("acquiring locks for compressing \"%s.%s\"",
 					get_namespace_name(get_rel_namespace(chunk_relid)),
 					get_rel_name(chunk_relid))));
+	ts_bgw_job_profile_phase_start("lock_wait");
 	LockRelationOid(cxt.srcht->main_table_relid, AccessShareLock);
 	LockRelationOid(cxt.compress_ht->main_table_relid, AccessShareLock);
 	LockRelationOid(cxt.srcht_chunk->table_id, ExclusiveLock);
 
 	/* acquire locks on catalog tables to keep till end of txn */
 	LockRelationOid(catalog_get_table_id(ts_catalog_get(), CHUNK), RowExclusiveLock);
+	ts_bgw_job_profile_phase_end("lock_wait");
 	ereport(DEBUG1,
 			(errmsg("locks acquired for compressing \"%s.%s\"",
 					get_namespace_name(get_rel_namespace(chunk_relid)),
@@ -528,9 +531,17 @@ compress_chunk_impl(Oid hypertable_relid, Oid chunk_relid)
 	if (cxt.srcht->range_space)
 		ts_chunk_column_stats_calculate(cxt.srcht, cxt.srcht_chunk);
 
+	ts_bgw_job_profile_phase_start("compression");
 	cstat = compress_chunk(cxt.srcht_chunk->table_id, compress_ht_chunk->table_id, insert_options);
+	ts_bgw_job_profile_phase_end("compression");
 	after_size = ts_relation_size_impl(compress_ht_chunk->table_id);
 
+	ts_bgw_job_profile_count("chunks_compressed", 1);
+	ts_bgw_job_profile_count("rows_read", cstat.rowcnt_pre_compression);
+	ts_bgw_job_profile_count("batches_compressed", cstat.rowcnt_post_compression);
+	ts_bgw_job_profile_count("bytes_before", before_size.total_size);
+	ts_bgw_job_profile_count("bytes_after", after_size.total_size);
+
 	if (new_compressed_chunk)
 	{
 		compression_chunk_size_catalog_insert(cxt.srcht_chunk->fd.id,
@@ -24,6 +24,7 @@
 #include "algorithms/gorilla.h"
 #include "chunk.h"
 #include "compression.h"
+#include "compression_analyze.h"
 #include "create.h"
 #include "custom_type_cache.h"
 #include "debug_assert.h"
@@ -101,7 +102,8 @@ tsl_get_decompress_all_function(CompressionAlgorithm algorithm, Oid type)
 	return definitions[algorithm].decompress_all;
 }
 
-static Tuplesortstate *compress_chunk_sort_relation(CompressionSettings *settings, Relation in_rel);
+static Tuplesortstate *compress_chunk_sort_relation(CompressionSettings *settings, Relation in_rel,
+												   CompressionAnalyzeState *analyze_state);
 static void row_compressor_process_ordered_slot(RowCompressor *row_compressor, TupleTableSlot *slot,
 												CommandId mycid);
 static void row_compressor_update_group(RowCompressor *row_compressor, TupleTableSlot *row);
@@ -448,6 +450,9 @@ compress_chunk(Oid in_table, Oid out_table, int insert_options)
 						true /*need_bistate*/,
 						insert_options);
 
+	/* Collect the column statistics of the chunk while we read all of its rows */
+	CompressionAnalyzeState *analyze_state = compression_analyze_begin(in_rel);
+
 	if (matched_index_rel != NULL)
 	{
 		int64 nrows_processed = 0;
@@ -463,6 +468,9 @@ compress_chunk(Oid in_table, Oid out_table, int insert_options)
 		report_reltuples = calculate_reltuples_to_report(in_rel);
 		while (index_getnext_slot(index_scan, indexscan_direction, slot))
 		{
+			if (analyze_state != NULL)
+				compression_analyze_add_slot(analyze_state, slot);
+
 			row_compressor_process_ordered_slot(&row_compressor, slot, mycid);
 			if ((++nrows_processed % report_reltuples) == 0)
 				elog(DEBUG2,
@@ -489,12 +497,16 @@ compress_chunk(Oid in_table, Oid out_table, int insert_options)
 			 "using tuplesort to scan rows from \"%s\" for compression",
 			 RelationGetRelationName(in_rel));
 
-		Tuplesortstate *sorted_rel = compress_chunk_sort_relation(settings, in_rel);
+		Tuplesortstate *sorted_rel = compress_chunk_sort_relation(settings, in_rel, analyze_state);
 		row_compressor_append_sorted_rows(&row_compressor, sorted_rel, in_desc, in_rel);
 		tuplesort_end(sorted_rel);
 	}
 
 	row_compressor_close(&row_compressor);
+
+	if (analyze_state != NULL)
+		compression_analyze_end(analyze_state);
+
 	if (!ts_guc_enable_delete_after_compression)
 	{
 		DEBUG_WAITPOINT("compression_done_before_truncate_uncompressed");
@@ -571,7 +583,8 @@ compression_create_tuplesort_state(CompressionSettings *settings, Relation rel)
 }
 
 static Tuplesortstate *
-compress_chunk_sort_relation(CompressionSettings *settings, Relation in_rel)
+compress_chunk_sort_relation(CompressionSettings *settings, Relation in_rel,
+							 CompressionAnalyzeState *analyze_state)
 {
 	Tuplesortstate *tuplesortstate;
 	TableScanDesc scan;
@@ -590,6 +603,9 @@ compress_chunk_sort_relation(CompressionSettings *settings, Relation in_rel)
 			 *      so ISTM that the options are this or maybe putdatum().
 			 */
 			tuplesort_puttupleslot(tuplesortstate, slot);
+
+			if (analyze_state != NULL)
+				compression_analyze_add_slot(analyze_state, slot);
 		}
 	}
 
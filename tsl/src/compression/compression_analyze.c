@@ -0,0 +1,262 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Column statistics of a chunk computed during compression.
+ *
+ * Once a chunk is compressed, its rows are only found in the compressed
+ * chunk, so ANALYZE can't compute statistics for the chunk anymore. Since
+ * compression reads all the rows of the chunk anyway, it takes a sample of
+ * them on the way, the same kind of sample that ANALYZE would take, and
+ * computes the column statistics of the chunk from it with the typanalyze
+ * functions of the columns.
+ */
+#include <postgres.h>
+#include <access/htup_details.h>
+#include <catalog/pg_type.h>
+#include <commands/vacuum.h>
+#include <executor/tuptable.h>
+#include <utils/memutils.h>
+#include <utils/rel.h>
+#include <utils/sampling.h>
+#include <utils/syscache.h>
+
+#include "compat/compat.h"
+#include "attstats.h"
+#include "compression_analyze.h"
+#include "guc.h"
+#include "hypercore/hypercore_handler.h"
+
+struct CompressionAnalyzeState
+{
+	MemoryContext mcxt;
+	Relation rel;
+	VacAttrStats **vacattrstats;
+	int attr_cnt;
+	/* The reservoir of sample rows */
+	HeapTuple *rows;
+	int targrows;
+	int numrows;
+	/* The number of rows seen so far */
+	double samplerows;
+	double rowstoskip;
+	ReservoirStateData rstate;
+};
+
+/*
+ * Set up the statistics of a column, like examine_attribute() in analyze.c
+ * does. Returns NULL if the column is not analyzed.
+ */
+static VacAttrStats *
+compression_analyze_examine_attribute(Relation rel, AttrNumber attnum, MemoryContext mcxt)
+{
+	Form_pg_attribute attr = TupleDescAttr(RelationGetDescr(rel), AttrNumberGetAttrOffset(attnum));
+	HeapTuple typtuple;
+	VacAttrStats *stats;
+	int attstattarget;
+	bool ok;
+
+	if (attr->attisdropped)
+		return NULL;
+
+#if PG17_GE
+	{
+		HeapTuple atttuple = SearchSysCache2(ATTNUM,
+											 ObjectIdGetDatum(RelationGetRelid(rel)),
+											 Int16GetDatum(attnum));
+		bool isnull;
+		Datum dat;
+
+		if (!HeapTupleIsValid(atttuple))
+			elog(ERROR,
+				 "cache lookup failed for attribute %d of relation %u",
+				 attnum,
+				 RelationGetRelid(rel));
+
+		dat = SysCacheGetAttr(ATTNUM, atttuple, Anum_pg_attribute_attstattarget, &isnull);
+		attstattarget = isnull ? -1 : DatumGetInt16(dat);
+		ReleaseSysCache(atttuple);
+	}
+#else
+	attstattarget = attr->attstattarget;
+#endif
+
+	if (attstattarget == 0)
+		return NULL;
+
+	stats = palloc0(sizeof(VacAttrStats));
+#if PG17_GE
+	stats->attstattarget = attstattarget;
+#else
+	stats->attr = palloc(ATTRIBUTE_FIXED_PART_SIZE);
+	memcpy(stats->attr, attr, ATTRIBUTE_FIXED_PART_SIZE);
+#endif
+	stats->attrtypid = attr->atttypid;
+	stats->attrtypmod = attr->atttypmod;
+	stats->attrcollid = attr->attcollation;
+
+	typtuple = SearchSysCacheCopy1(TYPEOID, ObjectIdGetDatum(stats->attrtypid));
+	if (!HeapTupleIsValid(typtuple))
+		elog(ERROR, "cache lookup failed for type %u", stats->attrtypid);
+	stats->attrtype = (Form_pg_type) GETSTRUCT(typtuple);
+	stats->anl_context = mcxt;
+	stats->tupattnum = attnum;
+
+	for (int i = 0; i < STATISTIC_NUM_SLOTS; i++)
+	{
+		stats->statypid[i] = stats->attrtypid;
+		stats->statyplen[i] = stats->attrtype->typlen;
+		stats->statypbyval[i] = stats->attrtype->typbyval;
+		stats->statypalign[i] = stats->attrtype->typalign;
+	}
+
+	if (OidIsValid(stats->attrtype->typanalyze))
+		ok = DatumGetBool(OidFunctionCall1(stats->attrtype->typanalyze, PointerGetDatum(stats)));
+	else
+		ok = std_typanalyze(stats);
+
+	if (!ok || stats->compute_stats == NULL || stats->minrows <= 0)
+		return NULL;
+
+	return stats;
+}
+
+/*
+ * Start collecting the sample of the rows of a chunk that is compressed.
+ * Returns NULL if no statistics are computed for the chunk.
+ */
+CompressionAnalyzeState *
+compression_analyze_begin(Relation rel)
+{
+	CompressionAnalyzeState *state;
+	MemoryContext mcxt;
+	MemoryContext oldmcxt;
+	TupleDesc tupdesc = RelationGetDescr(rel);
+
+	/* ANALYZE sees the compressed data of Hypercore */
+	if (!ts_guc_enable_compression_analyze || REL_IS_HYPERCORE(rel))
+		return NULL;
+
+	mcxt = AllocSetContextCreate(CurrentMemoryContext,
+								 "compression analyze",
+								 ALLOCSET_DEFAULT_SIZES);
+	oldmcxt = MemoryContextSwitchTo(mcxt);
+
+	state = palloc0(sizeof(CompressionAnalyzeState));
+	state->mcxt = mcxt;
+	state->rel = rel;
+	state->vacattrstats = palloc(sizeof(VacAttrStats *) * tupdesc->natts);
+	/* The minimum sample size of ANALYZE */
+	state->targrows = 100;
+
+	for (int i = 0; i < tupdesc->natts; i++)
+	{
+		VacAttrStats *stats =
+			compression_analyze_examine_attribute(rel, AttrOffsetGetAttrNumber(i), mcxt);
+
+		if (stats == NULL)
+			continue;
+
+		state->vacattrstats[state->attr_cnt++] = stats;
+		state->targrows = Max(state->targrows, stats->minrows);
+	}
+
+	MemoryContextSwitchTo(oldmcxt);
+
+	if (state->attr_cnt == 0)
+	{
+		MemoryContextDelete(mcxt);
+		return NULL;
+	}
+
+	state->rows = MemoryContextAlloc(mcxt, sizeof(HeapTuple) * state->targrows);
+	state->rowstoskip = -1;
+	reservoir_init_selection_state(&state->rstate, state->targrows);
+
+	return state;
+}
+
+/*
+ * Add a row to the sample. This is the reservoir sampling of
+ * acquire_sample_rows() in analyze.c, so every row has the same chance to end
+ * up in the sample.
+ */
+void
+compression_analyze_add_slot(CompressionAnalyzeState *state, TupleTableSlot *slot)
+{
+	MemoryContext oldmcxt = MemoryContextSwitchTo(state->mcxt);
+
+	if (state->numrows < state->targrows)
+		state->rows[state->numrows++] = ExecCopySlotHeapTuple(slot);
+	else
+	{
+		if (state->rowstoskip < 0)
+			state->rowstoskip =
+				reservoir_get_next_S(&state->rstate, state->samplerows, state->targrows);
+
+		if (state->rowstoskip <= 0)
+		{
+#if PG15_GE
+			int k = (int) (state->targrows * sampler_random_fract(&state->rstate.randstate));
+#else
+			int k = (int) (state->targrows * sampler_random_fract(state->rstate.randstate));
+#endif
+
+			heap_freetuple(state->rows[k]);
+			state->rows[k] = ExecCopySlotHeapTuple(slot);
+		}
+
+		state->rowstoskip -= 1;
+	}
+
+	state->samplerows += 1;
+	MemoryContextSwitchTo(oldmcxt);
+}
+
+static Datum
+compression_analyze_fetch(VacAttrStatsP stats, int rownum, bool *isnull)
+{
+	return heap_getattr(stats->rows[rownum], stats->tupattnum, stats->tupDesc, isnull);
+}
+
+/*
+ * Compute the column statistics from the sample and store them as the
+ * statistics of the chunk.
+ */
+void
+compression_analyze_end(CompressionAnalyzeState *state)
+{
+	if (state->numrows > 0)
+	{
+		MemoryContext col_mcxt = AllocSetContextCreate(state->mcxt,
+														"compression analyze column",
+														ALLOCSET_DEFAULT_SIZES);
+
+		for (int i = 0; i < state->attr_cnt; i++)
+		{
+			VacAttrStats *stats = state->vacattrstats[i];
+			MemoryContext oldmcxt = MemoryContextSwitchTo(col_mcxt);
+
+			stats->rows = state->rows;
+			stats->tupDesc = RelationGetDescr(state->rel);
+			stats->compute_stats(stats,
+								 compression_analyze_fetch,
+								 state->numrows,
+								 state->samplerows);
+
+			if (stats->stats_valid)
+				ts_attstats_store(RelationGetRelid(state->rel), stats->tupattnum, false, stats);
+
+			MemoryContextSwitchTo(oldmcxt);
+			MemoryContextReset(col_mcxt);
+		}
+
+		/* Make the statistics visible */
+		CommandCounterIncrement();
+	}
+
+	MemoryContextDelete(state->mcxt);
+}
@@ -0,0 +1,16 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+#include <executor/tuptable.h>
+#include <utils/relcache.h>
+
+typedef struct CompressionAnalyzeState CompressionAnalyzeState;
+
+extern CompressionAnalyzeState *compression_analyze_begin(Relation rel);
+extern void compression_analyze_add_slot(CompressionAnalyzeState *state, TupleTableSlot *slot);
+extern void compression_analyze_end(CompressionAnalyzeState *state);
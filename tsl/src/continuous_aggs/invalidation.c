@@ -175,6 +175,52 @@ hypertable_invalidation_scan_init(ScanIterator *iterator, int32 hyper_id, LOCKMO
 		Int32GetDatum(hyper_id));
 }
 
+/*
+ * Count the entries in the hypertable invalidation log that overlap with the
+ * given window, i.e., the modifications that a refresh of the window has not
+ * processed yet.
+ *
+ * Only entries starting before the end of the window are scanned, and the
+ * scan stops once max_count entries are found.
+ */
+int64
+invalidation_hyper_log_count_in_window(int32 hyper_id, const InternalTimeRange *window,
+									   int64 max_count)
+{
+	ScanIterator iterator;
+	int64 count = 0;
+
+	hypertable_invalidation_scan_init(&iterator, hyper_id, AccessShareLock);
+	ts_scan_iterator_scan_key_init(
+		&iterator,
+		Anum_continuous_aggs_hypertable_invalidation_log_idx_lowest_modified_value,
+		BTLessStrategyNumber,
+		F_INT8LT,
+		Int64GetDatum(window->end));
+
+	ts_scanner_foreach(&iterator)
+	{
+		bool should_free;
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		HeapTuple tuple = ts_scanner_fetch_heap_tuple(ti, false, &should_free);
+		Form_continuous_aggs_hypertable_invalidation_log form =
+			(Form_continuous_aggs_hypertable_invalidation_log) GETSTRUCT(tuple);
+
+		if (form->greatest_modified_value >= window->start)
+			count++;
+
+		if (should_free)
+			heap_freetuple(tuple);
+
+		if (count >= max_count)
+			break;
+	}
+
+	ts_scan_iterator_close(&iterator);
+
+	return count;
+}
+
 static HeapTuple
 create_invalidation_tup(const TupleDesc tupdesc, int32 cagg_hyper_id, int64 start, int64 end)
 {
@@ -20,6 +20,7 @@
 #include <utils/snapmgr.h>
 #include <utils/timestamp.h>
 
+#include "bgw/job_stat_history.h"
 #include "debug_assert.h"
 #include "guc.h"
 #include "materialize.h"
@@ -661,6 +662,9 @@ execute_materialization_plan(MaterializationContext *context, MaterializationPla
 	{
 		if (materialization->emit_progress != NULL)
 			materialization->emit_progress(context, SPI_processed);
+
+		if (!materialization->read_only)
+			ts_bgw_job_profile_count("rows_written", SPI_processed);
 	}
 
 	return SPI_processed;
@@ -18,6 +18,7 @@
 #include <utils/lsyscache.h>
 #include <utils/snapmgr.h>
 
+#include "bgw/job_stat_history.h"
 #include "ts_catalog/catalog.h"
 #include "ts_catalog/continuous_agg.h"
 #include <dimension.h>
@@ -718,7 +719,11 @@ process_cagg_invalidations_and_refresh(const ContinuousAgg *cagg,
 	 * same continuous aggregate when they don't have overlapping refresh
 	 * windows.
 	 */
+	ts_bgw_job_profile_phase_start("lock_wait");
 	LockRelationOid(hyper_relid, ExclusiveLock);
+	ts_bgw_job_profile_phase_end("lock_wait");
+
+	ts_bgw_job_profile_phase_start("cagg_invalidations");
 	const CaggsInfo all_caggs_info =
 		ts_continuous_agg_get_all_caggs_info(cagg->data.raw_hypertable_id);
 	invalidations = invalidation_process_cagg_log(cagg,
@@ -728,6 +733,11 @@ process_cagg_invalidations_and_refresh(const ContinuousAgg *cagg,
 												  &do_merged_refresh,
 												  &merged_refresh_window,
 												  callctx);
+	ts_bgw_job_profile_phase_end("cagg_invalidations");
+
+	if (invalidations != NULL)
+		ts_bgw_job_profile_count("invalidations_processed",
+								 tuplestore_tuple_count(invalidations->tupstore));
 
 	if (invalidations != NULL || do_merged_refresh)
 	{
@@ -740,6 +750,7 @@ process_cagg_invalidations_and_refresh(const ContinuousAgg *cagg,
 							 "aggregate on creation.")));
 		}
 
+		ts_bgw_job_profile_phase_start("materialization");
 		continuous_agg_refresh_with_window(cagg,
 										   refresh_window,
 										   invalidations,
@@ -747,6 +758,7 @@ process_cagg_invalidations_and_refresh(const ContinuousAgg *cagg,
 										   do_merged_refresh,
 										   merged_refresh_window,
 										   callctx);
+		ts_bgw_job_profile_phase_end("materialization");
 		if (invalidations)
 			invalidation_store_free(invalidations);
 		return true;
@@ -874,7 +886,9 @@ continuous_agg_refresh_internal(const ContinuousAgg *cagg,
 	/* Process invalidations in the hypertable invalidation log */
 	const CaggsInfo all_caggs_info =
 		ts_continuous_agg_get_all_caggs_info(cagg->data.raw_hypertable_id);
+	ts_bgw_job_profile_phase_start("hypertable_invalidations");
 	invalidation_process_hypertable_log(cagg, refresh_window.type, &all_caggs_info);
+	ts_bgw_job_profile_phase_end("hypertable_invalidations");
 
 	/* Commit and Start a new transaction */
 	SPI_commit_and_chain();
@@ -16,6 +16,7 @@
 #include "bgw_policy/retention_api.h"
 #include "chunk.h"
 #include "chunk_api.h"
+#include "chunk_merge.h"
 #include "compression/algorithms/array.h"
 #include "compression/algorithms/deltadelta.h"
 #include "compression/algorithms/dictionary.h"
@@ -43,6 +44,7 @@
 #include "license_guc.h"
 #include "nodes/columnar_scan/columnar_scan.h"
 #include "nodes/decompress_chunk/planner.h"
+#include "nodes/gapfill/gapfill.h"
 #include "nodes/gapfill/gapfill_functions.h"
 #include "nodes/skip_scan/skip_scan.h"
 #include "nodes/vector_agg/plan.h"
@@ -183,6 +185,8 @@ CrossModuleFunctions tsl_cm_functions = {
 	.create_chunk = chunk_create,
 	.chunk_freeze_chunk = chunk_freeze_chunk,
 	.chunk_unfreeze_chunk = chunk_unfreeze_chunk,
+	.chunk_merge_chunks = chunk_merge_chunks,
+	.chunk_split_chunk = chunk_split_chunk,
 	.set_rel_pathlist = tsl_set_rel_pathlist,
 	.chunk_create_empty_table = chunk_create_empty_table,
 	.recompress_chunk_segmentwise = tsl_recompress_chunk_segmentwise,
@@ -215,6 +219,7 @@ ts_module_init(PG_FUNCTION_ARGS)
 	_attr_capture_init();
 	_skip_scan_init();
 	_vector_agg_init();
+	_gapfill_init();
 
 	/* Register a cleanup function to be called when the backend exits */
 	if (register_proc_exit)
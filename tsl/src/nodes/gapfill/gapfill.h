@@ -9,11 +9,15 @@
 #include <nodes/pathnodes.h>
 #include <nodes/primnodes.h>
 
+#include "hypertable.h"
+
 #define GAPFILL_FUNCTION "time_bucket_gapfill"
 #define GAPFILL_LOCF_FUNCTION "locf"
 #define GAPFILL_INTERPOLATE_FUNCTION "interpolate"
 
-void plan_add_gapfill(PlannerInfo *root, RelOptInfo *group_rel);
+extern void _gapfill_init(void);
+void plan_add_gapfill(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *group_rel,
+					  Hypertable *ht);
 void gapfill_adjust_window_targetlist(PlannerInfo *root, RelOptInfo *input_rel,
 									  RelOptInfo *output_rel);
 
@@ -61,7 +61,8 @@ static void gapfill_rescan(CustomScanState *node);
 static TupleTableSlot *gapfill_exec(CustomScanState *node);
 
 static void gapfill_state_reset_group(GapFillState *state, TupleTableSlot *slot);
-static TupleTableSlot *gapfill_state_gaptuple_create(GapFillState *state, int64 time);
+static void gapfill_state_fill_batch(GapFillState *state);
+static TupleTableSlot *gapfill_state_batch_next(GapFillState *state);
 static bool gapfill_state_is_new_group(GapFillState *state, TupleTableSlot *slot);
 static void gapfill_state_set_next(GapFillState *state, TupleTableSlot *subslot);
 static TupleTableSlot *gapfill_state_return_subplan_slot(GapFillState *state);
@@ -660,10 +661,7 @@ gapfill_advance_timestamp(GapFillState *state)
 			if (state->have_timezone &&
 				(state->next_offset->day != 0 || state->next_offset->month != 0))
 			{
-				bool isnull;
-				/* TODO: optimize by constifying and caching the datum if possible */
-				Datum tzname = gapfill_exec_expr(state, get_timezone_arg(state), &isnull);
-				Assert(!isnull);
+				Datum tzname = state->timezone;
 
 				/* Convert to local timestamp */
 				next = DirectFunctionCall2(timestamptz_zone,
@@ -776,6 +774,14 @@ gapfill_begin(CustomScanState *node, EState *estate, int eflags)
 	state->next_timestamp = state->gapfill_start;
 	state->next_offset = state->gapfill_interval;
 
+	/* the timezone is needed for every gap tuple so evaluate it only once */
+	if (state->have_timezone)
+	{
+		Datum tzname = gapfill_exec_expr(state, get_timezone_arg(state), &isnull);
+		Assert(!isnull);
+		state->timezone = datumCopy(tzname, false, -1);
+	}
+
 	/* gap fill end */
 	if (is_const_null(get_finish_arg(state)))
 		state->gapfill_end = infer_gapfill_boundary(state, GAPFILL_END);
@@ -803,6 +809,19 @@ gapfill_begin(CustomScanState *node, EState *estate, int eflags)
 
 	gapfill_state_initialize_columns(state);
 
+	state->batch_times = palloc(sizeof(int64) * GAPFILL_BATCH_SIZE);
+	state->batch_len = 0;
+	state->batch_next = 0;
+	for (i = 0; i < state->ncolumns; i++)
+	{
+		if (state->columns[i]->ctype == LOCF_COLUMN ||
+			state->columns[i]->ctype == INTERPOLATE_COLUMN)
+		{
+			state->columns[i]->batch_values = palloc(sizeof(Datum) * GAPFILL_BATCH_SIZE);
+			state->columns[i]->batch_isnull = palloc(sizeof(bool) * GAPFILL_BATCH_SIZE);
+		}
+	}
+
 	/*
 	 * Build ProjectionInfo that will be used for gap filled tuples only.
 	 *
@@ -846,6 +865,10 @@ gapfill_exec(CustomScanState *node)
 	{
 		CHECK_FOR_INTERRUPTS();
 
+		/* return gap tuples filled ahead of time first */
+		if (state->batch_next < state->batch_len)
+			return gapfill_state_batch_next(state);
+
 		/* fetch next tuple from subplan */
 		if (FETCHED_NONE == state->state)
 		{
@@ -888,13 +911,12 @@ gapfill_exec(CustomScanState *node)
 			return gapfill_state_return_subplan_slot(state);
 		}
 
-		/* if we are within gapfill boundaries we need to insert tuple */
+		/* if we are within gapfill boundaries we need to insert tuples */
 		if (state->next_timestamp < state->gapfill_end)
 		{
 			Assert(state->state != FETCHED_NONE);
-			slot = gapfill_state_gaptuple_create(state, state->next_timestamp);
-			gapfill_advance_timestamp(state);
-			return slot;
+			gapfill_state_fill_batch(state);
+			continue;
 		}
 
 		/* return any remaining subplan tuples after gapfill_end */
@@ -936,6 +958,8 @@ gapfill_rescan(CustomScanState *node)
 		ExecReScan(linitial(node->custom_ps));
 	}
 	((GapFillState *) node)->state = FETCHED_NONE;
+	((GapFillState *) node)->batch_len = 0;
+	((GapFillState *) node)->batch_next = 0;
 }
 
 static void
@@ -975,15 +999,29 @@ gapfill_state_reset_group(GapFillState *state, TupleTableSlot *slot)
 }
 
 /*
- * Create generated tuple according to column state
+ * Fill the next batch of gap tuples.
+ *
+ * A run of missing buckets ends at the bucket of the tuple fetched from the
+ * subplan or at gapfill_end. Since no subplan tuple is returned within a run,
+ * the group columns are the same for all gap tuples of the run and locf and
+ * interpolate columns can be calculated for the whole batch at once.
  */
-static TupleTableSlot *
-gapfill_state_gaptuple_create(GapFillState *state, int64 time)
+static void
+gapfill_state_fill_batch(GapFillState *state)
 {
 	TupleTableSlot *slot = state->scanslot;
 	GapFillColumnStateUnion column;
+	int ntimes = 0;
 	int i;
 
+	while (ntimes < GAPFILL_BATCH_SIZE && state->next_timestamp < state->gapfill_end &&
+		   !(FETCHED_ONE == state->state && state->subslot_time == state->next_timestamp))
+	{
+		state->batch_times[ntimes++] = state->next_timestamp;
+		gapfill_advance_timestamp(state);
+	}
+	Assert(ntimes > 0);
+
 	ExecClearTuple(slot);
 
 	/*
@@ -995,7 +1033,8 @@ gapfill_state_gaptuple_create(GapFillState *state, int64 time)
 		switch (column.base->ctype)
 		{
 			case TIME_COLUMN:
-				slot->tts_values[i] = gapfill_internal_get_datum(time, state->gapfill_typid);
+				slot->tts_values[i] =
+					gapfill_internal_get_datum(state->batch_times[0], state->gapfill_typid);
 				slot->tts_isnull[i] = false;
 				break;
 			case GROUP_COLUMN:
@@ -1022,18 +1061,54 @@ gapfill_state_gaptuple_create(GapFillState *state, int64 time)
 		switch (column.base->ctype)
 		{
 			case LOCF_COLUMN:
-				gapfill_locf_calculate(column.locf,
-									   state,
-									   time,
-									   &slot->tts_values[i],
-									   &slot->tts_isnull[i]);
+				gapfill_locf_calculate_batch(column.locf,
+											 state,
+											 state->batch_times,
+											 ntimes,
+											 column.base->batch_values,
+											 column.base->batch_isnull);
 				break;
 			case INTERPOLATE_COLUMN:
-				gapfill_interpolate_calculate(column.interpolate,
-											  state,
-											  time,
-											  &slot->tts_values[i],
-											  &slot->tts_isnull[i]);
+				gapfill_interpolate_calculate_batch(column.interpolate,
+													state,
+													state->batch_times,
+													ntimes,
+													column.base->batch_values,
+													column.base->batch_isnull);
+				break;
+			default:
+				break;
+		}
+	}
+
+	state->batch_len = ntimes;
+	state->batch_next = 0;
+}
+
+/*
+ * Create the next generated tuple of the current batch
+ */
+static TupleTableSlot *
+gapfill_state_batch_next(GapFillState *state)
+{
+	TupleTableSlot *slot = state->scanslot;
+	GapFillColumnStateUnion column;
+	int next = state->batch_next++;
+	int i;
+
+	/* group and NULL columns were filled in by gapfill_state_fill_batch */
+	foreach_column(column.base, i, state)
+	{
+		switch (column.base->ctype)
+		{
+			case TIME_COLUMN:
+				slot->tts_values[i] =
+					gapfill_internal_get_datum(state->batch_times[next], state->gapfill_typid);
+				break;
+			case LOCF_COLUMN:
+			case INTERPOLATE_COLUMN:
+				slot->tts_values[i] = column.base->batch_values[next];
+				slot->tts_isnull[i] = column.base->batch_isnull[next];
 				break;
 			default:
 				break;
@@ -8,6 +8,13 @@
 #include <postgres.h>
 #include <nodes/execnodes.h>
 
+/*
+ * Maximum number of gap tuples filled in one go. Runs of missing buckets
+ * are filled into arrays in batches of this size and then emitted from
+ * there, see gapfill_state_fill_batch.
+ */
+#define GAPFILL_BATCH_SIZE 1000
+
 /*
  * GapFillFetchState describes the state of subslot in GapFillState:
  * FETCHED_NONE: no tuple in subslot
@@ -75,6 +82,9 @@ typedef struct GapFillColumnState
 	Oid typid;
 	bool typbyval;
 	int16 typlen;
+	/* values of the current batch of gap tuples for locf and interpolate columns */
+	Datum *batch_values;
+	bool *batch_isnull;
 } GapFillColumnState;
 
 typedef struct GapFillGroupColumnState
@@ -95,6 +105,8 @@ typedef struct GapFillState
 	/* arguments of the gapfill function call */
 	List *args;
 	bool have_timezone;
+	/* value of the timezone argument */
+	Datum timezone;
 	int64 gapfill_start;
 	int64 gapfill_end;
 	/* bucket width for fixed-size buckets */
@@ -119,6 +131,11 @@ typedef struct GapFillState
 	ProjectionInfo *pi;
 	TupleTableSlot *scanslot;
 	GapFillFetchState state;
+
+	/* times of the current batch of gap tuples */
+	int64 *batch_times;
+	int batch_len;
+	int batch_next;
 } GapFillState;
 
 Node *gapfill_state_create(CustomScan *);
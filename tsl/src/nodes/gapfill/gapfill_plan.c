@@ -9,23 +9,37 @@
 #include <nodes/extensible.h>
 #include <nodes/nodeFuncs.h>
 #include <optimizer/clauses.h>
+#include <optimizer/cost.h>
 #include <optimizer/optimizer.h>
 #include <optimizer/pathnode.h>
 #include <optimizer/paths.h>
+#include <optimizer/prep.h>
 #include <optimizer/tlist.h>
 #include <parser/parse_func.h>
 #include <utils/lsyscache.h>
+#include <utils/selfuncs.h>
 
 #include "compat/compat.h"
 
+#include "dimension.h"
 #include "gapfill.h"
 #include "gapfill_internal.h"
+#include "guc.h"
+#include "hypercube.h"
+#include "planner/planner.h"
+#include "utils.h"
 
 static CustomScanMethods gapfill_plan_methods = {
 	.CustomName = "GapFill",
 	.CreateCustomScanState = gapfill_state_create,
 };
 
+void
+_gapfill_init(void)
+{
+	TryRegisterCustomScanMethods(&gapfill_plan_methods);
+}
+
 typedef struct gapfill_walker_context
 {
 	union
@@ -407,13 +421,242 @@ gapfill_path_create(PlannerInfo *root, Path *subpath, FuncExpr *func)
 	return &path->cpath.path;
 }
 
+/*
+ * Find a space dimension of the hypertable whose column is a GROUP BY
+ * column of the query, so no group spans several space partitions.
+ */
+static const Dimension *
+gapfill_get_grouped_space_dimension(PlannerInfo *root, RelOptInfo *input_rel, Hypertable *ht)
+{
+	List *group_exprs =
+		get_sortgrouplist_exprs(root->parse->groupClause, root->parse->targetList);
+	const Dimension *dim;
+
+	for (int i = 0; (dim = hyperspace_get_closed_dimension(ht->space, i)) != NULL; i++)
+	{
+		ListCell *lc;
+
+		foreach (lc, group_exprs)
+		{
+			Var *var = lfirst(lc);
+
+			if (IsA(var, Var) && (Index) var->varno == input_rel->relid && var->varlevelsup == 0 &&
+				var->varattno == dim->column_attno)
+				return dim;
+		}
+	}
+
+	return NULL;
+}
+
+typedef struct GapFillPartitionSubpath
+{
+	int64 range_start;
+	int64 range_end;
+	Path *path;
+} GapFillPartitionSubpath;
+
+static int
+gapfill_partition_subpath_cmp(const void *a, const void *b)
+{
+	const GapFillPartitionSubpath *left = a;
+	const GapFillPartitionSubpath *right = b;
+
+	if (left->range_start != right->range_start)
+		return left->range_start < right->range_start ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Group the chunk paths below an Append by the slice of the space dimension
+ * of their chunk. Slices overlap when the number of partitions was changed,
+ * so overlapping slices are merged into one partition. Returns a list with
+ * the subpaths of every partition or NIL if a subpath is not a chunk scan.
+ */
+static List *
+gapfill_group_subpaths_by_partition(PlannerInfo *root, List *subpaths, const Dimension *dim)
+{
+	GapFillPartitionSubpath *entries =
+		palloc(sizeof(GapFillPartitionSubpath) * list_length(subpaths));
+	List *partitions = NIL;
+	List *current = NIL;
+	int64 current_end = 0;
+	int nentries = 0;
+	ListCell *lc;
+
+	foreach (lc, subpaths)
+	{
+		Path *subpath = lfirst(lc);
+		const Chunk *chunk = ts_planner_chunk_fetch(root, subpath->parent);
+		const DimensionSlice *slice;
+
+		if (chunk == NULL || chunk->cube == NULL)
+			return NIL;
+
+		slice = ts_hypercube_get_slice_by_dimension_id(chunk->cube, dim->fd.id);
+		if (slice == NULL)
+			return NIL;
+
+		entries[nentries].range_start = slice->fd.range_start;
+		entries[nentries].range_end = slice->fd.range_end;
+		entries[nentries].path = subpath;
+		nentries++;
+	}
+
+	qsort(entries, nentries, sizeof(GapFillPartitionSubpath), gapfill_partition_subpath_cmp);
+
+	for (int i = 0; i < nentries; i++)
+	{
+		if (current != NIL && entries[i].range_start >= current_end)
+		{
+			partitions = lappend(partitions, current);
+			current = NIL;
+		}
+
+		if (current == NIL || entries[i].range_end > current_end)
+			current_end = entries[i].range_end;
+		current = lappend(current, entries[i].path);
+	}
+
+	if (current != NIL)
+		partitions = lappend(partitions, current);
+
+	return partitions;
+}
+
+/*
+ * Add paths running a separate aggregation and gapfill for every space
+ * partition of the hypertable.
+ *
+ * When a space partitioning column is grouped on, no group spans partitions
+ * so the gapfill of each partition only needs its own input sorted and the
+ * results can simply be appended. Since a non-partial subplan of a Parallel
+ * Append is executed by a single process, the gapfill of a partition can run
+ * in a parallel worker even though the gapfill node itself is not parallel
+ * aware.
+ */
+static void
+gapfill_add_partitioned_paths(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *group_rel,
+							  Hypertable *ht, FuncExpr *func)
+{
+	Query *parse = root->parse;
+#if PG16_LT
+	List *group_clause = parse->groupClause;
+#else
+	List *group_clause = root->processed_groupClause;
+#endif
+	AggClauseCosts agg_costs;
+	List *subpaths;
+	List *gapfill_paths = NIL;
+	double rows = 0;
+	ListCell *lc;
+
+	if (!ts_guc_enable_partitionwise_gapfill || ht == NULL || input_rel == NULL ||
+		IS_DUMMY_REL(input_rel) || parse->groupingSets || parse->hasWindowFuncs ||
+		group_clause == NIL)
+		return;
+
+	const Dimension *dim = gapfill_get_grouped_space_dimension(root, input_rel, ht);
+	if (dim == NULL)
+		return;
+
+	/* the grouping target is usually projected on top of the append */
+	Path *input_path = input_rel->cheapest_total_path;
+	PathTarget *input_target = input_path->pathtarget;
+	if (IsA(input_path, ProjectionPath))
+		input_path = castNode(ProjectionPath, input_path)->subpath;
+
+	if (IsA(input_path, AppendPath) && !input_path->parallel_aware)
+		subpaths = castNode(AppendPath, input_path)->subpaths;
+	else if (IsA(input_path, MergeAppendPath))
+		subpaths = castNode(MergeAppendPath, input_path)->subpaths;
+	else
+		return;
+
+	List *partitions = gapfill_group_subpaths_by_partition(root, subpaths, dim);
+	if (list_length(partitions) < 2)
+		return;
+
+	bool can_hash = grouping_is_hashable(group_clause);
+	if (!can_hash && !grouping_is_sortable(group_clause))
+		return;
+
+	List *group_exprs = get_sortgrouplist_exprs(group_clause, parse->targetList);
+	double total_groups = estimate_num_groups(root, group_exprs, input_path->rows, NULL, NULL);
+	bool parallel_safe =
+		group_rel->consider_parallel &&
+		is_parallel_safe(root, (Node *) root->upper_targets[UPPERREL_FINAL]->exprs);
+
+	MemSet(&agg_costs, 0, sizeof(AggClauseCosts));
+	get_agg_clause_costs(root, AGGSPLIT_SIMPLE, &agg_costs);
+
+	foreach (lc, partitions)
+	{
+		Path *path = (Path *)
+			create_append_path(root, input_rel, lfirst(lc), NIL, NIL, NULL, 0, false, -1);
+
+		/* the append outputs what the original one did, not the rel target */
+		path->pathtarget = input_path->pathtarget;
+		if (input_target != input_path->pathtarget)
+			path = (Path *) create_projection_path(root, input_rel, path, input_target);
+
+		/* groups are split between the partitions like the rows */
+		double num_groups =
+			clamp_row_est(total_groups * path->rows / Max(input_path->rows, 1.0));
+
+		if (!can_hash)
+			path = (Path *) create_sort_path(root, input_rel, path, root->group_pathkeys, -1.0);
+
+		path = (Path *) create_agg_path(root,
+										group_rel,
+										path,
+										group_rel->reltarget,
+										can_hash ? AGG_HASHED : AGG_SORTED,
+										AGGSPLIT_SIMPLE,
+										group_clause,
+										(List *) parse->havingQual,
+										&agg_costs,
+										num_groups);
+		parallel_safe = parallel_safe && path->parallel_safe;
+		path = gapfill_path_create(root, path, func);
+		path->parallel_safe = parallel_safe;
+
+		rows += path->rows;
+		gapfill_paths = lappend(gapfill_paths, path);
+	}
+
+	PathTarget *target = ((Path *) linitial(gapfill_paths))->pathtarget;
+	AppendPath *append =
+		create_append_path(root, group_rel, gapfill_paths, NIL, NIL, NULL, 0, false, -1);
+	append->path.pathtarget = target;
+	add_path(group_rel, &append->path);
+
+	if (parallel_safe && max_parallel_workers_per_gather > 0)
+	{
+		int workers = Min(list_length(gapfill_paths), max_parallel_workers_per_gather);
+
+		append = create_append_path(root,
+									group_rel,
+									gapfill_paths,
+									NIL,
+									NIL,
+									NULL,
+									workers,
+									true,
+									-1);
+		append->path.pathtarget = target;
+		add_path(group_rel,
+				 (Path *) create_gather_path(root, group_rel, &append->path, target, NULL, &rows));
+	}
+}
+
 /*
  * Prepend GapFill node to every group_rel path.
  * The implementation assumes that TimescaleDB planning hook is called only once
  * per grouping.
  */
 void
-plan_add_gapfill(PlannerInfo *root, RelOptInfo *group_rel)
+plan_add_gapfill(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *group_rel, Hypertable *ht)
 {
 	ListCell *lc;
 	Query *parse = root->parse;
@@ -458,6 +701,8 @@ plan_add_gapfill(PlannerInfo *root, RelOptInfo *group_rel)
 			add_path(group_rel, gapfill_path_create(root, lfirst(lc), context.call.func));
 		}
 		list_free(copy);
+
+		gapfill_add_partitioned_paths(root, input_rel, group_rel, ht, context.call.func);
 	}
 }
 
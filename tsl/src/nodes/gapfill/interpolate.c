@@ -266,3 +266,65 @@ gapfill_interpolate_calculate(GapFillInterpolateColumnState *column, GapFillStat
 			break;
 	}
 }
+
+/*
+ * gapfill_interpolate_calculate_batch gets called for a run of gapfilled tuples
+ *
+ * The samples before and after the run are the same for all tuples of the
+ * run so the float types are interpolated in a tight loop. Integer types go
+ * through numeric for every tuple like in gapfill_interpolate_calculate.
+ */
+void
+gapfill_interpolate_calculate_batch(GapFillInterpolateColumnState *column, GapFillState *state,
+									const int64 *times, int ntimes, Datum *values, bool *isnull)
+{
+	Assert(ntimes > 0);
+
+	/* the first tuple does the out of boundary lookups if necessary */
+	gapfill_interpolate_calculate(column, state, times[0], &values[0], &isnull[0]);
+
+	if (isnull[0])
+	{
+		/* the lookups are only done for the first tuple so the whole run is NULL */
+		for (int i = 1; i < ntimes; i++)
+			isnull[i] = true;
+		return;
+	}
+
+	int64 x0 = column->prev.time;
+	int64 x1 = column->next.time;
+
+	switch (column->base.typid)
+	{
+		case FLOAT4OID:
+		{
+			float4 y0 = DatumGetFloat4(column->prev.value);
+			float4 y1 = DatumGetFloat4(column->next.value);
+
+			for (int i = 1; i < ntimes; i++)
+			{
+				values[i] = y0 == y1 ? Float4GetDatum(y0) :
+									   Float4GetDatum(INTERPOLATE(times[i], x0, x1, y0, y1));
+				isnull[i] = false;
+			}
+			break;
+		}
+		case FLOAT8OID:
+		{
+			float8 y0 = DatumGetFloat8(column->prev.value);
+			float8 y1 = DatumGetFloat8(column->next.value);
+
+			for (int i = 1; i < ntimes; i++)
+			{
+				values[i] = y0 == y1 ? Float8GetDatum(y0) :
+									   Float8GetDatum(INTERPOLATE(times[i], x0, x1, y0, y1));
+				isnull[i] = false;
+			}
+			break;
+		}
+		default:
+			for (int i = 1; i < ntimes; i++)
+				gapfill_interpolate_calculate(column, state, times[i], &values[i], &isnull[i]);
+			break;
+	}
+}
@@ -29,3 +29,5 @@ void gapfill_interpolate_tuple_fetched(GapFillInterpolateColumnState *, int64, D
 void gapfill_interpolate_tuple_returned(GapFillInterpolateColumnState *, int64, Datum, bool);
 void gapfill_interpolate_calculate(GapFillInterpolateColumnState *, GapFillState *, int64, Datum *,
 								   bool *);
+void gapfill_interpolate_calculate_batch(GapFillInterpolateColumnState *, GapFillState *,
+										 const int64 *, int, Datum *, bool *);
@@ -71,3 +71,24 @@ gapfill_locf_calculate(GapFillLocfColumnState *locf, GapFillState *state, int64
 	*value = locf->value;
 	*isnull = locf->isnull;
 }
+
+/*
+ * gapfill_locf_calculate_batch gets called for a run of gapfilled tuples
+ *
+ * All tuples of the run get the same value since no subplan tuple is
+ * returned in between.
+ */
+void
+gapfill_locf_calculate_batch(GapFillLocfColumnState *locf, GapFillState *state, const int64 *times,
+							 int ntimes, Datum *values, bool *isnull)
+{
+	Assert(ntimes > 0);
+
+	gapfill_locf_calculate(locf, state, times[0], &values[0], &isnull[0]);
+
+	for (int i = 1; i < ntimes; i++)
+	{
+		values[i] = values[0];
+		isnull[i] = isnull[0];
+	}
+}
@@ -22,3 +22,5 @@ void gapfill_locf_initialize(GapFillLocfColumnState *, GapFillState *, FuncExpr
 void gapfill_locf_group_change(GapFillLocfColumnState *);
 void gapfill_locf_tuple_returned(GapFillLocfColumnState *, Datum, bool);
 void gapfill_locf_calculate(GapFillLocfColumnState *, GapFillState *, int64, Datum *, bool *);
+void gapfill_locf_calculate_batch(GapFillLocfColumnState *, GapFillState *, const int64 *, int,
+								  Datum *, bool *);
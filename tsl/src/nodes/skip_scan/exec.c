@@ -38,15 +38,31 @@
  *                    |   DONE    |
  *                    \===========/
  *
+ * For DISTINCT over several columns, which are all known to be NOT NULL, we
+ * skip over the values of each prefix of the distinct columns in turn. After
+ * returning a tuple with values (a, b, c) we look for
+ *     WHERE col_a = a AND col_b = b AND col_c > c
+ * and when no such tuple exists anymore we drop the last column and look for
+ *     WHERE col_a = a AND col_b > b
+ * and so on. Whenever a tuple is found it is returned and the search starts
+ * again with all columns. The scan is done when no tuple satisfies
+ *     WHERE col_a > a
+ *
+ * On compressed chunks the SkipScan runs on top of a DecompressChunk node
+ * and the skip quals are applied to the index scan on the segmentby columns
+ * of the compressed chunk. Every rescan drops the batches decompressed so far,
+ * so only the first batch of each segment gets decompressed.
  */
 
 #include <postgres.h>
 #include <access/genam.h>
+#include <access/stratnum.h>
 #include <nodes/extensible.h>
 #include <nodes/pg_list.h>
 #include <utils/datum.h>
 
 #include "guc.h"
+#include "nodes/decompress_chunk/exec.h"
 #include "nodes/skip_scan/skip_scan.h"
 
 typedef enum SkipScanStage
@@ -59,28 +75,48 @@ typedef enum SkipScanStage
 	SS_END,
 } SkipScanStage;
 
+/* State of one of the distinct columns */
+typedef struct SkipScanKeyState
+{
+	/* Pointer into the ScanKeys of the Index(Only)Scan */
+	ScanKey skip_key;
+
+	/* Strategy and comparison function of the skip qual as planned */
+	StrategyNumber skip_strategy;
+	FmgrInfo skip_func;
+	/* Equality function to stay on the value of the column */
+	FmgrInfo eq_func;
+
+	Datum prev_datum;
+	bool prev_is_null;
+
+	/* Info about the type we are performing DISTINCT on */
+	bool distinct_by_val;
+	int distinct_col_attnum;
+	int distinct_typ_len;
+	int sk_attno;
+} SkipScanKeyState;
+
 typedef struct SkipScanState
 {
 	CustomScanState cscan_state;
 	IndexScanDesc *scan_desc;
 	MemoryContext ctx;
 
-	/* Interior Index(Only)Scan the SkipScan runs over */
+	/* Interior Index(Only)Scan the SkipScan runs over, or DecompressChunk on top of it */
 	ScanState *idx;
+	/* Set when skipping over the compressed index scan of a DecompressChunk */
+	DecompressChunkState *decompress_state;
 
 	/* Pointers into the Index(Only)Scan */
 	int *num_scan_keys;
 	ScanKey *scan_keys;
-	ScanKey skip_key;
-
-	Datum prev_datum;
-	bool prev_is_null;
 
-	/* Info about the type we are performing DISTINCT on */
-	bool distinct_by_val;
-	int distinct_col_attnum;
-	int distinct_typ_len;
-	int sk_attno;
+	/* The distinct columns ordered by their position in the index */
+	int num_skip_keys;
+	SkipScanKeyState *skip_keys;
+	/* Index of the column we are currently skipping over */
+	int skip_level;
 
 	SkipScanStage stage;
 
@@ -105,16 +141,24 @@ skip_scan_begin(CustomScanState *node, EState *estate, int eflags)
 	state->idx = (ScanState *) ExecInitNode(state->idx_scan, estate, eflags);
 	node->custom_ps = list_make1(state->idx);
 
-	if (IsA(state->idx_scan, IndexScan))
+	PlanState *scan_state = &state->idx->ps;
+	if (IsA(state->idx_scan, CustomScan))
 	{
-		IndexScanState *idx = castNode(IndexScanState, state->idx);
+		/* DecompressChunk is the only custom node we plan SkipScan on */
+		state->decompress_state = (DecompressChunkState *) state->idx;
+		scan_state = linitial(state->decompress_state->csstate.custom_ps);
+	}
+
+	if (IsA(scan_state, IndexScanState))
+	{
+		IndexScanState *idx = castNode(IndexScanState, scan_state);
 		state->scan_keys = &idx->iss_ScanKeys;
 		state->num_scan_keys = &idx->iss_NumScanKeys;
 		state->scan_desc = &idx->iss_ScanDesc;
 	}
-	else if (IsA(state->idx_scan, IndexOnlyScan))
+	else if (IsA(scan_state, IndexOnlyScanState))
 	{
-		IndexOnlyScanState *idx = castNode(IndexOnlyScanState, state->idx);
+		IndexOnlyScanState *idx = castNode(IndexOnlyScanState, scan_state);
 		state->scan_keys = &idx->ioss_ScanKeys;
 		state->num_scan_keys = &idx->ioss_NumScanKeys;
 		state->scan_desc = &idx->ioss_ScanDesc;
@@ -126,32 +170,44 @@ skip_scan_begin(CustomScanState *node, EState *estate, int eflags)
 	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
 		return;
 
-	/* find position of our skip key
+	/* find position of our skip keys
 	 * skip key is put as first key for the respective column in sort_indexquals
 	 */
 	ScanKey data = *state->scan_keys;
-	for (int i = 0; i < *state->num_scan_keys; i++)
+	for (int k = 0; k < state->num_skip_keys; k++)
 	{
-		if (data[i].sk_flags == SK_ISNULL && data[i].sk_attno == state->sk_attno)
+		SkipScanKeyState *key = &state->skip_keys[k];
+
+		for (int i = 0; i < *state->num_scan_keys; i++)
 		{
-			state->skip_key = &data[i];
-			break;
+			if (data[i].sk_flags == SK_ISNULL && data[i].sk_attno == key->sk_attno)
+			{
+				key->skip_key = &data[i];
+				break;
+			}
 		}
+		if (!key->skip_key)
+			elog(ERROR, "ScanKey for skip qual not found");
+
+		key->skip_strategy = key->skip_key->sk_strategy;
+		fmgr_info_copy(&key->skip_func, &key->skip_key->sk_func, CurrentMemoryContext);
 	}
-	if (!state->skip_key)
-		elog(ERROR, "ScanKey for skip qual not found");
 }
 
+/*
+ * NULLs are only searched for with a single distinct column, with several
+ * columns they are all known to be NOT NULL
+ */
 static bool
 has_nulls_first(SkipScanState *state)
 {
-	return state->nulls_first;
+	return state->num_skip_keys == 1 && state->nulls_first;
 }
 
 static bool
 has_nulls_last(SkipScanState *state)
 {
-	return !has_nulls_first(state);
+	return state->num_skip_keys == 1 && !state->nulls_first;
 }
 
 static void
@@ -164,14 +220,62 @@ skip_scan_rescan_index(SkipScanState *state)
 	 * has not been initialized it will pick up
 	 * any ScanKey changes we did */
 	if (*state->scan_desc)
+	{
+		/* drop the batches of the segment we are skipping over */
+		if (state->decompress_state)
+		{
+			BatchQueue *bq = state->decompress_state->batch_queue;
+			bq->funcs->reset(bq);
+		}
+
 		index_rescan(*state->scan_desc,
 					 *state->scan_keys,
 					 *state->num_scan_keys,
 					 NULL /*orderbys*/,
 					 0 /*norderbys*/);
+	}
 	state->needs_rescan = false;
 }
 
+static void
+skip_scan_key_set_not_null(SkipScanKeyState *key)
+{
+	key->skip_key->sk_flags = SK_ISNULL | SK_SEARCHNOTNULL;
+	key->skip_key->sk_argument = 0;
+}
+
+/*
+ * Set the ScanKey of a column to look for values after the previous value,
+ * or for the previous value itself.
+ */
+static void
+skip_scan_key_set_prev(SkipScanKeyState *key, bool equal)
+{
+	ScanKey skip_key = key->skip_key;
+
+	if (equal)
+	{
+		skip_key->sk_strategy = BTEqualStrategyNumber;
+		fmgr_info_copy(&skip_key->sk_func, &key->eq_func, CurrentMemoryContext);
+	}
+	else
+	{
+		skip_key->sk_strategy = key->skip_strategy;
+		fmgr_info_copy(&skip_key->sk_func, &key->skip_func, CurrentMemoryContext);
+	}
+
+	if (key->prev_is_null)
+	{
+		skip_key->sk_flags = SK_ISNULL;
+		skip_key->sk_argument = 0;
+	}
+	else
+	{
+		skip_key->sk_flags = 0;
+		skip_key->sk_argument = key->prev_datum;
+	}
+}
+
 /*
  * Update skip scankey flags according to stage
  */
@@ -183,20 +287,22 @@ skip_scan_switch_stage(SkipScanState *state, SkipScanStage new_stage)
 	switch (new_stage)
 	{
 		case SS_NOT_NULL:
-			state->skip_key->sk_flags = SK_ISNULL | SK_SEARCHNOTNULL;
-			state->skip_key->sk_argument = 0;
+			for (int k = 0; k < state->num_skip_keys; k++)
+				skip_scan_key_set_not_null(&state->skip_keys[k]);
 			state->needs_rescan = true;
 			break;
 
 		case SS_VALUES:
-			state->skip_key->sk_flags = 0;
+			/* the ScanKeys get set up by skip_scan_update_key */
 			state->needs_rescan = true;
 			break;
 
 		case SS_NULLS_LAST:
 		case SS_NULLS_FIRST:
-			state->skip_key->sk_flags = SK_ISNULL | SK_SEARCHNULL;
-			state->skip_key->sk_argument = 0;
+			/* NULLs are only searched for with a single distinct column */
+			Assert(state->num_skip_keys == 1);
+			state->skip_keys[0].skip_key->sk_flags = SK_ISNULL | SK_SEARCHNULL;
+			state->skip_keys[0].skip_key->sk_argument = 0;
 			state->needs_rescan = true;
 			break;
 
@@ -208,28 +314,33 @@ skip_scan_switch_stage(SkipScanState *state, SkipScanStage new_stage)
 	state->stage = new_stage;
 }
 
+/*
+ * Remember the values of the distinct columns of the tuple we are returning
+ * and look for the next tuple where any of them differs.
+ */
 static void
 skip_scan_update_key(SkipScanState *state, TupleTableSlot *slot)
 {
-	if (!state->prev_is_null && !state->distinct_by_val)
-	{
-		Assert(state->stage == SS_VALUES);
-		pfree(DatumGetPointer(state->prev_datum));
-	}
-
 	MemoryContext old_ctx = MemoryContextSwitchTo(state->ctx);
-	state->prev_datum = slot_getattr(slot, state->distinct_col_attnum, &state->prev_is_null);
-	if (state->prev_is_null)
-	{
-		state->skip_key->sk_flags = SK_ISNULL;
-		state->skip_key->sk_argument = 0;
-	}
-	else
+
+	for (int k = 0; k < state->num_skip_keys; k++)
 	{
-		state->prev_datum =
-			datumCopy(state->prev_datum, state->distinct_by_val, state->distinct_typ_len);
-		state->skip_key->sk_argument = state->prev_datum;
+		SkipScanKeyState *key = &state->skip_keys[k];
+
+		if (!key->prev_is_null && !key->distinct_by_val)
+		{
+			Assert(state->stage == SS_VALUES);
+			pfree(DatumGetPointer(key->prev_datum));
+		}
+
+		key->prev_datum = slot_getattr(slot, key->distinct_col_attnum, &key->prev_is_null);
+		if (!key->prev_is_null)
+			key->prev_datum = datumCopy(key->prev_datum, key->distinct_by_val, key->distinct_typ_len);
+
+		/* stay on the values of all but the last column and skip over the last one */
+		skip_scan_key_set_prev(key, k < state->num_skip_keys - 1);
 	}
+	state->skip_level = state->num_skip_keys - 1;
 
 	MemoryContextSwitchTo(old_ctx);
 
@@ -237,6 +348,26 @@ skip_scan_update_key(SkipScanState *state, TupleTableSlot *slot)
 	state->needs_rescan = true;
 }
 
+/*
+ * Move on to skipping over a shorter prefix of the distinct columns, once
+ * there are no more values for the current one. Returns false if there is no
+ * shorter prefix left.
+ */
+static bool
+skip_scan_prev_level(SkipScanState *state)
+{
+	if (state->skip_level == 0)
+		return false;
+
+	/* the columns after the new level can take any value */
+	skip_scan_key_set_not_null(&state->skip_keys[state->skip_level]);
+	state->skip_level--;
+	skip_scan_key_set_prev(&state->skip_keys[state->skip_level], false);
+
+	state->needs_rescan = true;
+	return true;
+}
+
 static TupleTableSlot *
 skip_scan_exec(CustomScanState *node)
 {
@@ -300,6 +431,13 @@ skip_scan_exec(CustomScanState *node)
 				}
 				else
 				{
+					/*
+					 * with several distinct columns there might be more
+					 * values for a shorter prefix of the columns
+					 */
+					if (state->stage == SS_VALUES && skip_scan_prev_level(state))
+						break;
+
 					/*
 					 * if there are no more values that satisfy
 					 * the skip constraint we are either done
@@ -348,8 +486,12 @@ skip_scan_rescan(CustomScanState *node)
 	else
 		skip_scan_switch_stage(state, SS_NOT_NULL);
 
-	state->prev_is_null = true;
-	state->prev_datum = 0;
+	for (int k = 0; k < state->num_skip_keys; k++)
+	{
+		state->skip_keys[k].prev_is_null = true;
+		state->skip_keys[k].prev_datum = 0;
+	}
+	state->skip_level = 0;
 
 	state->needs_rescan = false;
 	ExecReScan(&state->idx->ps);
@@ -369,16 +511,33 @@ tsl_skip_scan_state_create(CustomScan *cscan)
 {
 	SkipScanState *state = (SkipScanState *) newNode(sizeof(SkipScanState), T_CustomScanState);
 
+	List *keys = linitial(cscan->custom_private);
+	List *eq_opfuncs = lsecond(cscan->custom_private);
+
 	state->idx_scan = linitial(cscan->custom_plans);
 	state->stage = SS_BEGIN;
 
-	state->distinct_col_attnum = linitial_int(cscan->custom_private);
-	state->distinct_by_val = lsecond_int(cscan->custom_private);
-	state->distinct_typ_len = lthird_int(cscan->custom_private);
-	state->nulls_first = lfourth_int(cscan->custom_private);
-	state->sk_attno = list_nth_int(cscan->custom_private, 4);
+	state->num_skip_keys = list_length(keys);
+	state->skip_keys = palloc0(sizeof(SkipScanKeyState) * state->num_skip_keys);
+
+	for (int k = 0; k < state->num_skip_keys; k++)
+	{
+		SkipScanKeyState *key = &state->skip_keys[k];
+		List *key_info = list_nth(keys, k);
+		Oid eq_opfuncid = list_nth_oid(eq_opfuncs, k);
+
+		key->distinct_col_attnum = linitial_int(key_info);
+		key->distinct_by_val = lsecond_int(key_info);
+		key->distinct_typ_len = lthird_int(key_info);
+		key->sk_attno = list_nth_int(key_info, 4);
+		key->prev_is_null = true;
+
+		if (OidIsValid(eq_opfuncid))
+			fmgr_info(eq_opfuncid, &key->eq_func);
+	}
+
+	state->nulls_first = lfourth_int(linitial(keys));
 
-	state->prev_is_null = true;
 	state->cscan_state.methods = &skip_scan_state_methods;
 	return (Node *) state;
 }
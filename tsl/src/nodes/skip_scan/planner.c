@@ -6,6 +6,7 @@
 
 #include <postgres.h>
 #include <access/sysattr.h>
+#include <catalog/pg_aggregate.h>
 #include <nodes/extensible.h>
 #include <nodes/makefuncs.h>
 #include <nodes/nodeFuncs.h>
@@ -16,11 +17,14 @@
 #include <optimizer/pathnode.h>
 #include <optimizer/paths.h>
 #include <optimizer/planmain.h>
+#include <optimizer/prep.h>
 #include <optimizer/restrictinfo.h>
 #include <optimizer/tlist.h>
 #include <parser/parse_coerce.h>
 #include <parser/parsetree.h>
 #include <rewrite/rewriteManip.h>
+#include <utils/lsyscache.h>
+#include <utils/selfuncs.h>
 #include <utils/syscache.h>
 #include <utils/typcache.h>
 
@@ -28,19 +32,21 @@
 #include "guc.h"
 #include "nodes/chunk_append/chunk_append.h"
 #include "nodes/constraint_aware_append/constraint_aware_append.h"
+#include "nodes/decompress_chunk/decompress_chunk.h"
 #include "nodes/skip_scan/skip_scan.h"
+#include "planner/planner.h"
 #include <import/planner.h>
 
 #include <math.h>
 
-typedef struct SkipScanPath
+/* A distinct column the SkipScan skips over */
+typedef struct SkipKeyInfo
 {
-	CustomPath cpath;
-	IndexPath *index_path;
-
 	/* Index clause which we'll use to skip past elements we've already seen */
 	RestrictInfo *skip_clause;
-	/* attribute number of the distinct column on the table/chunk */
+	/* Equality operator function used to stay on the values of a prefix */
+	Oid eq_opfuncid;
+	/* attribute number of the distinct column on the indexed relation */
 	AttrNumber distinct_attno;
 	/* The column offset on the index we are calling DISTINCT on */
 	AttrNumber scankey_attno;
@@ -48,16 +54,52 @@ typedef struct SkipScanPath
 	bool distinct_by_val;
 	/* Var referencing the distinct column on the relation */
 	Var *distinct_var;
+} SkipKeyInfo;
+
+typedef struct SkipScanPath
+{
+	CustomPath cpath;
+	IndexPath *index_path;
+	/* DecompressChunk on top of index_path when skipping over a compressed chunk */
+	DecompressChunkPath *decompress_path;
+
+	/* The distinct columns ordered by their position in the index */
+	List *skip_keys;
 } SkipScanPath;
 
+/* What a SkipScan has to skip over for a query */
+typedef struct SkipScanSpec
+{
+	/* Expressions referencing the queried relation we skip over the values of */
+	List *distinct_exprs;
+
+	/*
+	 * Column the first tuple returned for each distinct value has to have the
+	 * smallest or largest value of, according to bookend_sortop. Used for
+	 * MIN/MAX and FIRST/LAST aggregates per group.
+	 */
+	Var *bookend_var;
+	Oid bookend_sortop;
+} SkipScanSpec;
+
 static int get_idx_key(IndexOptInfo *idxinfo, AttrNumber attno);
 static List *sort_indexquals(IndexOptInfo *indexinfo, List *quals);
 static OpExpr *fix_indexqual(IndexOptInfo *index, RestrictInfo *rinfo, AttrNumber scankey_attno);
-static bool build_skip_qual(PlannerInfo *root, SkipScanPath *skip_scan_path, IndexPath *index_path,
-							Var *var);
-static List *build_subpath(PlannerInfo *root, List *subpaths, double ndistinct);
-static Var *get_distinct_var(PlannerInfo *root, IndexPath *index_path,
-							 SkipScanPath *skip_scan_path);
+static SkipKeyInfo *build_skip_qual(PlannerInfo *root, IndexPath *index_path, Var *var);
+static List *build_subpath(PlannerInfo *root, List *subpaths, SkipScanSpec *spec,
+						   double ndistinct);
+static Path *build_skip_scan_subpath(PlannerInfo *root, Path *subpath, SkipScanSpec *spec,
+									 double ndistinct);
+static List *get_distinct_exprs(PlannerInfo *root, List *clauses);
+static List *get_distinct_vars(PlannerInfo *root, RelOptInfo *rel, List *exprs);
+static Var *get_distinct_var(PlannerInfo *root, RelOptInfo *rel, Var *var);
+static IndexPath *get_compressed_index_path(DecompressChunkPath *decompress_path);
+static Var *get_compressed_var(CompressionInfo *info, Var *var);
+static int skip_key_cmp_scankey_attno(const ListCell *a, const ListCell *b);
+static bool var_is_not_null(PlannerInfo *root, RelOptInfo *rel, Var *var);
+static bool index_has_bookend_order(PlannerInfo *root, IndexPath *index_path, SkipScanSpec *spec,
+									AttrNumber scankey_attno);
+static bool build_agg_spec(PlannerInfo *root, RelOptInfo *output_rel, SkipScanSpec *spec);
 static TargetEntry *tlist_member_match_var(Var *var, List *targetlist);
 
 /**************************
@@ -82,29 +124,59 @@ skip_scan_plan_create(PlannerInfo *root, RelOptInfo *relopt, CustomPath *best_pa
 	SkipScanPath *path = (SkipScanPath *) best_path;
 	CustomScan *skip_plan = makeNode(CustomScan);
 	IndexPath *index_path = path->index_path;
+	List *skip_quals = NIL;
+	List *keys = NIL;
+	List *eq_opfuncs = NIL;
+	ListCell *lc;
 
-	OpExpr *op = fix_indexqual(index_path->indexinfo, path->skip_clause, path->scankey_attno);
+	foreach (lc, path->skip_keys)
+	{
+		SkipKeyInfo *key = lfirst(lc);
+		skip_quals = lappend(skip_quals,
+							 fix_indexqual(index_path->indexinfo,
+										   key->skip_clause,
+										   key->scankey_attno));
+	}
 
 	Plan *plan = linitial(custom_plans);
-	if (IsA(plan, IndexScan))
+	Plan *scan_plan = plan;
+
+	/*
+	 * When skipping over a compressed chunk the skip quals go to the index
+	 * scan on the compressed chunk below the DecompressChunk node.
+	 */
+	if (path->decompress_path)
+	{
+		CustomScan *decompress_plan = castNode(CustomScan, plan);
+		skip_plan->scan = decompress_plan->scan;
+		scan_plan = linitial(decompress_plan->custom_plans);
+	}
+
+	if (IsA(scan_plan, IndexScan))
 	{
-		IndexScan *idx_plan = castNode(IndexScan, plan);
-		skip_plan->scan = idx_plan->scan;
+		IndexScan *idx_plan = castNode(IndexScan, scan_plan);
+		if (!path->decompress_path)
+			skip_plan->scan = idx_plan->scan;
 
-		/* we prepend skip qual here so sort_indexquals will put it as first qual for that column */
-		idx_plan->indexqual =
-			sort_indexquals(index_path->indexinfo, lcons(op, idx_plan->indexqual));
+		/* we prepend skip quals here so sort_indexquals will put them as first qual for their
+		 * column */
+		idx_plan->indexqual = sort_indexquals(index_path->indexinfo,
+											  list_concat(skip_quals, idx_plan->indexqual));
 	}
-	else if (IsA(plan, IndexOnlyScan))
+	else if (IsA(scan_plan, IndexOnlyScan))
 	{
-		IndexOnlyScan *idx_plan = castNode(IndexOnlyScan, plan);
-		skip_plan->scan = idx_plan->scan;
-		/* we prepend skip qual here so sort_indexquals will put it as first qual for that column */
-		idx_plan->indexqual =
-			sort_indexquals(index_path->indexinfo, lcons(op, idx_plan->indexqual));
+		IndexOnlyScan *idx_plan = castNode(IndexOnlyScan, scan_plan);
+		if (!path->decompress_path)
+			skip_plan->scan = idx_plan->scan;
+		/* we prepend skip quals here so sort_indexquals will put them as first qual for their
+		 * column */
+		idx_plan->indexqual = sort_indexquals(index_path->indexinfo,
+											  list_concat(skip_quals, idx_plan->indexqual));
 	}
 	else
-		elog(ERROR, "unsupported subplan type for SkipScan: %s", ts_get_node_name((Node *) plan));
+		elog(ERROR,
+			 "unsupported subplan type for SkipScan: %s",
+			 ts_get_node_name((Node *) scan_plan));
 
 	skip_plan->scan.plan.targetlist = tlist;
 	skip_plan->custom_scan_tlist = list_copy(tlist);
@@ -112,18 +184,28 @@ skip_scan_plan_create(PlannerInfo *root, RelOptInfo *relopt, CustomPath *best_pa
 	skip_plan->scan.plan.type = T_CustomScan;
 	skip_plan->methods = &skip_scan_plan_methods;
 	skip_plan->custom_plans = custom_plans;
-	/* get position of skipped column in tuples produced by child scan */
-	TargetEntry *tle = tlist_member_match_var(path->distinct_var, plan->targetlist);
 
-	bool nulls_first = index_path->indexinfo->nulls_first[path->scankey_attno - 1];
-	if (index_path->indexscandir == BackwardScanDirection)
-		nulls_first = !nulls_first;
+	foreach (lc, path->skip_keys)
+	{
+		SkipKeyInfo *key = lfirst(lc);
+
+		/* get position of skipped column in tuples produced by child scan */
+		TargetEntry *tle = tlist_member_match_var(key->distinct_var, plan->targetlist);
+
+		bool nulls_first = index_path->indexinfo->nulls_first[key->scankey_attno - 1];
+		if (index_path->indexscandir == BackwardScanDirection)
+			nulls_first = !nulls_first;
+
+		keys = lappend(keys,
+					   list_make5_int(tle->resno,
+									  key->distinct_by_val,
+									  key->distinct_typ_len,
+									  nulls_first,
+									  key->scankey_attno));
+		eq_opfuncs = lappend_oid(eq_opfuncs, key->eq_opfuncid);
+	}
 
-	skip_plan->custom_private = list_make5_int(tle->resno,
-											   path->distinct_by_val,
-											   path->distinct_typ_len,
-											   nulls_first,
-											   path->scankey_attno);
+	skip_plan->custom_private = list_make2(keys, eq_opfuncs);
 	return &skip_plan->scan.plan;
 }
 
@@ -135,7 +217,10 @@ static CustomPathMethods skip_scan_path_methods = {
 	.PlanCustomPath = skip_scan_plan_create,
 };
 
-static SkipScanPath *skip_scan_path_create(PlannerInfo *root, IndexPath *index_path,
+static SkipScanPath *skip_scan_child_path_create(PlannerInfo *root, Path *child_path,
+													 SkipScanSpec *spec, double ndistinct);
+static bool index_covers_rel(RelOptInfo *rel, IndexOptInfo *index);
+static SkipScanPath *skip_scan_path_create(PlannerInfo *root, Path *child_path, SkipScanSpec *spec,
 										   double ndistinct);
 
 /*
@@ -168,6 +253,16 @@ static SkipScanPath *skip_scan_path_create(PlannerInfo *root, IndexPath *index_p
  *                ->  Index Scan using _hyper_2_1_chunk_idx on _hyper_2_1_chunk
  *          ->  Custom Scan (SkipScan) on _hyper_2_2_chunk
  *                ->  Index Scan using _hyper_2_2_chunk_idx on _hyper_2_2_chunk
+ *
+ * For compressed chunks with the distinct columns as segmentby columns the
+ * SkipScan is put on top of the DecompressChunk node and skips over the
+ * segments of the index scan on the compressed chunk, so only the first batch
+ * of every segment gets decompressed:
+ *
+ *  Unique
+ *    ->  Custom Scan (SkipScan) on _hyper_2_1_chunk
+ *          ->  Custom Scan (DecompressChunk) on _hyper_2_1_chunk
+ *                ->  Index Scan using compress_hyper_3_2_chunk_idx on compress_hyper_3_2_chunk
  */
 void
 tsl_skip_scan_paths_add(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *output_rel)
@@ -189,17 +284,6 @@ tsl_skip_scan_paths_add(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *ou
 		if (IsA(lfirst(lc), UpperUniquePath))
 		{
 			unique = lfirst_node(UpperUniquePath, lc);
-
-			/* currently we do not handle DISTINCT on more than one key. To do so,
-			 * we would need to break down the SkipScan into subproblems: first
-			 * find the minimal tuple then for each prefix find all unique suffix
-			 * tuples. For instance, if we are searching over (int, int), we would
-			 * first find (0, 0) then find (0, N) for all N in the domain, then
-			 * find (1, N), then (2, N), etc
-			 */
-			if (unique->numkeys > 1)
-				return;
-
 			break;
 		}
 	}
@@ -219,10 +303,13 @@ tsl_skip_scan_paths_add(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *ou
 	unique = makeNode(UpperUniquePath);
 	memcpy(unique, lfirst_node(UpperUniquePath, lc), sizeof(UpperUniquePath));
 
+	SkipScanSpec spec = {
+		.distinct_exprs = get_distinct_exprs(root, root->parse->distinctClause),
+	};
+
 	foreach (lc, input_rel->pathlist)
 	{
 		bool project = false;
-		bool has_caa = false;
 
 		Path *subpath = lfirst(lc);
 
@@ -240,88 +327,291 @@ tsl_skip_scan_paths_add(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *ou
 			project = true;
 		}
 
-		/* Path might be wrapped in a ConstraintAwareAppendPath if this
-		 * is a MergeAppend that could benefit from runtime exclusion.
-		 * We treat this similar to ProjectionPath and add it back
-		 * later
-		 */
-		if (ts_is_constraint_aware_append_path(subpath))
+		subpath = build_skip_scan_subpath(root, subpath, &spec, unique->path.rows);
+		if (!subpath)
+			continue;
+
+		Path *new_unique = (Path *)
+			create_upper_unique_path(root, output_rel, subpath, unique->numkeys, unique->path.rows);
+		new_unique->pathtarget = unique->path.pathtarget;
+
+		if (project)
+			new_unique = (Path *) create_projection_path(root,
+														 output_rel,
+														 new_unique,
+														 copy_pathtarget(new_unique->pathtarget));
+
+		add_path(output_rel, new_unique);
+	}
+}
+
+/*
+ * Create SkipScan paths for grouped aggregation when the aggregates don't
+ * need to see more than the first tuple of each group, e.g.
+ *
+ *  SELECT count(DISTINCT dev) FROM skip_scan;
+ *  SELECT dev, max(time), last(val, time) FROM skip_scan GROUP BY dev;
+ *
+ * The SkipScan returns one tuple per distinct value of the grouping columns,
+ * or of the argument of the DISTINCT aggregates, to the Agg node:
+ *
+ *  GroupAggregate
+ *    Group Key: dev
+ *    ->  Custom Scan (SkipScan) on skip_scan
+ *          ->  Index Scan Backward using skip_scan_dev_time_idx on skip_scan
+ *
+ * For MIN/MAX and FIRST/LAST aggregates the index has to order the tuples of
+ * each group so the first one has the smallest or largest value respectively.
+ */
+void
+tsl_skip_scan_agg_paths_add(PlannerInfo *root, RelOptInfo *input_rel, RelOptInfo *output_rel)
+{
+	Query *parse = root->parse;
+	SkipScanSpec spec = { 0 };
+	AggClauseCosts agg_costs;
+	ListCell *lc;
+
+	if (!ts_guc_enable_skip_scan || input_rel == NULL || IS_DUMMY_REL(input_rel))
+		return;
+
+	if (parse->groupingSets || root->group_pathkeys == NIL)
+		return;
+
+	if (!build_agg_spec(root, output_rel, &spec))
+		return;
+
+	double ndistinct = estimate_num_groups(root, spec.distinct_exprs, input_rel->rows, NULL, NULL);
+
+	MemSet(&agg_costs, 0, sizeof(AggClauseCosts));
+	get_agg_clause_costs(root, AGGSPLIT_SIMPLE, &agg_costs);
+
+	foreach (lc, input_rel->pathlist)
+	{
+		Path *subpath = lfirst(lc);
+		ProjectionPath *proj = NULL;
+
+		if (!pathkeys_contained_in(root->group_pathkeys, subpath->pathkeys))
+			continue;
+
+		/* Strip off a ProjectionPath and put it back on top of the SkipScan */
+		if (IsA(subpath, ProjectionPath))
 		{
-			subpath = linitial(castNode(CustomPath, subpath)->custom_paths);
-			Assert(IsA(subpath, MergeAppendPath));
-			has_caa = true;
+			proj = castNode(ProjectionPath, subpath);
+			subpath = proj->subpath;
 		}
 
-		if (IsA(subpath, IndexPath))
-		{
-			IndexPath *index_path = castNode(IndexPath, subpath);
+		subpath = build_skip_scan_subpath(root, subpath, &spec, ndistinct);
+		if (!subpath)
+			continue;
 
-			subpath = (Path *) skip_scan_path_create(root, index_path, unique->path.rows);
-			if (!subpath)
-				continue;
-		}
-		else if (IsA(subpath, MergeAppendPath))
-		{
-			MergeAppendPath *merge_path = castNode(MergeAppendPath, subpath);
-			List *new_paths = build_subpath(root, merge_path->subpaths, unique->path.rows);
+		if (proj)
+			subpath = (Path *) create_projection_path(root,
+													  subpath->parent,
+													  subpath,
+													  proj->path.pathtarget);
+
+		add_path(output_rel,
+				 (Path *) create_agg_path(root,
+										  output_rel,
+										  subpath,
+										  output_rel->reltarget,
+										  parse->groupClause ? AGG_SORTED : AGG_PLAIN,
+										  AGGSPLIT_SIMPLE,
+#if PG16_LT
+										  parse->groupClause,
+#else
+										  root->processed_groupClause,
+#endif
+										  (List *) parse->havingQual,
+										  &agg_costs,
+										  parse->groupClause ? ndistinct : 1));
+	}
+}
 
-			/* build_subpath returns NULL when no SkipScanPath was created */
-			if (!new_paths)
-				continue;
+/*
+ * Replace the scans of a path below a Unique or Agg node with SkipScans.
+ * Returns NULL if no SkipScan could be created.
+ */
+static Path *
+build_skip_scan_subpath(PlannerInfo *root, Path *subpath, SkipScanSpec *spec, double ndistinct)
+{
+	bool has_caa = false;
 
-			subpath = (Path *) create_merge_append_path(root,
-														merge_path->path.parent,
-														new_paths,
-														merge_path->path.pathkeys,
-														NULL);
-			subpath->pathtarget = copy_pathtarget(merge_path->path.pathtarget);
-		}
-		else if (ts_is_chunk_append_path(subpath))
+	/* Path might be wrapped in a ConstraintAwareAppendPath if this
+	 * is a MergeAppend that could benefit from runtime exclusion.
+	 * We treat this similar to ProjectionPath and add it back
+	 * later
+	 */
+	if (ts_is_constraint_aware_append_path(subpath))
+	{
+		subpath = linitial(castNode(CustomPath, subpath)->custom_paths);
+		Assert(IsA(subpath, MergeAppendPath));
+		has_caa = true;
+	}
+
+	if (IsA(subpath, IndexPath) || ts_is_decompress_chunk_path(subpath))
+	{
+		subpath = (Path *) skip_scan_child_path_create(root, subpath, spec, ndistinct);
+		if (!subpath)
+			return NULL;
+	}
+	else if (IsA(subpath, MergeAppendPath))
+	{
+		MergeAppendPath *merge_path = castNode(MergeAppendPath, subpath);
+		List *new_paths = build_subpath(root, merge_path->subpaths, spec, ndistinct);
+
+		/* build_subpath returns NULL when no SkipScanPath was created */
+		if (!new_paths)
+			return NULL;
+
+		subpath = (Path *) create_merge_append_path(root,
+													merge_path->path.parent,
+													new_paths,
+													merge_path->path.pathkeys,
+													NULL);
+		subpath->pathtarget = copy_pathtarget(merge_path->path.pathtarget);
+	}
+	else if (ts_is_chunk_append_path(subpath))
+	{
+		ChunkAppendPath *ca = (ChunkAppendPath *) subpath;
+		List *new_paths = build_subpath(root, ca->cpath.custom_paths, spec, ndistinct);
+		/* ChunkAppend should never be wrapped in ConstraintAwareAppendPath */
+		Assert(!has_caa);
+
+		/* build_subpath returns NULL when no SkipScanPath was created */
+		if (!new_paths)
+			return NULL;
+
+		/* We copy the existing ChunkAppendPath here because we don't have all the
+		 * information used for creating the original one and we don't want to
+		 * duplicate all the checks done when creating the original one.
+		 */
+		subpath = (Path *) ts_chunk_append_path_copy(ca, new_paths, ca->cpath.path.pathtarget);
+	}
+	else
+	{
+		return NULL;
+	}
+
+	/* add ConstraintAwareAppendPath if the original path had one */
+	if (has_caa)
+		subpath = ts_constraint_aware_append_path_create(root, subpath);
+
+	return subpath;
+}
+
+/*
+ * Create a SkipScanPath for a scan below the Unique or Agg node.
+ *
+ * For MIN/MAX and FIRST/LAST aggregates the IndexPath kept by the planner is
+ * the cheapest one providing the grouping order, which usually does not
+ * order the bookend column within each group. So if that index cannot be
+ * used we try the other indexes of the relation providing the same order.
+ */
+static SkipScanPath *
+skip_scan_child_path_create(PlannerInfo *root, Path *child_path, SkipScanSpec *spec,
+							double ndistinct)
+{
+	SkipScanPath *skip_path = skip_scan_path_create(root, child_path, spec, ndistinct);
+	ScanDirection directions[] = { ForwardScanDirection, BackwardScanDirection };
+	ListCell *lc;
+
+	if (skip_path || !spec->bookend_var || !IsA(child_path, IndexPath))
+		return skip_path;
+
+	/* we only build unparameterized paths without index quals */
+	IndexPath *index_path = castNode(IndexPath, child_path);
+	if (index_path->indexclauses != NIL || child_path->param_info != NULL)
+		return NULL;
+
+	RelOptInfo *rel = child_path->parent;
+	foreach (lc, rel->indexlist)
+	{
+		IndexOptInfo *index = lfirst_node(IndexOptInfo, lc);
+
+		if (index == index_path->indexinfo || !index->sortopfamily ||
+			(index->indpred != NIL && !index->predOK))
+			continue;
+
+		for (size_t i = 0; i < lengthof(directions); i++)
 		{
-			ChunkAppendPath *ca = (ChunkAppendPath *) subpath;
-			List *new_paths = build_subpath(root, ca->cpath.custom_paths, unique->path.rows);
-			/* ChunkAppend should never be wrapped in ConstraintAwareAppendPath */
-			Assert(!has_caa);
+			List *pathkeys = build_index_pathkeys(root, index, directions[i]);
 
-			/* build_subpath returns NULL when no SkipScanPath was created */
-			if (!new_paths)
+			if (!pathkeys_contained_in(child_path->pathkeys, pathkeys))
 				continue;
 
-			/* We copy the existing ChunkAppendPath here because we don't have all the
-			 * information used for creating the original one and we don't want to
-			 * duplicate all the checks done when creating the original one.
-			 */
-			subpath = (Path *) ts_chunk_append_path_copy(ca, new_paths, ca->cpath.path.pathtarget);
-		}
-		else
-		{
-			continue;
+			IndexPath *path = create_index_path(root,
+												index,
+												NIL,
+												NIL,
+												NIL,
+												pathkeys,
+												directions[i],
+												index_covers_rel(rel, index),
+												NULL,
+												1.0,
+												false);
+
+			skip_path = skip_scan_path_create(root, &path->path, spec, ndistinct);
+			if (skip_path)
+				return skip_path;
 		}
+	}
 
-		/* add ConstraintAwareAppendPath if the original path had one */
-		if (has_caa)
-			subpath = ts_constraint_aware_append_path_create(root, subpath);
+	return NULL;
+}
 
-		Path *new_unique = (Path *)
-			create_upper_unique_path(root, output_rel, subpath, unique->numkeys, unique->path.rows);
-		new_unique->pathtarget = unique->path.pathtarget;
+/*
+ * Check if an index returns all the columns of a relation needed by the
+ * query so an index-only scan can be used.
+ */
+static bool
+index_covers_rel(RelOptInfo *rel, IndexOptInfo *index)
+{
+	Bitmapset *attrs = NULL;
+	Bitmapset *index_attrs = NULL;
+	ListCell *lc;
 
-		if (project)
-			new_unique = (Path *) create_projection_path(root,
-														 output_rel,
-														 new_unique,
-														 copy_pathtarget(new_unique->pathtarget));
+	if (!enable_indexonlyscan)
+		return false;
 
-		add_path(output_rel, new_unique);
+	pull_varattnos((Node *) rel->reltarget->exprs, rel->relid, &attrs);
+	foreach (lc, rel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = lfirst_node(RestrictInfo, lc);
+		pull_varattnos((Node *) rinfo->clause, rel->relid, &attrs);
 	}
+
+	for (int i = 0; i < index->ncolumns; i++)
+	{
+		if (index->indexkeys[i] != 0 && index->canreturn[i])
+			index_attrs =
+				bms_add_member(index_attrs,
+							   index->indexkeys[i] - FirstLowInvalidHeapAttributeNumber);
+	}
+
+	return bms_is_subset(attrs, index_attrs);
 }
 
 static SkipScanPath *
-skip_scan_path_create(PlannerInfo *root, IndexPath *index_path, double ndistinct)
+skip_scan_path_create(PlannerInfo *root, Path *child_path, SkipScanSpec *spec, double ndistinct)
 {
-	double startup = index_path->path.startup_cost;
-	double total = index_path->path.total_cost;
-	double rows = index_path->path.rows;
+	double startup = child_path->startup_cost;
+	double total = child_path->total_cost;
+	double rows = child_path->rows;
+	IndexPath *index_path;
+	DecompressChunkPath *decompress_path = NULL;
+
+	if (IsA(child_path, IndexPath))
+		index_path = castNode(IndexPath, child_path);
+	else
+	{
+		Assert(ts_is_decompress_chunk_path(child_path));
+		decompress_path = (DecompressChunkPath *) child_path;
+		index_path = get_compressed_index_path(decompress_path);
+		if (!index_path)
+			return NULL;
+	}
 
 	/* cannot use SkipScan with non-orderable index or IndexPath without pathkeys */
 	if (!index_path->path.pathkeys || !index_path->indexinfo->sortopfamily)
@@ -334,12 +624,12 @@ skip_scan_path_create(PlannerInfo *root, IndexPath *index_path, double ndistinct
 	SkipScanPath *skip_scan_path = (SkipScanPath *) newNode(sizeof(SkipScanPath), T_CustomPath);
 
 	skip_scan_path->cpath.path.pathtype = T_CustomScan;
-	skip_scan_path->cpath.path.pathkeys = index_path->path.pathkeys;
-	skip_scan_path->cpath.path.pathtarget = index_path->path.pathtarget;
-	skip_scan_path->cpath.path.param_info = index_path->path.param_info;
-	skip_scan_path->cpath.path.parent = index_path->path.parent;
+	skip_scan_path->cpath.path.pathkeys = child_path->pathkeys;
+	skip_scan_path->cpath.path.pathtarget = child_path->pathtarget;
+	skip_scan_path->cpath.path.param_info = child_path->param_info;
+	skip_scan_path->cpath.path.parent = child_path->parent;
 	skip_scan_path->cpath.path.rows = ndistinct;
-	skip_scan_path->cpath.custom_paths = list_make1(index_path);
+	skip_scan_path->cpath.custom_paths = list_make1(child_path);
 	skip_scan_path->cpath.methods = &skip_scan_path_methods;
 
 	/* We calculate SkipScan cost as ndistinct * startup_cost + (ndistinct/rows) * total_cost
@@ -362,31 +652,352 @@ skip_scan_path_create(PlannerInfo *root, IndexPath *index_path, double ndistinct
 	 * it will never free IndexPaths and only ever do a shallow
 	 * free so reusing the IndexPath here is safe. */
 	skip_scan_path->index_path = index_path;
+	skip_scan_path->decompress_path = decompress_path;
 
-	Var *var = get_distinct_var(root, index_path, skip_scan_path);
+	List *vars = get_distinct_vars(root, child_path->parent, spec->distinct_exprs);
+	ListCell *lc;
 
-	if (!var)
+	if (vars == NIL)
 		return NULL;
 
-	skip_scan_path->distinct_var = var;
+	/*
+	 * With several distinct columns we skip over the values of each prefix
+	 * of the distinct columns in turn. Searching for NULL values is only
+	 * implemented for a single column, so with several columns all of them
+	 * have to be known to be NOT NULL.
+	 */
+	if (list_length(vars) > 1)
+	{
+		foreach (lc, vars)
+		{
+			if (!var_is_not_null(root, child_path->parent, lfirst_node(Var, lc)))
+				return NULL;
+		}
+	}
 
-	/* build skip qual this may fail if we cannot look up the operator */
-	if (!build_skip_qual(root, skip_scan_path, index_path, var))
-		return NULL;
+	foreach (lc, vars)
+	{
+		Var *var = lfirst_node(Var, lc);
+		Var *index_var = var;
+
+		/* On compressed chunks we can only skip over segmentby columns */
+		if (decompress_path)
+		{
+			index_var = get_compressed_var(decompress_path->info, var);
+			if (!index_var)
+				return NULL;
+		}
+
+		/* build skip qual this may fail if we cannot look up the operator */
+		SkipKeyInfo *key = build_skip_qual(root, index_path, index_var);
+
+		if (!key)
+			return NULL;
+
+		/* the tuples returned to the SkipScan reference the uncompressed column */
+		key->distinct_var = var;
+
+		skip_scan_path->skip_keys = lappend(skip_scan_path->skip_keys, key);
+	}
+
+	if (list_length(skip_scan_path->skip_keys) > 1)
+	{
+		ListCell *prev = NULL;
+
+		list_sort(skip_scan_path->skip_keys, skip_key_cmp_scankey_attno);
+
+		/* The distinct columns have to be different index columns */
+		foreach (lc, skip_scan_path->skip_keys)
+		{
+			SkipKeyInfo *key = lfirst(lc);
+
+			if (!OidIsValid(key->eq_opfuncid))
+				return NULL;
+			if (prev != NULL &&
+				((SkipKeyInfo *) lfirst(prev))->scankey_attno == key->scankey_attno)
+				return NULL;
+			prev = lc;
+		}
+	}
+
+	if (spec->bookend_var)
+	{
+		SkipKeyInfo *last_key = llast(skip_scan_path->skip_keys);
+
+		/* the segments of compressed chunks are not ordered by other columns */
+		if (decompress_path)
+			return NULL;
+
+		if (!index_has_bookend_order(root, index_path, spec, last_key->scankey_attno))
+			return NULL;
+	}
 
 	return skip_scan_path;
 }
 
-/* Extract the Var to use for the SkipScan and do attno mapping if required. */
-static Var *
-get_distinct_var(PlannerInfo *root, IndexPath *index_path, SkipScanPath *skip_scan_path)
+static int
+skip_key_cmp_scankey_attno(const ListCell *a, const ListCell *b)
+{
+	AttrNumber attno_a = ((SkipKeyInfo *) lfirst(a))->scankey_attno;
+	AttrNumber attno_b = ((SkipKeyInfo *) lfirst(b))->scankey_attno;
+
+	return (attno_a > attno_b) - (attno_a < attno_b);
+}
+
+/*
+ * Check if a column of the scanned relation cannot contain NULL values,
+ * either because of a NOT NULL constraint or because of an IS NOT NULL
+ * restriction in the query.
+ */
+static bool
+var_is_not_null(PlannerInfo *root, RelOptInfo *rel, Var *var)
 {
+	RangeTblEntry *rte = planner_rt_fetch(rel->relid, root);
 	ListCell *lc;
-	int num_vars = 0;
+
+	if (rte->rtekind == RTE_RELATION)
+	{
+		HeapTuple tuple = SearchSysCache2(ATTNUM,
+										  ObjectIdGetDatum(rte->relid),
+										  Int16GetDatum(var->varattno));
+
+		if (HeapTupleIsValid(tuple))
+		{
+			bool attnotnull = ((Form_pg_attribute) GETSTRUCT(tuple))->attnotnull;
+
+			ReleaseSysCache(tuple);
+			if (attnotnull)
+				return true;
+		}
+	}
+
+	foreach (lc, rel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = lfirst_node(RestrictInfo, lc);
+		NullTest *ntest = (NullTest *) rinfo->clause;
+
+		if (IsA(ntest, NullTest) && ntest->nulltesttype == IS_NOT_NULL && !ntest->argisrow &&
+			IsA(ntest->arg, Var) && ((Var *) ntest->arg)->varno == var->varno &&
+			((Var *) ntest->arg)->varattno == var->varattno)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Check if the index column following the last skip key orders the tuples
+ * of each group so the first tuple returned has the smallest or largest
+ * value of the bookend column, as required by the MIN/MAX or FIRST/LAST
+ * aggregates.
+ */
+static bool
+index_has_bookend_order(PlannerInfo *root, IndexPath *index_path, SkipScanSpec *spec,
+						AttrNumber scankey_attno)
+{
+	IndexOptInfo *info = index_path->indexinfo;
 	RelOptInfo *rel = index_path->path.parent;
-	Expr *tlexpr = NULL;
+	/* scankey_attno is 1-based so this is the 0-based position of the next column */
+	int idx_key = scankey_attno;
+
+	Var *var = get_distinct_var(root, rel, spec->bookend_var);
+	if (!var || idx_key >= info->nkeycolumns || info->indexkeys[idx_key] != var->varattno)
+		return false;
+
+	int strategy = get_op_opfamily_strategy(spec->bookend_sortop, info->sortopfamily[idx_key]);
+	if (strategy != BTLessStrategyNumber && strategy != BTGreaterStrategyNumber)
+		return false;
 
-	foreach (lc, root->parse->distinctClause)
+	bool descending = info->reverse_sort[idx_key];
+	bool nulls_first = info->nulls_first[idx_key];
+	if (index_path->indexscandir == BackwardScanDirection)
+	{
+		descending = !descending;
+		nulls_first = !nulls_first;
+	}
+
+	/* the smallest value has to come first for "<" and the largest for ">" */
+	if (descending != (strategy == BTGreaterStrategyNumber))
+		return false;
+
+	/* NULL values are ignored by the aggregates so they must not come first */
+	if (nulls_first && !var_is_not_null(root, rel, var))
+		return false;
+
+	return true;
+}
+
+/* Get the Var of an aggregate argument ignoring binary-compatible relabeling */
+static Var *
+get_aggref_arg_var(Aggref *aggref, int argno)
+{
+	if (list_length(aggref->args) <= argno)
+		return NULL;
+
+	Expr *expr = list_nth_node(TargetEntry, aggref->args, argno)->expr;
+	while (expr && IsA(expr, RelabelType))
+		expr = ((RelabelType *) expr)->arg;
+
+	if (!expr || !IsA(expr, Var))
+		return NULL;
+
+	return castNode(Var, expr);
+}
+
+static bool
+list_member_var(List *exprs, Var *var)
+{
+	ListCell *lc;
+
+	foreach (lc, exprs)
+	{
+		Expr *expr = lfirst(lc);
+		while (expr && IsA(expr, RelabelType))
+			expr = ((RelabelType *) expr)->arg;
+
+		if (expr && IsA(expr, Var) && ((Var *) expr)->varno == var->varno &&
+			((Var *) expr)->varattno == var->varattno && ((Var *) expr)->varlevelsup == 0)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Build the SkipScanSpec for a grouped query. This is only possible when all
+ * aggregates produce the same result when only seeing the first tuple of each
+ * distinct value of the columns we skip over:
+ *
+ *  - DISTINCT aggregates on a grouping column, or on a single column without
+ *    GROUP BY
+ *  - MIN/MAX of a grouping column
+ *  - MIN/MAX and FIRST/LAST with GROUP BY, all ordering by the same column
+ *    in the same direction
+ */
+static bool
+build_agg_spec(PlannerInfo *root, RelOptInfo *output_rel, SkipScanSpec *spec)
+{
+	Query *parse = root->parse;
+	List *aggrefs = NIL;
+	ListCell *lc;
+
+	List *exprs = list_copy(output_rel->reltarget->exprs);
+	if (parse->havingQual)
+		exprs = lappend(exprs, parse->havingQual);
+
+	foreach (lc, pull_var_clause((Node *) exprs, PVC_INCLUDE_AGGREGATES | PVC_RECURSE_PLACEHOLDERS))
+	{
+		if (IsA(lfirst(lc), Aggref))
+			aggrefs = lappend(aggrefs, lfirst(lc));
+	}
+
+	if (parse->groupClause)
+	{
+		spec->distinct_exprs = get_distinct_exprs(root, parse->groupClause);
+		if (spec->distinct_exprs == NIL)
+			return false;
+	}
+	else
+	{
+		/* without GROUP BY we skip over the argument of the DISTINCT aggregates */
+		foreach (lc, aggrefs)
+		{
+			Aggref *aggref = lfirst_node(Aggref, lc);
+			Var *var = get_aggref_arg_var(aggref, 0);
+
+			if (aggref->aggdistinct != NIL && var != NULL)
+			{
+				spec->distinct_exprs = list_make1(var);
+				break;
+			}
+		}
+		if (spec->distinct_exprs == NIL)
+			return false;
+	}
+
+	foreach (lc, aggrefs)
+	{
+		Aggref *aggref = lfirst_node(Aggref, lc);
+		Var *var;
+		Oid sortop = InvalidOid;
+
+		if (aggref->aggfilter != NULL || aggref->aggkind != AGGKIND_NORMAL ||
+			aggref->agglevelsup != 0)
+			return false;
+
+		if (aggref->aggdistinct != NIL)
+		{
+			/* duplicates of the distinct values don't change the result */
+			var = get_aggref_arg_var(aggref, 0);
+			if (list_length(aggref->args) != 1 || !var ||
+				!list_member_var(spec->distinct_exprs, var))
+				return false;
+			continue;
+		}
+
+		if (aggref->aggorder != NIL)
+			return false;
+
+		StrategyNumber strategy = ts_first_last_agg_strategy(aggref->aggfnoid);
+		if (strategy != InvalidStrategy)
+		{
+			/* first(value, time) and last(value, time) order by the second argument */
+			var = get_aggref_arg_var(aggref, 1);
+			if (!var)
+				return false;
+
+			TypeCacheEntry *tce =
+				lookup_type_cache(var->vartype, TYPECACHE_LT_OPR | TYPECACHE_GT_OPR);
+			sortop = strategy == BTLessStrategyNumber ? tce->lt_opr : tce->gt_opr;
+		}
+		else
+		{
+			HeapTuple tuple = SearchSysCache1(AGGFNOID, ObjectIdGetDatum(aggref->aggfnoid));
+
+			if (!HeapTupleIsValid(tuple))
+				return false;
+			/* MIN/MAX aggregates have a sort operator */
+			sortop = ((Form_pg_aggregate) GETSTRUCT(tuple))->aggsortop;
+			ReleaseSysCache(tuple);
+
+			var = get_aggref_arg_var(aggref, 0);
+			if (!var || list_length(aggref->args) != 1)
+				return false;
+		}
+
+		if (!OidIsValid(sortop))
+			return false;
+
+		/* MIN/MAX of a column we skip over doesn't need any particular order */
+		if (strategy == InvalidStrategy && list_member_var(spec->distinct_exprs, var))
+			continue;
+
+		/* Without GROUP BY there is only one group and we would skip over it */
+		if (!parse->groupClause)
+			return false;
+
+		if (spec->bookend_var == NULL)
+		{
+			spec->bookend_var = var;
+			spec->bookend_sortop = sortop;
+		}
+		else if (spec->bookend_var->varno != var->varno ||
+				 spec->bookend_var->varattno != var->varattno || spec->bookend_sortop != sortop)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Get the expressions of a DISTINCT or GROUP BY clause we skip over.
+ */
+static List *
+get_distinct_exprs(PlannerInfo *root, List *clauses)
+{
+	ListCell *lc;
+	List *exprs = NIL;
+
+	foreach (lc, clauses)
 	{
 		SortGroupClause *clause = lfirst_node(SortGroupClause, lc);
 		Node *expr = get_sortgroupclause_expr(clause, root->parse->targetList);
@@ -396,25 +1007,51 @@ get_distinct_var(PlannerInfo *root, IndexPath *index_path, SkipScanPath *skip_sc
 		if (IsA(estimate_expression_value(root, expr), Const))
 			continue;
 
-		num_vars++;
+		exprs = lappend(exprs, expr);
+	}
+
+	return exprs;
+}
+
+/*
+ * Extract the Vars to use for the SkipScan, in the order of the DISTINCT
+ * expressions. Returns NIL if SkipScan cannot be used for them.
+ */
+static List *
+get_distinct_vars(PlannerInfo *root, RelOptInfo *rel, List *exprs)
+{
+	ListCell *lc;
+	List *vars = NIL;
+
+	foreach (lc, exprs)
+	{
+		Node *expr = lfirst(lc);
 
 		/* We ignore binary-compatible relabeling */
-		tlexpr = (Expr *) expr;
+		Expr *tlexpr = (Expr *) expr;
 		while (tlexpr && IsA(tlexpr, RelabelType))
 			tlexpr = ((RelabelType *) tlexpr)->arg;
-	}
 
-	if (num_vars != 1)
-		return NULL;
+		/* SkipScan on expressions not supported */
+		if (!tlexpr || !IsA(tlexpr, Var))
+			return NIL;
 
-	/* SkipScan on expressions not supported */
-	if (!tlexpr || !IsA(tlexpr, Var))
-		return NULL;
+		Var *var = get_distinct_var(root, rel, castNode(Var, tlexpr));
+		if (!var)
+			return NIL;
 
-	Var *var = castNode(Var, tlexpr);
+		vars = lappend(vars, var);
+	}
+
+	return vars;
+}
 
+/* Do attno mapping of a distinct Var to the scanned relation if required. */
+static Var *
+get_distinct_var(PlannerInfo *root, RelOptInfo *rel, Var *var)
+{
 	/* If we are dealing with a hypertable Var extracted from distinctClause will point to
-	 * the parent hypertable while the IndexPath will be on a Chunk.
+	 * the parent hypertable while the scanned relation will be a Chunk.
 	 * For a normal table they point to the same relation and we are done here. */
 	if ((Index) var->varno == rel->relid)
 		return var;
@@ -468,13 +1105,60 @@ get_distinct_var(PlannerInfo *root, IndexPath *index_path, SkipScanPath *skip_sc
 	return var;
 }
 
+/*
+ * Get the index scan on the compressed chunk below a DecompressChunk path.
+ * Skipping over the compressed index only returns the right tuples if the
+ * batches are decompressed one after another in the order of the index, so
+ * no batch sorted merge or sort of the compressed scan can be involved.
+ */
+static IndexPath *
+get_compressed_index_path(DecompressChunkPath *decompress_path)
+{
+	Path *compressed_path = linitial(decompress_path->custom_path.custom_paths);
+
+	if (decompress_path->batch_sorted_merge || !IsA(compressed_path, IndexPath))
+		return NULL;
+
+	if (decompress_path->required_compressed_pathkeys == NIL ||
+		!pathkeys_contained_in(decompress_path->required_compressed_pathkeys,
+							   compressed_path->pathkeys))
+		return NULL;
+
+	return castNode(IndexPath, compressed_path);
+}
+
+/*
+ * Map a Var of a compressed chunk to the corresponding column of the
+ * compressed relation. Only segmentby columns are stored uncompressed in
+ * the compressed relation, for any other column NULL is returned.
+ */
+static Var *
+get_compressed_var(CompressionInfo *info, Var *var)
+{
+	if (!bms_is_member(var->varattno, info->chunk_segmentby_attnos))
+		return NULL;
+
+	char *attname = get_attname(info->chunk_rte->relid, var->varattno, false);
+	AttrNumber compressed_attno = get_attnum(info->compressed_rte->relid, attname);
+
+	if (compressed_attno == InvalidAttrNumber)
+		return NULL;
+
+	Var *compressed_var = copyObject(var);
+	compressed_var->varno = info->compressed_rel->relid;
+	compressed_var->varattno = compressed_attno;
+
+	return compressed_var;
+}
+
 /*
  * Creates SkipScanPath for each path of subpaths that is an IndexPath
+ * or a DecompressChunkPath over an IndexPath.
  * If no subpath can be changed to SkipScanPath returns NULL
  * otherwise returns list of new paths
  */
 static List *
-build_subpath(PlannerInfo *root, List *subpaths, double ndistinct)
+build_subpath(PlannerInfo *root, List *subpaths, SkipScanSpec *spec, double ndistinct)
 {
 	bool has_skip_path = false;
 	List *new_paths = NIL;
@@ -483,10 +1167,9 @@ build_subpath(PlannerInfo *root, List *subpaths, double ndistinct)
 	foreach (lc, subpaths)
 	{
 		Path *child = lfirst(lc);
-		if (IsA(child, IndexPath))
+		if (IsA(child, IndexPath) || ts_is_decompress_chunk_path(child))
 		{
-			SkipScanPath *skip_path =
-				skip_scan_path_create(root, castNode(IndexPath, child), ndistinct);
+			SkipScanPath *skip_path = skip_scan_child_path_create(root, child, spec, ndistinct);
 
 			if (skip_path)
 			{
@@ -507,8 +1190,8 @@ build_subpath(PlannerInfo *root, List *subpaths, double ndistinct)
 	return new_paths;
 }
 
-static bool
-build_skip_qual(PlannerInfo *root, SkipScanPath *skip_scan_path, IndexPath *index_path, Var *var)
+static SkipKeyInfo *
+build_skip_qual(PlannerInfo *root, IndexPath *index_path, Var *var)
 {
 	IndexOptInfo *info = index_path->indexinfo;
 	Oid column_type = exprType((Node *) var);
@@ -533,13 +1216,15 @@ build_skip_qual(PlannerInfo *root, SkipScanPath *skip_scan_path, IndexPath *inde
 	 */
 	int idx_key = get_idx_key(info, var->varattno);
 	if (idx_key < 0)
-		return false;
+		return NULL;
 
-	skip_scan_path->distinct_attno = var->varattno;
-	skip_scan_path->distinct_by_val = tce->typbyval;
-	skip_scan_path->distinct_typ_len = tce->typlen;
+	SkipKeyInfo *key = palloc0(sizeof(SkipKeyInfo));
+	key->distinct_var = var;
+	key->distinct_attno = var->varattno;
+	key->distinct_by_val = tce->typbyval;
+	key->distinct_typ_len = tce->typlen;
 	/* sk_attno of the skip qual */
-	skip_scan_path->scankey_attno = idx_key + 1;
+	key->scankey_attno = idx_key + 1;
 
 	int16 strategy = info->reverse_sort[idx_key] ? BTLessStrategyNumber : BTGreaterStrategyNumber;
 	if (index_path->indexscandir == BackwardScanDirection)
@@ -551,6 +1236,7 @@ build_skip_qual(PlannerInfo *root, SkipScanPath *skip_scan_path, IndexPath *inde
 
 	Oid comparator =
 		get_opfamily_member(info->sortopfamily[idx_key], column_type, column_type, strategy);
+	Oid eq_type = column_type;
 
 	/* If there is no exact operator match for the column type we have here check
 	 * if we can coerce to the type of the operator class. */
@@ -561,13 +1247,21 @@ build_skip_qual(PlannerInfo *root, SkipScanPath *skip_scan_path, IndexPath *inde
 			comparator =
 				get_opfamily_member(info->sortopfamily[idx_key], opcintype, opcintype, strategy);
 			if (!OidIsValid(comparator))
-				return false;
+				return NULL;
 			need_coerce = true;
+			eq_type = opcintype;
 		}
 		else
-			return false; /* cannot use this index */
+			return NULL; /* cannot use this index */
 	}
 
+	/* The equality operator is only needed when skipping over several columns */
+	Oid eq_operator = get_opfamily_member(info->sortopfamily[idx_key],
+										  eq_type,
+										  eq_type,
+										  BTEqualStrategyNumber);
+	key->eq_opfuncid = OidIsValid(eq_operator) ? get_opcode(eq_operator) : InvalidOid;
+
 	Const *prev_val = makeNullConst(need_coerce ? opcintype : column_type, -1, column_collation);
 	Expr *current_val = (Expr *) makeVar(info->rel->relid /*varno*/,
 										 var->varattno /*varattno*/,
@@ -597,9 +1291,9 @@ build_skip_qual(PlannerInfo *root, SkipScanPath *skip_scan_path, IndexPath *inde
 										  info->indexcollations[idx_key] /*inputcollid*/);
 	set_opfuncid(castNode(OpExpr, comparison_expr));
 
-	skip_scan_path->skip_clause = make_simple_restrictinfo(root, comparison_expr);
+	key->skip_clause = make_simple_restrictinfo(root, comparison_expr);
 
-	return true;
+	return key;
 }
 
 static int
@@ -135,19 +135,30 @@ vector_agg_begin(CustomScanState *node, EState *estate, int eflags)
 			Assert(func != NULL);
 			def->func = *func;
 
+			def->input_offset = -1;
+			def->input_offset2 = -1;
 			if (list_length(aggref->args) > 0)
 			{
-				Assert(list_length(aggref->args) == 1);
+				Assert(list_length(aggref->args) == (func->agg_vector2 != NULL ? 2 : 1));
 
 				/* The aggregate should be a partial aggregate */
 				Assert(aggref->aggsplit == AGGSPLIT_INITIAL_SERIAL);
 
-				Var *var = castNode(Var, castNode(TargetEntry, linitial(aggref->args))->expr);
-				def->input_offset = get_input_offset(decompress_state, var);
-			}
-			else
-			{
-				def->input_offset = -1;
+				int *offsets[2] = { &def->input_offset, &def->input_offset2 };
+				for (int arg = 0; arg < list_length(aggref->args); arg++)
+				{
+					Expr *expr = castNode(TargetEntry, list_nth(aggref->args, arg))->expr;
+					if (IsA(expr, Const))
+					{
+						/* Only the functions with two arguments accept constants. */
+						Assert(func->agg_vector2 != NULL);
+						def->input_const[arg] = castNode(Const, expr)->constvalue;
+						def->input_const_isnull[arg] = castNode(Const, expr)->constisnull;
+						continue;
+					}
+
+					*offsets[arg] = get_input_offset(decompress_state, castNode(Var, expr));
+				}
 			}
 		}
 		else
@@ -17,6 +17,14 @@ typedef struct VectorAggDef
 {
 	VectorAggFunctions func;
 	int input_offset;
+	/* The second argument of the functions with two arguments, otherwise -1. */
+	int input_offset2;
+	/*
+	 * The constant arguments of the functions with two arguments, used when
+	 * the respective input offset is -1.
+	 */
+	Datum input_const[2];
+	bool input_const_isnull[2];
 	int output_offset;
 } VectorAggDef;
 
@@ -14,6 +14,7 @@
 #include <utils/fmgroids.h>
 #include <utils/fmgrprotos.h>
 
+#include "func_cache.h"
 #include "functions.h"
 
 #include "compat/compat.h"
@@ -118,6 +119,37 @@ VectorAggFunctions count_any_agg = {
 	.agg_vector = count_any_vector,
 };
 
+extern VectorAggFunctions time_weight_agg;
+extern VectorAggFunctions quantile_sketch_agg;
+
+/*
+ * Return the vector aggregate definition corresponding to the TimescaleDB
+ * aggregate function with the given Oid.
+ */
+static VectorAggFunctions *
+get_timescaledb_vector_aggregate(Oid aggfnoid)
+{
+	FuncInfo *finfo = ts_func_cache_get(aggfnoid);
+	if (finfo == NULL || finfo->origin != ORIGIN_TIMESCALE)
+	{
+		return NULL;
+	}
+
+	/* These aggregates share the transition function and the partial state. */
+	if (strcmp(finfo->funcname, "time_weighted_avg") == 0 ||
+		strcmp(finfo->funcname, "integral") == 0 || strcmp(finfo->funcname, "counter_rate") == 0)
+	{
+		return &time_weight_agg;
+	}
+
+	if (strcmp(finfo->funcname, "approx_percentile") == 0)
+	{
+		return &quantile_sketch_agg;
+	}
+
+	return NULL;
+}
+
 /*
  * Return the vector aggregate definition corresponding to the given
  * PG aggregate function Oid.
@@ -140,6 +172,6 @@ get_vector_aggregate(Oid aggfnoid)
 #include "sum_float_templates.c"
 #undef GENERATE_DISPATCH_TABLE
 		default:
-			return NULL;
+			return get_timescaledb_vector_aggregate(aggfnoid);
 	}
 }
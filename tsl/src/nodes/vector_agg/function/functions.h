@@ -37,6 +37,16 @@ typedef struct
 	void (*agg_scalar)(void *restrict agg_state, Datum constvalue, bool constisnull, int n,
 					   MemoryContext agg_extra_mctx);
 
+	/*
+	 * Aggregate the arguments of a function with two arguments. An argument
+	 * that has the same value for all rows of the batch, like a segmentby
+	 * column or a constant, is passed as a NULL arrow array and a non-null
+	 * constant value. Set only for such functions.
+	 */
+	void (*agg_vector2)(void *restrict agg_state, int n, const ArrowArray *vector1,
+						Datum constvalue1, const ArrowArray *vector2, Datum constvalue2,
+						const uint64 *filter, MemoryContext agg_extra_mctx);
+
 	/* Emit a partial aggregation result. */
 	void (*agg_emit)(void *restrict agg_state, Datum *out_result, bool *out_isnull);
 } VectorAggFunctions;
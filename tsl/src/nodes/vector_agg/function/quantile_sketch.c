@@ -0,0 +1,142 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Vectorized implementation of the transition function of the
+ * approx_percentile() aggregate. The fraction is usually a constant, so the
+ * rows of a batch only have to be counted in the buckets of the sketch.
+ */
+
+#include <postgres.h>
+
+#include "functions.h"
+#include "quantile_sketch.h"
+
+static void
+quantile_sketch_init(void *restrict agg_states, int n)
+{
+	QuantileSketch *sketches = (QuantileSketch *) agg_states;
+	for (int i = 0; i < n; i++)
+	{
+		ts_quantile_sketch_init(&sketches[i]);
+	}
+}
+
+static void
+quantile_sketch_emit(void *agg_state, Datum *out_result, bool *out_isnull)
+{
+	QuantileSketch *sketch = (QuantileSketch *) agg_state;
+
+	*out_result = PointerGetDatum(ts_quantile_sketch_serialize(sketch));
+	*out_isnull = false;
+}
+
+static pg_attribute_always_inline void
+quantile_sketch_vector_impl(QuantileSketch *sketch, int n, const float8 *fractions,
+							const float8 *values, const uint64 *filter,
+							MemoryContext agg_extra_mctx)
+{
+	for (int row = 0; row < n; row++)
+	{
+		if (!arrow_row_is_valid(filter, row))
+		{
+			continue;
+		}
+
+		if (fractions != NULL)
+		{
+			ts_quantile_sketch_set_fraction(sketch, fractions[row]);
+		}
+
+		ts_quantile_sketch_add(sketch, values[row], 1, agg_extra_mctx);
+	}
+}
+
+static pg_noinline void
+quantile_sketch_vector_all_valid(QuantileSketch *sketch, int n, const float8 *values,
+								 MemoryContext agg_extra_mctx)
+{
+	quantile_sketch_vector_impl(sketch, n, NULL, values, NULL, agg_extra_mctx);
+}
+
+static pg_noinline void
+quantile_sketch_vector_one_validity(QuantileSketch *sketch, int n, const float8 *values,
+									const uint64 *filter, MemoryContext agg_extra_mctx)
+{
+	quantile_sketch_vector_impl(sketch, n, NULL, values, filter, agg_extra_mctx);
+}
+
+static void
+quantile_sketch_vector2(void *agg_state, int n, const ArrowArray *vector1, Datum constvalue1,
+						const ArrowArray *vector2, Datum constvalue2, const uint64 *filter,
+						MemoryContext agg_extra_mctx)
+{
+	QuantileSketch *sketch = (QuantileSketch *) agg_state;
+
+	if (vector1 != NULL)
+	{
+		/*
+		 * The fraction is a column, which is a rare case, so we use the generic
+		 * implementation.
+		 */
+		if (vector2 != NULL)
+		{
+			quantile_sketch_vector_impl(sketch,
+										n,
+										vector1->buffers[1],
+										vector2->buffers[1],
+										filter,
+										agg_extra_mctx);
+			return;
+		}
+
+		const float8 *fractions = vector1->buffers[1];
+		for (int row = 0; row < n; row++)
+		{
+			if (arrow_row_is_valid(filter, row))
+			{
+				ts_quantile_sketch_set_fraction(sketch, fractions[row]);
+				ts_quantile_sketch_add(sketch, DatumGetFloat8(constvalue2), 1, agg_extra_mctx);
+			}
+		}
+		return;
+	}
+
+	const int valid = arrow_num_valid(filter, n);
+	if (valid == 0)
+	{
+		return;
+	}
+
+	ts_quantile_sketch_set_fraction(sketch, DatumGetFloat8(constvalue1));
+
+	if (vector2 == NULL)
+	{
+		/* A segmentby column or a column with default value. */
+		ts_quantile_sketch_add(sketch, DatumGetFloat8(constvalue2), valid, agg_extra_mctx);
+	}
+	else if (filter == NULL)
+	{
+		/* All rows are valid and we don't have to check any validity bitmaps. */
+		quantile_sketch_vector_all_valid(sketch, n, vector2->buffers[1], agg_extra_mctx);
+	}
+	else
+	{
+		/* Have to check only one combined validity bitmap. */
+		quantile_sketch_vector_one_validity(sketch,
+											n,
+											vector2->buffers[1],
+											filter,
+											agg_extra_mctx);
+	}
+}
+
+VectorAggFunctions quantile_sketch_agg = {
+	.state_bytes = sizeof(QuantileSketch),
+	.agg_init = quantile_sketch_init,
+	.agg_emit = quantile_sketch_emit,
+	.agg_vector2 = quantile_sketch_vector2,
+};
@@ -0,0 +1,145 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Vectorized implementation of the transition function shared by the
+ * time_weighted_avg(), integral() and counter_rate() aggregates. The compressed
+ * batches are usually ordered by time, so the rows of a batch form a single
+ * run of the transition state. The runs of the batches are stitched together
+ * in time order by the final function, so the batches can arrive in any order.
+ */
+
+#include <postgres.h>
+
+#include <utils/timestamp.h>
+
+#include "functions.h"
+#include "time_weight.h"
+
+static void
+time_weight_init(void *restrict agg_states, int n)
+{
+	TimeWeightState *states = (TimeWeightState *) agg_states;
+	for (int i = 0; i < n; i++)
+	{
+		ts_time_weight_state_init(&states[i]);
+	}
+}
+
+static void
+time_weight_emit(void *agg_state, Datum *out_result, bool *out_isnull)
+{
+	TimeWeightState *state = (TimeWeightState *) agg_state;
+
+	*out_result = PointerGetDatum(ts_time_weight_state_serialize(state));
+	*out_isnull = false;
+}
+
+static pg_attribute_always_inline void
+time_weight_vector_impl(TimeWeightState *state, int n, const TimestampTz *times,
+						TimestampTz const_time, const float8 *values, float8 const_value,
+						const uint64 *filter, MemoryContext agg_extra_mctx)
+{
+	TimeWeightRun run;
+	bool have_run = false;
+
+	for (int row = 0; row < n; row++)
+	{
+		if (!arrow_row_is_valid(filter, row))
+		{
+			continue;
+		}
+
+		const TimestampTz time = times != NULL ? times[row] : const_time;
+		const float8 value = values != NULL ? values[row] : const_value;
+
+		if (have_run && time_weight_run_extend(&run, time, value))
+		{
+			continue;
+		}
+
+		if (have_run)
+		{
+			ts_time_weight_state_add_run(state, &run, agg_extra_mctx);
+			time_weight_run_restart(&run, time, value);
+		}
+		else
+		{
+			time_weight_run_init(&run, time, value);
+			have_run = true;
+		}
+	}
+
+	if (have_run)
+	{
+		ts_time_weight_state_add_run(state, &run, agg_extra_mctx);
+	}
+}
+
+static pg_noinline void
+time_weight_vector_all_valid(TimeWeightState *state, int n, const TimestampTz *times,
+							 const float8 *values, MemoryContext agg_extra_mctx)
+{
+	time_weight_vector_impl(state, n, times, 0, values, 0, NULL, agg_extra_mctx);
+}
+
+static pg_noinline void
+time_weight_vector_one_validity(TimeWeightState *state, int n, const TimestampTz *times,
+								const float8 *values, const uint64 *filter,
+								MemoryContext agg_extra_mctx)
+{
+	time_weight_vector_impl(state, n, times, 0, values, 0, filter, agg_extra_mctx);
+}
+
+static void
+time_weight_vector2(void *agg_state, int n, const ArrowArray *vector1, Datum constvalue1,
+					const ArrowArray *vector2, Datum constvalue2, const uint64 *filter,
+					MemoryContext agg_extra_mctx)
+{
+	TimeWeightState *state = (TimeWeightState *) agg_state;
+
+	if (vector1 == NULL || vector2 == NULL)
+	{
+		/*
+		 * A segmentby column or a column with default value, which is a rare
+		 * case, so we use the generic implementation.
+		 */
+		time_weight_vector_impl(state,
+								n,
+								vector1 != NULL ? vector1->buffers[1] : NULL,
+								DatumGetTimestampTz(constvalue1),
+								vector2 != NULL ? vector2->buffers[1] : NULL,
+								DatumGetFloat8(constvalue2),
+								filter,
+								agg_extra_mctx);
+	}
+	else if (filter == NULL)
+	{
+		/* All rows are valid and we don't have to check any validity bitmaps. */
+		time_weight_vector_all_valid(state,
+									 n,
+									 vector1->buffers[1],
+									 vector2->buffers[1],
+									 agg_extra_mctx);
+	}
+	else
+	{
+		/* Have to check only one combined validity bitmap. */
+		time_weight_vector_one_validity(state,
+										n,
+										vector1->buffers[1],
+										vector2->buffers[1],
+										filter,
+										agg_extra_mctx);
+	}
+}
+
+VectorAggFunctions time_weight_agg = {
+	.state_bytes = sizeof(TimeWeightState),
+	.agg_init = time_weight_init,
+	.agg_emit = time_weight_emit,
+	.agg_vector2 = time_weight_vector2,
+};
@@ -112,10 +112,93 @@ gp_batch_reset(GroupingPolicy *obj)
 	policy->have_results = false;
 }
 
+/*
+ * Compute an aggregate function with two arguments. A scalar or constant
+ * argument is passed to the function as a constant, or filters out the entire
+ * batch if it is null.
+ */
+static void
+compute_two_argument_aggregate(GroupingPolicyBatch *policy, DecompressBatchState *batch_state,
+							   VectorAggDef *agg_def, void *agg_state,
+							   MemoryContext agg_extra_mctx)
+{
+	const int offsets[2] = { agg_def->input_offset, agg_def->input_offset2 };
+	const ArrowArray *arg_arrows[2] = { NULL, NULL };
+	Datum arg_datums[2] = { 0, 0 };
+	const size_t num_words = (batch_state->total_batch_rows + 63) / 64;
+	const uint64 *filter = batch_state->vector_qual_result;
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (offsets[i] < 0)
+		{
+			if (agg_def->input_const_isnull[i])
+			{
+				/* The rows without a value don't contribute. */
+				return;
+			}
+			arg_datums[i] = agg_def->input_const[i];
+			continue;
+		}
+
+		CompressedColumnValues *values = &batch_state->compressed_columns[offsets[i]];
+		Assert(values->decompression_type != DT_Invalid);
+		Assert(values->decompression_type != DT_Iterator);
+
+		if (values->arrow != NULL)
+		{
+			arg_arrows[i] = values->arrow;
+
+			const uint64 *validity = values->buffers[0];
+			if (validity == NULL)
+			{
+				continue;
+			}
+
+			if (filter == NULL)
+			{
+				filter = validity;
+				continue;
+			}
+
+			for (size_t word = 0; word < num_words; word++)
+			{
+				policy->tmp_filter[word] = filter[word] & validity[word];
+			}
+			filter = policy->tmp_filter;
+		}
+		else
+		{
+			Assert(values->decompression_type == DT_Scalar);
+			if (*values->output_isnull)
+			{
+				/* The rows without a value don't contribute. */
+				return;
+			}
+			arg_datums[i] = *values->output_value;
+		}
+	}
+
+	agg_def->func.agg_vector2(agg_state,
+							  batch_state->total_batch_rows,
+							  arg_arrows[0],
+							  arg_datums[0],
+							  arg_arrows[1],
+							  arg_datums[1],
+							  filter,
+							  agg_extra_mctx);
+}
+
 static void
 compute_single_aggregate(GroupingPolicyBatch *policy, DecompressBatchState *batch_state,
 						 VectorAggDef *agg_def, void *agg_state, MemoryContext agg_extra_mctx)
 {
+	if (agg_def->func.agg_vector2 != NULL)
+	{
+		compute_two_argument_aggregate(policy, batch_state, agg_def, agg_state, agg_extra_mctx);
+		return;
+	}
+
 	ArrowArray *arg_arrow = NULL;
 	const uint64 *arg_validity_bitmap = NULL;
 	Datum arg_datum = 0;
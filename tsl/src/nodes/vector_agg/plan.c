@@ -323,7 +323,8 @@ can_vectorize_aggref(Aggref *aggref, CustomScan *custom)
 		return false;
 	}
 
-	if (get_vector_aggregate(aggref->aggfnoid) == NULL)
+	VectorAggFunctions *func = get_vector_aggregate(aggref->aggfnoid);
+	if (func == NULL)
 	{
 		/*
 		 * We don't have a vectorized implementation for this particular
@@ -338,12 +339,25 @@ can_vectorize_aggref(Aggref *aggref, CustomScan *custom)
 		return true;
 	}
 
-	/* The function must have one argument, check it. */
-	Assert(list_length(aggref->args) == 1);
-	TargetEntry *argument = castNode(TargetEntry, linitial(aggref->args));
-	if (!is_vector_var(custom, argument->expr, NULL))
+	/*
+	 * The function must have one argument, or two for the functions that
+	 * aggregate pairs of values. Check them. The functions with two arguments
+	 * also accept constants, like the fraction of approx_percentile().
+	 */
+	Assert(list_length(aggref->args) == (func->agg_vector2 != NULL ? 2 : 1));
+	ListCell *lc;
+	foreach (lc, aggref->args)
 	{
-		return false;
+		TargetEntry *argument = castNode(TargetEntry, lfirst(lc));
+		if (func->agg_vector2 != NULL && IsA(argument->expr, Const))
+		{
+			continue;
+		}
+
+		if (!is_vector_var(custom, argument->expr, NULL))
+		{
+			return false;
+		}
 	}
 
 	return true;
@@ -76,7 +76,10 @@ tsl_create_upper_paths_hook(PlannerInfo *root, UpperRelationKind stage, RelOptIn
 		case UPPERREL_GROUP_AGG:
 			if (input_reltype != TS_REL_HYPERTABLE_CHILD)
 			{
-				plan_add_gapfill(root, output_rel);
+				plan_add_gapfill(root,
+								 input_rel,
+								 output_rel,
+								 input_reltype == TS_REL_HYPERTABLE ? ht : NULL);
 			}
 
 			if (ts_guc_enable_chunkwise_aggregation && input_rel != NULL &&
@@ -85,6 +88,8 @@ tsl_create_upper_paths_hook(PlannerInfo *root, UpperRelationKind stage, RelOptIn
 			{
 				tsl_pushdown_partial_agg(root, ht, input_rel, output_rel, extra);
 			}
+
+			tsl_skip_scan_agg_paths_add(root, input_rel, output_rel);
 			break;
 		case UPPERREL_WINDOW:
 			if (IsA(linitial(input_rel->pathlist), CustomPath))
@@ -41,6 +41,7 @@
 #include <nodes/pg_list.h>
 #include <optimizer/planner.h>
 #include <storage/bufmgr.h>
+#include <storage/latch.h>
 #include <storage/lmgr.h>
 #include <storage/predicate.h>
 #include <storage/smgr.h>
@@ -57,6 +58,7 @@
 #include <utils/snapmgr.h>
 #include <utils/syscache.h>
 #include <utils/tuplesort.h>
+#include <utils/wait_event.h>
 
 #include "compat/compat.h"
 #include <access/toast_internals.h>
@@ -65,6 +67,7 @@
 #include "chunk.h"
 #include "chunk_index.h"
 #include "debug_assert.h"
+#include "guc.h"
 #include "hypertable_cache.h"
 #include "indexing.h"
 #include "reorder.h"
@@ -74,6 +77,9 @@ static void reorder_rel(Oid tableOid, Oid indexOid, bool verbose, Oid wait_id,
 
 #define REORDER_ACCESS_EXCLUSIVE_DEADLOCK_TIMEOUT "101000"
 
+/* Interval between attempts to take the swap lock without queueing */
+#define REORDER_SWAP_LOCK_RETRY_INTERVAL_MS 10
+
 static void rebuild_relation(Relation OldHeap, Oid indexOid, bool verbose, Oid wait_id,
 							 Oid destination_tablespace, Oid index_tablespace);
 static void copy_heap_data(Oid OIDNewHeap, Oid OIDOldHeap, Oid OIDOldIndex, bool verbose,
@@ -84,6 +90,8 @@ static void finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, List *old_index_oi
 							  List *new_index_oids, bool swap_toast_by_content, bool is_internal,
 							  TransactionId frozenXid, MultiXactId cutoffMulti, Oid wait_id);
 
+static void lock_relation_for_swap(Oid relid);
+
 static void swap_relation_files(Oid r1, Oid r2, bool swap_toast_by_content, bool is_internal,
 								TransactionId frozenXid, MultiXactId cutoffMulti);
 
@@ -110,6 +118,22 @@ tsl_reorder_chunk(PG_FUNCTION_ARGS)
 	PG_RETURN_VOID();
 }
 
+/*
+ * Move a relation and its indexes to new tablespaces by altering the
+ * tablespaces. This copies the relation files block by block instead of
+ * rewriting the tuples and rebuilding the indexes.
+ */
+static void
+move_relation_files(Oid relid, Oid tablespace, Oid index_tablespace, Node *context)
+{
+	AlterTableCmd cmd = { .type = T_AlterTableCmd,
+						  .subtype = AT_SetTableSpace,
+						  .name = get_tablespace_name(tablespace) };
+
+	ts_alter_table_with_event_trigger(relid, context, list_make1(&cmd), false);
+	ts_chunk_index_move_all(relid, index_tablespace);
+}
+
 Datum
 tsl_move_chunk(PG_FUNCTION_ARGS)
 {
@@ -172,9 +196,6 @@ tsl_move_chunk(PG_FUNCTION_ARGS)
 	if (OidIsValid(chunk->fd.compressed_chunk_id))
 	{
 		Chunk *compressed_chunk = ts_chunk_get_by_id(chunk->fd.compressed_chunk_id, true);
-		AlterTableCmd cmd = { .type = T_AlterTableCmd,
-							  .subtype = AT_SetTableSpace,
-							  .name = get_tablespace_name(destination_tablespace) };
 
 		if (OidIsValid(index_id))
 			ereport(NOTICE,
@@ -182,14 +203,34 @@ tsl_move_chunk(PG_FUNCTION_ARGS)
 					 errmsg("ignoring index parameter"),
 					 errdetail("Chunk will not be reordered as it has compressed data.")));
 
-		ts_alter_table_with_event_trigger(chunk_id, fcinfo->context, list_make1(&cmd), false);
-		ts_alter_table_with_event_trigger(compressed_chunk->table_id,
-										  fcinfo->context,
-										  list_make1(&cmd),
-										  false);
-		/* move indexes on original and compressed chunk */
-		ts_chunk_index_move_all(chunk_id, index_destination_tablespace);
-		ts_chunk_index_move_all(compressed_chunk->table_id, index_destination_tablespace);
+		move_relation_files(chunk_id,
+							destination_tablespace,
+							index_destination_tablespace,
+							fcinfo->context);
+		move_relation_files(compressed_chunk->table_id,
+							destination_tablespace,
+							index_destination_tablespace,
+							fcinfo->context);
+	}
+	else if (!OidIsValid(index_id) &&
+			 !OidIsValid(ts_indexing_find_clustered_index(chunk_id)) &&
+			 !OidIsValid(ts_indexing_find_clustered_index(chunk->hypertable_relid)))
+	{
+		/*
+		 * No reordering was requested and there is no clustered index to
+		 * reorder by, so there is no need to rewrite the chunk. Copy the
+		 * relation files block by block instead, which also moves the indexes
+		 * without rebuilding them.
+		 *
+		 * Unlike reorder, this holds an AccessExclusiveLock on the chunk for
+		 * the whole copy, so reads of the chunk are blocked until the move is
+		 * done. Passing a reorder index keeps using reorder, which only takes
+		 * that lock for the final swap.
+		 */
+		move_relation_files(chunk_id,
+							destination_tablespace,
+							index_destination_tablespace,
+							fcinfo->context);
 	}
 	else
 	{
@@ -740,6 +781,42 @@ copy_heap_data(Oid OIDNewHeap, Oid OIDOldHeap, Oid OIDOldIndex, bool verbose,
  * NB: new_index_oids must be in the same order as RelationGetIndexList
  *
  */
+/*
+ * There's a risk of deadlock if some other process is also trying to upgrade
+ * their lock in the same manner as us, at this time. Since our transaction
+ * has performed a large amount of work, and only needs to be run once per
+ * chunk, we do not want to abort it due to this deadlock. To prevent abort we
+ * set our `deadlock_timeout` to a large value in the expectation that the
+ * other process will timeout and abort first. Currently we set
+ * `deadlock_timeout` to 1 hour, as this should be longer than any other
+ * normal process, while still allowing the system to make progress in the
+ * event of a real deadlock. As this is the last lock we grab, and the setting
+ * is local to our transaction we do not bother changing the guc back.
+ */
+static void
+set_swap_deadlock_timeout(void)
+{
+	int config_change;
+
+	config_change = set_config_option("deadlock_timeout",
+									  REORDER_ACCESS_EXCLUSIVE_DEADLOCK_TIMEOUT,
+									  PGC_SUSET,
+									  PGC_S_SESSION,
+									  GUC_ACTION_LOCAL,
+									  true,
+									  0,
+									  false);
+
+	if (config_change == 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("deadlock_timeout guc does not exist.")));
+	else if (config_change < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("could not set deadlock_timeout guc.")));
+}
+
 static void
 finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, List *old_index_oids, List *new_index_oids,
 				  bool swap_toast_by_content, bool is_internal, TransactionId frozenXid,
@@ -749,7 +826,6 @@ finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, List *old_index_oids, List *ne
 	Relation oldHeapRel;
 	ListCell *old_index_cell;
 	ListCell *new_index_cell;
-	int config_change;
 
 #ifdef DEBUG
 
@@ -766,38 +842,9 @@ finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, List *old_index_oids, List *ne
 	}
 #endif
 
-	/*
-	 * There's a risk of deadlock if some other process is also trying to
-	 * upgrade their lock in the same manner as us, at this time. Since our
-	 * transaction has performed a large amount of work, and only needs to be
-	 * run once per chunk, we do not want to abort it due to this deadlock. To
-	 * prevent abort we set our `deadlock_timeout` to a large value in the
-	 * expectation that the other process will timeout and abort first.
-	 * Currently we set `deadlock_timeout` to 1 hour, as this should be longer
-	 * than any other normal process, while still allowing the system to make
-	 * progress in the event of a real deadlock. As this is the last lock we
-	 * grab, and the setting is local to our transaction we do not bother
-	 * changing the guc back.
-	 */
-	config_change = set_config_option("deadlock_timeout",
-									  REORDER_ACCESS_EXCLUSIVE_DEADLOCK_TIMEOUT,
-									  PGC_SUSET,
-									  PGC_S_SESSION,
-									  GUC_ACTION_LOCAL,
-									  true,
-									  0,
-									  false);
-
-	if (config_change == 0)
-		ereport(ERROR,
-				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-				 errmsg("deadlock_timeout guc does not exist.")));
-	else if (config_change < 0)
-		ereport(ERROR,
-				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-				 errmsg("could not set deadlock_timeout guc.")));
-
-	oldHeapRel = table_open(OIDOldHeap, AccessExclusiveLock);
+	set_swap_deadlock_timeout();
+	lock_relation_for_swap(OIDOldHeap);
+	oldHeapRel = table_open(OIDOldHeap, NoLock);
 
 	/*
 	 * All predicate locks on the tuples or pages are about to be made
@@ -894,6 +941,84 @@ finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, List *old_index_oids, List *ne
 	}
 }
 
+/*
+ * Take the AccessExclusiveLock needed to swap in the reordered heap.
+ *
+ * We already hold an ExclusiveLock, so only readers can conflict with the
+ * lock upgrade. A queued AccessExclusiveLock request blocks every reader that
+ * arrives after it, which stalls reads on the chunk for as long as the oldest
+ * reader runs. To avoid this, retry the lock without queueing for up to
+ * timescaledb.reorder_swap_lock_timeout before falling back to waiting for
+ * it.
+ */
+static void
+lock_relation_for_swap(Oid relid)
+{
+	if (ts_guc_reorder_swap_lock_timeout > 0)
+	{
+		TimestampTz deadline = TimestampTzPlusMilliseconds(GetCurrentTimestamp(),
+														   ts_guc_reorder_swap_lock_timeout);
+
+		while (GetCurrentTimestamp() < deadline)
+		{
+			if (ConditionalLockRelationOid(relid, AccessExclusiveLock))
+				return;
+
+			(void) WaitLatch(MyLatch,
+							 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+							 REORDER_SWAP_LOCK_RETRY_INTERVAL_MS,
+							 PG_WAIT_EXTENSION);
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+		}
+
+		elog(DEBUG1,
+			 "could not lock \"%s\" for swap without waiting, waiting for lock",
+			 get_rel_name(relid));
+	}
+
+	LockRelationOid(relid, AccessExclusiveLock);
+}
+
+/*
+ * Take the AccessExclusiveLock needed to swap a chunk, like reorder does.
+ *
+ * Operations that swap several chunks take all locks up front, in a
+ * consistent order, before swapping any of them.
+ */
+void
+reorder_lock_relation_for_swap(Oid relid)
+{
+	set_swap_deadlock_timeout();
+	lock_relation_for_swap(relid);
+}
+
+/*
+ * Swap a transient heap, filled by the caller, into a chunk.
+ *
+ * The chunk's indexes are built on the transient heap first, so the
+ * AccessExclusiveLock on the chunk is only needed for swapping the relation
+ * files. The transient heap is dropped afterwards.
+ */
+void
+reorder_swap_chunk_heap(Oid chunk_relid, Oid new_heap_relid, TransactionId frozenXid,
+						MultiXactId cutoffMulti)
+{
+	List *old_index_oids;
+	List *new_index_oids =
+		ts_chunk_index_duplicate(chunk_relid, new_heap_relid, &old_index_oids, InvalidOid);
+
+	finish_heap_swaps(chunk_relid,
+					  new_heap_relid,
+					  old_index_oids,
+					  new_index_oids,
+					  false,
+					  true,
+					  frozenXid,
+					  cutoffMulti,
+					  InvalidOid);
+}
+
 /*
  * Swap the physical files of two given relations.
  *
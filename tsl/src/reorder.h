@@ -6,8 +6,12 @@
 #pragma once
 
 #include <postgres.h>
+#include <access/multixact.h>
 
 extern Datum tsl_reorder_chunk(PG_FUNCTION_ARGS);
 extern Datum tsl_move_chunk(PG_FUNCTION_ARGS);
 extern void reorder_chunk(Oid chunk_id, Oid index_id, bool verbose, Oid wait_id,
 						  Oid destination_tablespace, Oid index_tablespace);
+extern void reorder_lock_relation_for_swap(Oid relid);
+extern void reorder_swap_chunk_heap(Oid chunk_relid, Oid new_heap_relid, TransactionId frozenXid,
+									MultiXactId cutoffMulti);
@@ -0,0 +1,50 @@
+# This file and its contents are licensed under the Timescale License.
+# Please see the included NOTICE for copyright information and
+# LICENSE-TIMESCALE for a copy of the license.
+
+# merge_chunks() and split_chunk() copy the rows while holding an
+# ExclusiveLock on the chunks, so reads continue during the copy, and the
+# copied rows keep their transaction information, so snapshots taken before
+# the operation still see them.
+setup {
+ CREATE TABLE mst(time timestamptz NOT NULL, device int, value float);
+ SELECT create_hypertable('mst', 'time', chunk_time_interval => interval '1 day');
+ INSERT INTO mst
+ SELECT t, 1, 1.0 FROM generate_series('2024-01-01 00:00+0'::timestamptz, '2024-01-02 23:00+0', interval '1 hour') t;
+ CREATE TABLE other(i int);
+}
+
+teardown {
+ DROP TABLE mst;
+ DROP TABLE other;
+}
+
+# A transaction that takes its snapshot before the merge or split
+session "S"
+step "Sbegin"	{ BEGIN ISOLATION LEVEL REPEATABLE READ; SELECT count(*) FROM other; }
+step "Scount"	{ SELECT count(*) FROM mst; }
+step "Sc"	{ COMMIT; }
+
+# A writer to the second chunk that the merge has to wait for
+session "W"
+step "Wbegin"	{ BEGIN; INSERT INTO mst VALUES ('2024-01-02 00:30+0', 2, 2.0); }
+step "Wc"	{ COMMIT; }
+
+# A reader of the first chunk, which the merge has locked
+session "Q"
+step "Qcount"	{ SELECT count(*) FROM mst; }
+
+session "M"
+step "Mmerge"	{ SELECT count(*) FROM (SELECT merge_chunks(array_agg(c)) FROM show_chunks('mst') c) m; }
+step "Msplit"	{ SELECT count(split_chunk(c)) FROM (SELECT c FROM show_chunks('mst') c ORDER BY c LIMIT 1) s; }
+step "Mchunks"	{ SELECT count(*) FROM show_chunks('mst'); }
+
+# the old snapshot sees all rows of the merged chunk
+permutation "Sbegin" "Mmerge" "Scount" "Sc" "Mchunks"
+
+# the old snapshot sees all rows of the split chunks
+permutation "Sbegin" "Msplit" "Scount" "Sc" "Mchunks"
+
+# while the merge holds the first chunk and waits for the writer to the
+# second chunk, the first chunk can still be read
+permutation "Wbegin" "Mmerge" "Qcount" "Wc" "Qcount" "Mchunks"
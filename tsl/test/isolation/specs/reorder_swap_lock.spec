@@ -0,0 +1,64 @@
+# This file and its contents are licensed under the Timescale License.
+# Please see the included NOTICE for copyright information and
+# LICENSE-TIMESCALE for a copy of the license.
+
+# With timescaledb.reorder_swap_lock_timeout set, reorder retries the lock
+# for the final table swap without queueing behind readers, and only waits
+# for the lock once the timeout has passed.
+setup {
+ CREATE TABLE ts_reorder_test(time int, temp float, location int);
+ SELECT create_hypertable('ts_reorder_test', 'time', chunk_time_interval => 100);
+ INSERT INTO ts_reorder_test VALUES (1, 23.4, 1), (11, 21.3, 2), (21, 19.5, 3);
+ CREATE TABLE waiter(i INTEGER);
+}
+
+teardown {
+ DROP TABLE ts_reorder_test;
+ DROP TABLE waiter;
+}
+
+# A reader that holds its lock on the chunk until it gives up waiting for
+# the lock on waiter. The lock on the chunk is taken in the subtransaction
+# of the exception block, so it is released when the lock wait times out.
+session "S"
+setup		{ BEGIN; SET LOCAL lock_timeout = '1s'; }
+step "S1"	{ SELECT count(*) FROM ts_reorder_test; }
+step "Sbounded"	{
+ DO $$
+ BEGIN
+   PERFORM count(*) FROM ts_reorder_test;
+   LOCK TABLE waiter;
+ EXCEPTION WHEN lock_not_available THEN
+   RAISE NOTICE 'reader released its lock';
+ END;
+ $$;
+}
+step "Sc"	{ COMMIT; }
+
+session "R"
+setup		{ SET lock_timeout = '500ms'; SET deadlock_timeout = '10ms'; }
+step "Rretry"	{ SET timescaledb.reorder_swap_lock_timeout = '1min'; }
+step "Rshort"	{ SET timescaledb.reorder_swap_lock_timeout = '100ms'; }
+step "Rwait"	{ SET timescaledb.reorder_swap_lock_timeout = 0; }
+step "R1"	{ SELECT reorder_chunk((SELECT show_chunks('ts_reorder_test') LIMIT 1), 'ts_reorder_test_time_idx'); }
+step "Rcount"	{ SELECT count(*) FROM ts_reorder_test; }
+
+session "B"
+setup		{ BEGIN; LOCK TABLE waiter; }
+step "Bc"	{ COMMIT; }
+
+# reorder retries while the reader holds its lock and swaps the chunk once
+# the reader released it, without ever queueing for the lock
+permutation "Rretry" "Sbounded" "R1" "Sc" "Bc"
+
+# without retrying, reorder queues for the lock and times out before the
+# reader releases it
+permutation "Rwait" "Sbounded" "R1" "Sc" "Bc"
+
+# once the retry timeout has passed, reorder queues for the lock and
+# finishes when the reader commits
+permutation "Rshort" "S1" "R1" "Sc" "Bc" "Rcount"
+
+# once the retry timeout has passed, reorder queues for the lock and fails
+# with a lock timeout if the reader does not release it in time
+permutation "Rshort" "S1" "R1" "Rcount" "Sc" "Bc"
@@ -185,3 +185,76 @@ RESET enable_seqscan;
 RESET random_page_cost;
 RESET cpu_operator_cost;
 RESET enable_hashagg;
+
+-- Eager aggregation: push the partial aggregation below a join with a
+-- dimension table
+RESET max_parallel_workers_per_gather;
+RESET parallel_leader_participation;
+SET max_parallel_workers_per_gather = 0;
+
+CREATE TABLE eager_metrics(time timestamptz NOT NULL, device_id int, value float);
+SELECT create_hypertable('eager_metrics', 'time', chunk_time_interval => interval '1 day');
+ALTER TABLE eager_metrics SET (timescaledb.compress, timescaledb.compress_segmentby = 'device_id', timescaledb.compress_orderby = 'time');
+
+INSERT INTO eager_metrics
+SELECT time, device_id, device_id * 10 + extract(minute from time)
+FROM generate_series('2000-01-01 0:00:00+0'::timestamptz, '2000-01-04 23:59:00+0', '1 minute') gtime(time), generate_series(1, 10) gdevice(device_id);
+
+SELECT count(compress_chunk(c)) FROM show_chunks('eager_metrics') c WHERE c < (SELECT max(c) FROM show_chunks('eager_metrics') c);
+
+CREATE TABLE eager_devices(id int PRIMARY KEY, name text, region text);
+INSERT INTO eager_devices SELECT id, 'device ' || id, CASE WHEN id % 2 = 0 THEN 'east' ELSE 'west' END FROM generate_series(1, 10) id;
+
+-- A dimension table with duplicate join keys
+CREATE TABLE eager_tags(device_id int, tag text);
+INSERT INTO eager_tags VALUES (1, 'a'), (1, 'b'), (2, 'a'), (3, NULL);
+
+ANALYZE eager_metrics, eager_devices, eager_tags;
+
+\set Q1 'SELECT d.region, count(*), sum(value), round(avg(value)::numeric, 6) AS avg, min(time), max(value) FROM eager_metrics m JOIN eager_devices d ON m.device_id = d.id GROUP BY d.region ORDER BY 1'
+\set Q2 'SELECT count(*), sum(value) FROM eager_metrics m JOIN eager_devices d ON m.device_id = d.id WHERE d.region = ''east'''
+\set Q3 'SELECT t.tag, m.device_id, count(*), sum(value) FROM eager_metrics m JOIN eager_tags t ON m.device_id = t.device_id GROUP BY 1, 2 HAVING count(*) > 1 ORDER BY 1, 2'
+\set Q4 'SELECT t.tag, count(*), sum(value) FILTER (WHERE value > 50) FROM eager_metrics m JOIN eager_tags t ON m.device_id < t.device_id GROUP BY 1 ORDER BY 1'
+
+EXPLAIN (costs off) :Q1;
+:Q1;
+EXPLAIN (costs off) :Q2;
+:Q2;
+EXPLAIN (costs off) :Q3;
+:Q3;
+EXPLAIN (costs off) :Q4;
+:Q4;
+
+-- The aggregate uses a column of the dimension table, so it cannot be pushed down
+EXPLAIN (costs off)
+SELECT t.tag, count(t.tag) FROM eager_metrics m JOIN eager_tags t ON m.device_id = t.device_id GROUP BY 1 ORDER BY 1;
+
+-- No join, same results
+SET timescaledb.enable_eager_aggregation = off;
+EXPLAIN (costs off) :Q1;
+:Q1;
+:Q2;
+:Q3;
+:Q4;
+RESET timescaledb.enable_eager_aggregation;
+RESET max_parallel_workers_per_gather;
+
+-- Equal values that are not identical, like numeric 1.0 and 1.00, cannot be
+-- grouped below the join, since the groups above the join tell them apart
+SET max_parallel_workers_per_gather = 0;
+CREATE TABLE eager_amounts(time timestamptz NOT NULL, amount numeric, value int);
+SELECT create_hypertable('eager_amounts', 'time', chunk_time_interval => interval '1 day');
+INSERT INTO eager_amounts
+SELECT '2000-01-01 0:00:00+0'::timestamptz + i * interval '1 minute', CASE WHEN i % 2 = 0 THEN 1.0 ELSE 1.00 END, 1
+FROM generate_series(0, 5000) i;
+CREATE TABLE eager_amount_names(amount numeric, name text);
+INSERT INTO eager_amount_names VALUES (1, 'one');
+ANALYZE eager_amounts, eager_amount_names;
+
+\set Q5 'SELECT m.amount::text, n.name, sum(value) FROM eager_amounts m JOIN eager_amount_names n ON m.amount = n.amount GROUP BY 1, 2 ORDER BY 1, 2'
+EXPLAIN (costs off) :Q5;
+:Q5;
+SET timescaledb.enable_eager_aggregation = off;
+:Q5;
+RESET timescaledb.enable_eager_aggregation;
+RESET max_parallel_workers_per_gather;
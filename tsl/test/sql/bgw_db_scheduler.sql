@@ -700,6 +700,34 @@ SELECT job_id, last_run_success, total_runs, total_successes, total_failures, to
 SELECT * FROM sorted_bgw_log WHERE msg NOT LIKE '[TESTING] Wait until%';
 SELECT last_finish, last_successful_finish, last_run_success FROM _timescaledb_internal.bgw_job_stat;
 
+--
+-- Test that many jobs are started in order of their next start, with the
+-- scheduler waking up once for every job
+--
+\c :TEST_DBNAME :ROLE_SUPERUSER
+TRUNCATE bgw_log;
+TRUNCATE _timescaledb_internal.bgw_job_stat;
+SELECT ts_bgw_params_reset_time();
+SELECT ts_bgw_params_mock_wait_returns_immediately(:WAIT_ON_JOB);
+DELETE FROM _timescaledb_config.bgw_job;
+SELECT count(insert_job(format('many_%s', lpad(i::text, 2, '0')), 'bgw_test_job_1', INTERVAL '1h', INTERVAL '100s', INTERVAL '1s'))
+FROM generate_series(1, 20) i;
+-- Schedule the jobs in reverse order of creation, 1ms apart
+INSERT INTO _timescaledb_internal.bgw_job_stat(job_id, last_start, last_finish, next_start, last_successful_finish,
+  last_run_success, total_runs, total_duration, total_duration_failures, total_successes, total_failures,
+  total_crashes, consecutive_failures, consecutive_crashes)
+SELECT id, '-infinity', '-infinity', '2000-01-01 00:00:00+00'::timestamptz + (120 - row_number() OVER (ORDER BY id)) * interval '1ms',
+  '-infinity', true, 0, '0', '0', 0, 0, 0, 0, 0
+FROM _timescaledb_config.bgw_job;
+\c :TEST_DBNAME :ROLE_DEFAULT_PERM_USER
+
+SELECT ts_bgw_db_scheduler_test_run_and_wait_for_scheduler_finish(200, 50);
+SELECT j.application_name, s.last_start, s.total_runs
+FROM _timescaledb_internal.bgw_job_stat s
+JOIN _timescaledb_config.bgw_job j ON j.id = s.job_id
+ORDER BY s.last_start, j.id;
+SELECT count(*) FROM bgw_log WHERE application_name = 'DB Scheduler' AND msg LIKE '[TESTING] Wait until%';
+
 -- clean up jobs
 \c :TEST_DBNAME :ROLE_SUPERUSER
 SELECT _timescaledb_functions.stop_background_workers();
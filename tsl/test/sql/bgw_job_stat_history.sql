@@ -149,6 +149,53 @@ FROM _timescaledb_internal.bgw_job_stat_history
 WHERE job_id = :job_id_3
 ORDER BY id;
 
+-- Policies record an execution profile
+CREATE TABLE profiled(time timestamptz NOT NULL, value int);
+SELECT table_name FROM create_hypertable('profiled', 'time', chunk_time_interval => interval '1 day');
+INSERT INTO profiled VALUES ('2000-01-01', 1), ('2000-01-03', 2), (now(), 3);
+SELECT add_retention_policy('profiled', interval '1 month', initial_start => now()) AS job_id_4 \gset
+SELECT test.wait_for_job_to_run(:job_id_4, 1);
+
+SELECT job_id = :job_id_4 AS job_id, proc_name, succeeded, phases ? 'drop_chunks' AS has_drop_chunks_phase, counters
+FROM timescaledb_information.job_profiles
+WHERE job_id = :job_id_4;
+
+-- Profiles are only collected in background workers, so running the job in
+-- the foreground does not add a profile
+CALL run_job(:job_id_4);
+SELECT count(*) FROM timescaledb_information.job_profiles WHERE job_id = :job_id_4;
+
+SELECT delete_job(:job_id_4);
+DROP TABLE profiled;
+
+-- Policies with adaptive scheduling start again early while they have backlog
+CREATE TABLE adaptive(time timestamptz NOT NULL, value int);
+SELECT table_name FROM create_hypertable('adaptive', 'time', chunk_time_interval => interval '1 day');
+ALTER TABLE adaptive SET (timescaledb.compress);
+INSERT INTO adaptive VALUES ('2000-01-01', 1), ('2000-01-03', 2), ('2000-01-05', 3);
+SELECT add_compression_policy('adaptive', interval '1 month', schedule_interval => interval '1 hour',
+                              initial_start => now() + interval '1 day') AS job_id_5 \gset
+SELECT config FROM alter_job(:job_id_5,
+                             config => (SELECT config FROM _timescaledb_config.bgw_job WHERE id = :job_id_5)
+                                       || '{"maxchunks_to_compress": 2, "adaptive_schedule": true}',
+                             next_start => now());
+SELECT test.wait_for_job_to_run(:job_id_5, 3);
+
+SELECT counters->'backlog' AS backlog
+FROM timescaledb_information.job_profiles
+WHERE job_id = :job_id_5
+ORDER BY id;
+SELECT count(*) FILTER (WHERE is_compressed) AS compressed, count(*) AS total
+FROM timescaledb_information.chunks
+WHERE hypertable_name = 'adaptive';
+-- without backlog the regular schedule is used
+SELECT next_start - last_finish > interval '50 minutes' AS regular_schedule
+FROM _timescaledb_internal.bgw_job_stat
+WHERE job_id = :job_id_5;
+
+SELECT delete_job(:job_id_5);
+DROP TABLE adaptive;
+
 SELECT delete_job(:job_id_1);
 SELECT delete_job(:job_id_2);
 SELECT delete_job(:job_id_3);
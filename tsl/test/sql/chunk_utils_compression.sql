@@ -58,6 +58,21 @@ ORDER BY table_name DESC;
 SELECT show_chunks('public.uncompressed_table');
 SELECT show_chunks('public.table_to_compress');
 
+-- no catalog rows are left behind for the dropped chunks and their
+-- compressed chunks
+SELECT
+  (SELECT count(*) FROM _timescaledb_catalog.chunk_constraint cc
+    WHERE NOT EXISTS (SELECT FROM _timescaledb_catalog.chunk c WHERE c.id = cc.chunk_id)) AS constraints,
+  (SELECT count(*) FROM _timescaledb_catalog.chunk_index ci
+    WHERE NOT EXISTS (SELECT FROM _timescaledb_catalog.chunk c WHERE c.id = ci.chunk_id)) AS indexes,
+  (SELECT count(*) FROM _timescaledb_catalog.compression_chunk_size s
+    WHERE NOT EXISTS (SELECT FROM _timescaledb_catalog.chunk c WHERE c.id = s.chunk_id)) AS sizes,
+  (SELECT count(*) FROM _timescaledb_catalog.compression_settings s
+    WHERE NOT EXISTS (SELECT FROM pg_class WHERE oid = s.relid)) AS settings,
+  (SELECT count(*) FROM _timescaledb_catalog.dimension_slice ds
+    WHERE NOT EXISTS (SELECT FROM _timescaledb_catalog.chunk_constraint cc
+                       WHERE cc.dimension_slice_id = ds.id)) AS slices;
+
 -- test calling on internal compressed table
 SELECT
   format('%I.%I', ht.schema_name, ht.table_name) AS "TABLENAME"
@@ -0,0 +1,96 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- test column statistics computed while compressing chunks and merged
+-- into the hypertable statistics by ANALYZE
+\c :TEST_DBNAME :ROLE_CLUSTER_SUPERUSER
+SET ROLE :ROLE_DEFAULT_PERM_USER;
+
+CREATE TABLE metrics(time int NOT NULL, device int, value float);
+SELECT table_name FROM create_hypertable('metrics', 'time', chunk_time_interval => 100);
+ALTER TABLE metrics SET (timescaledb.compress, timescaledb.compress_segmentby = 'device',
+    timescaledb.compress_orderby = 'time');
+
+INSERT INTO metrics
+SELECT t, t % 4, CASE WHEN t % 10 = 0 THEN NULL ELSE t % 7 END
+FROM generate_series(0, 299) t;
+
+CREATE VIEW chunk_stats AS
+SELECT c.chunk_name, s.attname, s.null_frac, s.n_distinct, s.most_common_vals::text,
+    s.most_common_freqs, cardinality(s.histogram_bounds::text::text[]) AS histogram_size
+FROM timescaledb_information.chunks c
+JOIN pg_stats s ON s.schemaname = c.chunk_schema AND s.tablename = c.chunk_name
+WHERE c.hypertable_name = 'metrics'
+ORDER BY 1, 2;
+
+CREATE VIEW hypertable_stats AS
+SELECT attname, null_frac, n_distinct, most_common_vals::text, most_common_freqs,
+    histogram_bounds::text::text[] AS bounds
+FROM pg_stats
+WHERE tablename = 'metrics' AND inherited
+ORDER BY 1;
+
+-- no statistics without compression, and none for the internal
+-- compressed chunks
+SELECT count(*) FROM chunk_stats;
+
+-- compressing a chunk computes its statistics
+SELECT compress_chunk(ch) FROM show_chunks('metrics') ch ORDER BY ch LIMIT 1;
+SELECT * FROM chunk_stats;
+SELECT count(*) FROM metrics WHERE device = 1;
+
+-- nothing is computed when disabled
+SET timescaledb.enable_compression_analyze TO off;
+SELECT compress_chunk(ch) FROM show_chunks('metrics') ch ORDER BY ch OFFSET 1 LIMIT 1;
+SELECT count(*) FROM chunk_stats;
+RESET timescaledb.enable_compression_analyze;
+SELECT decompress_chunk(ch) FROM show_chunks('metrics') ch ORDER BY ch OFFSET 1 LIMIT 1;
+SELECT compress_chunk(ch) FROM show_chunks('metrics') ch ORDER BY ch OFFSET 1 LIMIT 1;
+SELECT chunk_name, count(*) FROM chunk_stats GROUP BY 1 ORDER BY 1;
+
+-- ANALYZE merges the statistics of the compressed chunks with the
+-- statistics of the uncompressed chunks
+ANALYZE metrics;
+SELECT attname, null_frac, n_distinct, most_common_vals, most_common_freqs,
+    cardinality(bounds) AS histogram_size, bounds[1] AS lower, bounds[cardinality(bounds)] AS upper
+FROM hypertable_stats;
+
+-- an ANALYZE that doesn't run through the utility hook, like the ANALYZE
+-- of autovacuum, only computes the statistics from the uncompressed rows,
+-- and doesn't change the statistics of the compressed chunks
+RESET ROLE;
+SET timescaledb.restoring TO on;
+ANALYZE metrics;
+SELECT ch AS compressed_chunk FROM show_chunks('metrics') ch ORDER BY ch LIMIT 1 \gset
+ANALYZE :compressed_chunk;
+RESET timescaledb.restoring;
+SET ROLE :ROLE_DEFAULT_PERM_USER;
+SELECT attname, null_frac, n_distinct, cardinality(bounds) AS histogram_size,
+    bounds[1] AS lower, bounds[cardinality(bounds)] AS upper
+FROM hypertable_stats;
+SELECT chunk_name, count(*) FROM chunk_stats GROUP BY 1 ORDER BY 1;
+
+-- the next ANALYZE merges them again
+ANALYZE metrics;
+SELECT attname, null_frac, n_distinct, cardinality(bounds) AS histogram_size,
+    bounds[1] AS lower, bounds[cardinality(bounds)] AS upper
+FROM hypertable_stats;
+
+-- only the analyzed columns are merged
+RESET ROLE;
+DELETE FROM pg_statistic WHERE starelid = 'metrics'::regclass;
+SET ROLE :ROLE_DEFAULT_PERM_USER;
+ANALYZE metrics (device);
+SELECT attname FROM hypertable_stats;
+
+-- fully compressed hypertable
+SELECT count(compress_chunk(ch, if_not_compressed => true)) FROM show_chunks('metrics') ch;
+ANALYZE metrics;
+SELECT attname, null_frac, n_distinct, most_common_vals, most_common_freqs,
+    cardinality(bounds) AS histogram_size, bounds[1] AS lower, bounds[cardinality(bounds)] AS upper
+FROM hypertable_stats;
+
+DROP VIEW hypertable_stats;
+DROP VIEW chunk_stats;
+DROP TABLE metrics;
@@ -35,6 +35,14 @@ CREATE INDEX skip_scan_idx_time_dev_idx ON :TABLE(time, dev);
 :PREFIX SELECT DISTINCT ON (dev) dev FROM :TABLE WHERE time = 100;
 DROP INDEX skip_scan_idx_time_dev_idx;
 
+-- multicolumn DISTINCT on a prefix of the index, columns have to be NOT NULL
+CREATE INDEX skip_scan_idx_dev_name_dev_time_idx ON :TABLE(dev_name, dev, time);
+:PREFIX SELECT DISTINCT dev_name, dev FROM :TABLE WHERE dev_name IS NOT NULL AND dev IS NOT NULL ORDER BY dev_name, dev;
+:PREFIX SELECT DISTINCT ON (dev_name, dev) dev_name, dev, time FROM :TABLE WHERE dev_name IS NOT NULL AND dev IS NOT NULL ORDER BY dev_name DESC, dev DESC, time DESC;
+:PREFIX SELECT DISTINCT ON (dev_name, time) dev_name, dev, time FROM :TABLE WHERE dev = 1 AND dev_name IS NOT NULL AND time IS NOT NULL AND time < 10;
+:PREFIX SELECT DISTINCT dev_name, dev FROM :TABLE WHERE dev_name IS NOT NULL ORDER BY dev_name, dev;
+DROP INDEX skip_scan_idx_dev_name_dev_time_idx;
+
 -- hash index is not ordered so can't use skipscan
 CREATE INDEX skip_scan_idx_hash ON :TABLE USING hash(dev_name);
 :PREFIX SELECT DISTINCT dev_name FROM :TABLE WHERE dev_name IN ('device_1','device_2') ORDER BY dev_name;
@@ -239,3 +247,16 @@ TRUNCATE skip_scan_insert;
 -- no tuples in resultset
 :PREFIX SELECT DISTINCT ON (time) time FROM skip_scan_nulls WHERE time IS NOT NULL;
 
+
+-- SkipScan below aggregates that only need the first tuple of each group
+:PREFIX SELECT count(DISTINCT dev) FROM :TABLE;
+:PREFIX SELECT count(DISTINCT dev), min(dev), max(dev) FROM :TABLE;
+:PREFIX SELECT dev FROM :TABLE GROUP BY dev ORDER BY dev;
+:PREFIX SELECT dev, min(time), first(val, time) FROM :TABLE GROUP BY dev ORDER BY dev;
+:PREFIX SELECT dev, max(time), last(val, time) FROM :TABLE WHERE time IS NOT NULL GROUP BY dev ORDER BY dev DESC;
+:PREFIX SELECT dev, min(time) FROM :TABLE GROUP BY dev HAVING min(time) < 100 ORDER BY dev;
+
+-- aggregates that need all tuples of a group can't use SkipScan
+:PREFIX SELECT dev, count(*) FROM :TABLE GROUP BY dev ORDER BY dev;
+:PREFIX SELECT dev, min(time), max(time) FROM :TABLE GROUP BY dev ORDER BY dev;
+:PREFIX SELECT count(DISTINCT dev), count(*) FROM :TABLE;
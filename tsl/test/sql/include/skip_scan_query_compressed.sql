@@ -0,0 +1,13 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- SkipScan over the segmentby index of compressed chunks
+:PREFIX SELECT DISTINCT ON (dev) dev, time FROM :TABLE ORDER BY dev, time DESC;
+:PREFIX SELECT DISTINCT ON (dev) dev, time FROM :TABLE ORDER BY dev DESC, time;
+:PREFIX SELECT DISTINCT ON (dev) dev, time, val FROM :TABLE WHERE time > 100 AND time < 600 ORDER BY dev, time DESC;
+:PREFIX SELECT DISTINCT dev FROM :TABLE WHERE dev > 5 ORDER BY dev;
+:PREFIX SELECT DISTINCT ON (dev) dev, time FROM _timescaledb_internal._hyper_1_1_chunk ORDER BY dev, time DESC;
+
+-- no SkipScan on columns that are not segmentby
+:PREFIX SELECT DISTINCT ON (time) time FROM :TABLE ORDER BY time DESC;
@@ -0,0 +1,144 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+SET timezone TO 'UTC';
+
+CREATE VIEW chunk_ranges AS
+SELECT c.table_name, s.range_start, s.range_end, c.status
+FROM _timescaledb_catalog.chunk c
+JOIN _timescaledb_catalog.chunk_constraint cc ON cc.chunk_id = c.id
+JOIN _timescaledb_catalog.dimension_slice s ON s.id = cc.dimension_slice_id
+JOIN _timescaledb_catalog.dimension d ON d.id = s.dimension_id
+WHERE NOT c.dropped AND d.column_name = 'time'
+ORDER BY s.range_start, c.table_name;
+
+CREATE TABLE metrics(time timestamptz NOT NULL, device int, value float, note text);
+SELECT table_name FROM create_hypertable('metrics', 'time', chunk_time_interval => interval '1 day');
+CREATE UNIQUE INDEX ON metrics(device, time);
+
+INSERT INTO metrics
+SELECT t, d, d * 0.5, CASE WHEN d = 1 THEN repeat(md5(t::text), 100) END
+FROM generate_series('2024-01-01'::timestamptz, '2024-01-04 23:00', interval '1 hour') t,
+     generate_series(1, 3) d;
+
+-- Chunks created after dropping a column have a different layout than
+-- the chunks created before
+ALTER TABLE metrics DROP COLUMN note;
+INSERT INTO metrics
+SELECT t, 1, 1.0
+FROM generate_series('2024-01-05'::timestamptz, '2024-01-05 23:00', interval '1 hour') t;
+
+CREATE TABLE metrics_expected AS SELECT * FROM metrics;
+
+SELECT * FROM chunk_ranges;
+
+-- Merge all chunks into the first one
+SELECT merge_chunks(array_agg(c ORDER BY c DESC)) FROM show_chunks('metrics') c;
+SELECT * FROM chunk_ranges;
+SELECT tableoid::regclass, count(*) FROM metrics GROUP BY 1;
+SELECT count(*) FROM (SELECT * FROM metrics EXCEPT ALL SELECT * FROM metrics_expected) s;
+
+-- The indexes are rebuilt on the merged data
+SET enable_seqscan TO off;
+SET enable_bitmapscan TO off;
+EXPLAIN (costs off) SELECT count(*) FROM metrics WHERE device = 1 AND time >= '2024-01-03';
+SELECT count(*) FROM metrics WHERE device = 1 AND time >= '2024-01-03';
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+
+SELECT pg_get_constraintdef(oid)
+FROM pg_constraint
+WHERE conrelid = '_timescaledb_internal._hyper_1_1_chunk'::regclass AND contype = 'c';
+
+-- Split the chunk in the middle and at a given point
+SELECT split_chunk('_timescaledb_internal._hyper_1_1_chunk');
+SELECT split_chunk('_timescaledb_internal._hyper_1_1_chunk', '2024-01-02'::timestamptz);
+SELECT * FROM chunk_ranges;
+SELECT tableoid::regclass, count(*), min(time), max(time) FROM metrics GROUP BY 1 ORDER BY 1;
+SELECT count(*) FROM (SELECT * FROM metrics EXCEPT ALL SELECT * FROM metrics_expected) s;
+
+SELECT conrelid::regclass, pg_get_constraintdef(oid)
+FROM pg_constraint
+WHERE conrelid IN (SELECT show_chunks('metrics')) AND contype = 'c'
+ORDER BY 1;
+
+-- Chunk exclusion uses the new ranges
+EXPLAIN (costs off) SELECT * FROM metrics WHERE time >= '2024-01-02 12:00' AND time < '2024-01-03';
+
+-- New rows are routed to the new chunks
+INSERT INTO metrics VALUES ('2024-01-02 12:30', 5, 5.0), ('2024-01-04 12:30', 5, 5.0);
+SELECT tableoid::regclass, count(*) FROM metrics WHERE device = 5 GROUP BY 1 ORDER BY 1;
+DELETE FROM metrics WHERE device = 5;
+
+\set ON_ERROR_STOP 0
+SELECT merge_chunks(NULL);
+SELECT merge_chunks(ARRAY['_timescaledb_internal._hyper_1_1_chunk'::regclass]);
+SELECT merge_chunks(ARRAY['_timescaledb_internal._hyper_1_1_chunk'::regclass, '_timescaledb_internal._hyper_1_1_chunk']);
+SELECT merge_chunks(ARRAY['metrics'::regclass, '_timescaledb_internal._hyper_1_1_chunk']);
+-- Chunks that are not adjacent
+SELECT merge_chunks(ARRAY['_timescaledb_internal._hyper_1_1_chunk'::regclass, '_timescaledb_internal._hyper_1_6_chunk']);
+SELECT split_chunk(NULL);
+SELECT split_chunk('_timescaledb_internal._hyper_1_1_chunk', '2024-01-05'::timestamptz);
+SELECT split_chunk('_timescaledb_internal._hyper_1_1_chunk', '2024-01-01'::timestamptz);
+SELECT split_chunk('_timescaledb_internal._hyper_1_1_chunk', 10);
+\set ON_ERROR_STOP 1
+
+-- Merge chunks in the same transaction they are split in
+BEGIN;
+SELECT split_chunk('_timescaledb_internal._hyper_1_7_chunk') AS new_chunk \gset
+SELECT merge_chunks(ARRAY['_timescaledb_internal._hyper_1_7_chunk'::regclass, :'new_chunk']);
+COMMIT;
+SELECT * FROM chunk_ranges;
+SELECT count(*) FROM (SELECT * FROM metrics EXCEPT ALL SELECT * FROM metrics_expected) s;
+
+-- Compressed chunks
+ALTER TABLE metrics SET (timescaledb.compress,
+                         timescaledb.compress_segmentby = 'device',
+                         timescaledb.compress_orderby = 'time');
+SELECT count(compress_chunk(c)) FROM show_chunks('metrics') c;
+
+\set ON_ERROR_STOP 0
+SELECT split_chunk('_timescaledb_internal._hyper_1_1_chunk');
+SELECT decompress_chunk('_timescaledb_internal._hyper_1_1_chunk');
+SELECT merge_chunks(ARRAY['_timescaledb_internal._hyper_1_1_chunk'::regclass, '_timescaledb_internal._hyper_1_7_chunk']);
+SELECT compress_chunk('_timescaledb_internal._hyper_1_1_chunk');
+\set ON_ERROR_STOP 1
+
+SELECT c.table_name, s.numrows_pre_compression, s.numrows_post_compression
+FROM _timescaledb_catalog.chunk c
+JOIN _timescaledb_catalog.compression_chunk_size s ON s.chunk_id = c.id
+ORDER BY 1;
+
+SELECT merge_chunks(array_agg(c)) FROM show_chunks('metrics') c;
+SELECT * FROM chunk_ranges;
+SELECT c.table_name, s.numrows_pre_compression, s.numrows_post_compression
+FROM _timescaledb_catalog.chunk c
+JOIN _timescaledb_catalog.compression_chunk_size s ON s.chunk_id = c.id
+ORDER BY 1;
+SELECT count(*) FROM (SELECT * FROM metrics EXCEPT ALL SELECT * FROM metrics_expected) s;
+
+SELECT count(decompress_chunk(c)) FROM show_chunks('metrics') c;
+SELECT count(*) FROM (SELECT * FROM metrics EXCEPT ALL SELECT * FROM metrics_expected) s;
+SELECT count(*) FROM (SELECT * FROM metrics_expected EXCEPT ALL SELECT * FROM metrics) s;
+
+-- Chunks must differ in one dimension only
+CREATE TABLE space(time timestamptz NOT NULL, device int);
+SELECT table_name FROM create_hypertable('space', 'time', 'device', 2, chunk_time_interval => interval '1 day');
+INSERT INTO space VALUES ('2024-01-01', 1), ('2024-01-01', 2), ('2024-01-02', 1), ('2024-01-02', 2);
+SELECT chunk_name, range_start, range_end, primary_dimension
+FROM timescaledb_information.chunks WHERE hypertable_name = 'space' ORDER BY 1;
+
+\set ON_ERROR_STOP 0
+SELECT merge_chunks(array_agg(c)) FROM show_chunks('space') c;
+\set ON_ERROR_STOP 1
+
+-- Merging in the space dimension
+SELECT merge_chunks(array_agg(c))
+FROM show_chunks('space', newer_than => '2024-01-02'::timestamptz) c;
+SELECT tableoid::regclass, count(*) FROM space GROUP BY 1 ORDER BY 1;
+
+DROP TABLE space;
+DROP TABLE metrics;
+DROP TABLE metrics_expected;
+DROP VIEW chunk_ranges;
@@ -31,9 +31,16 @@ COMMIT;
 SELECT * FROM test.show_indexes('_timescaledb_internal._hyper_1_1_chunk');
 SELECT * FROM test.show_indexes('_timescaledb_internal._hyper_1_2_chunk');
 
-\set ON_ERROR_STOP 0
--- cannot move a chunk with no reorder index on first call
+-- a chunk with no reorder index is moved without reordering it. This used to
+-- be an error. The chunk files are now copied with ALTER TABLE SET TABLESPACE,
+-- the way compressed chunks are moved, which keeps the chunk locked for the
+-- whole copy
 SELECT move_chunk(chunk=>'_timescaledb_internal._hyper_1_2_chunk', destination_tablespace=>'tablespace1', index_destination_tablespace=>'tablespace1');
+SELECT * FROM test.show_subtables('cluster_test');
+SELECT * FROM test.show_indexes('_timescaledb_internal._hyper_1_2_chunk');
+SELECT indexrelid::regclass, indisclustered FROM pg_index WHERE indrelid = '_timescaledb_internal._hyper_1_2_chunk'::regclass ORDER BY 1;
+
+\set ON_ERROR_STOP 0
 -- cannot move a chunk without a destination tablespace set
 SELECT move_chunk(chunk=>'_timescaledb_internal._hyper_1_2_chunk', destination_tablespace=>NULL, index_destination_tablespace=>'tablespace1', reorder_index=>'_timescaledb_internal._hyper_1_2_chunk_cluster_test_time_idx');
 -- cannot move a chunk without an index_destination_tablespace set
@@ -264,3 +264,36 @@ FROM
 SELECT add_reorder_policy(:'INTERNALTABLE','internal_idx');
 \set ON_ERROR_STOP 1
 
+
+-- reorder several chunks in a single run of the reorder policy
+CREATE TABLE multi_reorder(time int NOT NULL, value int);
+SELECT table_name FROM create_hypertable('multi_reorder', 'time', chunk_time_interval => 1);
+INSERT INTO multi_reorder SELECT t, t FROM generate_series(1, 6) t;
+SELECT add_reorder_policy('multi_reorder', 'multi_reorder_time_idx') AS reorder_job_id \gset
+
+\set ON_ERROR_STOP 0
+SELECT config FROM alter_job(:reorder_job_id,
+  config => jsonb_set((SELECT config FROM _timescaledb_config.bgw_job WHERE id = :reorder_job_id), '{maxchunks_to_reorder}', '0'));
+\set ON_ERROR_STOP 1
+
+SELECT config FROM alter_job(:reorder_job_id,
+  config => jsonb_set((SELECT config FROM _timescaledb_config.bgw_job WHERE id = :reorder_job_id), '{maxchunks_to_reorder}', '3'));
+
+CALL run_job(:reorder_job_id);
+SELECT indexrelid::regclass, indisclustered
+    FROM pg_index
+    WHERE indisclustered = true AND indexrelid::regclass::text LIKE '%multi_reorder%' ORDER BY 1;
+
+-- the remaining chunk is reordered on the next run
+CALL run_job(:reorder_job_id);
+SELECT count(*)
+    FROM pg_index
+    WHERE indisclustered = true AND indexrelid::regclass::text LIKE '%multi_reorder%';
+
+-- swap the reordered chunk in without queueing behind readers
+SET timescaledb.reorder_swap_lock_timeout = '1s';
+SELECT reorder_chunk(show_chunks('multi_reorder', older_than => 2), 'multi_reorder_time_idx');
+RESET timescaledb.reorder_swap_lock_timeout;
+
+SELECT delete_job(:reorder_job_id);
+DROP TABLE multi_reorder;
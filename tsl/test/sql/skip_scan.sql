@@ -47,3 +47,19 @@ RESET timescaledb.enable_skipscan;
 -- compare SkipScan results on hypertable
 :DIFF_CMD
 
+
+-- run tests on compressed hypertable and diff results
+SELECT count(compress_chunk(ch)) FROM show_chunks('skip_scan_ht') ch;
+\set TEST_QUERY_NAME include/skip_scan_query_compressed.sql
+\o :TEST_RESULTS_OPTIMIZED
+\ir :TEST_QUERY_NAME
+\o
+
+SET timescaledb.enable_skipscan TO false;
+\o :TEST_RESULTS_UNOPTIMIZED
+\ir :TEST_QUERY_NAME
+\o
+RESET timescaledb.enable_skipscan;
+
+-- compare SkipScan results on compressed hypertable
+:DIFF_CMD
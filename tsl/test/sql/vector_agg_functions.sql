@@ -152,9 +152,41 @@ where
     and (variable != 'cint8' or function != 'stddev')
     and (function != 'count' or variable in ('cint2', 's', '*'))
     and (condition is distinct from 'cint2 is null' or variable = 'cint2')
+    -- These use SkipScan, tested below
+    and (grouping is distinct from 's' or variable != 's' or function not in ('min', 'max'))
 order by explain, condition.n, variable, function, grouping.n
 \gexec
 
+-- Min and max of the segmentby column grouped by it use SkipScan, which is not
+-- vectorized.
+set timescaledb.debug_require_vector_agg = 'forbid';
+explain (costs off) select s, max(s) from aggfns group by s order by max(s), s limit 10;
+explain (costs off) select s, min(s) from aggfns where cfloat8 > 0 group by s order by min(s), s limit 10;
+
+select
+    format('select s, %s(s) from aggfns%s group by s order by %s(s), s limit 10;',
+            function, ' where ' || condition, function)
+from
+    unnest(array[
+        'min',
+        'max']) function,
+    unnest(array[
+        null,
+        'cfloat8 > 0',
+        'cfloat8 <= 0',
+        'cfloat8 < 1000',
+        'cfloat8 > 1000']) with ordinality as condition(condition, n)
+order by condition.n, function
+\gexec
+
+-- Without SkipScan, they are vectorized.
+set timescaledb.enable_skipscan to off;
+set timescaledb.debug_require_vector_agg = :'guc_value';
+explain (costs off) select s, max(s) from aggfns group by s order by max(s), s limit 10;
+explain (costs off) select s, min(s) from aggfns where cfloat8 > 0 group by s order by min(s), s limit 10;
+select s, min(s) from aggfns where cfloat8 > 0 group by s order by min(s), s limit 10;
+reset timescaledb.enable_skipscan;
+
 
 -- Test edge cases for various batch sizes and the filter matching around batch
 -- end.
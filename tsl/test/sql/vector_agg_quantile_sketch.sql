@@ -0,0 +1,88 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+\c :TEST_DBNAME :ROLE_SUPERUSER
+
+create table qsagg(time timestamptz not null, device int, value float8);
+select create_hypertable('qsagg', 'time', chunk_time_interval => interval '1 day');
+
+insert into qsagg
+select t, d, case when extract(minute from t)::int % 17 = 0 then null
+    else ((extract(epoch from t)::bigint / 60 * 7919) % 10007) * d - 2000 end
+from generate_series('2024-01-01'::timestamptz, '2024-01-03 23:59', interval '1 minute') t,
+    generate_series(1, 3) d;
+
+-- Compute the reference results before compression. The sketches are merged
+-- by adding up the bucket counts, so the results are the same for any split
+-- of the input.
+create table qsagg_reference as
+select device, approx_percentile(0.01, value) p01, approx_percentile(0.5, value) p50,
+    approx_percentile(0.99, value) p99
+from qsagg group by device;
+
+alter table qsagg set (timescaledb.compress, timescaledb.compress_segmentby = 'device');
+select count(compress_chunk(x)) from show_chunks('qsagg') x;
+vacuum analyze qsagg;
+
+set max_parallel_workers_per_gather = 0;
+set timescaledb.debug_require_vector_agg = 'require';
+
+-- The constant fraction is accepted by the vectorized aggregation
+explain (costs off)
+select device, approx_percentile(0.5, value) from qsagg group by device;
+
+select device, approx_percentile(0.01, value) p01, approx_percentile(0.5, value) p50,
+    approx_percentile(0.99, value) p99
+from qsagg group by device
+except select * from qsagg_reference;
+
+-- Vectorized filters
+select device, round(approx_percentile(0.9, value)::numeric, 4)
+from qsagg where time >= '2024-01-02 12:00' and value > 0
+group by device order by device;
+
+-- A column with a default value in the older batches
+reset timescaledb.debug_require_vector_agg;
+alter table qsagg add column value2 float8 default 7;
+insert into qsagg
+select t, d, null, d * 10
+from generate_series('2024-01-04'::timestamptz, '2024-01-04 23:59', interval '1 minute') t,
+    generate_series(1, 3) d;
+select count(compress_chunk(x)) from show_chunks('qsagg') x;
+vacuum analyze qsagg;
+set timescaledb.debug_require_vector_agg = 'require';
+
+select device, round(approx_percentile(0.1, value2)::numeric, 4),
+    round(approx_percentile(0.9, value2)::numeric, 4)
+from qsagg group by device order by device;
+
+\set ON_ERROR_STOP 0
+select approx_percentile(2, value) from qsagg;
+\set ON_ERROR_STOP 1
+
+-- A fraction that is not a constant is not vectorized
+set timescaledb.debug_require_vector_agg = 'forbid';
+select device, round(approx_percentile(device / 10.0, value)::numeric, 4)
+from qsagg group by device order by device;
+
+reset timescaledb.debug_require_vector_agg;
+
+-- Continuous aggregates materialize the finalized values
+create materialized view qsagg_daily with (timescaledb.continuous) as
+select time_bucket('1 day', time) bucket, device, approx_percentile(0.5, value) p50,
+    approx_percentile(0.99, value) p99
+from qsagg group by bucket, device with no data;
+call refresh_continuous_aggregate('qsagg_daily', null, null);
+
+select c.bucket, c.device, c.p50 = q.p50 p50_ok, c.p99 = q.p99 p99_ok
+from qsagg_daily c join (
+    select time_bucket('1 day', time) bucket, device, approx_percentile(0.5, value) p50,
+        approx_percentile(0.99, value) p99
+    from qsagg group by bucket, device) q on c.bucket = q.bucket and c.device = q.device
+where c.bucket < '2024-01-04'
+order by 1, 2;
+
+drop materialized view qsagg_daily;
+drop table qsagg;
+drop table qsagg_reference;
@@ -0,0 +1,106 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+\c :TEST_DBNAME :ROLE_SUPERUSER
+
+create table twagg(time timestamptz not null, device int, value float8);
+select create_hypertable('twagg', 'time', chunk_time_interval => interval '1 day');
+
+insert into twagg
+select t, d, case when extract(minute from t)::int % 17 = 0 then null
+    else (extract(epoch from t)::int % (900 * d)) / 10.0 end
+from generate_series('2024-01-01'::timestamptz, '2024-01-03 23:59', interval '1 minute') t,
+    generate_series(1, 3) d;
+
+-- Compute the reference results before compression.
+create table twagg_reference as
+select device, round(integral(time, value)::numeric, 3) integral,
+    round(time_weighted_avg(time, value)::numeric, 6) avg,
+    round(counter_rate(time, value)::numeric, 6) rate
+from twagg group by device;
+
+alter table twagg set (timescaledb.compress, timescaledb.compress_segmentby = 'device');
+select count(compress_chunk(x)) from show_chunks('twagg') x;
+vacuum analyze twagg;
+
+set max_parallel_workers_per_gather = 0;
+set timescaledb.debug_require_vector_agg = 'require';
+
+-- The batches are ordered by time descending and can arrive in any order
+explain (costs off)
+select device, integral(time, value) from twagg group by device;
+
+select device, round(integral(time, value)::numeric, 3) integral,
+    round(time_weighted_avg(time, value)::numeric, 6) avg,
+    round(counter_rate(time, value)::numeric, 6) rate
+from twagg group by device
+except select * from twagg_reference;
+
+select round(integral(time, value)::numeric, 3) integral,
+    round(time_weighted_avg(time, value)::numeric, 6) avg,
+    round(counter_rate(time, value)::numeric, 6) rate
+from twagg where device = 2;
+
+select * from twagg_reference where device = 2;
+
+-- Vectorized filters
+select device, round(integral(time, value)::numeric, 3)
+from twagg where time >= '2024-01-02 12:00' and value is not null
+group by device order by device;
+
+-- The rows of different devices are not ordered by time
+\set ON_ERROR_STOP 0
+select integral(time, value) from twagg;
+\set ON_ERROR_STOP 1
+
+-- Batches ordered by time ascending
+reset timescaledb.debug_require_vector_agg;
+alter table twagg set (timescaledb.compress_orderby = 'time');
+select count(compress_chunk(decompress_chunk(x))) from show_chunks('twagg') x;
+vacuum analyze twagg;
+set timescaledb.debug_require_vector_agg = 'require';
+
+select device, round(integral(time, value)::numeric, 3) integral,
+    round(time_weighted_avg(time, value)::numeric, 6) avg,
+    round(counter_rate(time, value)::numeric, 6) rate
+from twagg group by device
+except select * from twagg_reference;
+
+-- A column with a default value in the older batches
+reset timescaledb.debug_require_vector_agg;
+alter table twagg add column value2 float8 default 7;
+insert into twagg
+select t, d, null, d * 10
+from generate_series('2024-01-04'::timestamptz, '2024-01-04 23:59', interval '1 minute') t,
+    generate_series(1, 3) d;
+select count(compress_chunk(x)) from show_chunks('twagg') x;
+vacuum analyze twagg;
+set timescaledb.debug_require_vector_agg = 'require';
+
+select device, round(integral(time, value2)::numeric, 3),
+    round(time_weighted_avg(time, value2)::numeric, 6)
+from twagg group by device order by device;
+
+reset timescaledb.debug_require_vector_agg;
+
+-- Continuous aggregates materialize the finalized values
+create materialized view twagg_daily with (timescaledb.continuous) as
+select time_bucket('1 day', time) bucket, device, time_weighted_avg(time, value) avg,
+    integral(time, value), counter_rate(time, value) rate
+from twagg group by bucket, device with no data;
+call refresh_continuous_aggregate('twagg_daily', null, null);
+
+select c.bucket, c.device, round(c.avg::numeric, 6) = round(q.avg::numeric, 6) avg_ok,
+    round(c.integral::numeric, 3) = round(q.integral::numeric, 3) integral_ok,
+    round(c.rate::numeric, 6) = round(q.rate::numeric, 6) rate_ok
+from twagg_daily c join (
+    select time_bucket('1 day', time) bucket, device, time_weighted_avg(time, value) avg,
+        integral(time, value), counter_rate(time, value) rate
+    from twagg group by bucket, device) q on c.bucket = q.bucket and c.device = q.device
+where c.bucket < '2024-01-04'
+order by 1, 2;
+
+drop materialized view twagg_daily;
+drop table twagg;
+drop table twagg_reference;